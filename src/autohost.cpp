@@ -140,7 +140,16 @@ void AutoHost::OnSaidBattle(const wxString& /*unused*/, const wxString& msg)
 		if (params.IsEmpty())
 			DoAction(_T( "cannot switch to void mapname" ));
 		else {
-			const wxString mapname = GetBestMatch(lslTowxArrayString(LSL::usync().GetMapList()), params);
+			const std::vector<std::string> maps = LSL::usync().GetMapList();
+			if (maps != m_map_names) {
+				m_map_names = maps;
+				m_map_matcher.Clear();
+				for (size_t i = 0; i < m_map_names.size(); ++i) {
+					m_map_matcher.Add(TowxString(m_map_names[i]).ToStdWstring());
+				}
+			}
+			const int index = GetBestMatch(m_map_matcher, params.ToStdWstring());
+			const wxString mapname = (index < 0) ? wxString() : TowxString(m_map_names[index]);
 			try {
 				m_battle.SetLocalMap(STD_STRING(mapname));
 				DoAction(_T( "is switching to map " ) + mapname);
@@ -152,11 +161,11 @@ void AutoHost::OnSaidBattle(const wxString& /*unused*/, const wxString& msg)
 	} else if (command == _T( "!set" )) {
 		const std::string key = STD_STRING(params.BeforeFirst(_T(' ')));
 		const std::string value = STD_STRING(params.AfterFirst(_T(' ')));
-		const bool exists = m_battle.CustomBattleOptions().keyExists(key);
+		const bool exists = m_battle.GetCustomBattleOptions().keyExists(key);
 		if (exists) {
 			bool result = m_battle.CustomBattleOptions().setSingleOption(key, value);
 			if (result) {
-				auto section = m_battle.CustomBattleOptions().GetSection(key);
+				auto section = m_battle.GetCustomBattleOptions().GetSection(key);
 				m_battle.SendHostInfo(stdprintf("%d_%s", section, key.c_str()));
 				DoAction(TowxString("has set option " + key + " to value " + value));
 			} else
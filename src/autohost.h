@@ -6,6 +6,10 @@
 //including this header is only really needed for time_t ..
 #include <wx/string.h>
 #include <wx/arrstr.h>
+#include <string>
+#include <vector>
+
+#include "utils/fuzzymatcher.h"
 
 class IBattle;
 class User;
@@ -33,6 +37,10 @@ private:
 	bool m_enabled;
 	time_t m_lastActionTime;
 	wxArrayString m_userlist;
+
+	//! index over the installed maps for !map, rebuilt when the map list changes
+	FuzzyMatcher m_map_matcher;
+	std::vector<std::string> m_map_names;
 };
 
 #endif // SPRINGLOBBY_HEADERGUARD_AUTOHOST_H
@@ -21,6 +21,9 @@
 #include "utils/uievents.h"
 #include "utils/battleevents.h"
 #include "utils/slpaths.h"
+#include "utils/colourassigner.h"
+#include "utils/crc.h"
+#include "utils/teambalance.h"
 #include "gui/uiutils.h"
 #include "settings.h"
 #include "useractions.h"
@@ -172,7 +175,7 @@ void Battle::SaveMapDefaults()
 {
 	// save map preset
 	const wxString mapname = TowxString(LoadMap().name);
-	const std::string startpostype = CustomBattleOptions().getSingleValue("startpostype", LSL::Enum::EngineOption);
+	const std::string startpostype = GetCustomBattleOptions().getSingleValue("startpostype", LSL::Enum::EngineOption);
 	sett().SetMapLastStartPosType(mapname, TowxString(startpostype));
 	std::vector<Settings::SettStartBox> rects;
 	for (unsigned int i = 0; i <= GetLastRectIdx(); ++i) {
@@ -405,10 +408,10 @@ bool Battle::ExecuteSayCommand(const std::string& cmd)
 
 			if (UserExists(STD_STRING(nick))) {
 				User& user = GetUser(STD_STRING(nick));
-				if (!user.BattleStatus().ip.empty()) {
-					m_banned_ips.insert(user.BattleStatus().ip);
+				if (!user.BattleStatus().GetIP().empty()) {
+					m_banned_ips.insert(user.BattleStatus().GetIP());
 					UiEvents::GetUiEventSender(UiEvents::OnBattleActionEvent).SendEvent(
-					    UiEvents::OnBattleActionData(wxString(_T(" ")), TowxString(user.BattleStatus().ip) + _T(" banned")));
+					    UiEvents::OnBattleActionData(wxString(_T(" ")), TowxString(user.BattleStatus().GetIP()) + _T(" banned")));
 				}
 				m_serv.BattleKickPlayer(m_opts.battleid, user);
 			}
@@ -431,9 +434,9 @@ bool Battle::CheckBan(User& user)
 			UiEvents::GetUiEventSender(UiEvents::OnBattleActionEvent).SendEvent(
 			    UiEvents::OnBattleActionData(wxString(_T(" ")), TowxString(user.GetNick()) + _T(" is banned, kicking")));
 			return true;
-		} else if (m_banned_ips.count(user.BattleStatus().ip) > 0) {
+		} else if (m_banned_ips.count(user.BattleStatus().GetIP()) > 0) {
 			UiEvents::GetUiEventSender(UiEvents::OnBattleActionEvent).SendEvent(
-			    UiEvents::OnBattleActionData(wxString(_T(" ")), TowxString(user.BattleStatus().ip) + _T(" is banned, kicking")));
+			    UiEvents::OnBattleActionData(wxString(_T(" ")), TowxString(user.BattleStatus().GetIP()) + _T(" is banned, kicking")));
 			KickPlayer(user);
 			return true;
 		}
@@ -560,6 +563,7 @@ void Battle::ForceUnsyncedAndUnreadyToSpectate()
 
 void Battle::UserPositionChanged(const User& user)
 {
+	IBattle::UserPositionChanged(user);
 	m_serv.SendUserPosition(user);
 }
 
@@ -678,157 +682,112 @@ void Battle::FixColours()
 {
 	if (!IsFounderMe())
 		return;
-	std::vector<LSL::lslColor>& palette = GetFixColoursPalette(m_teams_sizes.size() + 1);
-	std::vector<int> palette_use(palette.size(), 0);
 
-	LSL::lslColor my_col = GetMe().BattleStatus().colour; // Never changes color of founder (me) :-)
-	int my_diff = 0;
-	int my_col_i = GetClosestFixColour(my_col, palette_use, my_diff);
-	palette_use[my_col_i]++;
-	std::set<int> parsed_teams;
+	const LSL::lslColor& my_col = GetMe().BattleStatus().colour; // Never changes color of founder (me) :-)
+	ColourAssigner assigner;
+	assigner.AddFixed(RGBColour(my_col.Red(), my_col.Green(), my_col.Blue()));
 
+	// one colour per team, players sharing a team keep sharing the colour
+	std::map<int, size_t> team_index;
 	for (user_map_t::size_type i = 0; i < GetNumUsers(); i++) {
 		User& user = GetUser(i);
 		if (&user == &GetMe())
 			continue; // skip founder ( yourself )
-		UserBattleStatus& status = user.BattleStatus();
+		const UserBattleStatus& status = user.BattleStatus();
 		if (status.spectator)
 			continue;
-		if (parsed_teams.find(status.team) != parsed_teams.end())
+		if (team_index.find(status.team) != team_index.end())
 			continue; // skip duplicates
-		parsed_teams.insert(status.team);
-
-		LSL::lslColor& user_col = status.colour;
-		int user_col_i = GetClosestFixColour(user_col, palette_use, 60);
-		palette_use[user_col_i]++;
-		for (user_map_t::size_type j = 0; j < GetNumUsers(); j++) {
-			User& usr = GetUser(j);
-			if (usr.BattleStatus().team == status.team) {
-				ForceColour(usr, palette[user_col_i]);
-			}
+		const LSL::lslColor& user_col = status.colour;
+		team_index[status.team] = assigner.AddPlayer(RGBColour(user_col.Red(), user_col.Green(), user_col.Blue()));
+	}
+
+	const std::vector<RGBColour> colours = assigner.Assign();
+	for (user_map_t::size_type i = 0; i < GetNumUsers(); i++) {
+		User& usr = GetUser(i);
+		if (&usr == &GetMe() || usr.BattleStatus().spectator)
+			continue;
+		const std::map<int, size_t>::const_iterator it = team_index.find(usr.BattleStatus().team);
+		if (it == team_index.end())
+			continue;
+		const RGBColour& col = colours[it->second];
+		const LSL::lslColor newcol(col.r, col.g, col.b);
+		if (!(usr.BattleStatus().colour == newcol)) {
+			ForceColour(usr, newcol);
 		}
 	}
 }
 
 
-bool PlayerRankCompareFunction(User* a, User* b) // should never operate on nulls. Hence, ASSERT_LOGIC is appropriate here.
-{
-	ASSERT_LOGIC(a, "fail in Autobalance, NULL player");
-	ASSERT_LOGIC(b, "fail in Autobalance, NULL player");
-	return (a->GetBalanceRank() > b->GetBalanceRank());
-}
-
-bool PlayerTeamCompareFunction(User* a, User* b) // should never operate on nulls. Hence, ASSERT_LOGIC is appropriate here.
-{
-	ASSERT_LOGIC(a, "fail in Autobalance, NULL player");
-	ASSERT_LOGIC(b, "fail in Autobalance, NULL player");
-	return (a->BattleStatus().team > b->BattleStatus().team);
-}
+//! players which have to end up in the same alliance / team
+typedef std::vector<User*> BalanceUnit;
 
-struct Alliance
+//! splits players into units: one per clan (if enabled and not dissolved) and one per remaining player
+static std::vector<BalanceUnit> GetBalanceUnits(const std::vector<User*>& players, size_t numgroups, bool support_clans, bool strong_clans)
 {
-	std::vector<User*> players;
-	float ranksum;
-	int allynum;
-	Alliance()
-	    : ranksum(0)
-	    , allynum(-1)
-	{
-	}
-	Alliance(int i)
-	    : ranksum(0)
-	    , allynum(i)
-	{
-	}
-	void AddPlayer(User* player)
-	{
-		if (player) {
-			players.push_back(player);
-			ranksum += player->GetBalanceRank();
+	std::vector<BalanceUnit> units;
+	std::map<std::string, BalanceUnit> clans;
+	if (support_clans) {
+		for (size_t i = 0; i < players.size(); ++i) {
+			const std::string clan = players[i]->GetClan();
+			if (!clan.empty()) {
+				clans[clan].push_back(players[i]);
+			}
 		}
 	}
-	void AddAlliance(Alliance& other)
-	{
-		for (std::vector<User*>::const_iterator i = other.players.begin(); i != other.players.end(); ++i)
-			AddPlayer(*i);
-	}
-	bool operator<(const Alliance& other) const
-	{
-		return ranksum < other.ranksum;
-	}
-};
-
-struct ControlTeam
-{
-	std::vector<User*> players;
-	float ranksum;
-	int teamnum;
-	ControlTeam()
-	    : ranksum(0)
-	    , teamnum(-1)
-	{
-	}
-	ControlTeam(int i)
-	    : ranksum(0)
-	    , teamnum(i)
-	{
-	}
-	void AddPlayer(User* player)
-	{
-		if (player) {
-			players.push_back(player);
-			ranksum += player->GetBalanceRank();
+	numgroups = std::max<size_t>(numgroups, 1);
+	const size_t capacity = (players.size() + numgroups - 1) / numgroups;
+	for (std::map<std::string, BalanceUnit>::iterator it = clans.begin(); it != clans.end(); ++it) {
+		// if clan is too small (only 1 clan member in battle) or too big, dont count it as clan
+		if ((it->second.size() < 2) || (!strong_clans && (it->second.size() > capacity))) {
+			wxLogMessage(_T("removing clan %s"), TowxString(it->first).c_str());
+			continue;
 		}
+		wxLogMessage(_T("Inserting clan %s"), TowxString(it->first).c_str());
+		units.push_back(it->second);
 	}
-	void AddTeam(ControlTeam& other)
-	{
-		for (std::vector<User*>::const_iterator i = other.players.begin(); i != other.players.end(); ++i)
-			AddPlayer(*i);
-	}
-	bool operator<(const ControlTeam& other) const
-	{
-		return ranksum < other.ranksum;
+	for (size_t i = 0; i < players.size(); ++i) {
+		const std::map<std::string, BalanceUnit>::const_iterator clan = clans.find(players[i]->GetClan());
+		if (clan != clans.end() && (clan->second.size() >= 2) && (strong_clans || (clan->second.size() <= capacity))) {
+			continue; // clanners have been added already
+		}
+		units.push_back(BalanceUnit(1, players[i]));
 	}
-};
-
-int my_random(int range)
-{
-	return rand() % range;
+	return units;
 }
 
-void shuffle(std::vector<User*>& players) // proper shuffle.
+//! assigns every unit to one of @p numgroups groups, see TeamBalancer
+static std::vector<size_t> BalanceUnits(const std::vector<BalanceUnit>& units, size_t numgroups, IBattle::BalanceType balance_type)
 {
-	for (size_t i = 0; i < players.size(); ++i) // the players below i are shuffled, the players above arent
-	{
-		int rn = i + my_random(players.size() - i); // the top of shuffled part becomes random card from unshuffled part
-		User* tmp = players[i];
-		players[i] = players[rn];
-		players[rn] = tmp;
+	// balance_divide has to give the same result for the same players each time,
+	// so the seed is derived from the players, balance_random is seeded randomly
+	CRC crc;
+	for (size_t i = 0; i < units.size(); ++i) {
+		for (size_t j = 0; j < units[i].size(); ++j) {
+			crc.UpdateData(units[i][j]->GetNick());
+		}
 	}
-}
+	const unsigned int seed = (balance_type == IBattle::balance_random) ? rand() : crc.GetCRC();
 
-/*
-bool ClanRemovalFunction(const std::map<wxString, Alliance>::value_type &v){
-  return v.second.players.size()<2;
+	TeamBalancer balancer(numgroups, seed);
+	for (size_t i = 0; i < units.size(); ++i) {
+		double rank = 0;
+		for (size_t j = 0; j < units[i].size(); ++j) {
+			ASSERT_LOGIC(units[i][j], "fail in Autobalance, NULL player");
+			// random balancing only cares about the number of players
+			rank += (balance_type == IBattle::balance_random) ? 1.0 : units[i][j]->GetBalanceRank();
+		}
+		balancer.AddUnit(rank, units[i].size());
+	}
+	const std::vector<size_t> groups = balancer.Balance();
+	wxLogMessage(_T("balanced %u units into %u groups, size difference %d, rank difference %f, optimal=%d"), units.size(), numgroups, balancer.GetSizeSpread(), balancer.GetRankSpread(), balancer.IsOptimal());
+	return groups;
 }
-*/
-/*
-struct ClannersRemovalPredicate{
-  std::map<wxString, Alliance> &clans;
-  PlayerRemovalPredicate(std::map<wxString, Alliance> &clans_):clans(clans_)
-  {
-  }
-  bool operator()(User *u) const{
-    return clans.find(u->GetClan());
-  }
-}*/
 
 void Battle::Autobalance(BalanceType balance_type, bool support_clans, bool strong_clans, int numallyteams)
 {
 	wxLogMessage(_T("Autobalancing alliances, type=%d, clans=%d, strong_clans=%d, numallyteams=%d"), balance_type, support_clans, strong_clans, numallyteams);
-	//size_t i;
-	//int num_alliances;
-	std::vector<Alliance> alliances;
+	std::vector<int> alliances;
 	if (numallyteams == 0 || numallyteams == -1) // 0 or 1 -> use num start rects
 	{
 		int ally = 0;
@@ -836,127 +795,50 @@ void Battle::Autobalance(BalanceType balance_type, bool support_clans, bool stro
 			BattleStartRect sr = GetStartRect(i);
 			if (sr.IsOk()) {
 				ally = i;
-				alliances.push_back(Alliance(ally));
+				alliances.push_back(ally);
 				ally++;
 			}
 		}
 		// make at least two alliances
 		while (alliances.size() < 2) {
-			alliances.push_back(Alliance(ally));
+			alliances.push_back(ally);
 			ally++;
 		}
 	} else {
 		for (int i = 0; i < numallyteams; i++)
-			alliances.push_back(Alliance(i));
+			alliances.push_back(i);
 	}
 
-	//for(i=0;i<alliances.size();++i)alliances[i].allynum=i;
-
 	wxLogMessage(_T("number of alliances: %u"), alliances.size());
 
-	std::vector<User*> players_sorted;
-	players_sorted.reserve(GetNumUsers());
-
+	// remove players in the same team so only one remains
+	std::map<int, User*> dedupe_teams;
 	for (size_t i = 0; i < GetNumUsers(); ++i) {
 		User& usr = GetUser(i);
 		if (!usr.BattleStatus().spectator) {
-			players_sorted.push_back(&usr);
+			dedupe_teams[usr.BattleStatus().team] = &usr;
 		}
 	}
-
-	// remove players in the same team so only one remains
-	std::map<int, User*> dedupe_teams;
-	for (std::vector<User*>::const_iterator it = players_sorted.begin(); it != players_sorted.end(); ++it) {
-		dedupe_teams[(*it)->BattleStatus().team] = *it;
-	}
-	players_sorted.clear();
-	players_sorted.reserve(dedupe_teams.size());
+	std::vector<User*> players;
+	players.reserve(dedupe_teams.size());
 	for (std::map<int, User*>::const_iterator it = dedupe_teams.begin(); it != dedupe_teams.end(); ++it) {
-		players_sorted.push_back(it->second);
+		players.push_back(it->second);
 	}
 
-	shuffle(players_sorted);
-
-	std::map<wxString, Alliance> clan_alliances;
-	if (support_clans) {
-		for (size_t i = 0; i < players_sorted.size(); ++i) {
-			wxString clan = TowxString(players_sorted[i]->GetClan());
-			if (!clan.empty()) {
-				clan_alliances[clan].AddPlayer(players_sorted[i]);
-			}
-		}
-	};
-
-	if (balance_type != balance_random)
-		std::sort(players_sorted.begin(), players_sorted.end(), PlayerRankCompareFunction);
-
-	if (support_clans) {
-		std::map<wxString, Alliance>::iterator clan_it = clan_alliances.begin();
-		while (clan_it != clan_alliances.end()) {
-			Alliance& clan = (*clan_it).second;
-			// if clan is too small (only 1 clan member in battle) or too big, dont count it as clan
-			if ((clan.players.size() < 2) || (!strong_clans && (clan.players.size() > ((players_sorted.size() + alliances.size() - 1) / alliances.size())))) {
-				wxLogMessage(_T("removing clan %s"), (*clan_it).first.c_str());
-				std::map<wxString, Alliance>::iterator next = clan_it;
-				++next;
-				clan_alliances.erase(clan_it);
-				clan_it = next;
-				continue;
-			}
-			wxLogMessage(_T("Inserting clan %s"), (*clan_it).first.c_str());
-			std::sort(alliances.begin(), alliances.end());
-			float lowestrank = alliances[0].ranksum;
-			int rnd_k = 1; // number of alliances with rank equal to lowestrank
-			while (size_t(rnd_k) < alliances.size()) {
-				if (fabs(alliances[rnd_k].ranksum - lowestrank) > 0.01)
-					break;
-				rnd_k++;
-			}
-			wxLogMessage(_T("number of lowestrank alliances with same rank=%d"), rnd_k);
-			alliances[my_random(rnd_k)].AddAlliance(clan);
-			++clan_it;
-		}
-	}
-
-	for (size_t i = 0; i < players_sorted.size(); ++i) {
-		// skip clanners, those have been added already.
-		if (clan_alliances.count(TowxString(players_sorted[i]->GetClan())) > 0) {
-			wxLogMessage(_T("clanner already added, nick=%s"), players_sorted[i]->GetNick().c_str());
-			continue;
-		}
-
-		// find alliances with lowest ranksum
-		// insert current user into random one out of them
-		// since performance doesnt matter here, i simply sort alliances,
-		// then find how many alliances in beginning have lowest ranksum
-		// note that balance player ranks range from 1 to 1.1 now
-		// i.e. them are quasi equal
-		// so we're essentially adding to alliance with smallest number of players,
-		// the one with smallest ranksum.
-
-		std::sort(alliances.begin(), alliances.end());
-		float lowestrank = alliances[0].ranksum;
-		int rnd_k = 1; // number of alliances with rank equal to lowestrank
-		while (size_t(rnd_k) < alliances.size()) {
-			if (fabs(alliances[rnd_k].ranksum - lowestrank) > 0.01)
-				break;
-			rnd_k++;
-		}
-		wxLogMessage(_T("number of lowestrank alliances with same rank=%d"), rnd_k);
-		alliances[my_random(rnd_k)].AddPlayer(players_sorted[i]);
-	}
+	const std::vector<BalanceUnit> units = GetBalanceUnits(players, alliances.size(), support_clans, strong_clans);
+	const std::vector<size_t> groups = BalanceUnits(units, alliances.size(), balance_type);
 
 	UserList::user_map_t::size_type totalplayers = GetNumUsers();
-	for (size_t i = 0; i < alliances.size(); ++i) {
-		for (size_t j = 0; j < alliances[i].players.size(); ++j) {
-			ASSERT_LOGIC(alliances[i].players[j], "fail in Autobalance, NULL player");
-			int balanceteam = alliances[i].players[j]->BattleStatus().team;
-			wxLogMessage(_T("setting team %d to alliance %d"), balanceteam, i);
+	for (size_t i = 0; i < units.size(); ++i) {
+		const int allynum = alliances[groups[i]];
+		for (size_t j = 0; j < units[i].size(); ++j) {
+			int balanceteam = units[i][j]->BattleStatus().team;
+			wxLogMessage(_T("setting team %d to alliance %d"), balanceteam, allynum);
 			for (size_t h = 0; h < totalplayers; h++) // change ally num of all players in the team
 			{
 				User& usr = GetUser(h);
 				if (usr.BattleStatus().team == balanceteam)
-					ForceAlly(usr, alliances[i].allynum);
+					ForceAlly(usr, allynum);
 			}
 		}
 	}
@@ -965,14 +847,11 @@ void Battle::Autobalance(BalanceType balance_type, bool support_clans, bool stro
 void Battle::FixTeamIDs(BalanceType balance_type, bool support_clans, bool strong_clans, int numcontrolteams)
 {
 	wxLogMessage(_T("Autobalancing teams, type=%d, clans=%d, strong_clans=%d, numcontrolteams=%d"), balance_type, support_clans, strong_clans, numcontrolteams);
-	//size_t i;
-	//int num_alliances;
-	std::vector<ControlTeam> control_teams;
 
 	if (numcontrolteams == 0 || numcontrolteams == -1)
 		numcontrolteams = GetNumUsers() - GetSpectators(); // 0 or -1 -> use num players, will use comshare only if no available team slots
 	IBattle::StartType position_type = (IBattle::StartType)
-	    LSL::Util::FromString<long>(CustomBattleOptions().getSingleValue("startpostype", LSL::Enum::EngineOption));
+	    LSL::Util::FromString<long>(GetCustomBattleOptions().getSingleValue("startpostype", LSL::Enum::EngineOption));
 	if ((position_type == ST_Fixed) || (position_type == ST_Random)) // if fixed start pos type or random, use max teams = start pos count
 	{
 		try {
@@ -1009,105 +888,28 @@ void Battle::FixTeamIDs(BalanceType balance_type, bool support_clans, bool stron
 		}
 		return;
 	}
-	for (int i = 0; i < numcontrolteams; i++)
-		control_teams.push_back(ControlTeam(i));
-
-	wxLogMessage(_T("number of teams: %u"), control_teams.size());
-
-	std::vector<User*> players_sorted;
-	players_sorted.reserve(GetNumUsers());
 
-	int player_team_counter = 0;
+	wxLogMessage(_T("number of teams: %d"), numcontrolteams);
 
+	std::vector<User*> players;
+	players.reserve(GetNumUsers());
 	for (size_t i = 0; i < GetNumUsers(); ++i) // don't count spectators
 	{
 		if (!GetUser(i).BattleStatus().spectator) {
-			players_sorted.push_back(&GetUser(i));
-			// -- server fail? it doesnt work right.
-			//ForceTeam(GetUser(i),player_team_counter);
-			player_team_counter++;
-		}
-	}
-
-	shuffle(players_sorted);
-
-	std::map<wxString, ControlTeam> clan_teams;
-	if (support_clans) {
-		for (size_t i = 0; i < players_sorted.size(); ++i) {
-			wxString clan = TowxString(players_sorted[i]->GetClan());
-			if (!clan.empty()) {
-				clan_teams[clan].AddPlayer(players_sorted[i]);
-			}
-		}
-	};
-
-	if (balance_type != balance_random)
-		std::sort(players_sorted.begin(), players_sorted.end(), PlayerRankCompareFunction);
-
-	if (support_clans) {
-		std::map<wxString, ControlTeam>::iterator clan_it = clan_teams.begin();
-		while (clan_it != clan_teams.end()) {
-			ControlTeam& clan = (*clan_it).second;
-			// if clan is too small (only 1 clan member in battle) or too big, dont count it as clan
-			if ((clan.players.size() < 2) || (!strong_clans && (clan.players.size() > ((players_sorted.size() + control_teams.size() - 1) / control_teams.size())))) {
-				wxLogMessage(_T("removing clan %s"), (*clan_it).first.c_str());
-				std::map<wxString, ControlTeam>::iterator next = clan_it;
-				++next;
-				clan_teams.erase(clan_it);
-				clan_it = next;
-				continue;
-			}
-			wxLogMessage(_T("Inserting clan %s"), (*clan_it).first.c_str());
-			std::sort(control_teams.begin(), control_teams.end());
-			float lowestrank = control_teams[0].ranksum;
-			int rnd_k = 1; // number of alliances with rank equal to lowestrank
-			while (size_t(rnd_k) < control_teams.size()) {
-				if (fabs(control_teams[rnd_k].ranksum - lowestrank) > 0.01)
-					break;
-				rnd_k++;
-			}
-			wxLogMessage(_T("number of lowestrank teams with same rank=%d"), rnd_k);
-			control_teams[my_random(rnd_k)].AddTeam(clan);
-			++clan_it;
-		}
-	}
-
-	for (size_t i = 0; i < players_sorted.size(); ++i) {
-		// skip clanners, those have been added already.
-		if (clan_teams.count(TowxString(players_sorted[i]->GetClan())) > 0) {
-			wxLogMessage(_T("clanner already added, nick=%s"), players_sorted[i]->GetNick().c_str());
-			continue;
-		}
-
-		// find teams with lowest ranksum
-		// insert current user into random one out of them
-		// since performance doesnt matter here, i simply sort teams,
-		// then find how many teams in beginning have lowest ranksum
-		// note that balance player ranks range from 1 to 1.1 now
-		// i.e. them are quasi equal
-		// so we're essentially adding to teams with smallest number of players,
-		// the one with smallest ranksum.
-
-		std::sort(control_teams.begin(), control_teams.end());
-		float lowestrank = control_teams[0].ranksum;
-		int rnd_k = 1; // number of alliances with rank equal to lowestrank
-		while (size_t(rnd_k) < control_teams.size()) {
-			if (fabs(control_teams[rnd_k].ranksum - lowestrank) > 0.01)
-				break;
-			rnd_k++;
+			players.push_back(&GetUser(i));
 		}
-		wxLogMessage(_T("number of lowestrank teams with same rank=%d"), rnd_k);
-		control_teams[my_random(rnd_k)].AddPlayer(players_sorted[i]);
 	}
 
+	const std::vector<BalanceUnit> units = GetBalanceUnits(players, numcontrolteams, support_clans, strong_clans);
+	const std::vector<size_t> groups = BalanceUnits(units, numcontrolteams, balance_type);
 
-	for (size_t i = 0; i < control_teams.size(); ++i) {
-		for (size_t j = 0; j < control_teams[i].players.size(); ++j) {
-			ASSERT_LOGIC(control_teams[i].players[j], "fail in Autobalance teams, NULL player");
-			wxString msg = wxString::Format(_T("setting player %s to team and ally %d"), TowxString(control_teams[i].players[j]->GetNick()).c_str(), i);
+	for (size_t i = 0; i < units.size(); ++i) {
+		const int teamnum = groups[i];
+		for (size_t j = 0; j < units[i].size(); ++j) {
+			wxString msg = wxString::Format(_T("setting player %s to team and ally %d"), TowxString(units[i][j]->GetNick()).c_str(), teamnum);
 			wxLogMessage(_T("%s"), msg.c_str());
-			ForceTeam(*control_teams[i].players[j], control_teams[i].teamnum);
-			ForceAlly(*control_teams[i].players[j], control_teams[i].teamnum);
+			ForceTeam(*units[i][j], teamnum);
+			ForceAlly(*units[i][j], teamnum);
 		}
 	}
 }
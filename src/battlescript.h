@@ -0,0 +1,433 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#ifndef SPRINGLOBBY_BATTLESCRIPT_H_INCLUDED
+#define SPRINGLOBBY_BATTLESCRIPT_H_INCLUDED
+
+#include <wx/string.h>
+
+#include <algorithm>
+#include <clocale>
+#include <cstdlib>
+#include <ctime>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <lsl/battle/tdfcontainer.h>
+#include <lslutils/conversion.h>
+
+#include "ibattle.h"
+#include "utils/conversion.h"
+#include "utils/scriptsections.h"
+#include "log.h"
+
+//! values from outside the battle which go into its start script
+struct ScriptEnvironment
+{
+	//! SourcePort used when joining, 0 lets the engine choose
+	int clientport;
+	//! returns the side names of a game, only called when the teams are written
+	std::vector<std::string> (*getsides)(const std::string& modname);
+};
+
+/** @brief Writes one section of the script which is kept in a ScriptSectionCache.
+ *
+ * The writer starts inside the GAME section, so the text gets the same
+ * indentation as the rest of the script and is copied into it unchanged.
+ */
+class ScriptSectionWriter
+{
+public:
+	ScriptSectionWriter()
+	    : m_writer(m_stream)
+	{
+		m_writer.EnterSection("GAME");
+		m_start = m_stream.str().size();
+	}
+
+	LSL::TDF::TDFWriter& Writer()
+	{
+		return m_writer;
+	}
+	//! the text written since construction, without the enclosing GAME section
+	std::string Text() const
+	{
+		return m_stream.str().substr(m_start);
+	}
+
+private:
+	std::stringstream m_stream;
+	LSL::TDF::TDFWriter m_writer;
+	std::string::size_type m_start;
+};
+
+/** @brief Writes the start script (script.txt) of @p battle.
+ *
+ * The sections kept in battle.GetScriptCache() are only written again after
+ * they were invalidated, see IBattle::InvalidateScript. This is a template so
+ * the tests can run it on a battle without a server.
+ */
+template <class Battle>
+std::string WriteBattleScript(Battle& battle, const ScriptEnvironment& env)
+{
+	std::stringstream ret;
+
+	LSL::TDF::TDFWriter tdf(ret);
+
+	// Start generating the script.
+	tdf.EnterSection("GAME");
+
+	if (battle.IsFounderMe()) {
+		tdf.Append("HostIP", ""); //Listen on all addresses for connections when hosting
+		if (battle.GetNatType() == NAT_Hole_punching)
+			tdf.Append("HostPort", battle.GetMyInternalUdpSourcePort());
+		else
+			tdf.Append("HostPort", battle.GetHostPort());
+	} else {
+		tdf.Append("HostIP", battle.GetHostIp());
+		tdf.Append("HostPort", battle.GetHostPort());
+		if (battle.GetNatType() == NAT_Hole_punching) {
+			tdf.Append("SourcePort", battle.GetMyInternalUdpSourcePort());
+		} else if (env.clientport != 0) {
+			tdf.Append("SourcePort", env.clientport); /// this allows to play with broken router by setting SourcePort to some forwarded port.
+		}
+	}
+	tdf.Append("IsHost", battle.IsFounderMe());
+
+	auto& me = battle.GetMe();
+	tdf.Append("MyPlayerName", me.GetNick());
+
+	if (!me.BattleStatus().GetScriptPassword().empty()) {
+		tdf.Append("MyPasswd", me.BattleStatus().GetScriptPassword());
+	}
+
+	if (!battle.IsFounderMe()) {
+		tdf.LeaveSection();
+		return ret.str();
+	}
+
+	/**********************************************************************************
+																Host-only section
+	**********************************************************************************/
+
+	tdf.AppendLineBreak();
+
+	tdf.Append("ModHash", battle.LoadMod().hash);
+	tdf.Append("MapHash", battle.LoadMap().hash);
+
+	tdf.Append("Mapname", battle.GetHostMapName());
+	tdf.Append("GameType", battle.GetHostModName());
+
+	tdf.AppendLineBreak();
+
+	switch (battle.GetBattleType()) {
+		case BT_Played:
+			break;
+		case BT_Replay: {
+			wxString path = TowxString(battle.GetPlayBackFilePath());
+			if (path.Find(_T("/")) != wxNOT_FOUND)
+				path.BeforeLast(_T('/'));
+			tdf.Append("DemoFile", STD_STRING(path));
+			tdf.AppendLineBreak();
+			break;
+		}
+		case BT_Savegame: {
+			wxString path = TowxString(battle.GetPlayBackFilePath());
+			if (path.Find(_T("/")) != wxNOT_FOUND)
+				path.BeforeLast(_T('/'));
+			tdf.Append("Savefile", STD_STRING(path));
+			tdf.AppendLineBreak();
+			break;
+		}
+		default:
+			slLogDebugFunc("");
+			break;
+	}
+
+	// read the options through a const reference, the non-const accessor invalidates the cached script sections
+	const auto& options = battle.GetCustomBattleOptions();
+	const long startpostype = LSL::Util::FromString<long>(
+	    options.getSingleValue("startpostype", LSL::Enum::EngineOption));
+
+	std::vector<LSL::StartPos> remap_positions;
+	if (battle.IsProxy() && (startpostype != IBattle::ST_Pick) && (startpostype != IBattle::ST_Choose)) {
+		std::set<int> parsedteams;
+		unsigned int NumUsers = battle.GetNumUsers();
+		unsigned int NumTeams = 0;
+		for (unsigned int i = 0; i < NumUsers; i++) {
+			UserBattleStatus& status = battle.GetUser(i).BattleStatus();
+			if (status.spectator)
+				continue;
+			if (parsedteams.find(status.team) != parsedteams.end())
+				continue; // skip duplicates
+			parsedteams.insert(status.team);
+			NumTeams++;
+		}
+
+		LSL::MapInfo infos = battle.LoadMap().info;
+		unsigned int nummapstartpositions = infos.positions.size();
+		unsigned int copysize = std::min(nummapstartpositions, NumTeams);
+		remap_positions = std::vector<LSL::StartPos>(infos.positions.begin(), infos.positions.begin() + copysize); // only add the first x positions
+
+		if (startpostype == IBattle::ST_Random) {
+			std::random_shuffle(remap_positions.begin(), remap_positions.end()); // shuffle the positions
+		}
+	}
+	if (battle.IsProxy()) {
+		if ((startpostype == IBattle::ST_Random) || (startpostype == IBattle::ST_Fixed)) {
+			tdf.Append("startpostype", IBattle::ST_Pick);
+		} else
+			tdf.Append("startpostype", startpostype);
+	} else
+		tdf.Append("startpostype", startpostype);
+
+	typedef ScriptSectionCache ScriptCache;
+	ScriptCache& cache = battle.GetScriptCache();
+
+	if (!cache.IsValid(ScriptCache::SECTION_OPTIONS)) {
+		ScriptSectionWriter section;
+		LSL::TDF::TDFWriter& writer = section.Writer();
+		writer.EnterSection("mapoptions");
+		for (const auto& it : options.getOptions(LSL::Enum::MapOption)) {
+			writer.Append(it.first, it.second.second);
+		}
+		writer.LeaveSection();
+
+
+		writer.EnterSection("modoptions");
+		writer.Append("relayhoststartpostype", startpostype); // also save the original wanted setting
+		for (const auto& it : options.getOptions(LSL::Enum::ModOption)) {
+			writer.Append(it.first, it.second.second);
+		}
+		writer.LeaveSection();
+		cache.Set(ScriptCache::SECTION_OPTIONS, section.Text());
+	}
+	ret << cache.Get(ScriptCache::SECTION_OPTIONS);
+
+	if (!cache.IsValid(ScriptCache::SECTION_RESTRICTIONS)) {
+		ScriptSectionWriter section;
+		LSL::TDF::TDFWriter& writer = section.Writer();
+		std::map<std::string, int> units = battle.RestrictedUnits();
+		writer.Append("NumRestrictions", units.size());
+		writer.EnterSection("RESTRICT");
+		int restrictcount = 0;
+		for (std::map<std::string, int>::const_iterator itor = units.begin(); itor != units.end(); ++itor) {
+			writer.Append(stdprintf("Unit%d", restrictcount), itor->first);
+			writer.Append(stdprintf("Limit%d", restrictcount), itor->second);
+			restrictcount++;
+		}
+		writer.LeaveSection();
+		cache.Set(ScriptCache::SECTION_RESTRICTIONS, section.Text());
+	}
+	ret << cache.Get(ScriptCache::SECTION_RESTRICTIONS);
+
+
+	tdf.AppendLineBreak();
+
+	if (battle.IsProxy()) {
+		tdf.Append("NumPlayers", battle.GetNumPlayers() - 1);
+		tdf.Append("NumUsers", battle.GetNumUsers() - 1);
+	} else {
+		tdf.Append("NumPlayers", battle.GetNumPlayers());
+		tdf.Append("NumUsers", battle.GetNumUsers());
+	}
+
+	tdf.AppendLineBreak();
+
+	unsigned int NumUsers = battle.GetNumUsers();
+
+	// the numbering is cheap and needed by every section below, so it isn't cached
+	typedef std::map<int, int> ProgressiveTeamsVec;
+	typedef ProgressiveTeamsVec::iterator ProgressiveTeamsVecIter;
+	ProgressiveTeamsVec teams_to_sorted_teams; // original team -> progressive team
+	int free_team = 0;
+	std::map<std::string, int> player_to_number; // player nick -> ordernumber
+	for (unsigned int i = 0; i < NumUsers; i++) {
+		auto& user = battle.GetUser(i);
+		UserBattleStatus& status = user.BattleStatus();
+		if (!status.spectator) {
+			ProgressiveTeamsVecIter itor = teams_to_sorted_teams.find(status.team);
+			if (itor == teams_to_sorted_teams.end()) {
+				teams_to_sorted_teams[status.team] = free_team;
+				free_team++;
+			}
+		}
+		if (battle.IsProxy() && (user.GetNick() == battle.GetFounder().GetNick()))
+			continue;
+		if (status.IsBot())
+			continue;
+		player_to_number[user.GetNick()] = i;
+	}
+	for (unsigned int i = 0; i < NumUsers; i++) {
+		auto& user = battle.GetUser(i);
+		if (user.BattleStatus().IsBot())
+			player_to_number[user.GetNick()] = i;
+	}
+
+	if (!cache.IsValid(ScriptCache::SECTION_PLAYERS)) {
+		ScriptSectionWriter section;
+		LSL::TDF::TDFWriter& writer = section.Writer();
+		srand(time(NULL));
+		for (unsigned int i = 0; i < NumUsers; i++) {
+			auto& user = battle.GetUser(i);
+			UserBattleStatus& status = user.BattleStatus();
+			if (battle.IsProxy() && (user.GetNick() == battle.GetFounder().GetNick()))
+				continue;
+			if (status.IsBot())
+				continue;
+			writer.EnterSection(stdprintf("PLAYER%d", i));
+			writer.Append("Name", user.GetNick());
+			writer.Append("CountryCode", STD_STRING(TowxString(user.GetCountry()).Lower()));
+			writer.Append("Spectator", status.spectator);
+			writer.Append("Rank", (int)user.GetRank());
+			writer.Append("IsFromDemo", int(status.isfromdemo));
+			if (!status.GetScriptPassword().empty()) {
+				writer.Append("Password", status.GetScriptPassword());
+			}
+			if (!status.spectator) {
+				writer.Append("Team", teams_to_sorted_teams[status.team]);
+			} else {
+				int speccteam = 0;
+				if (!teams_to_sorted_teams.empty())
+					speccteam = rand() % teams_to_sorted_teams.size();
+				writer.Append("Team", speccteam);
+			}
+			writer.LeaveSection();
+		}
+		for (unsigned int i = 0; i < NumUsers; i++) {
+			auto& user = battle.GetUser(i);
+			UserBattleStatus& status = user.BattleStatus();
+			if (!status.IsBot())
+				continue;
+			writer.EnterSection(stdprintf("AI%d", i));
+			writer.Append("Name", user.GetNick());	 // AI's nick;
+			writer.Append("ShortName", status.GetAIShortName()); // AI libtype
+			writer.Append("Version", status.GetAIVersion());     // AI libtype version
+			writer.Append("Team", teams_to_sorted_teams[status.team]);
+			writer.Append("IsFromDemo", int(status.isfromdemo));
+			writer.Append("Host", player_to_number[battle.GetUser(status.GetOwner()).GetNick()]);
+			writer.EnterSection("Options");
+			int optionmapindex = options.GetAIOptionIndex(user.GetNick());
+			if (optionmapindex > 0) {
+				for (const auto& it : options.getOptions((LSL::Enum::GameOption)optionmapindex)) {
+					writer.Append(it.first, it.second.second);
+				}
+			}
+			writer.LeaveSection();
+			writer.LeaveSection();
+		}
+		cache.Set(ScriptCache::SECTION_PLAYERS, section.Text());
+	}
+	ret << cache.Get(ScriptCache::SECTION_PLAYERS);
+
+	tdf.AppendLineBreak();
+
+	if (!cache.IsValid(ScriptCache::SECTION_TEAMS)) {
+		ScriptSectionWriter section;
+		LSL::TDF::TDFWriter& writer = section.Writer();
+		std::set<int> parsedteams;
+		const std::vector<std::string> sides = env.getsides(battle.GetHostModName());
+		for (unsigned int i = 0; i < NumUsers; i++) {
+			auto& usr = battle.GetUser(i);
+			UserBattleStatus& status = usr.BattleStatus();
+			if (status.spectator)
+				continue;
+			if (parsedteams.find(status.team) != parsedteams.end())
+				continue; // skip duplicates
+			parsedteams.insert(status.team);
+
+			writer.EnterSection(stdprintf("TEAM%d", teams_to_sorted_teams[status.team]));
+			if (status.IsBot()) {
+				writer.Append("TeamLeader", player_to_number[battle.GetUser(status.GetOwner()).GetNick()]);
+			} else {
+				writer.Append("TeamLeader", player_to_number[usr.GetNick()]);
+			}
+			if (battle.IsProxy()) {
+				if (startpostype == IBattle::ST_Pick) {
+					writer.Append("StartPosX", status.pos.x);
+					writer.Append("StartPosZ", status.pos.y);
+				} else if ((startpostype == IBattle::ST_Fixed) || (startpostype == IBattle::ST_Random)) {
+					int teamnumber = teams_to_sorted_teams[status.team];
+					if (teamnumber < int(remap_positions.size())) { // don't overflow
+						LSL::StartPos position = remap_positions[teamnumber];
+						writer.Append("StartPosX", position.x);
+						writer.Append("StartPosZ", position.y);
+					}
+				}
+			} else {
+				if (startpostype == IBattle::ST_Pick) {
+					writer.Append("StartPosX", status.pos.x);
+					writer.Append("StartPosZ", status.pos.y);
+				}
+			}
+
+			writer.Append("AllyTeam", status.ally);
+
+			wxString colourstring =
+			    TowxString(status.colour.Red() / 255.0) + _T(' ') +
+			    TowxString(status.colour.Green() / 255.0) + _T(' ') +
+			    TowxString(status.colour.Blue() / 255.0);
+			writer.Append("RGBColor", STD_STRING(colourstring));
+
+			unsigned int side = status.side;
+			if (side < sides.size())
+				writer.Append("Side", sides[side]);
+			writer.Append("Handicap", status.handicap);
+			writer.LeaveSection();
+		}
+		cache.Set(ScriptCache::SECTION_TEAMS, section.Text());
+	}
+	ret << cache.Get(ScriptCache::SECTION_TEAMS);
+	if (battle.IsProxy() && startpostype == IBattle::ST_Random) {
+		// the start positions are shuffled again for every game
+		cache.Invalidate(ScriptCache::Mask(ScriptCache::SECTION_TEAMS));
+	}
+
+	tdf.AppendLineBreak();
+
+	if (!cache.IsValid(ScriptCache::SECTION_ALLYTEAMS)) {
+		ScriptSectionWriter section;
+		LSL::TDF::TDFWriter& writer = section.Writer();
+		unsigned int maxiter = std::max(NumUsers, battle.GetLastRectIdx() + 1);
+		std::set<int> parsedallys;
+		for (unsigned int i = 0; i < maxiter; i++) {
+
+			UserBattleStatus& status = battle.GetUser(i).BattleStatus();
+			BattleStartRect sr = battle.GetStartRect(i);
+			if (status.spectator && !sr.IsOk())
+				continue;
+			int ally = status.ally;
+			if (status.spectator)
+				ally = i;
+			if (parsedallys.find(ally) != parsedallys.end())
+				continue; // skip duplicates
+			sr = battle.GetStartRect(ally);
+			parsedallys.insert(ally);
+
+			writer.EnterSection(stdprintf("ALLYTEAM%d", ally));
+			writer.Append("NumAllies", 0);
+			if (startpostype == IBattle::ST_Choose) {
+				if (sr.IsOk()) {
+					const char* old_locale = std::setlocale(LC_NUMERIC, "C");
+
+					writer.Append("StartRectLeft", wxString::Format(_T("%.3f"), sr.left / 200.0));
+					writer.Append("StartRectTop", wxString::Format(_T("%.3f"), sr.top / 200.0));
+					writer.Append("StartRectRight", wxString::Format(_T("%.3f"), sr.right / 200.0));
+					writer.Append("StartRectBottom", wxString::Format(_T("%.3f"), sr.bottom / 200.0));
+
+					std::setlocale(LC_NUMERIC, old_locale);
+				}
+			}
+			writer.LeaveSection();
+		}
+		cache.Set(ScriptCache::SECTION_ALLYTEAMS, section.Text());
+	}
+	ret << cache.Get(ScriptCache::SECTION_ALLYTEAMS);
+
+	tdf.LeaveSection();
+	return ret.str();
+}
+
+#endif // SPRINGLOBBY_BATTLESCRIPT_H_INCLUDED
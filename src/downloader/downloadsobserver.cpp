@@ -25,6 +25,7 @@ ObserverDownloadInfo::ObserverDownloadInfo(IDownload* dl)
 }
 
 DownloadsObserver::DownloadsObserver()
+    : m_snapshot(new Snapshot())
 {
 }
 
@@ -38,47 +39,79 @@ static const DownloadsObserver& DownloadsObserver::Instance()
     return downloadsObserver;
 }
 */
+DownloadsObserver::SnapshotPtr DownloadsObserver::LoadSnapshot() const
+{
+	return std::atomic_load(&m_snapshot);
+}
+
+void DownloadsObserver::Publish(Snapshot* snapshot)
+{
+	std::atomic_store(&m_snapshot, SnapshotPtr(snapshot));
+}
+
 void DownloadsObserver::Add(IDownload* dl)
 {
 	wxMutexLocker lock(mutex);
-	m_dl_list.push_back(dl);
+	Snapshot* snapshot = new Snapshot(*LoadSnapshot());
+	snapshot->downloads.push_back(EntryPtr(new Entry(dl)));
+	Publish(snapshot);
 }
 
 void DownloadsObserver::Remove(IDownload* dl)
 {
 	wxMutexLocker lock(mutex);
-	m_dl_list.remove(dl);
-	ObserverDownloadInfo di = GetInfo(dl);
+	Snapshot* snapshot = new Snapshot(*LoadSnapshot());
+	std::vector<EntryPtr>::iterator it = snapshot->downloads.begin();
+	while ((it != snapshot->downloads.end()) && ((*it)->dl != dl)) {
+		++it;
+	}
+	ObserverDownloadInfo di(dl);
+	if (it != snapshot->downloads.end()) {
+		// older snapshots still contain the entry, readers get this info from now on
+		wxMutexLocker entrylock((*it)->mutex);
+		(*it)->last = di;
+		(*it)->dl = NULL;
+		snapshot->downloads.erase(it);
+	}
 	di.finished = 1;
-	m_finished_list.push_back(di);
+	snapshot->finished.push_back(di);
+	Publish(snapshot);
 }
 
 void DownloadsObserver::GetList(std::list<ObserverDownloadInfo>& lst)
 {
-	wxMutexLocker lock(mutex);
-	std::list<IDownload*>::iterator it;
-	for (it = m_dl_list.begin(); it != m_dl_list.end(); ++it) {
-		ObserverDownloadInfo di = GetInfo((*it));
+	const SnapshotPtr current = LoadSnapshot();
+	for (const EntryPtr& entry : current->downloads) {
+		ObserverDownloadInfo di = GetInfo(*entry);
 		if (di.size > 0)
 			lst.push_back(di);
 	}
 
-	lst.splice(lst.begin(), m_finished_list);
+	// finished downloads are only returned once. if a download is added or
+	// removed right now, they are returned by the next call instead of waiting
+	if (mutex.TryLock() != wxMUTEX_NO_ERROR)
+		return;
+	const SnapshotPtr latest = LoadSnapshot();
+	if (!latest->finished.empty()) {
+		std::list<ObserverDownloadInfo> finished = latest->finished;
+		lst.splice(lst.begin(), finished);
+		Snapshot* snapshot = new Snapshot();
+		snapshot->downloads = latest->downloads;
+		Publish(snapshot);
+	}
+	mutex.Unlock();
 }
 
 void DownloadsObserver::GetMap(std::map<wxString, ObserverDownloadInfo>& map)
 {
-	wxMutexLocker lock(mutex);
-	std::list<IDownload*>::iterator it_dl;
-	for (it_dl = m_dl_list.begin(); it_dl != m_dl_list.end(); ++it_dl) {
-		ObserverDownloadInfo di = GetInfo((*it_dl));
+	const SnapshotPtr snapshot = LoadSnapshot();
+	for (const EntryPtr& entry : snapshot->downloads) {
+		ObserverDownloadInfo di = GetInfo(*entry);
 		if (di.size > 0)
 			map[di.name] = di;
 	}
 
-	std::list<ObserverDownloadInfo>::iterator it_di;
-	for (it_di = m_finished_list.begin(); it_di != m_finished_list.end(); ++it_di) {
-		ObserverDownloadInfo di = (*it_di);
+	for (const ObserverDownloadInfo& di : snapshot->finished) {
 		if (di.size > 0)
 			map[di.name] = di;
 	}
@@ -86,12 +119,18 @@ void DownloadsObserver::GetMap(std::map<wxString, ObserverDownloadInfo>& map)
 
 void DownloadsObserver::ClearFinished()
 {
-	m_finished_list.clear();
+	wxMutexLocker lock(mutex);
+	Snapshot* snapshot = new Snapshot();
+	snapshot->downloads = LoadSnapshot()->downloads;
+	Publish(snapshot);
 }
 
-ObserverDownloadInfo DownloadsObserver::GetInfo(IDownload* dl)
+ObserverDownloadInfo DownloadsObserver::GetInfo(Entry& entry)
 {
-	ObserverDownloadInfo di(dl);
+	wxMutexLocker lock(entry.mutex);
+	if (entry.dl == NULL)
+		return entry.last;
+	ObserverDownloadInfo di(entry.dl);
 	return di;
 }
 
@@ -103,5 +142,5 @@ DownloadsObserver& downloadsObserver()
 
 bool DownloadsObserver::IsEmpty()
 {
-	return m_dl_list.empty();
+	return LoadSnapshot()->downloads.empty();
 }
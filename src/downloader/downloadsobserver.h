@@ -4,6 +4,8 @@
 #define DOWNLOADSOBSERVER_H
 #include <list>
 #include <map>
+#include <memory>
+#include <vector>
 #include <wx/thread.h>
 #include <wx/string.h>
 #include "lib/src/Downloader/Download.h"
@@ -44,7 +46,11 @@ private:
 };
 
 //! DownloadsObserver collect and control information about downloads
-//! This class is thread-safe
+//! This class is thread-safe, readers never wait for the downloader threads:
+//! the lists are published as immutable snapshots, which are replaced when
+//! a download is added or removed. A snapshot refers to the downloads through
+//! shared entries, so a removed download is never accessed by a reader which
+//! still holds an older snapshot.
 class DownloadsObserver : public IDownloadsObserver
 {
 public:
@@ -71,16 +77,42 @@ public:
 	bool IsEmpty();
 
 private:
+	//! A download, kept alive by the snapshots which contain it
+	struct Entry
+	{
+		explicit Entry(IDownload* dl_)
+		    : dl(dl_)
+		{
+		}
+		//! Held while accessing dl, Remove clears dl before the download is deleted
+		wxMutex mutex;
+		IDownload* dl;
+		//! Information when the download was removed
+		ObserverDownloadInfo last;
+	};
+	typedef std::shared_ptr<Entry> EntryPtr;
+
 	//! Creatre infromation about download
-	ObserverDownloadInfo GetInfo(IDownload* dl);
+	static ObserverDownloadInfo GetInfo(Entry& entry);
+
+	struct Snapshot
+	{
+		//! Downloads which are in process
+		std::vector<EntryPtr> downloads;
+
+		//! Finished downloads
+		std::list<ObserverDownloadInfo> finished;
+	};
+	typedef std::shared_ptr<const Snapshot> SnapshotPtr;
 
-	//! List with downloads which are in process
-	std::list<IDownload*> m_dl_list;
+	SnapshotPtr LoadSnapshot() const;
+	//! Replace the snapshot, readers of the old one keep it until they're done
+	void Publish(Snapshot* snapshot);
 
-	//! List with finished downloads
-	std::list<ObserverDownloadInfo> m_finished_list;
+	//! Only accessed with std::atomic_load / std::atomic_store
+	SnapshotPtr m_snapshot;
 
-	//! Mutex fir functions Add, Remove, GetList, GetMap
+	//! Serializes the writers: Add, Remove, GetList and ClearFinished
 	wxMutex mutex;
 };
 
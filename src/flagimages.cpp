@@ -4,13 +4,18 @@
 #include "flagimagedata.h"
 
 #include <wx/bitmap.h>
-#include <wx/imaglist.h>
 #include <wx/log.h>
 
-#include <map>
+#include <algorithm>
+#include <cstring>
 
-typedef std::map<std::string, int> NameToPosMap;
-static NameToPosMap m_name_to_pos;
+// flag_str and flag_xpm are terminated by a null entry
+static const int flag_count = sizeof(flag_str) / sizeof(flag_str[0]) - 1;
+
+static bool FlagNameLess(const char* a, const char* b)
+{
+	return strcmp(a, b) < 0;
+}
 
 int GetFlagIndex(const std::string& flag)
 {
@@ -22,22 +27,24 @@ int GetFlagIndex(const std::string& flag)
 	    (flag == "O1"))   // other country
 		return FLAG_NONE;
 
-	NameToPosMap::const_iterator itor = m_name_to_pos.find(flag);
-	if (itor != m_name_to_pos.end())
-		return itor->second;
+	// flag_str is sorted by country code
+	const char* const* end = flag_str + flag_count;
+	const char* const* itor = std::lower_bound(static_cast<const char* const*>(flag_str), end, flag.c_str(), FlagNameLess);
+	if (itor != end && flag == *itor)
+		return itor - flag_str;
 
 	wxLogMessage(_T( "%s flag not found!" ), flag.c_str());
 	return FLAG_NONE;
 }
 
-int AddFlagImages(wxImageList& imgs)
+int GetFlagCount()
+{
+	return flag_count;
+}
+
+wxBitmap GetFlagBitmap(int index)
 {
-	int poszero = 0;
-	for (int i = 0; flag_xpm[i]; ++i) {
-		const int index = imgs.Add(wxBitmap(const_cast<const char**>(flag_xpm[i])));
-		if (i == 0)
-			poszero = index;
-		m_name_to_pos[flag_str[i]] = i;
-	}
-	return poszero;
+	if (index < 0 || index >= flag_count)
+		return wxNullBitmap;
+	return wxBitmap(const_cast<const char**>(flag_xpm[index]));
 }
@@ -5,10 +5,13 @@
 
 #include <string>
 
-class wxImageList;
+class wxBitmap;
 
+//! @return the position of the flag of a country code, or FLAG_NONE
 int GetFlagIndex(const std::string& flag);
-int AddFlagImages(wxImageList& imgs);
+int GetFlagCount();
+//! decodes the flag at @p index, flags are only decoded when they are displayed
+wxBitmap GetFlagBitmap(int index);
 
 enum {
 	FLAG_NONE = -1
@@ -18,8 +18,12 @@
 #include "aui/auimanager.h"
 #include "utils/conversion.h"
 #include "utils/slpaths.h"
+#include "utils/availabilitycache.h"
 #include "downloader/prdownloader.h"
 
+#include <algorithm>
+#include <set>
+
 template <>
 SortOrder CustomVirtListCtrl<IBattle*, BattleListCtrl>::m_sortorder = SortOrder();
 
@@ -143,11 +147,11 @@ int BattleListCtrl::GetItemColumnImage(long item, long column) const
 		case 2:
 			return icons().GetRankLimitIcon(battle.GetRankNeeded(), false);
 		case 4:
-			return battle.MapExists(false) ? icons().ICON_EXISTS : icons().ICON_NEXISTS;
+			return availabilityCache().MapExists(battle.GetHostMapName()) ? icons().ICON_EXISTS : icons().ICON_NEXISTS;
 		case 5:
-			return battle.ModExists(false) ? icons().ICON_EXISTS : icons().ICON_NEXISTS;
+			return availabilityCache().ModExists(battle.GetHostModName()) ? icons().ICON_EXISTS : icons().ICON_NEXISTS;
 		case 11:
-			return SlPaths::GetCompatibleVersion(battle.GetEngineVersion()).empty() ? icons().ICON_NEXISTS : icons().ICON_EXISTS;
+			return availabilityCache().EngineExists(battle.GetEngineVersion()) ? icons().ICON_EXISTS : icons().ICON_NEXISTS;
 	}
 	return -1; // simply to avoid compiler warning
 }
@@ -205,15 +209,42 @@ void BattleListCtrl::UpdateBattle(IBattle& battle)
 	MarkDirtySort();
 }
 
+void BattleListCtrl::UpdateBattles(const std::vector<IBattle*>& added, const std::vector<IBattle*>& removed)
+{
+	if (added.empty() && removed.empty())
+		return;
+
+	SaveSelection();
+	if (!removed.empty()) {
+		const std::set<IBattle*> gone(removed.begin(), removed.end());
+		m_data.erase(std::remove_if(m_data.begin(), m_data.end(), [&gone](IBattle* battle) { return gone.count(battle) != 0; }), m_data.end());
+	}
+	m_data.insert(m_data.end(), added.begin(), added.end());
+	if (m_data.empty()) {
+		Clear();
+		return;
+	}
+	SetItemCount(m_data.size());
+	if (!added.empty()) {
+		// change column width based on content
+		SetColumnWidth(3, wxLIST_AUTOSIZE);
+		SetColumnWidth(4, wxLIST_AUTOSIZE);
+		SetColumnWidth(5, wxLIST_AUTOSIZE);
+		SetColumnWidth(6, wxLIST_AUTOSIZE);
+	}
+	MarkDirtySort();
+	RestoreSelection();
+}
+
 void BattleListCtrl::OnListRightClick(wxListEvent& event)
 {
 	int idx = event.GetIndex();
 	if (idx < (long)m_data.size() && idx > -1) {
 
 		DataType dt = m_data[idx];
-		const bool mod_missing = !dt->ModExists(false);
-		const bool map_missing = !dt->MapExists(false);
-		const bool engine_missing = SlPaths::GetCompatibleVersion(dt->GetEngineVersion()).empty();
+		const bool mod_missing = !availabilityCache().ModExists(dt->GetHostModName());
+		const bool map_missing = !availabilityCache().MapExists(dt->GetHostMapName());
+		const bool engine_missing = !availabilityCache().EngineExists(dt->GetEngineVersion());
 		m_popup = new wxMenu(wxEmptyString);
 		// &m enables shortcout "alt + m" and underlines m
 		if (map_missing)
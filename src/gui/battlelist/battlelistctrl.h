@@ -25,6 +25,8 @@ public:
 	void AddBattle(IBattle& battle);
 	void RemoveBattle(IBattle& battle);
 	void UpdateBattle(IBattle& battle);
+	//! adds and removes many battles at once, the list is resized and refreshed only once
+	void UpdateBattles(const std::vector<IBattle*>& added, const std::vector<IBattle*>& removed);
 
 
 	void OnListRightClick(wxListEvent& event);
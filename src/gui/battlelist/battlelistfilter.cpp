@@ -26,6 +26,7 @@
 #include "ibattle.h"
 #include "gui/uiutils.h"
 #include "utils/tasutil.h"
+#include "utils/availabilitycache.h"
 #include "aui/auimanager.h"
 #include "useractions.h"
 #include "utils/slconfig.h"
@@ -444,36 +445,6 @@ bool BattleListFilter::_IntCompare(const int a, const int b, const BattleListFil
 	}
 }
 
-bool BattleListFilter::StringMatches(const wxString& input, const wxString& filter_string, const wxRegEx* filter_regex, StringTransformFunction additional_transform, bool case_sensitive)
-{
-	if (filter_string.Len() < 1 || filter_string == wxEmptyString)
-		return true;
-
-	wxString input_cased(input);
-	wxString filter_cased(filter_string);
-	bool use_regex(filter_regex && filter_regex->IsValid());
-
-	/* Case-(in)sensitivize the input and filter strings. */
-	if (!case_sensitive) {
-		input_cased.MakeUpper();
-		filter_cased.MakeUpper();
-	}
-
-	if (input_cased.Find(filter_cased) != wxNOT_FOUND || (use_regex && filter_regex->Matches(input)))
-		return true;
-	else if (additional_transform) {
-		/* Try matching using a transformed input string. */
-		wxString input_generated(additional_transform(input));
-		if (!case_sensitive)
-			input_generated.MakeUpper();
-
-		if (input_generated.Find(filter_cased) != wxNOT_FOUND || (use_regex && filter_regex->Matches(input_generated)))
-			return true;
-	}
-
-	return false;
-}
-
 void BattleListFilter::OnRankButton(wxCommandEvent& event)
 {
 	m_filter_rank_mode = _GetNextMode(m_filter_rank_mode);
@@ -507,25 +478,40 @@ void BattleListFilter::OnSpectatorButton(wxCommandEvent& event)
 void BattleListFilter::SetActiv(bool state)
 {
 	m_activ = state;
+	if (m_activ)
+		Compile();
 	if (m_parent_battlelisttab != 0) {
 		m_parent_battlelisttab->UpdateList();
 	}
 }
 
+void BattleListFilter::Compile()
+{
+	m_compiled.highlighted = m_filter_highlighted->IsChecked();
+	m_compiled.started = m_filter_status_start->IsChecked();
+	m_compiled.locked = m_filter_status_locked->IsChecked();
+	m_compiled.passworded = m_filter_status_pass->IsChecked();
+	m_compiled.full = m_filter_status_full->IsChecked();
+	m_compiled.open = m_filter_status_open->IsChecked();
+	m_compiled.map_show = m_filter_map_show->IsChecked();
+	m_compiled.mod_show = m_filter_mod_show->IsChecked();
+
+	m_compiled.host.Set(m_filter_host_edit->GetValue(), m_filter_host_expression);
+	m_compiled.description.Set(m_filter_description_edit->GetValue(), m_filter_description_expression);
+	m_compiled.map.Set(m_filter_map_edit->GetValue(), m_filter_map_expression);
+	m_compiled.mod.Set(m_filter_mod_edit->GetValue(), m_filter_mod_expression);
+}
+
 bool BattleListFilter::FilterBattle(IBattle& battle)
 {
 	if (!m_activ)
 		return true;
 
-	if (m_filter_highlighted->IsChecked() |
-	    m_filter_status_start->IsChecked() |
-	    m_filter_status_locked->IsChecked() |
-	    m_filter_status_pass->IsChecked() |
-	    m_filter_status_full->IsChecked() |
-	    m_filter_status_open->IsChecked()) {
+	const CompiledFilter& f = m_compiled;
+	if (f.highlighted || f.started || f.locked || f.passworded || f.full || f.open) {
 		bool bResult = false;
 
-		if (m_filter_highlighted->IsChecked()) {
+		if (f.highlighted) {
 			try {
 				wxString host = TowxString(battle.GetFounder().GetNick());
 				bResult = useractions().DoActionOnUser(UserActions::ActHighlight, host);
@@ -544,19 +530,19 @@ bool BattleListFilter::FilterBattle(IBattle& battle)
 
 
 		//Battle Status Check
-		if (m_filter_status_start->GetValue())
+		if (f.started)
 			bResult |= battle.GetInGame();
 
-		if (m_filter_status_locked->GetValue())
+		if (f.locked)
 			bResult |= battle.IsLocked();
 
-		if (m_filter_status_pass->GetValue())
+		if (f.passworded)
 			bResult |= battle.IsPassworded();
 
-		if (m_filter_status_full->GetValue())
+		if (f.full)
 			bResult |= battle.IsFull();
 
-		if (m_filter_status_open->GetValue())
+		if (f.open)
 			bResult |= (!battle.IsPassworded() && !battle.IsLocked() && !battle.GetInGame() && !battle.IsFull());
 
 		if (bResult == false)
@@ -592,40 +578,34 @@ bool BattleListFilter::FilterBattle(IBattle& battle)
 		return false;
 
 	//Only Maps i have Check
-	if (m_filter_map_show->GetValue() && !battle.MapExists())
+	if (f.map_show && !availabilityCache().MapExists(battle.GetHostMapName(), battle.GetHostMapHash()))
 		return false;
 
 	//Only Mods i have Check
-	if (m_filter_mod_show->GetValue() && !battle.ModExists())
+	if (f.mod_show && !availabilityCache().ModExists(battle.GetHostModName(), battle.GetHostModHash()))
 		return false;
 
 	//Strings Plain Text & RegEx Check (Case insensitiv)
 
 	//Description:
-	if (!StringMatches(TowxString(battle.GetDescription()),
-			   m_filter_description_edit->GetValue(),
-			   m_filter_description_expression))
+	if (!f.description.Matches(TowxString(battle.GetDescription())))
 		return false;
 
 	//Host:
-	try { //!TODO
-		if (!StringMatches(TowxString(battle.GetFounder().GetNick()),
-				   m_filter_host_edit->GetValue(),
-				   m_filter_host_expression))
-			return false;
-	} catch (...) {
+	if (!f.host.IsEmpty()) {
+		try { //!TODO
+			if (!f.host.Matches(TowxString(battle.GetFounder().GetNick())))
+				return false;
+		} catch (...) {
+		}
 	}
 
 	//Map:
-	if (!StringMatches(TowxString(battle.GetHostMapName()),
-			   m_filter_map_edit->GetValue(),
-			   m_filter_map_expression))
+	if (!f.map.Matches(TowxString(battle.GetHostMapName())))
 		return false;
 
 	//Mod:
-	if (!StringMatches(TowxString(battle.GetHostModName()),
-			   m_filter_mod_edit->GetValue(),
-			   m_filter_mod_expression))
+	if (!f.mod.Matches(TowxString(battle.GetHostModName())))
 		return false;
 
 	return true;
@@ -635,6 +615,7 @@ void BattleListFilter::OnChange(wxCommandEvent& /*unused*/)
 {
 	if (!m_activ)
 		return;
+	Compile();
 	m_parent_battlelisttab->UpdateList();
 }
 
@@ -7,6 +7,7 @@
 #include <wx/bmpcbox.h>
 
 #include "battlelisttab.h"
+#include "filtertext.h"
 #include "utils/mixins.h"
 ///////////////////////////////////////////////////////////////////////////
 
@@ -67,8 +68,8 @@ private:
 	ButtonMode _GetButtonMode(const wxString& sign);
 	bool _IntCompare(int a, int b, ButtonMode mode);
 
-	/** A function callback used to transform an input string. */
-	typedef wxString (*StringTransformFunction)(const wxString& input);
+	//! reads the filter controls into m_compiled, called on every change of an active filter
+	void Compile();
 
 	bool m_activ;
 
@@ -145,28 +146,26 @@ private:
 
 	wxCheckBox* m_filter_highlighted;
 
-public:
-	/** Test whether an input string matches a filter string.
-		*  The filter will be tried as both a fixed string, and as a regular expression.
-		*
-		* @param input The input string to test.
-		*
-		* @param filter_string A fixed string to match against.
-		*
-		* @param filter_regex A regular expression object pointer.  If
-		* the expression is valid, it will be used to match the input if
-		* the fixed string does not.
-		*
-		* @param additional_transform A function that should be called to
-		* generate an additional <em>input</em> string.
-		*
-		* @param case_sensitive @c true if the comparison should be done case-sensitively.
-		*
-		* @return @c true if the input or generated input matches the filter string, and @c false otherwise.
-		*/
-	static bool StringMatches(const wxString& input, const wxString& filter_string, const wxRegEx* filter_regex = NULL, StringTransformFunction additional_transform = NULL, bool case_sensitive = false);
+	/** The filter settings as FilterBattle() needs them, so checking a battle doesn't have
+	 * to query any control.
+	 */
+	struct CompiledFilter
+	{
+		bool highlighted;
+		bool started;
+		bool locked;
+		bool passworded;
+		bool full;
+		bool open;
+		bool map_show;
+		bool mod_show;
+		FilterText host;
+		FilterText description;
+		FilterText map;
+		FilterText mod;
+	};
+	CompiledFilter m_compiled;
 
-private:
 	DECLARE_EVENT_TABLE()
 	BattleListFilterValues GetBattleFilterValues(const wxString& profile_name = (_T("default")));
 	void SetBattleFilterValues(const BattleListFilterValues& blfValues, const wxString& profile_name = _T("default"));
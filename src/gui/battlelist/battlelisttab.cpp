@@ -33,6 +33,7 @@
 #include "battlelistfilter.h"
 #include "iconimagelist.h"
 #include "useractions.h"
+#include "utils/availabilitycache.h"
 #include "gui/customdialogs.h"
 #include "utils/slconfig.h"
 #include "log.h"
@@ -168,6 +169,7 @@ BattleListTab::BattleListTab(wxWindow* parent)
 	SelectBattle(0);
 	ShowExtendedInfos(cfg().ReadBool(_T("/BattleListTab/ShowExtendedInfos")));
 	ConnectGlobalEvent(this, GlobalEvent::OnUnitsyncReloaded, wxObjectEventFunction(&BattleListTab::OnUnitsyncReloaded));
+	ConnectGlobalEvent(this, GlobalEvent::OnSpringVersionsChanged, wxObjectEventFunction(&BattleListTab::OnSpringVersionsChanged));
 }
 
 
@@ -275,12 +277,29 @@ void BattleListTab::UpdateList()
 {
 	m_battle_list->SetSelectedIndex(-1);
 
+	// only battles whose visibility changed touch the list, all of them in one go
+	std::vector<IBattle*> added;
+	std::vector<IBattle*> removed;
 	serverSelector().GetServer().battles_iter->IteratorBegin();
 	while (!serverSelector().GetServer().battles_iter->EOL()) {
 		IBattle* b = serverSelector().GetServer().battles_iter->GetBattle();
-		if (b != 0)
-			UpdateBattle(*b);
+		if (b == 0)
+			continue;
+		const bool visible = !m_filter->GetActiv() || m_filter->FilterBattle(*b);
+		if (visible == b->GetGUIListActiv())
+			continue;
+		if (visible)
+			added.push_back(b);
+		else
+			removed.push_back(b);
+		b->SetGUIListActiv(visible);
 	}
+	m_battle_list->UpdateBattles(added, removed);
+	SetNumDisplayed();
+
+	if (m_sel_battle != NULL)
+		SelectBattle(m_sel_battle->GetGUIListActiv() ? m_sel_battle : NULL);
+
 	m_battle_list->SortList(true);
 	m_battle_list->RefreshVisibleItems();
 
@@ -430,12 +449,20 @@ void BattleListTab::OnSelect(wxListEvent& event)
 void BattleListTab::OnUnitsyncReloaded(wxCommandEvent& /*data*/)
 {
 	assert(wxThread::IsMain());
+	availabilityCache().ClearContent();
 	if (!serverSelector().IsServerAvailible())
 		return;
 
 	UpdateList();
 }
 
+void BattleListTab::OnSpringVersionsChanged(wxCommandEvent& /*data*/)
+{
+	assert(wxThread::IsMain());
+	availabilityCache().ClearEngines();
+	UpdateHighlights();
+}
+
 void BattleListTab::UpdateHighlights()
 {
 	m_battle_list->RefreshVisibleItems();
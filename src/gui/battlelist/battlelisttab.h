@@ -63,6 +63,7 @@ public:
 
 	void OnSelect(wxListEvent& event);
 	void OnUnitsyncReloaded(wxCommandEvent& data);
+	void OnSpringVersionsChanged(wxCommandEvent& data);
 
 	void UpdateHighlights();
 
@@ -0,0 +1,31 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#include "filtertext.h"
+
+#include <wx/regex.h>
+
+void FilterText::Set(const wxString& text, const wxRegEx* expression)
+{
+	m_upper = text.Upper();
+	const bool use_regex = expression != NULL && expression->IsValid() && !IsPlainText(text);
+	m_regex = use_regex ? expression : NULL;
+}
+
+bool FilterText::Matches(const wxString& input) const
+{
+	if (m_upper.empty())
+		return true;
+	if (input.Upper().Find(m_upper) != wxNOT_FOUND)
+		return true;
+	return m_regex != NULL && m_regex->Matches(input);
+}
+
+bool FilterText::IsPlainText(const wxString& text)
+{
+	static const wxString special(_T(".[]()*+?{}|^$\\"));
+	for (wxString::const_iterator it = text.begin(); it != text.end(); ++it) {
+		if (special.Find(*it) != wxNOT_FOUND)
+			return false;
+	}
+	return true;
+}
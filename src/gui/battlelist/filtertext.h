@@ -0,0 +1,42 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#ifndef SPRINGLOBBY_FILTERTEXT_H_INCLUDED
+#define SPRINGLOBBY_FILTERTEXT_H_INCLUDED
+
+#include <wx/string.h>
+
+class wxRegEx;
+
+/** @brief A text filter of the battle list, ready to be matched against many battles.
+ *
+ * The input matches if it contains the filter text (case-insensitive) or
+ * matches the filter's regex. The regex is only tried if the filter text
+ * contains regex syntax, a plain text regex can't match anything the
+ * substring search misses.
+ */
+class FilterText
+{
+public:
+	FilterText()
+	    : m_regex(NULL)
+	{
+	}
+
+	//! @p expression is @p text compiled case-insensitively, it must outlive this filter
+	void Set(const wxString& text, const wxRegEx* expression);
+	bool IsEmpty() const
+	{
+		return m_upper.empty();
+	}
+	//! an empty filter matches everything
+	bool Matches(const wxString& input) const;
+
+	//! @return false if @p text contains characters with a special meaning in a regex
+	static bool IsPlainText(const wxString& text);
+
+private:
+	wxString m_upper;
+	const wxRegEx* m_regex;
+};
+
+#endif // SPRINGLOBBY_FILTERTEXT_H_INCLUDED
@@ -10,6 +10,7 @@
 #include "uiutils.h"
 
 #include "chatpanel.h"
+#include "chatview.h"
 
 #include <wx/intl.h>
 #include <wx/splitter.h>
@@ -35,6 +36,7 @@
 #include "gui/wxtextctrlhist.h"
 #include "log.h"
 #include "utils/slconfig.h"
+#include "utils/multipatternmatcher.h"
 #include "gui/hosting/votepanel.h"
 
 BEGIN_EVENT_TABLE(ChatPanel, wxPanel)
@@ -267,8 +269,8 @@ void ChatPanel::CreateControls()
 
 	// Creating ui elements
 
-	m_chatlog_text = new wxTextCtrl(m_chat_panel, CHAT_LOG, wxEmptyString, wxDefaultPosition, wxDefaultSize,
-					wxTE_MULTILINE | wxTE_READONLY | wxTE_RICH | wxTE_AUTO_URL);
+	m_chatlog_text = new ChatView(m_chat_panel, CHAT_LOG);
+	m_chatlog_text->SetFont(sett().GetChatFont());
 	m_chan_opts_button = NULL;
 	if (m_type == CPT_Channel) {
 		m_chatlog_text->SetToolTip(_("right click for options (like autojoin)"));
@@ -318,7 +320,6 @@ void ChatPanel::CreateControls()
 	}
 
 	m_chatlog_text->SetBackgroundColour(sett().GetChatColorBackground());
-	m_chatlog_text->ShowPosition(m_chatlog_text->GetLastPosition());
 
 	m_say_text->SetBackgroundColour(sett().GetChatColorBackground());
 	m_say_text->SetForegroundColour(sett().GetChatColorNormal());
@@ -392,93 +393,56 @@ void ChatPanel::OutputLine(const wxString& message, const wxColour& col, bool sh
 
 void ChatPanel::OutputLine(const ChatLine& line)
 {
-	const int pos = m_chatlog_text->GetScrollPos(wxVERTICAL);   // vertical scrolled window position
-	const int end = m_chatlog_text->GetScrollRange(wxVERTICAL); // hight of complete scolled window
-	const int height = m_chatlog_text->GetSize().GetHeight();
-	const int numOfLines = m_chatlog_text->GetNumberOfLines();
-	const int maxlength = sett().GetChatHistoryLenght();
-	float original_pos = (float)(pos + height) / (float)end;
-
-	if (original_pos < 0.0f)
-		original_pos = 0.0f;
-	if (original_pos > 1.0f)
-		original_pos = 1.0f;
-
-	// crop lines from history that exceeds limit
-	if ((maxlength > 0) && (numOfLines > maxlength)) {
-		int end_line = 0;
-		for (int i = 0; i < numOfLines - maxlength; i++) {
-			end_line += m_chatlog_text->GetLineLength(i) + 1;
-		}
-		if (end_line > 0) {
-			m_chatlog_text->Remove(0, end_line);
-		}
-	}
+	m_chatlog_text->SetHistoryLength(std::max(sett().GetChatHistoryLenght(), 0));
 
+	ChatView::Segments segments;
 	if (!line.time.empty()) {
-		m_chatlog_text->SetDefaultStyle(line.timestyle);
-		m_chatlog_text->AppendText(line.time);
+		segments.push_back(ChatView::Segment(line.time, line.timestyle.GetTextColour()));
 	}
 
-#ifndef __WXOSX_COCOA__
 	if (sett().GetUseIrcColors()) {
-		wxString m1(line.chat);
-		wxString m2;
-		wxString m3;
-		wxTextAttr at(line.chatstyle);
-		int color = 0;
-		bool bold = false;
-		wxColor curcolor(line.chatstyle.GetTextColour());
-		const wxFont oldfont = sett().GetChatFont();
 		const wxColor oldcolor(line.chatstyle.GetTextColour());
-
-		while (m1.Len() > 0) {
-			const wxUniChar c = m1.GetChar(0);
-			if (c == 3 && m1.Len() > 1 && (m1.GetChar(1) >= 48 && m1.GetChar(1) <= 58)) { // Color
-				if (m1.Len() > 2 && (m1.GetChar(2) >= 48 && m1.GetChar(2) <= 58)) {
-					color = (int(m1.GetChar(1)) - 48) * 10 + (int(m1.GetChar(2)) - 48);
-					m1 = m1.Mid(3);
+		wxColor curcolor(oldcolor);
+		bool bold = false;
+		wxString text;
+		const size_t len = line.chat.Len();
+		for (size_t i = 0; i < len; i++) {
+			const wxUniChar c = line.chat.GetChar(i);
+			const bool isdigit = (i + 1 < len) && (line.chat.GetChar(i + 1) >= 48 && line.chat.GetChar(i + 1) <= 58);
+			if ((c != 3 || !isdigit) && c != 2 && c != 0x0F) {
+				text += c;
+				continue;
+			}
+			// formatting changes, flush the text so far
+			segments.push_back(ChatView::Segment(text, curcolor, bold));
+			text.clear();
+			if (c == 3) { // Color
+				int color;
+				if (i + 2 < len && (line.chat.GetChar(i + 2) >= 48 && line.chat.GetChar(i + 2) <= 58)) {
+					color = (int(line.chat.GetChar(i + 1)) - 48) * 10 + (int(line.chat.GetChar(i + 2)) - 48);
+					i += 2;
 				} else {
-					color = int(m1.GetChar(1)) - 48;
-					m1 = m1.Mid(2);
+					color = int(line.chat.GetChar(i + 1)) - 48;
+					i += 1;
 				}
 
 				wxColor dummy(0, 0, 0);
 				if ((color > -1) && (color < long((sizeof(m_irc_colors) / sizeof(dummy))))) {
 					curcolor = m_irc_colors[color];
 				}
-
 			} else if (c == 2) { //Bold
 				bold = !bold;
-				m1 = m1.Mid(1);
-			} else if (c == 0x0F) { //Reset formatting
+			} else { //Reset formatting
 				bold = false;
 				curcolor = oldcolor;
-				m1 = m1.Mid(1);
-			} else {
-
-				wxFont font = oldfont; //isn't needed any more in wx3.0
-				at = line.chatstyle;
-				if (bold)
-					font.SetWeight(wxFONTWEIGHT_BOLD);
-				at.SetFont(font);
-				at.SetTextColour(curcolor);
-				m_chatlog_text->SetDefaultStyle(at);
-				m_chatlog_text->AppendText(m1.Mid(0, 1));
-				m1 = m1.Mid(1);
 			}
 		}
-		m_chatlog_text->AppendText(_T("\n"));
-	} else
-#endif
-	{
-		m_chatlog_text->SetDefaultStyle(line.chatstyle);
-		m_chatlog_text->AppendText(line.chat + _T( "\n" ));
+		segments.push_back(ChatView::Segment(text, curcolor, bold));
+	} else {
+		segments.push_back(ChatView::Segment(line.chat, line.chatstyle.GetTextColour()));
 	}
 
-
-	m_chatlog_text->ScrollLines(1);
-	m_chatlog_text->ShowPosition(m_chatlog_text->GetLastPosition());
+	m_chatlog_text->AppendLine(segments);
 }
 
 
@@ -487,8 +451,9 @@ void ChatPanel::OnLinkEvent(wxTextUrlEvent& event)
 	if (!event.GetMouseEvent().LeftDown())
 		return;
 
-	wxString url = m_chatlog_text->GetRange(event.GetURLStart(), event.GetURLEnd());
-	OpenWebBrowser(url);
+	const wxString url = m_chatlog_text->GetUrlAt(event.GetMouseEvent().GetPosition());
+	if (!url.empty())
+		OpenWebBrowser(url);
 }
 
 void ChatPanel::OnChanOpts(wxCommandEvent& /*unused*/)
@@ -573,21 +538,16 @@ void ChatPanel::Said(const wxString& who, const wxString& message)
 		if (inactive) {
 			ui().mw().RequestUserAttention();
 			const wxString msg = wxString::Format(_T("%s:\n%s"), who.c_str(), message.Left(50).c_str());
+			const wxString source = ((m_type == CPT_Channel) && (m_channel != NULL)) ? _T("#") + TowxString(m_channel->GetName()) : who;
 			UiEvents::GetNotificationEventSender().SendEvent(
-			    UiEvents::NotficationData(UiEvents::PrivateMessage, msg));
+			    UiEvents::NotficationData(UiEvents::PrivateMessage, msg, source));
 		}
 	}
 }
 
 bool ChatPanel::ContainsWordToHighlight(const wxString& message) const
 {
-	//get list of words to highlight
-	wxArrayString words = sett().GetHighlightedWords();
-	for (unsigned int i = 0; i < words.GetCount(); i++) {
-		if (message.Find(words[i]) != wxNOT_FOUND)
-			return true;
-	}
-	return false;
+	return sett().GetHighlightMatcher().ContainsAny(message.ToStdWstring());
 }
 
 void ChatPanel::DidAction(const wxString& who, const wxString& action)
@@ -603,7 +563,7 @@ void ChatPanel::DidAction(const wxString& who, const wxString& action)
 	if (m_type == CPT_User && (ui().GetActiveChatPanel() != this || !wxTheApp->IsActive())) {
 		const wxString msg = wxString::Format(_T("%s \n%s"), who.c_str(), action.Left(50).c_str());
 		UiEvents::GetNotificationEventSender().SendEvent(
-		    UiEvents::NotficationData(UiEvents::PrivateMessage, msg));
+		    UiEvents::NotficationData(UiEvents::PrivateMessage, msg, who));
 	}
 }
 
@@ -893,7 +853,7 @@ bool ChatPanel::Say(const wxString& message)
 		}
 
 		if (line == _T( "/clear" )) {
-			m_chatlog_text->SetValue(wxEmptyString);
+			m_chatlog_text->Clear();
 			return true;
 		}
 
@@ -1022,41 +982,10 @@ void ChatPanel::FocusInputBox()
 	m_say_text->SetFocus();
 }
 
-wxString ChatPanel::FindUrl(const long pos) const
-{
-	if (pos < 0) {
-		return wxEmptyString;
-	}
-	long last = m_chatlog_text->GetLastPosition();
-
-	long start = pos;
-	while (start > 0 && m_chatlog_text->GetRange(start - 1, start) != _T(" "))
-		start--;
-
-	long end = pos;
-	//the last bit prevents topic links from being copied with next line's timestamp appended
-	//checking for newline isn't possible, cause links may well span multiple lines
-	while (end < last && m_chatlog_text->GetRange(end, end + 1) != _T(" ") && m_chatlog_text->GetRange(end, end + 1) != _T("["))
-		end++;
-
-	wxString ret = m_chatlog_text->GetRange(start, end);
-	//! \todo there's prolly some smarter way to capture a more flexible range of url types
-	if (ret.StartsWith(_T("http://")) || ret.StartsWith(_T("https://")) || ret.StartsWith(_T("ftp://")))
-		return ret;
-	else
-		return wxEmptyString;
-}
-
 void ChatPanel::OnMouseDown(wxMouseEvent& event)
 {
 	slLogDebugFunc("");
-	wxTextCoord row;
-	wxTextCoord col;
-	wxTextCtrlHitTestResult ht = m_chatlog_text->HitTest(event.GetPosition(), &col, &row);
-	if (ht != wxTE_HT_UNKNOWN) {
-		long pos = m_chatlog_text->XYToPosition(col, row);
-		m_url_at_pos = FindUrl(pos);
-	}
+	m_url_at_pos = m_chatlog_text->GetUrlAt(event.GetPosition());
 	CreatePopup();
 	if (m_popup_menu != NULL) {
 		PopupMenu(m_popup_menu->GetMenu());
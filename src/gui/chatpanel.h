@@ -38,6 +38,7 @@ class wxNotebook;
 class wxImageList;
 class ChatPanelMenu;
 class VotePanel;
+class ChatView;
 
 enum ChatPanelType {
 	CPT_Channel,
@@ -161,7 +162,6 @@ private:
 	};
 
 	void SetIconHighlight(HighlightType highlight);
-	wxString FindUrl(const long pos) const;
 
 	bool ContainsWordToHighlight(const wxString& message) const;
 	bool m_show_nick_list; //!< If the nicklist should be shown or not.
@@ -178,7 +178,7 @@ private:
 	wxPanel* m_nick_panel;	//!< Panel containing the nicklist.
 	wxTextCtrl* m_nick_filter;    //!< Textcontrol for filtering nicklist
 
-	wxTextCtrl* m_chatlog_text;	 //!< The chat log textcontrol.
+	ChatView* m_chatlog_text;	 //!< The chat log view.
 	wxTextCtrlHist* m_say_text;	 //!< The say textcontrol.
 	wxBitmapButton* m_chan_opts_button; //!< The channel options button.
 
@@ -5,6 +5,7 @@
 #include <wx/log.h>
 
 #include "chatpanel.h"
+#include "chatview.h"
 #include "channel.h"
 #include "iserver.h"
 #include "serverselector.h"
@@ -686,7 +687,7 @@ void ChatPanelMenu::OnChatMenuOpenLog(wxCommandEvent&)
 
 void ChatPanelMenu::OnChannelClearContents(wxCommandEvent& /*unused*/)
 {
-	m_chatpanel->m_chatlog_text->SetValue(wxEmptyString);
+	m_chatpanel->m_chatlog_text->Clear();
 }
 
 void ChatPanelMenu::OnUserMenuAddToGroup(wxCommandEvent& event)
@@ -838,7 +839,7 @@ void ChatPanelMenu::OnMenuItem(wxCommandEvent& event)
 	else if (event.GetId() == GROUP_ID_REMOVE)
 		OnUserMenuDeleteFromGroup(event);
 	else if (event.GetId() == wxID_COPY)
-		m_chatpanel->m_chatlog_text->OnCopy(event);
+		m_chatpanel->m_chatlog_text->Copy();
 	else if (event.GetId() == CHAT_MENU_CH_SUBSCRIBE)
 		OnChannelSubscribe(event);
 
@@ -0,0 +1,504 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#include "chatview.h"
+
+#include <wx/dcbuffer.h>
+#include <wx/dcclient.h>
+#include <wx/settings.h>
+#include <wx/textctrl.h>
+#include <algorithm>
+
+#include "uiutils.h"
+
+static const int MARGIN = 3; // space left and right of the text
+
+BEGIN_EVENT_TABLE(ChatView, wxVScrolledWindow)
+EVT_PAINT(ChatView::OnPaint)
+EVT_SIZE(ChatView::OnSize)
+EVT_LEFT_DOWN(ChatView::OnLeftDown)
+EVT_LEFT_UP(ChatView::OnLeftUp)
+EVT_MOTION(ChatView::OnMouseMove)
+EVT_MOUSE_CAPTURE_LOST(ChatView::OnCaptureLost)
+EVT_KEY_DOWN(ChatView::OnKeyDown)
+END_EVENT_TABLE()
+
+static bool IsUrlStart(const wxString& text, size_t pos)
+{
+	if ((pos > 0) && (text[pos - 1] != ' '))
+		return false;
+	const wxString rest = text.Mid(pos, 8);
+	return rest.StartsWith(_T("http://")) || rest.StartsWith(_T("https://")) || rest.StartsWith(_T("ftp://"));
+}
+
+ChatView::ChatView(wxWindow* parent, wxWindowID id)
+    : wxVScrolledWindow(parent, id, wxDefaultPosition, wxDefaultSize, wxSUNKEN_BORDER | wxFULL_REPAINT_ON_RESIZE | wxWANTS_CHARS)
+    , m_lines(MaxHistory)
+    , m_first_id(0)
+    , m_selecting(false)
+    , m_has_selection(false)
+{
+	SetBackgroundStyle(wxBG_STYLE_CUSTOM);
+	SetRowCount(0);
+}
+
+void ChatView::AppendLine(const Segments& segments)
+{
+	Line line;
+	for (const Segment& segment : segments) {
+		if (segment.text.empty())
+			continue;
+		Run run;
+		run.start = line.text.length();
+		run.len = segment.text.length();
+		run.colour = segment.colour;
+		run.bold = segment.bold;
+		run.url = false;
+		line.runs.push_back(run);
+		line.text += segment.text;
+	}
+	MarkUrls(line.text, line.runs);
+
+	const bool atend = IsAtEnd();
+	const size_t firstvisible = GetVisibleRowsBegin();
+	if (!m_lines.push_back(line)) { // the oldest line was dropped
+		m_first_id++;
+		SetRowCount(m_lines.size());
+		RefreshAll(); // all rows moved up by one
+		if (!atend && firstvisible > 0)
+			ScrollToRow(firstvisible - 1);
+	} else {
+		SetRowCount(m_lines.size());
+	}
+	if (atend) {
+		ScrollToEnd();
+	}
+	Refresh();
+}
+
+void ChatView::Clear()
+{
+	m_first_id += m_lines.size();
+	m_lines.clear();
+	m_has_selection = false;
+	m_selecting = false;
+	SetRowCount(0);
+	Refresh();
+}
+
+void ChatView::SetHistoryLength(size_t lines)
+{
+	if ((lines == 0) || (lines > MaxHistory))
+		lines = MaxHistory;
+	if (lines == m_lines.GetCapacity())
+		return;
+	const size_t dropped = (m_lines.size() > lines) ? m_lines.size() - lines : 0;
+	m_lines.SetCapacity(lines);
+	m_first_id += dropped;
+	SetRowCount(m_lines.size());
+	RefreshAll();
+}
+
+bool ChatView::GetSelection(size_t row, size_t& from, size_t& to) const
+{
+	if (!HasSelection())
+		return false;
+	const TextPos& begin = std::min(m_sel_anchor, m_sel_current);
+	const TextPos& end = std::max(m_sel_anchor, m_sel_current);
+	const size_t id = m_first_id + row;
+	if ((id < begin.id) || (id > end.id))
+		return false;
+	const size_t length = m_lines[row].text.length();
+	from = (id == begin.id) ? std::min(begin.offset, length) : 0;
+	to = (id == end.id) ? std::min(end.offset, length) : length;
+	return from < to;
+}
+
+wxString ChatView::GetSelectedText() const
+{
+	wxString res;
+	if (!HasSelection())
+		return res;
+	const TextPos& begin = std::min(m_sel_anchor, m_sel_current);
+	const TextPos& end = std::max(m_sel_anchor, m_sel_current);
+	const size_t first = std::max(begin.id, m_first_id);
+	for (size_t id = first; (id <= end.id) && (id - m_first_id < m_lines.size()); id++) {
+		const size_t row = id - m_first_id;
+		if (id != first)
+			res += _T("\n");
+		size_t from;
+		size_t to;
+		if (GetSelection(row, from, to))
+			res += m_lines[row].text.Mid(from, to - from);
+	}
+	return res;
+}
+
+void ChatView::Copy()
+{
+	const wxString text = GetSelectedText();
+	if (!text.empty())
+		CopyToClipboard(text);
+}
+
+void ChatView::SelectAll()
+{
+	if (m_lines.empty())
+		return;
+	m_sel_anchor = TextPos(m_first_id, 0);
+	m_sel_current = TextPos(m_first_id + m_lines.size() - 1, m_lines[m_lines.size() - 1].text.length());
+	m_has_selection = true;
+	m_selecting = false;
+	Refresh();
+}
+
+wxString ChatView::GetUrlAt(const wxPoint& pos) const
+{
+	size_t row;
+	size_t offset;
+	if (!HitTestText(pos, row, offset))
+		return wxEmptyString;
+	const Line& line = m_lines[row];
+	for (const Run& run : line.runs) {
+		if (run.url && (offset >= run.start) && (offset < run.start + run.len))
+			return line.text.Mid(run.start, run.len);
+	}
+	return wxEmptyString;
+}
+
+bool ChatView::SetFont(const wxFont& font)
+{
+	if (!wxVScrolledWindow::SetFont(font))
+		return false;
+	for (size_t row = 0; row < m_lines.size(); row++) {
+		m_lines[row].wrap_width = -1;
+	}
+	RefreshAll();
+	return true;
+}
+
+int ChatView::GetTextWidth() const
+{
+	return std::max(GetClientSize().GetWidth() - 2 * MARGIN, 1);
+}
+
+void ChatView::SetRunFont(wxDC& dc, const Run& run) const
+{
+	wxFont font = GetFont();
+	if (run.bold)
+		font.SetWeight(wxFONTWEIGHT_BOLD);
+	if (run.url)
+		font.SetUnderlined(true);
+	dc.SetFont(font);
+}
+
+//! wraps the line at spaces, or anywhere if a word doesn't fit into a row
+const ChatView::Line& ChatView::GetWrappedLine(size_t row) const
+{
+	const Line& line = m_lines[row];
+	const int width = GetTextWidth();
+	if (line.wrap_width == width)
+		return line;
+	line.wrap_width = width;
+	line.rows.assign(1, 0);
+
+	wxClientDC dc(const_cast<ChatView*>(this));
+	wxArrayInt extents;
+	wxFont font = GetFont();
+	dc.SetFont(font);
+	if (!dc.GetPartialTextExtents(line.text, extents))
+		return line;
+
+	size_t rowstart = 0;
+	int offset = 0; // extent of the text before rowstart
+	size_t lastspace = wxString::npos;
+	for (size_t i = 0; i < line.text.length(); i++) {
+		if (line.text[i] == ' ')
+			lastspace = i;
+		if ((extents[i] - offset <= width) || (i == rowstart))
+			continue;
+		size_t next = i;
+		if ((lastspace != wxString::npos) && (lastspace >= rowstart) && (lastspace < i))
+			next = lastspace + 1;
+		line.rows.push_back(next);
+		offset = extents[next - 1];
+		rowstart = next;
+		lastspace = wxString::npos;
+	}
+	return line;
+}
+
+wxCoord ChatView::OnGetRowHeight(size_t row) const
+{
+	return GetWrappedLine(row).rows.size() * GetCharHeight();
+}
+
+void ChatView::ForEachPiece(wxDC& dc, const Line& line, size_t subrow, const PieceHandler& handler) const
+{
+	const size_t rowbegin = line.rows[subrow];
+	const size_t rowend = (subrow + 1 < line.rows.size()) ? line.rows[subrow + 1] : line.text.length();
+	int x = MARGIN;
+	for (const Run& run : line.runs) {
+		const size_t begin = std::max(run.start, rowbegin);
+		const size_t end = std::min(run.start + run.len, rowend);
+		if (begin >= end)
+			continue;
+		const wxString piece = line.text.Mid(begin, end - begin);
+		SetRunFont(dc, run);
+		const int width = dc.GetTextExtent(piece).GetWidth();
+		if (!handler(run, begin, piece, x, width))
+			return;
+		x += width;
+	}
+}
+
+bool ChatView::HitTestText(const wxPoint& pos, size_t& row, size_t& offset, bool nearest) const
+{
+	const int hit = VirtualHitTest(pos.y);
+	if ((hit == wxNOT_FOUND) || (size_t(hit) >= m_lines.size()))
+		return false;
+	row = hit;
+	int top = 0;
+	for (size_t i = GetVisibleRowsBegin(); i < row; i++) {
+		top += OnGetRowHeight(i);
+	}
+	const Line& line = GetWrappedLine(row);
+	const size_t subrow = std::min<size_t>((pos.y - top) / GetCharHeight(), line.rows.size() - 1);
+
+	bool found = false;
+	wxClientDC dc(const_cast<ChatView*>(this));
+	ForEachPiece(dc, line, subrow, [&](const Run&, size_t start, const wxString& piece, int x, int width) {
+		if (nearest && (pos.x < x)) { // left of the row
+			offset = start;
+			found = true;
+			return false;
+		}
+		if (pos.x >= x + width)
+			return true;
+		wxArrayInt extents;
+		dc.GetPartialTextExtents(piece, extents);
+		size_t i = 0;
+		while ((i + 1 < extents.size()) && (x + extents[i] <= pos.x)) {
+			i++;
+		}
+		offset = start + i;
+		if (nearest) { // round to the closer side of the character
+			const int left = (i > 0) ? extents[i - 1] : 0;
+			if (pos.x - x >= (left + extents[i]) / 2)
+				offset++;
+		}
+		found = true;
+		return false;
+	});
+	if (!found && nearest) { // right of the row, or an empty line
+		offset = (subrow + 1 < line.rows.size()) ? line.rows[subrow + 1] : line.text.length();
+		found = true;
+	}
+	return found;
+}
+
+ChatView::TextPos ChatView::GetSelectionPos(const wxPoint& pos) const
+{
+	const int height = GetClientSize().GetHeight();
+	wxPoint clamped(pos.x, std::min(std::max(pos.y, 0), height - 1));
+	size_t row;
+	size_t offset;
+	if (HitTestText(clamped, row, offset, true))
+		return TextPos(m_first_id + row, offset);
+	// below the last line
+	row = std::min(GetVisibleRowsEnd(), m_lines.size()) - 1;
+	return TextPos(m_first_id + row, m_lines[row].text.length());
+}
+
+bool ChatView::IsAtEnd() const
+{
+	return (GetRowCount() == 0) || (GetVisibleRowsEnd() >= GetRowCount());
+}
+
+void ChatView::ScrollToEnd()
+{
+	const size_t count = GetRowCount();
+	const int height = GetClientSize().GetHeight();
+	size_t first = count;
+	int used = 0;
+	while (first > 0) {
+		const int rowheight = OnGetRowHeight(first - 1);
+		if ((used + rowheight > height) && (first < count))
+			break;
+		used += rowheight;
+		first--;
+	}
+	ScrollToRow(first);
+}
+
+void ChatView::OnPaint(wxPaintEvent& /*unused*/)
+{
+	wxAutoBufferedPaintDC dc(this);
+	dc.SetBackground(wxBrush(GetBackgroundColour()));
+	dc.Clear();
+
+	const wxSize size = GetClientSize();
+	const int lineheight = GetCharHeight();
+	const wxColour highlight = wxSystemSettings::GetColour(wxSYS_COLOUR_HIGHLIGHT);
+	const wxColour highlighttext = wxSystemSettings::GetColour(wxSYS_COLOUR_HIGHLIGHTTEXT);
+	dc.SetBackgroundMode(wxTRANSPARENT);
+
+	int y = 0;
+	for (size_t row = GetVisibleRowsBegin(); (row < m_lines.size()) && (y < size.GetHeight()); row++) {
+		const Line& line = GetWrappedLine(row);
+		const int height = line.rows.size() * lineheight;
+		size_t selfrom = 0;
+		size_t selto = 0;
+		const bool selected = GetSelection(row, selfrom, selto);
+		for (size_t subrow = 0; subrow < line.rows.size(); subrow++) {
+			const int top = y + subrow * lineheight;
+			ForEachPiece(dc, line, subrow, [&](const Run& run, size_t start, const wxString& piece, int x, int width) {
+				const size_t end = start + piece.length();
+				const size_t from = selected ? std::min(std::max(selfrom, start), end) - start : 0;
+				const size_t to = selected ? std::min(std::max(selto, start), end) - start : 0;
+				if (from >= to) {
+					dc.SetTextForeground(run.colour);
+					dc.DrawText(piece, x, top);
+					return true;
+				}
+				// draw the text before, in and after the selection separately
+				wxArrayInt extents;
+				dc.GetPartialTextExtents(piece, extents);
+				const int selx = x + ((from > 0) ? extents[from - 1] : 0);
+				const int selwidth = x + extents[to - 1] - selx;
+				dc.SetPen(*wxTRANSPARENT_PEN);
+				dc.SetBrush(wxBrush(highlight));
+				dc.DrawRectangle(selx, top, selwidth, lineheight);
+				dc.SetTextForeground(run.colour);
+				dc.DrawText(piece.Left(from), x, top);
+				dc.DrawText(piece.Mid(to), selx + selwidth, top);
+				dc.SetTextForeground(highlighttext);
+				dc.DrawText(piece.Mid(from, to - from), selx, top);
+				return true;
+			});
+		}
+		y += height;
+	}
+}
+
+void ChatView::OnSize(wxSizeEvent& event)
+{
+	// the heights of the rows depend on the width
+	const bool atend = IsAtEnd();
+	RefreshAll();
+	if (atend)
+		ScrollToEnd();
+	event.Skip();
+}
+
+void ChatView::OnLeftDown(wxMouseEvent& event)
+{
+	SetFocus();
+	const wxString url = GetUrlAt(event.GetPosition());
+	if (!url.empty()) {
+		wxTextUrlEvent urlevent(GetId(), event, 0, url.length());
+		urlevent.SetEventObject(this);
+		GetEventHandler()->ProcessEvent(urlevent);
+		return;
+	}
+	m_has_selection = false;
+	if (!m_lines.empty()) {
+		m_sel_anchor = m_sel_current = GetSelectionPos(event.GetPosition());
+		m_has_selection = true;
+		m_selecting = true;
+		CaptureMouse();
+	}
+	Refresh();
+}
+
+void ChatView::OnLeftUp(wxMouseEvent& /*unused*/)
+{
+	if (HasCapture())
+		ReleaseMouse();
+	m_selecting = false;
+}
+
+void ChatView::OnCaptureLost(wxMouseCaptureLostEvent& /*unused*/)
+{
+	m_selecting = false;
+}
+
+void ChatView::OnMouseMove(wxMouseEvent& event)
+{
+	if (!m_selecting || !event.LeftIsDown()) {
+		SetCursor(GetUrlAt(event.GetPosition()).empty() ? wxNullCursor : wxCursor(wxCURSOR_HAND));
+		return;
+	}
+	const int y = event.GetPosition().y;
+	if (y < 0) {
+		ScrollRows(-1);
+	} else if (y >= GetClientSize().GetHeight()) {
+		ScrollRows(1);
+	}
+	if (m_lines.empty())
+		return;
+	const TextPos current = GetSelectionPos(event.GetPosition());
+	if (current != m_sel_current) {
+		m_sel_current = current;
+		Refresh();
+	}
+}
+
+void ChatView::OnKeyDown(wxKeyEvent& event)
+{
+	if (event.CmdDown() && ((event.GetKeyCode() == 'C') || (event.GetKeyCode() == WXK_INSERT))) {
+		Copy();
+		return;
+	}
+	if (event.CmdDown() && (event.GetKeyCode() == 'A')) {
+		SelectAll();
+		return;
+	}
+	event.Skip();
+}
+
+//! splits the runs of a line at the urls it contains and marks the url parts
+void ChatView::MarkUrls(const wxString& text, std::vector<Run>& runs)
+{
+	std::vector<std::pair<size_t, size_t> > urls;
+	for (size_t i = 0; i < text.length(); i++) {
+		if (!IsUrlStart(text, i))
+			continue;
+		size_t end = text.find(' ', i);
+		if (end == wxString::npos)
+			end = text.length();
+		urls.push_back(std::make_pair(i, end));
+		i = end;
+	}
+	if (urls.empty())
+		return;
+
+	std::vector<Run> res;
+	for (const Run& run : runs) {
+		size_t pos = run.start;
+		const size_t runend = run.start + run.len;
+		for (const auto& url : urls) {
+			if ((url.second <= pos) || (url.first >= runend))
+				continue;
+			if (url.first > pos) {
+				Run before = run;
+				before.start = pos;
+				before.len = url.first - pos;
+				res.push_back(before);
+				pos = url.first;
+			}
+			Run link = run;
+			link.start = pos;
+			link.len = std::min(url.second, runend) - pos;
+			link.url = true;
+			res.push_back(link);
+			pos += link.len;
+		}
+		if (pos < runend) {
+			Run after = run;
+			after.start = pos;
+			after.len = runend - pos;
+			res.push_back(after);
+		}
+	}
+	runs.swap(res);
+}
@@ -0,0 +1,159 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#ifndef SPRINGLOBBY_HEADERGUARD_CHATVIEW_H
+#define SPRINGLOBBY_HEADERGUARD_CHATVIEW_H
+
+#include <wx/vscroll.h>
+#include <wx/colour.h>
+#include <wx/string.h>
+#include <functional>
+#include <vector>
+
+#include "utils/ringbuffer.h"
+
+class wxDC;
+class wxPaintEvent;
+class wxSizeEvent;
+class wxMouseEvent;
+class wxKeyEvent;
+class wxMouseCaptureLostEvent;
+
+/** @brief Read only view of the chat history.
+ *
+ * Lines are parsed into colored runs once when they're appended and kept in
+ * a ring buffer, so appending and dropping the oldest line don't depend on
+ * the size of the history. Only the visible lines are wrapped and drawn.
+ * Clicking on an url sends a wxTextUrlEvent like wxTextCtrl with
+ * wxTE_AUTO_URL does.
+ */
+class ChatView : public wxVScrolledWindow
+{
+public:
+	//! lines kept if no history length is set
+	static const size_t MaxHistory = 50000;
+
+	struct Segment
+	{
+		Segment(const wxString& text_, const wxColour& colour_, bool bold_ = false)
+		    : text(text_)
+		    , colour(colour_)
+		    , bold(bold_)
+		{
+		}
+		wxString text;
+		wxColour colour;
+		bool bold;
+	};
+	typedef std::vector<Segment> Segments;
+
+	ChatView(wxWindow* parent, wxWindowID id);
+
+	//! appends a line, the oldest line is dropped if the history is full
+	void AppendLine(const Segments& segments);
+	void Clear();
+	//! number of lines kept, 0 means MaxHistory
+	void SetHistoryLength(size_t lines);
+
+	bool HasSelection() const
+	{
+		return m_has_selection && (m_sel_anchor != m_sel_current);
+	}
+	wxString GetSelectedText() const;
+	//! copies the selected text to the clipboard
+	void Copy();
+	void SelectAll();
+
+	//! @return the url at @p pos (client coordinates), or an empty string
+	wxString GetUrlAt(const wxPoint& pos) const;
+
+	virtual bool SetFont(const wxFont& font);
+
+protected:
+	virtual wxCoord OnGetRowHeight(size_t row) const;
+
+private:
+	struct Run
+	{
+		size_t start;
+		size_t len;
+		wxColour colour;
+		bool bold;
+		bool url;
+	};
+	struct Line
+	{
+		Line()
+		    : wrap_width(-1)
+		{
+		}
+		wxString text;
+		std::vector<Run> runs;
+		mutable int wrap_width;		  //!< text width the line was wrapped for
+		mutable std::vector<size_t> rows; //!< start offsets of the wrapped rows
+	};
+	//! a position between two characters, the line is given by its id so it doesn't move when old lines are dropped
+	struct TextPos
+	{
+		TextPos()
+		    : id(0)
+		    , offset(0)
+		{
+		}
+		TextPos(size_t id_, size_t offset_)
+		    : id(id_)
+		    , offset(offset_)
+		{
+		}
+		bool operator<(const TextPos& other) const
+		{
+			return (id < other.id) || ((id == other.id) && (offset < other.offset));
+		}
+		bool operator!=(const TextPos& other) const
+		{
+			return (id != other.id) || (offset != other.offset);
+		}
+		size_t id;
+		size_t offset;
+	};
+	//! called for each run piece of a wrapped row, return false to stop
+	typedef std::function<bool(const Run& run, size_t start, const wxString& piece, int x, int width)> PieceHandler;
+
+	int GetTextWidth() const;
+	const Line& GetWrappedLine(size_t row) const;
+	void ForEachPiece(wxDC& dc, const Line& line, size_t subrow, const PieceHandler& handler) const;
+	void SetRunFont(wxDC& dc, const Run& run) const;
+	static void MarkUrls(const wxString& text, std::vector<Run>& runs);
+	/** @brief Finds the text at @p pos.
+	 * @p offset is the character at @p pos, with @p nearest it's the character
+	 * boundary closest to @p pos and positions left or right of the text count
+	 * as the start or the end of the row.
+	 * @return false if there is no text at @p pos
+	 */
+	bool HitTestText(const wxPoint& pos, size_t& row, size_t& offset, bool nearest = false) const;
+	//! @return the selection position for @p pos, which is clamped to the visible lines
+	TextPos GetSelectionPos(const wxPoint& pos) const;
+	bool IsAtEnd() const;
+	void ScrollToEnd();
+	//! @return false if no text of @p row is selected, otherwise its selected range is [@p from, @p to)
+	bool GetSelection(size_t row, size_t& from, size_t& to) const;
+
+	void OnPaint(wxPaintEvent& event);
+	void OnSize(wxSizeEvent& event);
+	void OnLeftDown(wxMouseEvent& event);
+	void OnLeftUp(wxMouseEvent& event);
+	void OnMouseMove(wxMouseEvent& event);
+	void OnCaptureLost(wxMouseCaptureLostEvent& event);
+	void OnKeyDown(wxKeyEvent& event);
+
+	RingBuffer<Line> m_lines;
+	size_t m_first_id; //!< number of lines dropped so far, which is the id of m_lines[0]
+
+	TextPos m_sel_anchor;
+	TextPos m_sel_current;
+	bool m_selecting;
+	bool m_has_selection;
+
+	DECLARE_EVENT_TABLE()
+};
+
+#endif // SPRINGLOBBY_HEADERGUARD_CHATVIEW_H
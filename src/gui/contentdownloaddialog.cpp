@@ -8,11 +8,104 @@
 #include <wx/stattext.h>
 #include <wx/button.h>
 #include <wx/msgdlg.h>
-#include "json/wx/jsonreader.h"
+#include "json/wx/jsonsaxreader.h"
 #include "httpfile.h"
 #include "ui.h"
 #include <lslunitsync/unitsync.h>
 
+namespace
+{
+
+//! reports each entry of the springfiles result array as soon as it is parsed
+class SearchResultHandler : public wxJSONSaxHandler
+{
+public:
+	explicit SearchResultHandler(ContentDownloadDialog& dialog)
+	    : m_dialog(dialog)
+	    , m_level(0)
+	    , m_size(0)
+	    , m_count(0)
+	{
+	}
+
+	unsigned int GetCount() const
+	{
+		return m_count;
+	}
+
+	virtual bool OnStartObject()
+	{
+		if (++m_level == 2) {
+			m_category.clear();
+			m_name.clear();
+			m_size = 0;
+		}
+		return true;
+	}
+	virtual bool OnEndObject()
+	{
+		if (m_level-- == 2) {
+			m_count++;
+			m_dialog.AddSearchResult(m_category, m_name, m_size);
+		}
+		return true;
+	}
+	virtual bool OnStartArray()
+	{
+		m_level++;
+		return true;
+	}
+	virtual bool OnEndArray()
+	{
+		m_level--;
+		return true;
+	}
+	virtual bool OnKey(const wxString& key)
+	{
+		if (m_level == 2) {
+			m_key = key;
+		}
+		return true;
+	}
+	virtual bool OnString(const wxString& value)
+	{
+		if (m_level != 2) {
+			return true;
+		}
+		if (m_key == _T("category")) {
+			m_category = value;
+		} else if (m_key == _T("springname")) {
+			m_name = value;
+		}
+		return true;
+	}
+	virtual bool OnInt(wxInt64 value)
+	{
+		if (m_level == 2 && m_key == _T("size")) {
+			m_size = value;
+		}
+		return true;
+	}
+	virtual bool OnUInt(wxUint64 value)
+	{
+		if (m_level == 2 && m_key == _T("size")) {
+			m_size = value;
+		}
+		return true;
+	}
+
+private:
+	ContentDownloadDialog& m_dialog;
+	int m_level;
+	wxString m_key;
+	wxString m_category;
+	wxString m_name;
+	long m_size;
+	unsigned int m_count;
+};
+
+} // namespace
+
 DECLARE_EVENT_TYPE(SEARCH_FINISHED, wxID_ANY);
 DEFINE_EVENT_TYPE(SEARCH_FINISHED);
 BEGIN_EVENT_TABLE(ContentDownloadDialog, wxDialog)
@@ -96,49 +189,39 @@ void ContentDownloadDialog::OnSearchCompleted(wxCommandEvent& event)
 	wxString json = event.GetString();
 	//   std::cout << json.ToAscii().data() << std::endl;
 
-	wxJSONReader reader;
-	wxJSONValue root;
-	int errors = reader.Parse(json, &root);
+	m_search_res_w->Clear();
+	wxJSONSaxReader reader;
+	SearchResultHandler handler(*this);
+	int errors = reader.Parse(json, handler);
 	m_searchbutton->Enable(true);
 	if (errors) {
 		wxMessageBox(wxString::Format(_T("Failed to parse search results:\n%s"), json.c_str()), _("Error"));
 		return;
 	}
-	const wxJSONInternalArray* a = root.AsArray();
-	if ((a->GetCount() == 0) && (!wildcardsearch)) { //no results returned, try wildcard search
+	if ((handler.GetCount() == 0) && (!wildcardsearch)) { //no results returned, try wildcard search
 		wildcardsearch = true;
 		const wxString search_query = _T("*") + m_searchbox->GetValue() + _T("*"); //By default the user would expect that
 		Search(search_query);
 		return;
 	}
 	wildcardsearch = false;
-	m_search_res_w->Clear();
-
-	for (unsigned i = 0; i < a->GetCount(); i++) {
-		wxJSONValue val = a->Item(i);
-		wxString category = val[_("category")].AsString();
+}
 
-		long size = 0;
-		if (val[_("size")].IsInt()) {
-			size = val[_("size")].AsInt();
-		} else if (val[_("size")].IsLong()) {
-			size = val[_("size")].AsLong();
-		}
-		wxString name = val[_("springname")].AsString();
-		//     std::cout << category.ToAscii().data() << "," << name.ToAscii().data() << "," << size << std::endl;
-		ContentSearchResult* res = new ContentSearchResult();
-		res->name = name;
-		res->filesize = size;
-		res->type = category;
-		if (category == _("map"))
-			res->is_downloaded = LSL::usync().MapExists(std::string(name.mb_str()));
-		else if (category == _("game"))
-			res->is_downloaded = LSL::usync().ModExists(std::string(name.mb_str()));
-		else
-			res->is_downloaded = 0;
-
-		m_search_res_w->AddContent(res);
-	}
+void ContentDownloadDialog::AddSearchResult(const wxString& category, const wxString& name, long size)
+{
+	//     std::cout << category.ToAscii().data() << "," << name.ToAscii().data() << "," << size << std::endl;
+	ContentSearchResult* res = new ContentSearchResult();
+	res->name = name;
+	res->filesize = size;
+	res->type = category;
+	if (category == _("map"))
+		res->is_downloaded = LSL::usync().MapExists(std::string(name.mb_str()));
+	else if (category == _("game"))
+		res->is_downloaded = LSL::usync().ModExists(std::string(name.mb_str()));
+	else
+		res->is_downloaded = 0;
+
+	m_search_res_w->AddContent(res);
 }
 
 void ContentDownloadDialog::OnCloseButton(wxCommandEvent& /*event*/)
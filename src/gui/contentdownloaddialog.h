@@ -24,6 +24,8 @@ public:
 	void OnDownloadButton(wxCommandEvent& event);
 	void OnCloseButton(wxCommandEvent& event);
 	void OnListDownload(wxListEvent& event);
+	//! called by the search result parser for each entry
+	void AddSearchResult(const wxString& category, const wxString& name, long size);
 
 private:
 	DECLARE_EVENT_TABLE()
@@ -295,7 +295,7 @@ void CustomListCtrl::UpdateHighlights()
 void CustomListCtrl::HighlightItemUser(long item, const wxString& name)
 {
 	if (m_highlight && useractions().DoActionOnUser(m_highlightAction, name)) {
-		wxColour c = useractions().GetGroupHLColor(useractions().GetGroupOfUser(name));
+		wxColour c = useractions().GetUserColor(name);
 		SetItemBackgroundColour(item, c);
 	} else
 		SetItemBackgroundColour(item, m_bg_color);
@@ -372,7 +372,7 @@ wxListItemAttr* CustomVirtListCtrl<T, L>::HighlightItemUser(const wxString& name
 {
 	static wxListItemAttr att;
 	if (m_highlight && useractions().DoActionOnUser(m_highlightAction, name)) {
-		att.SetBackgroundColour(useractions().GetGroupHLColor(useractions().GetGroupOfUser(name)));
+		att.SetBackgroundColour(useractions().GetUserColor(name));
 		return &att;
 	} else
 		return NULL;
@@ -249,7 +249,7 @@ void AddBotDialog::ShowAIOptions()
 	m_opts_list->DeleteAllItems();
 	m_opt_list_map.clear();
 	m_battle.CustomBattleOptions().loadAIOptions(m_battle.GetHostModName(), GetAIType(), STD_STRING(GetNick()));
-	AddMMOptionsToList(0, m_battle.CustomBattleOptions().GetAIOptionIndex(STD_STRING(GetNick())));
+	AddMMOptionsToList(0, m_battle.GetCustomBattleOptions().GetAIOptionIndex(STD_STRING(GetNick())));
 	m_opts_list->SetColumnWidth(0, wxLIST_AUTOSIZE);
 	m_opts_list->SetColumnWidth(1, wxLIST_AUTOSIZE);
 	Layout();
@@ -258,7 +258,7 @@ void AddBotDialog::ShowAIOptions()
 
 long AddBotDialog::AddMMOptionsToList(long pos, int optFlag)
 {
-	for (const auto& it : m_battle.CustomBattleOptions().getOptions((LSL::Enum::GameOption)optFlag)) {
+	for (const auto& it : m_battle.GetCustomBattleOptions().getOptions((LSL::Enum::GameOption)optFlag)) {
 		m_opts_list->InsertItem(pos, TowxString(it.second.first));
 		const wxString tag = wxString::Format(_T( "%d_%s"), optFlag, TowxString(it.first).c_str());
 		m_opt_list_map[tag] = pos;
@@ -276,16 +276,16 @@ void AddBotDialog::UpdateOption(const wxString& Tag)
 	const std::string key = STD_STRING(Tag.AfterFirst('_'));
 	std::string value;
 
-	const auto DataType = m_battle.CustomBattleOptions().GetSingleOptionType(key);
-	value = m_battle.CustomBattleOptions().getSingleValue(key, (LSL::Enum::GameOption)type);
-	if (m_battle.CustomBattleOptions().getDefaultValue(key, type) == value)
+	const auto DataType = m_battle.GetCustomBattleOptions().GetSingleOptionType(key);
+	value = m_battle.GetCustomBattleOptions().getSingleValue(key, (LSL::Enum::GameOption)type);
+	if (m_battle.GetCustomBattleOptions().getDefaultValue(key, type) == value)
 		m_opts_list->SetItemFont(index, wxFont(8, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_LIGHT));
 	else
 		m_opts_list->SetItemFont(index, wxFont(8, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_BOLD));
 	if (DataType == LSL::Enum::opt_bool) {
 		value = STD_STRING(bool2yn(LSL::Util::FromString<long>(value))); // convert from 0/1 to literal Yes/No
 	} else if (DataType == LSL::Enum::opt_list) {
-		value = m_battle.CustomBattleOptions().GetNameListOptValue(key, type); // get the key full name not short key
+		value = m_battle.GetCustomBattleOptions().GetNameListOptValue(key, type); // get the key full name not short key
 	}
 	m_opts_list->SetItem(index, 1, TowxString(value));
 	m_opts_list->SetColumnWidth(1, wxLIST_AUTOSIZE);
@@ -301,7 +301,7 @@ void AddBotDialog::OnOptionActivate(wxListEvent& event)
 			break;
 		}
 	}
-	LSL::OptionsWrapper& optWrap = m_battle.CustomBattleOptions();
+	const LSL::OptionsWrapper& optWrap = m_battle.GetCustomBattleOptions();
 	const LSL::Enum::GameOption optFlag = (LSL::Enum::GameOption)FromwxString(tag.BeforeFirst('_'));
 	const std::string key = STD_STRING(tag.AfterFirst('_'));
 	LSL::Enum::OptionType type = optWrap.GetSingleOptionType(key);
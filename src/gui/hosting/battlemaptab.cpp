@@ -136,7 +136,7 @@ void BattleMapTab::Update()
 	if (!m_battle)
 		return;
 	const long longval = LSL::Util::FromString<long>(
-	    m_battle->CustomBattleOptions().getSingleValue("startpostype", LSL::Enum::EngineOption));
+	    m_battle->GetCustomBattleOptions().getSingleValue("startpostype", LSL::Enum::EngineOption));
 	m_start_radios->SetSelection(longval);
 
 	m_minimap->UpdateMinimap();
@@ -171,7 +171,7 @@ void BattleMapTab::Update(const wxString& Tag)
 	Tag.BeforeFirst('_').ToLong(&type);
 	const std::string key = STD_STRING(Tag.AfterFirst('_'));
 	const long longval = LSL::Util::FromString<long>(
-	    m_battle->CustomBattleOptions().getSingleValue(key, (LSL::Enum::GameOption)type));
+	    m_battle->GetCustomBattleOptions().getSingleValue(key, (LSL::Enum::GameOption)type));
 	if (type == LSL::Enum::EngineOption) {
 		if (key == "startpostype") {
 			m_start_radios->SetSelection(longval);
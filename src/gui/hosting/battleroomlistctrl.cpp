@@ -326,10 +326,10 @@ wxString BattleroomListCtrl::GetItemText(long item, long column) const
 	}
 	if (column == m_nick_column_index) {
 		if (is_bot) {
-			wxString botname = TowxString(user.BattleStatus().aishortname);
-			if (!user.BattleStatus().aiversion.empty())
-				botname += _T(" ") + TowxString(user.BattleStatus().aiversion);
-			return wxString::Format(_T("%s - %s (%s)"), TowxString(user.GetNick()).c_str(), botname.c_str(), TowxString(user.BattleStatus().owner).c_str());
+			wxString botname = TowxString(user.BattleStatus().GetAIShortName());
+			if (!user.BattleStatus().GetAIVersion().empty())
+				botname += _T(" ") + TowxString(user.BattleStatus().GetAIVersion());
+			return wxString::Format(_T("%s - %s (%s)"), TowxString(user.GetNick()).c_str(), botname.c_str(), TowxString(user.BattleStatus().GetOwner()).c_str());
 		} else
 			return TowxString(user.GetNick());
 	}
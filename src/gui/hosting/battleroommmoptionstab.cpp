@@ -126,7 +126,7 @@ void BattleroomMMOptionsTab::setupOptionsSizer(wxBoxSizer* parent_sizer,
 	if (!m_battle)
 		return;
 	unsigned int num_options = 0;
-	for (const auto& it : m_battle->CustomBattleOptions().m_opts[optFlag].section_map) {
+	for (const auto& it : m_battle->GetCustomBattleOptions().m_opts[optFlag].section_map) {
 		wxStaticBoxSizer* section_sizer = new wxStaticBoxSizer(
 		    new wxStaticBox(this, wxID_ANY, TowxString(it.second.name)), wxVERTICAL);
 		//only add non-empty sizer
@@ -170,7 +170,7 @@ int BattleroomMMOptionsTab::setupOptionsSectionSizer(const LSL::mmOptionSection&
 		return -1;
 	const int col_gap = 35;
 	wxString pref = wxString::Format(_T("%d%s"), optFlag, wxsep.c_str());
-	LSL::OptionsWrapper optWrap = m_battle->CustomBattleOptions();
+	LSL::OptionsWrapper optWrap = m_battle->GetCustomBattleOptions();
 	bool enable = m_battle->IsFounderMe();
 	wxFlexGridSizer* cbxSizer = new wxFlexGridSizer(4, 2, 10, 10);
 	wxFlexGridSizer* spinSizer = new wxFlexGridSizer(4, 10, 10);
@@ -322,7 +322,7 @@ void BattleroomMMOptionsTab::OnComBoxChange(wxCommandEvent& event)
 	const auto key = STD_STRING((box->GetName()).AfterFirst(sep));
 	long gameoption;
 	box->GetName().BeforeFirst(sep).ToLong(&gameoption);
-	const auto itemKey = m_battle->CustomBattleOptions().GetNameListOptItemKey(key, STD_STRING(box->GetValue()),
+	const auto itemKey = m_battle->GetCustomBattleOptions().GetNameListOptItemKey(key, STD_STRING(box->GetValue()),
 										   (LSL::Enum::GameOption)gameoption);
 
 	if (m_battle->CustomBattleOptions().setSingleOption(key, itemKey,
@@ -383,19 +383,19 @@ void BattleroomMMOptionsTab::UpdateOptControls(const wxString& controlName)
 
 	if (m_chkbox_map.find(controlName) != m_chkbox_map.end()) {
 		const long value = LSL::Util::FromString<long>(
-		    m_battle->CustomBattleOptions().getSingleValue(optKey, (LSL::Enum::GameOption)gameoption));
+		    m_battle->GetCustomBattleOptions().getSingleValue(optKey, (LSL::Enum::GameOption)gameoption));
 		wxCheckBox* cur = m_chkbox_map[controlName];
 		cur->SetValue(value);
 	}
 
 	if (m_combox_map.find(controlName) != m_combox_map.end()) {
 		wxComboBox* cur = m_combox_map[controlName];
-		cur->SetValue(TowxString((m_battle->CustomBattleOptions()
+		cur->SetValue(TowxString((m_battle->GetCustomBattleOptions()
 					      .GetNameListOptValue(optKey, (LSL::Enum::GameOption)gameoption))));
 	}
 
 	if (m_textctrl_map.find(controlName) != m_textctrl_map.end()) {
-		const wxString value = TowxString(m_battle->CustomBattleOptions()
+		const wxString value = TowxString(m_battle->GetCustomBattleOptions()
 						      .getSingleValue(optKey, (LSL::Enum::GameOption)gameoption));
 		wxTextCtrl* cur = m_textctrl_map[controlName];
 		cur->SetValue(value);
@@ -403,7 +403,7 @@ void BattleroomMMOptionsTab::UpdateOptControls(const wxString& controlName)
 
 	if (m_spinctrl_map.find(controlName) != m_spinctrl_map.end()) {
 		const long value = LSL::Util::FromString<long>(
-		    m_battle->CustomBattleOptions().getSingleValue(optKey, (LSL::Enum::GameOption)gameoption));
+		    m_battle->GetCustomBattleOptions().getSingleValue(optKey, (LSL::Enum::GameOption)gameoption));
 		wxSpinCtrlDouble* cur = m_spinctrl_map[controlName];
 		cur->SetValue(value);
 	}
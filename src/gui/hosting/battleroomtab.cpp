@@ -432,9 +432,9 @@ void BattleRoomTab::UpdateBattleInfo(const wxString& Tag)
 	LSL::Enum::GameOption type = (LSL::Enum::GameOption)FromwxString(Tag.BeforeFirst('_'));
 	wxString key = Tag.AfterFirst('_');
 	if ((type == LSL::Enum::MapOption) || (type == LSL::Enum::ModOption) || (type == LSL::Enum::EngineOption)) {
-		LSL::Enum::OptionType DataType = m_battle->CustomBattleOptions().GetSingleOptionType(STD_STRING(key));
-		wxString value = TowxString(m_battle->CustomBattleOptions().getSingleValue(STD_STRING(key), (LSL::Enum::GameOption)type));
-		if (TowxString(m_battle->CustomBattleOptions().getDefaultValue(STD_STRING(key), type)) == value) {
+		LSL::Enum::OptionType DataType = m_battle->GetCustomBattleOptions().GetSingleOptionType(STD_STRING(key));
+		wxString value = TowxString(m_battle->GetCustomBattleOptions().getSingleValue(STD_STRING(key), (LSL::Enum::GameOption)type));
+		if (TowxString(m_battle->GetCustomBattleOptions().getDefaultValue(STD_STRING(key), type)) == value) {
 			m_opts_list->SetItemFont(index, wxFont(8, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_LIGHT));
 		} else {
 			m_opts_list->SetItemFont(index, wxFont(8, wxFONTFAMILY_DEFAULT, wxFONTSTYLE_NORMAL, wxFONTWEIGHT_BOLD));
@@ -442,7 +442,7 @@ void BattleRoomTab::UpdateBattleInfo(const wxString& Tag)
 		if (DataType == LSL::Enum::opt_bool) {
 			value = bool2yn(FromwxString(value)); // convert from 0/1 to literal Yes/No
 		} else if (DataType == LSL::Enum::opt_list) {
-			value = TowxString(m_battle->CustomBattleOptions().GetNameListOptValue(STD_STRING(key), type)); // get the key full name not short key
+			value = TowxString(m_battle->GetCustomBattleOptions().GetNameListOptValue(STD_STRING(key), type)); // get the key full name not short key
 		}
 		m_opts_list->SetItem(index, 1, value);
 	} else // if ( type == OptionsWrapper::PrivateOptions )
@@ -586,6 +586,7 @@ void BattleRoomTab::OnStart(wxCommandEvent& /*unused*/)
 		return;
 	if (m_battle->IsFounderMe()) {
 		m_battle->GetMe().BattleStatus().ready = true;
+		m_battle->InvalidateScript(IBattle::ScriptCache::Mask(IBattle::ScriptCache::SECTION_PLAYERS));
 		if (!m_battle->IsEveryoneReady()) {
 			int answer = customMessageBox(SL_MAIN_ICON, _("Some Players are not ready yet\nDo you want to force start?"), _("Not ready"), wxYES_NO);
 			if (answer == wxNO)
@@ -690,10 +691,10 @@ void BattleRoomTab::OnAddBot(wxCommandEvent& /*unused*/)
 		bs.ready = true;
 		bs.handicap = 0;
 		bs.colour = m_battle->GetNewColour();
-		bs.aishortname = STD_STRING(dlg.GetAIShortName());
-		bs.aiversion = STD_STRING(dlg.GetAIVersion());
+		bs.SetAIShortName(STD_STRING(dlg.GetAIShortName()));
+		bs.SetAIVersion(STD_STRING(dlg.GetAIVersion()));
 		bs.aitype = dlg.GetAIType();
-		bs.owner = m_battle->GetMe().GetNick();
+		bs.SetOwner(m_battle->GetMe().GetNick());
 		m_battle->GetServer().AddBot(m_battle->GetBattleId(), STD_STRING(dlg.GetNick()), bs);
 	}
 }
@@ -954,7 +955,7 @@ long BattleRoomTab::AddMMOptionsToList(long pos, LSL::Enum::GameOption optFlag)
 {
 	if (!m_battle)
 		return -1;
-	LSL::OptionsWrapper::stringTripleVec optlist = m_battle->CustomBattleOptions().getOptions(optFlag);
+	LSL::OptionsWrapper::stringTripleVec optlist = m_battle->GetCustomBattleOptions().getOptions(optFlag);
 	for (LSL::OptionsWrapper::stringTripleVec::const_iterator it = optlist.begin(); it != optlist.end(); ++it) {
 		m_opts_list->InsertItem(pos, TowxString(it->second.first));
 		wxString tag = wxString::Format(_T( "%d_%s" ), optFlag, TowxString(it->first).c_str());
@@ -1098,7 +1099,7 @@ void BattleRoomTab::OnOptionActivate(wxListEvent& event)
 			break;
 		}
 	}
-	LSL::OptionsWrapper& optWrap = m_battle->CustomBattleOptions();
+	const LSL::OptionsWrapper& optWrap = m_battle->GetCustomBattleOptions();
 	LSL::Enum::GameOption optFlag = (LSL::Enum::GameOption)FromwxString(tag.BeforeFirst('_'));
 	const std::string key = STD_STRING(tag.AfterFirst('_'));
 	LSL::Enum::OptionType type = optWrap.GetSingleOptionType(key);
@@ -131,7 +131,7 @@ void SingleOptionDialog::OnOk(wxCommandEvent& /*unused*/)
 	if (m_textctrl)
 		value = m_textctrl->GetValue();
 	else if (m_combobox)
-		value = TowxString(m_battle.CustomBattleOptions()
+		value = TowxString(m_battle.GetCustomBattleOptions()
 				       .GetNameListOptItemKey(key, STD_STRING(m_combobox->GetValue()), optFlag));
 	else if (m_spinctrl) {
 		double d = m_spinctrl->GetValue();
@@ -154,6 +154,7 @@ MainWindow::MainWindow()
 	m_menuEdit->Append(m_settings_menu);
 
 	m_menuEdit->Enable(MENU_SETTINGSPP, LSL::usync().IsLoaded()); //unitsync isn't loaded yet, disable menu entry
+	ConnectGlobalEvent(this, GlobalEvent::OnUnitsyncReloaded, wxObjectEventFunction(&MainWindow::OnUnitSyncReloaded));
 
 	m_menuTools = new wxMenu;
 	m_menuTools->Append(MENU_JOIN, _("&Join channel..."));
@@ -553,10 +554,14 @@ void MainWindow::OnMenuVersion(wxCommandEvent& /*unused*/)
 void MainWindow::OnUnitSyncReload(wxCommandEvent& /*unused*/)
 {
 	LSL::usync().ReloadUnitSyncLib();
-	m_menuEdit->Enable(MENU_SETTINGSPP, LSL::usync().IsLoaded());
 	GlobalEvent::Send(GlobalEvent::OnUnitsyncReloaded);
 }
 
+void MainWindow::OnUnitSyncReloaded(wxCommandEvent& /*data*/)
+{
+	m_menuEdit->Enable(MENU_SETTINGSPP, LSL::usync().IsLoaded());
+}
+
 void MainWindow::MainWindow::OnShowWriteableDir(wxCommandEvent& /*unused*/)
 {
 	BrowseFolder(TowxString(SlPaths::GetDataDir()));
@@ -6,6 +6,7 @@
 #include <wx/intl.h>
 #include <wx/frame.h>
 #include "gui/windowattributespickle.h"
+#include "utils/globalevents.h"
 
 class Ui;
 class Channel;
@@ -44,7 +45,7 @@ class wxFocusEvent;
 const wxEventType MainwindowMessageEvent = wxNewEventType();
 
 //! @brief wxFrame that contains the main window of the client.
-class MainWindow : public wxFrame, public WindowAttributesPickle
+class MainWindow : public wxFrame, public WindowAttributesPickle, public GlobalEvent
 {
 public:
 	MainWindow();
@@ -84,7 +85,7 @@ public:
 	void OnShowChannelChooser(wxCommandEvent& event);
 	void OnShowWriteableDir(wxCommandEvent& event);
 	void forceSettingsFrameClose();
-	void OnUnitSyncReloaded();
+	void OnUnitSyncReloaded(wxCommandEvent& event);
 	void OnChannelList(const wxString& channel, const int& numusers, const wxString& topic);
 	void OnChannelListStart();
 	void OnClose(wxCloseEvent&);
@@ -18,8 +18,10 @@
 #include <lslunitsync/data.h>
 
 #include "utils/conversion.h"
+#include "utils/summedareatable.h"
 #include "uiutils.h"
 #include "mapctrl.h"
+#include "mapimagecache.h"
 #include "user.h"
 #include "ui.h"
 #include "iserver.h"
@@ -90,18 +92,6 @@ END_EVENT_TABLE()
 const int boxsize = 8;
 const int minboxsize = 40;
 
-static inline void WriteInt24(unsigned char* p, int i)
-{
-	p[0] = i & 0xFF;
-	p[1] = (i >> 8) & 0xFF;
-	p[2] = (i >> 16) & 0xFF;
-}
-
-static inline int ReadInt24(const unsigned char* p)
-{
-	return p[0] | (p[1] << 8) | (p[2] << 16);
-}
-
 MapCtrl::MapCtrl(wxWindow* parent, int size, IBattle* battle, bool readonly, bool draw_start_types, bool singleplayer)
     : wxPanel(parent, -1, wxDefaultPosition, wxSize(size, size), wxSIMPLE_BORDER | wxFULL_REPAINT_ON_RESIZE)
     , m_async(boost::bind(&MapCtrl::OnGetMapImageAsyncCompleted, this, _1))
@@ -141,6 +131,7 @@ MapCtrl::MapCtrl(wxWindow* parent, int size, IBattle* battle, bool readonly, boo
 	m_close_img = new wxBitmap(close_xpm);
 	m_close_hi_img = new wxBitmap(close_hi_xpm);
 	m_tmp_brect.ally = -1;
+	ConnectGlobalEvent(this, GlobalEvent::OnUnitsyncReloaded, wxObjectEventFunction(&MapCtrl::OnUnitsyncReloaded));
 }
 
 
@@ -215,43 +206,6 @@ wxRect MapCtrl::GetStartRect(const BattleStartRect& sr) const
 }
 
 
-void MapCtrl::Accumulate(wxImage& image) const
-{
-	if (!image.IsOk())
-		return;
-
-	// Even tho GetData() returns a non-const pointer,
-	// it does not unshare the reference counted data,
-	// so we have to make a copy of the image..
-	image = image.Copy();
-
-	const int w = image.GetWidth();
-	const int h = image.GetHeight();
-	unsigned char* data = image.GetData();
-
-	// sum in vertical direction
-	unsigned char* p = data;
-	for (int x = 0; x < w; ++x, p += 3) {
-		WriteInt24(p, p[0] + p[1] + p[2]);
-	}
-	for (int y = 1; y < h; ++y) {
-		const unsigned char* prev = data + 3 * ((y - 1) * w);
-		unsigned char* curr = data + 3 * (y * w);
-		for (int x = 0; x < w; ++x, prev += 3, curr += 3) {
-			WriteInt24(curr, ReadInt24(prev) + curr[0] + curr[1] + curr[2]);
-		}
-	}
-
-	// sum in horizontal direction
-	for (int x = 1; x < w; ++x) {
-		for (int y = 0; y < h; ++y) {
-			p = data + 3 * (y * w + x);
-			WriteInt24(p, ReadInt24(p) + ReadInt24(p - 3));
-		}
-	}
-}
-
-
 double MapCtrl::GetStartRectMetalFraction(int index) const
 {
 	BattleStartRect sr = m_battle->GetStartRect(index);
@@ -265,27 +219,18 @@ double MapCtrl::GetStartRectMetalFraction(const BattleStartRect& sr) const
 {
 	// todo: this really is *logic*, not rendering code, so it
 	// should go in some other layer sometime (SpringUnitSync?).
-	if (!m_metalmap_cumulative.IsOk())
+	const uint64_t total = m_metalmap_cumulative.Total();
+	if (total == 0)
 		return 0.0;
 
-	int x1, y1, x2, y2, w, h;
-
-	w = m_metalmap_cumulative.GetWidth();
-	h = m_metalmap_cumulative.GetHeight();
-	x1 = std::max(0, std::min(w - 1, int((sr.left * w / 200.0) + 0.5)));
-	y1 = std::max(0, std::min(h - 1, int((sr.top * h / 200.0) + 0.5)));
-	x2 = std::max(0, std::min(w - 1, int((sr.right * w / 200.0) + 0.5)));
-	y2 = std::max(0, std::min(h - 1, int((sr.bottom * h / 200.0) + 0.5)));
+	const int w = m_metalmap_cumulative.GetWidth();
+	const int h = m_metalmap_cumulative.GetHeight();
+	const int x1 = int((sr.left * w / 200.0) + 0.5);
+	const int y1 = int((sr.top * h / 200.0) + 0.5);
+	const int x2 = int((sr.right * w / 200.0) + 0.5);
+	const int y2 = int((sr.bottom * h / 200.0) + 0.5);
 
-	const unsigned char* metalmap = m_metalmap_cumulative.GetData();
-	const int lefttop = ReadInt24(&metalmap[3 * (y1 * w + x1)]);
-	const int righttop = ReadInt24(&metalmap[3 * (y1 * w + x2)]);
-	const int leftbot = ReadInt24(&metalmap[3 * (y2 * w + x1)]);
-	const int rightbot = ReadInt24(&metalmap[3 * (y2 * w + x2)]);
-	// in 2d cumulative distribution total is value at bottom right corner
-	const int total = ReadInt24(&metalmap[3 * (w * h - 1)]);
-
-	return (double)(lefttop + rightbot - righttop - leftbot) / total;
+	return (double)m_metalmap_cumulative.Sum(x1, y1, x2, y2) / total;
 }
 
 
@@ -358,7 +303,7 @@ void MapCtrl::_SetCursor()
 	}
 
 	if (m_battle != 0) {
-		const long longval = LSL::Util::FromString<long>(m_battle->CustomBattleOptions()
+		const long longval = LSL::Util::FromString<long>(m_battle->GetCustomBattleOptions()
 								     .getSingleValue("startpostype", LSL::Enum::EngineOption));
 		if (longval != IBattle::ST_Choose) {
 			SetCursor(wxCursor(wxCURSOR_ARROW));
@@ -464,12 +409,12 @@ int MapCtrl::LoadMinimap()
 			return -2;
 		}
 
-		// start chain of asynchronous map image fetches
-		// first minimap, then metalmap and heightmap
-		m_async.GetMinimap(map, w, h);
-
 		m_mapname = map;
+		m_mapkey = MapImageCache::MakeKey(map, m_battle->GetHostMapHash());
 		m_lastsize = wxSize(w, h);
+
+		FetchMissingImage();
+		UpdateImagesFromCache();
 	} catch (...) {
 		FreeMinimap();
 		return -3;
@@ -486,7 +431,76 @@ void MapCtrl::FreeMinimap()
 	m_metalmap = 0;
 	delete m_heightmap;
 	m_heightmap = 0;
+	m_metalmap_cumulative.Clear();
 	m_mapname = "";
+	m_mapkey = "";
+}
+
+
+//! the first image which isn't cached at the current size, ImageTypeCount if there is none
+MapImageCache::ImageType MapCtrl::GetMissingImage(int resolution) const
+{
+	MapImageCache& cache = mapImageCache();
+	for (int type = 0; type < MapImageCache::ImageTypeCount; type++) {
+		// metalmap and heightmap are only shown with start types, e.g. not in the battle list
+		if (type != MapImageCache::Minimap && !m_draw_start_types)
+			break;
+		if (!cache.Contains(m_mapkey, (MapImageCache::ImageType)type, resolution))
+			return (MapImageCache::ImageType)type;
+	}
+	return MapImageCache::ImageTypeCount;
+}
+
+
+//! continues the chain of asynchronous map image fetches: first minimap, then metalmap and heightmap.
+//! m_mutex has to be locked
+void MapCtrl::FetchMissingImage()
+{
+	if (m_mapname.empty())
+		return;
+	const int res = MapImageCache::FetchResolution(m_lastsize.GetWidth(), m_lastsize.GetHeight());
+	switch (GetMissingImage(res)) {
+		case MapImageCache::Minimap:
+			m_async.GetMinimap(m_mapname, res, res);
+			break;
+		case MapImageCache::Metalmap:
+			m_async.GetMetalmap(m_mapname, res, res);
+			break;
+		case MapImageCache::Heightmap:
+			m_async.GetHeightmap(m_mapname, res, res);
+			break;
+		default:
+			break;
+	}
+}
+
+
+//! (re)creates the bitmaps for the current size from the map image cache, m_mutex has to be locked
+void MapCtrl::UpdateImagesFromCache()
+{
+	const int w = m_lastsize.GetWidth();
+	const int h = m_lastsize.GetHeight();
+	if (m_mapname.empty() || w <= 0 || h <= 0)
+		return;
+
+	MapImageCache& cache = mapImageCache();
+	wxBitmap** bitmaps[MapImageCache::ImageTypeCount] = {&m_minimap, &m_metalmap, &m_heightmap};
+	const int types = m_draw_start_types ? MapImageCache::ImageTypeCount : MapImageCache::Minimap + 1;
+	for (int type = 0; type < types; type++) {
+		const wxImage img = cache.Get(m_mapkey, (MapImageCache::ImageType)type, w, h);
+		if (!img.IsOk())
+			continue;
+		delete *bitmaps[type];
+		*bitmaps[type] = new wxBitmap(img);
+	}
+
+	// the metal statistics use the full size metalmap, they don't depend on the control size
+	if (m_draw_start_types && !m_metalmap_cumulative.IsOk()) {
+		const wxImage metalmap = cache.GetFull(m_mapkey, MapImageCache::Metalmap);
+		if (metalmap.IsOk()) {
+			m_metalmap_cumulative.Build(metalmap.GetData(), metalmap.GetWidth(), metalmap.GetHeight());
+		}
+	}
 }
 
 
@@ -502,18 +516,22 @@ void MapCtrl::UpdateMinimap()
 	m_mutex.Lock();
 	if (m_battle) //needs to be looked into, crahses with replaytab (koshi)
 	{
-		bool just_resize = (m_lastsize != wxSize(-1, -1) && m_lastsize != wxSize(w, h));
-		if ((m_mapname != m_battle->GetHostMapName()) || just_resize) {
+		if (m_mapkey != MapImageCache::MakeKey(m_battle->GetHostMapName(), m_battle->GetHostMapHash())) {
 			FreeMinimap();
 			int loaded_ok = LoadMinimap();
 
-			if (!just_resize && loaded_ok == 0) // if a new map is loaded, reset start positions
+			if (loaded_ok == 0) // if a new map is loaded, reset start positions
 			{
-				const long longval = LSL::Util::FromString<long>(m_battle->CustomBattleOptions()
+				const long longval = LSL::Util::FromString<long>(m_battle->GetCustomBattleOptions()
 										     .getSingleValue("startpostype", LSL::Enum::EngineOption));
 				if (longval == IBattle::ST_Pick)
 					RelocateUsers();
 			}
+		} else if (m_lastsize != wxSize(w, h) && w * h > 0) {
+			// rescale the cached images, unitsync is only asked again if the control grew a lot
+			m_lastsize = wxSize(w, h);
+			FetchMissingImage();
+			UpdateImagesFromCache();
 		}
 	}
 	m_mutex.Unlock();
@@ -757,7 +775,7 @@ void MapCtrl::DrawStartPositions(wxDC& dc)
 	wxRect mr = GetMinimapRect();
 	m_map = m_battle->LoadMap();
 	RequireImages();
-	const long longval = LSL::Util::FromString<long>(m_battle->CustomBattleOptions()
+	const long longval = LSL::Util::FromString<long>(m_battle->GetCustomBattleOptions()
 							     .getSingleValue("startpostype", LSL::Enum::EngineOption));
 	if (longval == IBattle::ST_Fixed) {
 
@@ -1041,7 +1059,7 @@ void MapCtrl::OnPaint(wxPaintEvent& WXUNUSED(event))
 
 	if (!m_minimap)
 		return;
-	const long longval = LSL::Util::FromString<long>(m_battle->CustomBattleOptions()
+	const long longval = LSL::Util::FromString<long>(m_battle->GetCustomBattleOptions()
 							     .getSingleValue("startpostype", LSL::Enum::EngineOption));
 
 
@@ -1082,7 +1100,7 @@ void MapCtrl::OnMouseMove(wxMouseEvent& event)
 		return;
 	if (p == wxDefaultPosition)
 		return;
-	const long longval = LSL::Util::FromString<long>(m_battle->CustomBattleOptions()
+	const long longval = LSL::Util::FromString<long>(m_battle->GetCustomBattleOptions()
 							     .getSingleValue("startpostype", LSL::Enum::EngineOption));
 
 	if (longval == IBattle::ST_Pick) {
@@ -1284,7 +1302,7 @@ void MapCtrl::OnLeftDown(wxMouseEvent& event)
 	if (m_battle == 0)
 		return;
 
-	const long longval = LSL::Util::FromString<long>(m_battle->CustomBattleOptions()
+	const long longval = LSL::Util::FromString<long>(m_battle->GetCustomBattleOptions()
 							     .getSingleValue("startpostype", LSL::Enum::EngineOption));
 
 	if (!m_ro) {
@@ -1356,6 +1374,7 @@ void MapCtrl::OnLeftDown(wxMouseEvent& event)
 		if (m_mover_rect >= 0) {
 			// Join ally rect that user clicked on
 			m_battle->GetMe().BattleStatus().ally = m_mover_rect;
+			m_battle->InvalidateScript(IBattle::ScriptCache::RosterMask());
 		}
 		m_maction = None;
 	}
@@ -1367,7 +1386,7 @@ void MapCtrl::OnLeftUp(wxMouseEvent& event)
 	if (m_battle == 0)
 		return;
 
-	const long longval = LSL::Util::FromString<long>(m_battle->CustomBattleOptions()
+	const long longval = LSL::Util::FromString<long>(m_battle->GetCustomBattleOptions()
 							     .getSingleValue("startpostype", LSL::Enum::EngineOption));
 	if (longval == IBattle::ST_Pick) {
 		if (!m_user_expanded)
@@ -1383,22 +1402,22 @@ void MapCtrl::OnLeftUp(wxMouseEvent& event)
 		if ((m_mdown_area == Move) && (m_maction == Moved)) {
 			m_battle->UserPositionChanged(user);
 		} else if (m_mdown_area == UpAllyButton) {
-			user.BattleStatus().ally = (user.BattleStatus().ally + 1) % SPRING_MAX_ALLIES;
+			m_battle->ForceAlly(user, (user.BattleStatus().ally + 1) % SPRING_MAX_ALLIES);
 			RefreshRect(GetUserRect(user, true), false);
 
 		} else if (m_mdown_area == DownAllyButton) {
-			user.BattleStatus().ally = (user.BattleStatus().ally - 1) >= 0 ? (user.BattleStatus().ally - 1) : (SPRING_MAX_ALLIES - 1);
+			m_battle->ForceAlly(user, (user.BattleStatus().ally - 1) >= 0 ? (user.BattleStatus().ally - 1) : (SPRING_MAX_ALLIES - 1));
 			RefreshRect(GetUserRect(user, true), false);
 
 		} else if (m_mdown_area == UpHandicapButton) {
 			if (user.BattleStatus().handicap == 100)
-				user.BattleStatus().handicap = 0;
+				m_battle->SetHandicap(user, 0);
 			else
-				user.BattleStatus().handicap = (user.BattleStatus().handicap + 5);
+				m_battle->SetHandicap(user, user.BattleStatus().handicap + 5);
 			RefreshRect(GetUserRect(user, true), false);
 
 		} else if (m_mdown_area == DownHandicapButton) {
-			user.BattleStatus().handicap = (user.BattleStatus().handicap - 5) >= 0 ? (user.BattleStatus().handicap - 5) : 100;
+			m_battle->SetHandicap(user, (user.BattleStatus().handicap - 5) >= 0 ? (user.BattleStatus().handicap - 5) : 100);
 			RefreshRect(GetUserRect(user, true), false);
 
 		} else if (m_mdown_area == Side) {
@@ -1406,9 +1425,9 @@ void MapCtrl::OnLeftUp(wxMouseEvent& event)
 				const auto sides = LSL::usync().GetSides(m_battle->GetHostModName());
 				const unsigned int sidecount = sides.size();
 				if (sidecount > 0)
-					user.BattleStatus().side = (user.BattleStatus().side + 1) % sidecount;
+					m_battle->ForceSide(user, (user.BattleStatus().side + 1) % sidecount);
 				else
-					user.BattleStatus().side = 0;
+					m_battle->ForceSide(user, 0);
 			} catch (...) {
 			}
 			RefreshRect(GetUserRect(user, true), false);
@@ -1480,7 +1499,7 @@ void MapCtrl::OnRightUp(wxMouseEvent& event)
 	if (p == wxDefaultPosition)
 		return;
 
-	const long longval = LSL::Util::FromString<long>(m_battle->CustomBattleOptions()
+	const long longval = LSL::Util::FromString<long>(m_battle->GetCustomBattleOptions()
 							     .getSingleValue("startpostype", LSL::Enum::EngineOption));
 	if (longval == IBattle::ST_Pick) {
 
@@ -1503,10 +1522,10 @@ void MapCtrl::OnRightUp(wxMouseEvent& event)
 					AddBotDialog dlg(this, m_battle[0], true);
 					if (dlg.ShowModal() == wxID_OK) {
 						UserBattleStatus bs;
-						bs.owner = m_battle->GetMe().GetNick();
-						bs.aishortname = STD_STRING(dlg.GetAIShortName());
-						bs.airawname = STD_STRING(dlg.GetAiRawName());
-						bs.aiversion = STD_STRING(dlg.GetAIVersion());
+						bs.SetOwner(m_battle->GetMe().GetNick());
+						bs.SetAIShortName(STD_STRING(dlg.GetAIShortName()));
+						bs.SetAIRawName(STD_STRING(dlg.GetAiRawName()));
+						bs.SetAIVersion(STD_STRING(dlg.GetAIVersion()));
 						bs.aitype = dlg.GetAIType();
 						bs.team = m_battle->GetFreeTeam();
 						bs.ally = m_battle->GetFreeAlly();
@@ -1515,6 +1534,7 @@ void MapCtrl::OnRightUp(wxMouseEvent& event)
 						ASSERT_LOGIC(&bot != 0, "bot == 0");
 						bot.BattleStatus().pos.x = x;
 						bot.BattleStatus().pos.y = y;
+						m_battle->UserPositionChanged(bot);
 						RefreshRect(GetUserRect(bot, false), false);
 					}
 				}
@@ -1553,24 +1573,24 @@ void MapCtrl::OnGetMapImageAsyncCompleted(const std::string& mapname)
 		return;
 	}
 
-	const int w = m_lastsize.GetWidth();
-	const int h = m_lastsize.GetHeight();
-
-	if (m_minimap == NULL) {
-		m_minimap = new wxBitmap(LSL::usync().GetMinimap(m_mapname, w, h).wxbitmap());
-		// this ensures metalmap and heightmap aren't loaded in battlelist
-		if (m_draw_start_types) {
-			m_async.GetMetalmap(m_mapname, w, h);
-		}
-	} else if (m_metalmap == NULL) {
-		m_metalmap = new wxBitmap(LSL::usync().GetMetalmap(m_mapname, w, h).wxbitmap());
-		// singleplayer mode doesn't allow startboxes anyway
-		m_metalmap_cumulative = LSL::usync().GetMetalmap(m_mapname, w, h).wximage();
-		Accumulate(m_metalmap_cumulative);
-		m_async.GetHeightmap(m_mapname, w, h);
-	} else if (m_heightmap == NULL) {
-		m_heightmap = new wxBitmap(LSL::usync().GetHeightmap(m_mapname, w, h).wxbitmap());
+	const int res = MapImageCache::FetchResolution(m_lastsize.GetWidth(), m_lastsize.GetHeight());
+	MapImageCache& cache = mapImageCache();
+	switch (GetMissingImage(res)) {
+		case MapImageCache::Minimap:
+			cache.Add(m_mapkey, MapImageCache::Minimap, LSL::usync().GetMinimap(m_mapname, res, res).wximage(), res);
+			break;
+		case MapImageCache::Metalmap:
+			cache.Add(m_mapkey, MapImageCache::Metalmap, LSL::usync().GetMetalmap(m_mapname, res, res).wximage(), res);
+			m_metalmap_cumulative.Clear(); // rebuilt from the larger metalmap
+			break;
+		case MapImageCache::Heightmap:
+			cache.Add(m_mapkey, MapImageCache::Heightmap, LSL::usync().GetHeightmap(m_mapname, res, res).wximage(), res);
+			break;
+		default:
+			break;
 	}
+	UpdateImagesFromCache();
+	FetchMissingImage();
 
 	// never ever call a gui function here, it will crash! (in 1/100 cases)
 	wxCommandEvent evt(REFRESH_EVENT, GetId());
@@ -1585,3 +1605,14 @@ void MapCtrl::OnRefresh(wxCommandEvent& /*event*/)
 	assert(wxThread::IsMain());
 	Refresh();
 }
+
+void MapCtrl::OnUnitsyncReloaded(wxCommandEvent& /*event*/)
+{
+	assert(wxThread::IsMain());
+	// the map archives might have changed
+	mapImageCache().Clear();
+	m_mutex.Lock();
+	FreeMinimap();
+	m_mutex.Unlock();
+	UpdateMinimap();
+}
@@ -8,6 +8,9 @@
 #include <wx/panel.h>
 
 #include "ibattle.h"
+#include "mapimagecache.h"
+#include "utils/globalevents.h"
+#include "utils/summedareatable.h"
 #include <lslunitsync/unitsync.h>
 
 #include <wx/thread.h>
@@ -25,7 +28,7 @@ struct UnitsyncMap;
 }
 class BattleRoomTab;
 
-class MapCtrl : public wxPanel
+class MapCtrl : public wxPanel, public GlobalEvent
 {
 
 	enum RectangleArea {
@@ -86,6 +89,7 @@ public:
 	void OnGetMapImageAsyncCompleted(const std::string& mapname);
 
 	void OnRefresh(wxCommandEvent& event);
+	void OnUnitsyncReloaded(wxCommandEvent& event);
 
 	void SetReadOnly(bool readonly)
 	{
@@ -96,6 +100,9 @@ public:
 private:
 	int LoadMinimap();
 	void FreeMinimap();
+	MapImageCache::ImageType GetMissingImage(int resolution) const;
+	void FetchMissingImage();
+	void UpdateImagesFromCache();
 
 	BattleStartRect GetBattleRect(int x1, int y1, int x2, int y2, int ally = -1) const;
 
@@ -116,7 +123,6 @@ private:
 
 	wxRect GetStartRect(int index) const;
 	wxRect GetStartRect(const BattleStartRect& sr) const;
-	void Accumulate(wxImage& image) const;
 	double GetStartRectMetalFraction(int index) const;
 	double GetStartRectMetalFraction(const BattleStartRect& sr) const;
 
@@ -193,11 +199,14 @@ private:
 	wxBitmap* m_minimap;
 	wxBitmap* m_metalmap;
 	wxBitmap* m_heightmap;
-	wxImage m_metalmap_cumulative;
+	//! sum of the metal values, for the metal fraction of start boxes
+	SummedAreaTable m_metalmap_cumulative;
 
 	IBattle* m_battle;
 
 	std::string m_mapname;
+	//! m_mapname and its hash, see MapImageCache::MakeKey
+	std::string m_mapkey;
 
 	bool m_draw_start_types;
 	bool m_ro;
@@ -4,12 +4,14 @@
 #include <wx/geometry.h>
 #include <wx/settings.h>
 #include <wx/log.h>
+#include <wx/filefn.h>
 
 #include "mapgridctrl.h"
 
 #include "settings.h"
 #include "uiutils.h"
 #include "utils/conversion.h"
+#include "utils/slpaths.h"
 
 
 #include <algorithm>
@@ -27,6 +29,10 @@ const int MINIMAP_SIZE = 98;
 /// Margin between the map previews, in pixels.
 const int MINIMAP_MARGIN = 1;
 
+/// Number of thumbnails queued per worker thread, the rest waits in
+/// m_pending_mapimages so priorities can still change while scrolling.
+const int THUMBNAILS_PER_WORKER = 2;
+
 BEGIN_EVENT_TABLE(MapGridCtrl, wxPanel)
 EVT_PAINT(MapGridCtrl::OnPaint)
 EVT_SIZE(MapGridCtrl::OnResize)
@@ -46,9 +52,10 @@ const wxEventType MapGridCtrl::LoadingCompletedEvt = wxNewEventType();
 
 MapGridCtrl::MapGridCtrl(wxWindow* parent, wxSize size, wxWindowID id)
     : wxPanel(parent, id, wxDefaultPosition, size, wxSIMPLE_BORDER | wxFULL_REPAINT_ON_RESIZE)
-    , m_async_image(boost::bind(&MapGridCtrl::OnGetMapImageAsyncCompleted, this, _1))
     , m_async_ex(boost::bind(&MapGridCtrl::OnGetMapExAsyncCompleted, this, _1))
     , m_async_ops_count(0)
+    , m_usync_worker(1)
+    , m_thumbnails_in_flight(0)
     , m_selection_follows_mouse(sett().GetMapSelectorFollowsMouse())
     , m_size(0, 0)
     , m_pos(0, 0)
@@ -71,11 +78,23 @@ MapGridCtrl::MapGridCtrl(wxWindow* parent, wxSize size, wxWindowID id)
 	ASSERT_EXCEPTION(m_img_foreground.HasAlpha(), _T("map_select_2_png must have an alpha channel"));
 
 	m_img_minimap_loading = wxBitmap(BlendImage(m_img_foreground, m_img_background, false));
+
+	const std::string cachepath = SlPaths::GetCachePath();
+	if (!cachepath.empty()) {
+		const std::string dir = cachepath + "thumbnails";
+		if (wxDirExists(TowxString(dir)) || SlPaths::mkDir(dir)) {
+			m_thumbnail_cache.SetDirectory(LSL::Util::EnsureDelimiter(dir), MINIMAP_SIZE);
+		}
+	}
 }
 
 
 MapGridCtrl::~MapGridCtrl()
 {
+	// the workers use this object, so they have to finish first. tasks
+	// which the workers hand to each other are dropped once a pool stopped
+	m_thumbnail_workers.Stop();
+	m_usync_worker.Stop();
 	Clear();
 	m_pending_mapimages.clear();
 	m_pending_mapinfos.clear();
@@ -335,21 +354,22 @@ MapGridCtrl::MapData* MapGridCtrl::GetMaxPriorityMap(std::list<MapData*>& maps)
 
 void MapGridCtrl::UpdateAsyncFetches()
 {
-	if (m_async_ops_count > 2)
-		return;
-	if (!m_pending_mapinfos.empty()) {
+	if (!m_pending_mapinfos.empty() && m_async_ops_count <= 2) {
 		m_async_ops_count++;
 		const MapData* m = GetMaxPriorityMap(m_pending_mapinfos);
 		m_async_ex.GetMap(m->name);
-	} else if (!m_pending_mapimages.empty()) {
+	}
+	const int max_in_flight = THUMBNAILS_PER_WORKER * m_thumbnail_workers.GetThreadCount();
+	while (m_thumbnails_in_flight < max_in_flight && !m_pending_mapimages.empty()) {
 		MapData* m = GetMaxPriorityMap(m_pending_mapimages);
 		if (m->state != MapState_NoMinimap) //FIXME: this shouldn never happen
-			return;
-		m_async_ops_count++;
+			continue;
+		m_thumbnails_in_flight++;
 
 		m->state = MapState_GetMinimap;
-		m_async_image.GetMinimap(m->name, MINIMAP_SIZE, MINIMAP_SIZE);
-	} else {
+		m_thumbnail_workers.Push(boost::bind(&MapGridCtrl::LoadThumbnail, this, m->name, m->hash));
+	}
+	if (m_pending_mapinfos.empty() && m_pending_mapimages.empty()) {
 		wxCommandEvent evt(LoadingCompletedEvt, GetId());
 		evt.SetEventObject(this);
 		wxPostEvent(this, evt);
@@ -522,14 +542,9 @@ void MapGridCtrl::SelectMap(MapData* map)
 	}
 }
 
-void MapGridCtrl::OnGetMapImageAsyncCompleted(const std::string& _mapname)
+wxImage MapGridCtrl::BlendMinimap(const wxImage& minimap_) const
 {
-	// if mapname is empty, some error occurred in LSL::usync().GetMinimap...
-	if (_mapname.empty())
-		return;
-	const wxString mapname = TowxString(_mapname);
-	wxImage minimap(LSL::usync().GetMinimap(_mapname, MINIMAP_SIZE, MINIMAP_SIZE).wximage());
-
+	wxImage minimap(minimap_);
 	const int w = minimap.GetWidth();
 	const int h = minimap.GetHeight();
 	wxImage background(BorderInvariantResizeImage(m_img_background, w, h));
@@ -538,14 +553,59 @@ void MapGridCtrl::OnGetMapImageAsyncCompleted(const std::string& _mapname)
 
 	minimap.SetAlpha(minimap_alpha.GetAlpha(), true /* "static data" */);
 	minimap = BlendImage(minimap, background, false);
-	minimap = BlendImage(foreground, minimap, false);
+	return BlendImage(foreground, minimap, false);
+}
 
-	// set the minimap in all MapMaps
-	m_maps[mapname].minimap = wxBitmap(minimap);
-	m_maps[mapname].state = MapState_GotMinimap;
-	if (m_async_ops_count > 0) //WTF, why is this needed?
-		m_async_ops_count--;
 
+//! runs on a worker thread: reads the cached thumbnail, unitsync is left to FetchThumbnail
+void MapGridCtrl::LoadThumbnail(const std::string& mapname, const std::string& maphash)
+{
+	wxImage image;
+	if (maphash.empty() || !m_thumbnail_cache.Load(maphash, image)) {
+		m_usync_worker.Push(boost::bind(&MapGridCtrl::FetchThumbnail, this, mapname, maphash));
+		return;
+	}
+	Thumbnail thumbnail;
+	thumbnail.mapname = mapname;
+	thumbnail.hash = maphash;
+	thumbnail.blended = true;
+	ToThumbnail(image, thumbnail);
+	PushThumbnail(thumbnail);
+}
+
+
+//! runs on m_usync_worker, so unitsync is only used by one thread at a time
+void MapGridCtrl::FetchThumbnail(const std::string& mapname, const std::string& maphash)
+{
+	Thumbnail thumbnail;
+	thumbnail.mapname = mapname;
+	thumbnail.hash = maphash;
+	thumbnail.blended = false;
+	try {
+		if (thumbnail.hash.empty()) {
+			thumbnail.hash = LSL::usync().GetMap(mapname).hash;
+			const std::string path = m_thumbnail_cache.GetPath(thumbnail.hash);
+			if (!path.empty() && wxFileExists(TowxString(path))) {
+				// decoding the cached png is left to the pool
+				m_thumbnail_workers.Push(boost::bind(&MapGridCtrl::LoadThumbnail, this, mapname, thumbnail.hash));
+				return;
+			}
+		}
+		ToThumbnail(LSL::usync().GetMinimap(mapname, MINIMAP_SIZE, MINIMAP_SIZE).wximage(), thumbnail);
+	} catch (...) {
+		thumbnail.width = 0;
+		thumbnail.height = 0;
+	}
+	PushThumbnail(thumbnail);
+}
+
+
+void MapGridCtrl::PushThumbnail(const Thumbnail& thumbnail)
+{
+	{
+		wxMutexLocker lock(m_thumbnails_mutex);
+		m_loaded_thumbnails.push_back(thumbnail);
+	}
 	// never ever call a gui function here, it will crash! (in 1/100 cases)
 	wxCommandEvent evt(REFRESH_EVENT, GetId());
 	evt.SetEventObject(this);
@@ -553,6 +613,83 @@ void MapGridCtrl::OnGetMapImageAsyncCompleted(const std::string& _mapname)
 }
 
 
+//! runs on a worker thread
+void MapGridCtrl::SaveThumbnail(const std::string& hash, const Thumbnail& thumbnail)
+{
+	m_thumbnail_cache.Save(hash, FromThumbnail(thumbnail));
+}
+
+
+void MapGridCtrl::ToThumbnail(const wxImage& image, Thumbnail& thumbnail)
+{
+	thumbnail.width = 0;
+	thumbnail.height = 0;
+	thumbnail.rgb.clear();
+	thumbnail.alpha.clear();
+	if (!image.IsOk())
+		return;
+	thumbnail.width = image.GetWidth();
+	thumbnail.height = image.GetHeight();
+	const size_t pixels = (size_t)thumbnail.width * thumbnail.height;
+	thumbnail.rgb.assign(image.GetData(), image.GetData() + 3 * pixels);
+	if (image.HasAlpha()) {
+		thumbnail.alpha.assign(image.GetAlpha(), image.GetAlpha() + pixels);
+	}
+}
+
+
+wxImage MapGridCtrl::FromThumbnail(const Thumbnail& thumbnail)
+{
+	if (thumbnail.width <= 0 || thumbnail.height <= 0)
+		return wxImage();
+	wxImage image(thumbnail.width, thumbnail.height, false);
+	std::copy(thumbnail.rgb.begin(), thumbnail.rgb.end(), image.GetData());
+	if (!thumbnail.alpha.empty()) {
+		image.SetAlpha();
+		std::copy(thumbnail.alpha.begin(), thumbnail.alpha.end(), image.GetAlpha());
+	}
+	return image;
+}
+
+
+//! takes the thumbnails finished by the workers, must run on the main thread
+void MapGridCtrl::ProcessLoadedThumbnails()
+{
+	std::list<Thumbnail> loaded;
+	{
+		wxMutexLocker lock(m_thumbnails_mutex);
+		loaded.swap(m_loaded_thumbnails);
+	}
+	if (loaded.empty())
+		return;
+
+	for (std::list<Thumbnail>::const_iterator it = loaded.begin(); it != loaded.end(); ++it) {
+		if (m_thumbnails_in_flight > 0)
+			m_thumbnails_in_flight--;
+		MapMap::iterator map = m_maps.find(TowxString(it->mapname));
+		if (map == m_maps.end())
+			continue;
+
+		wxImage minimap(FromThumbnail(*it));
+		if (!minimap.IsOk()) {
+			// some error occurred in LSL::usync().GetMinimap...
+			map->second.minimap = m_img_minimap_loading;
+		} else {
+			if (!it->blended) {
+				minimap = BlendMinimap(minimap);
+				if (!m_thumbnail_cache.GetPath(it->hash).empty()) {
+					Thumbnail blended;
+					ToThumbnail(minimap, blended);
+					m_thumbnail_workers.Push(boost::bind(&MapGridCtrl::SaveThumbnail, this, it->hash, blended));
+				}
+			}
+			map->second.minimap = wxBitmap(minimap);
+		}
+		map->second.state = MapState_GotMinimap;
+	}
+}
+
+
 void MapGridCtrl::OnGetMapExAsyncCompleted(const std::string& _mapname)
 {
 	// if mapname is empty, some error occurred in LSL::usync().GetMapEx...
@@ -563,9 +700,17 @@ void MapGridCtrl::OnGetMapExAsyncCompleted(const std::string& _mapname)
 	m_maps[mapname].hash = m.hash;
 	m_maps[mapname].info = m.info;
 	m_async_ops_count--;
+
+	wxCommandEvent evt(REFRESH_EVENT, GetId());
+	evt.SetEventObject(this);
+	wxPostEvent(this, evt);
 }
 
 void MapGridCtrl::OnRefresh(wxCommandEvent& /*event*/)
 {
+	ProcessLoadedThumbnails();
+	// keep the fetches going, DrawMap only does so for visible maps
+	if (!m_pending_mapinfos.empty() || !m_pending_mapimages.empty())
+		UpdateAsyncFetches();
 	Refresh();
 }
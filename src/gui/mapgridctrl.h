@@ -6,7 +6,10 @@
 #include <wx/bitmap.h>
 #include <wx/image.h>
 #include <wx/panel.h>
+#include <wx/thread.h>
 #include <lslunitsync/unitsync.h>
+#include "utils/thumbnailcache.h"
+#include "utils/workerpool.h"
 class Ui;
 
 class MapGridCtrl : public wxPanel
@@ -100,6 +103,19 @@ private:
 
 	typedef std::map<wxString, MapData> MapMap;
 
+	//! raw pixels of a minimap, passed from the thumbnail workers to the main thread
+	struct Thumbnail
+	{
+		std::string mapname;
+		std::string hash;
+		int width;
+		int height;
+		std::vector<unsigned char> rgb;
+		std::vector<unsigned char> alpha;
+		//! true if loaded from the disk cache, false if it still needs blending
+		bool blended;
+	};
+
 	// wrapper around the Compare*() methods below to allow changing sort direction
 	template <class Compare>
 	class _Compare2
@@ -143,7 +159,14 @@ private:
 	void _Sort(int dimension, Compare cmp);
 
 private:
-	void OnGetMapImageAsyncCompleted(const std::string& _mapname);
+	void LoadThumbnail(const std::string& mapname, const std::string& hash);
+	void FetchThumbnail(const std::string& mapname, const std::string& hash);
+	void PushThumbnail(const Thumbnail& thumbnail);
+	void SaveThumbnail(const std::string& hash, const Thumbnail& thumbnail);
+	static void ToThumbnail(const wxImage& image, Thumbnail& thumbnail);
+	static wxImage FromThumbnail(const Thumbnail& thumbnail);
+	void ProcessLoadedThumbnails();
+	wxImage BlendMinimap(const wxImage& minimap) const;
 	void OnGetMapExAsyncCompleted(const std::string& _mapname);
 	void UpdateGridSize();
 	void UpdateAsyncFetches();
@@ -156,11 +179,21 @@ private:
 	bool IsInGrid(const std::string& mapname);
 	MapData* GetMaxPriorityMap(std::list<MapData*>& maps);
 
-	LSL::UnitSyncAsyncOps m_async_image;
 	LSL::UnitSyncAsyncOps m_async_ex;
 
 	int m_async_ops_count;
 
+	/// reads and writes the thumbnail cache
+	WorkerPool m_thumbnail_workers;
+	/// a single thread fetching minimaps from unitsync
+	WorkerPool m_usync_worker;
+	int m_thumbnails_in_flight;
+	/// thumbnails finished by the workers, protected by m_thumbnails_mutex
+	std::list<Thumbnail> m_loaded_thumbnails;
+	wxMutex m_thumbnails_mutex;
+	/// disabled if its directory couldn't be created
+	ThumbnailCache m_thumbnail_cache;
+
 	const bool m_selection_follows_mouse;
 
 	/// Set of maps which are queued to be fetched asynchronously.
@@ -0,0 +1,188 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#include "mapimagecache.h"
+
+#include <algorithm>
+
+const int MapImageCache::MaxResolution;
+const int MapImageCache::MinLevelSize;
+const size_t MapImageCache::MaxBytes;
+
+MapImageCache::MapImageCache()
+    : m_bytes(0)
+{
+}
+
+size_t MapImageCache::ImageBytes(const wxImage& image)
+{
+	if (!image.IsOk())
+		return 0;
+	const size_t pixels = (size_t)image.GetWidth() * image.GetHeight();
+	return pixels * (image.HasAlpha() ? 4 : 3);
+}
+
+std::string MapImageCache::MakeKey(const std::string& mapname, const std::string& hash)
+{
+	// '\n' can't be part of an archive name
+	return mapname + '\n' + hash;
+}
+
+int MapImageCache::FetchResolution(int width, int height)
+{
+	const int size = std::max(width, height);
+	int res = MinLevelSize;
+	while (res < size && res < MaxResolution) {
+		res *= 2;
+	}
+	return res;
+}
+
+void MapImageCache::Add(const std::string& key, ImageType type, const wxImage& image, int resolution)
+{
+	if (!image.IsOk() || type < 0 || type >= ImageTypeCount)
+		return;
+
+	// build the pyramid outside the lock, halving until the image gets tiny
+	Pyramid pyramid;
+	pyramid.push_back(image.Copy());
+	while (true) {
+		const wxImage& last = pyramid.back();
+		const int w = last.GetWidth() / 2;
+		const int h = last.GetHeight() / 2;
+		if (std::max(w, h) < MinLevelSize || w < 1 || h < 1)
+			break;
+		pyramid.push_back(last.Scale(w, h, wxIMAGE_QUALITY_HIGH));
+	}
+	size_t bytes = 0;
+	for (size_t i = 0; i < pyramid.size(); i++) {
+		bytes += ImageBytes(pyramid[i]);
+	}
+
+	wxMutexLocker lock(m_mutex);
+	EntryMap::iterator it = m_entries.find(key);
+	if (it == m_entries.end()) {
+		m_lru.push_front(key);
+		Entry entry;
+		std::fill(entry.resolution, entry.resolution + ImageTypeCount, 0);
+		entry.bytes = 0;
+		entry.lru = m_lru.begin();
+		it = m_entries.insert(std::make_pair(key, entry)).first;
+	} else {
+		m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+	}
+	Entry& entry = it->second;
+	for (size_t i = 0; i < entry.images[type].size(); i++) {
+		entry.bytes -= ImageBytes(entry.images[type][i]);
+		m_bytes -= ImageBytes(entry.images[type][i]);
+	}
+	entry.images[type].swap(pyramid);
+	entry.resolution[type] = resolution;
+	entry.bytes += bytes;
+	m_bytes += bytes;
+	Evict();
+}
+
+MapImageCache::Entry* MapImageCache::Find(const std::string& key)
+{
+	EntryMap::iterator it = m_entries.find(key);
+	if (it == m_entries.end())
+		return NULL;
+	m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+	return &it->second;
+}
+
+wxImage MapImageCache::Get(const std::string& key, ImageType type, int width, int height)
+{
+	if (width <= 0 || height <= 0 || type < 0 || type >= ImageTypeCount)
+		return wxImage();
+
+	wxImage source;
+	int w = 0, h = 0;
+	{
+		wxMutexLocker lock(m_mutex);
+		Entry* entry = Find(key);
+		if (entry == NULL || entry->images[type].empty())
+			return wxImage();
+		const Pyramid& pyramid = entry->images[type];
+
+		// fit into width x height, keeping the aspect ratio of the map
+		const wxImage& full = pyramid.front();
+		const int fw = full.GetWidth();
+		const int fh = full.GetHeight();
+		if ((long)fw * height > (long)fh * width) {
+			w = width;
+			h = std::max(1, (int)((long)fh * width / fw));
+		} else {
+			h = height;
+			w = std::max(1, (int)((long)fw * height / fh));
+		}
+
+		size_t level = 0;
+		while (level + 1 < pyramid.size() && pyramid[level + 1].GetWidth() >= w && pyramid[level + 1].GetHeight() >= h) {
+			level++;
+		}
+		// wxImage isn't thread-safe reference counted, so hand out a real copy
+		source = pyramid[level].Copy();
+	}
+
+	if (source.GetWidth() == w && source.GetHeight() == h)
+		return source;
+	// the source level is less than twice the target size, which keeps this cheap
+	return source.Scale(w, h, wxIMAGE_QUALITY_HIGH);
+}
+
+wxImage MapImageCache::GetFull(const std::string& key, ImageType type)
+{
+	if (type < 0 || type >= ImageTypeCount)
+		return wxImage();
+	wxMutexLocker lock(m_mutex);
+	Entry* entry = Find(key);
+	if (entry == NULL || entry->images[type].empty())
+		return wxImage();
+	return entry->images[type].front().Copy();
+}
+
+bool MapImageCache::Contains(const std::string& key, ImageType type, int resolution)
+{
+	if (type < 0 || type >= ImageTypeCount)
+		return false;
+	wxMutexLocker lock(m_mutex);
+	EntryMap::const_iterator it = m_entries.find(key);
+	return it != m_entries.end() && !it->second.images[type].empty() && it->second.resolution[type] >= resolution;
+}
+
+void MapImageCache::Remove(const std::string& key)
+{
+	wxMutexLocker lock(m_mutex);
+	EntryMap::iterator it = m_entries.find(key);
+	if (it == m_entries.end())
+		return;
+	m_bytes -= it->second.bytes;
+	m_lru.erase(it->second.lru);
+	m_entries.erase(it);
+}
+
+void MapImageCache::Clear()
+{
+	wxMutexLocker lock(m_mutex);
+	m_entries.clear();
+	m_lru.clear();
+	m_bytes = 0;
+}
+
+//! drops the least recently used maps, the most recent one is always kept
+void MapImageCache::Evict()
+{
+	while (m_bytes > MaxBytes && m_lru.size() > 1) {
+		EntryMap::iterator it = m_entries.find(m_lru.back());
+		m_bytes -= it->second.bytes;
+		m_entries.erase(it);
+		m_lru.pop_back();
+	}
+}
+
+MapImageCache& mapImageCache()
+{
+	static MapImageCache s_mapImageCache;
+	return s_mapImageCache;
+}
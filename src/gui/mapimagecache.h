@@ -0,0 +1,88 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#ifndef SPRINGLOBBY_HEADERGUARD_MAPIMAGECACHE_H
+#define SPRINGLOBBY_HEADERGUARD_MAPIMAGECACHE_H
+
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+#include <wx/image.h>
+#include <wx/thread.h>
+
+//! Keeps decoded map images in memory, so resizing a map view doesn't hit unitsync.
+//! Every image is stored as a pyramid (full size, half, quarter, ...), a request
+//! is served by rescaling the smallest level which is at least as large.
+//! Images are fetched at the resolution they're displayed with (see FetchResolution),
+//! a view growing beyond it fetches again. Maps are keyed by name and hash
+//! (see MakeKey) and evicted least recently used first once MaxBytes is exceeded.
+//! The owner has to Clear() the cache when unitsync was reloaded.
+//! This class is thread-safe
+class MapImageCache
+{
+public:
+	enum ImageType {
+		Minimap,
+		Metalmap,
+		Heightmap,
+		ImageTypeCount
+	};
+
+	//! largest size images are fetched from unitsync with
+	static const int MaxResolution = 1024;
+	//! smallest pyramid level
+	static const int MinLevelSize = 32;
+	static const size_t MaxBytes = 64 * 1024 * 1024;
+
+	MapImageCache();
+
+	//! the key of a map, maps with the same name but another hash are kept apart
+	static std::string MakeKey(const std::string& mapname, const std::string& hash);
+	//! the resolution to fetch images displayed in @p width x @p height with, rounded up
+	//! to a power of two, so small resizes don't fetch again
+	static int FetchResolution(int width, int height);
+
+	//! stores the full size @p image of map @p key, which was fetched at @p resolution
+	void Add(const std::string& key, ImageType type, const wxImage& image, int resolution);
+	//! @return the cached image scaled to fit into @p width x @p height, keeping the aspect ratio.
+	//! The returned image isn't shared with the cache, an invalid image is returned on a miss.
+	wxImage Get(const std::string& key, ImageType type, int width, int height);
+	//! @return a copy of the full size image or an invalid one
+	wxImage GetFull(const std::string& key, ImageType type);
+	//! true if the image was fetched at @p resolution or larger
+	bool Contains(const std::string& key, ImageType type, int resolution = 0);
+
+	void Remove(const std::string& key);
+	void Clear();
+
+	size_t GetBytes() const
+	{
+		return m_bytes;
+	}
+
+private:
+	typedef std::vector<wxImage> Pyramid;
+	struct Entry
+	{
+		Pyramid images[ImageTypeCount];
+		int resolution[ImageTypeCount];
+		size_t bytes;
+		std::list<std::string>::iterator lru;
+	};
+	typedef std::map<std::string, Entry> EntryMap;
+
+	//! @return the entry for key and marks it as recently used, NULL on a miss
+	Entry* Find(const std::string& key);
+	void Evict();
+	static size_t ImageBytes(const wxImage& image);
+
+	wxMutex m_mutex;
+	EntryMap m_entries;
+	//! most recently used map first
+	std::list<std::string> m_lru;
+	size_t m_bytes;
+};
+
+MapImageCache& mapImageCache();
+
+#endif // SPRINGLOBBY_HEADERGUARD_MAPIMAGECACHE_H
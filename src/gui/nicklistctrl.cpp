@@ -299,7 +299,8 @@ int NickListCtrl::GetItemColumnImage(long item, long column) const
 			case 0:
 				return user.GetStatusIconIndex();
 			case 1:
-				return user.GetFlagIconIndex();
+				// looked up here, so flags are only loaded for visible users
+				return icons().GetFlagIcon(user.GetCountry());
 			case 2:
 				return user.GetRankIconIndex();
 
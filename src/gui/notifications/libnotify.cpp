@@ -10,34 +10,89 @@
 #include "utils/version.h"
 
 #include <wx/log.h>
+#include <boost/bind.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
 #include <libnotify/notify.h>
 
 
+//! time the destructor waits for a notification which is being shown
+static const int QUIT_TIMEOUT_MS = 1000;
+
 LibnotifyNotification::LibnotifyNotification(wxWindow*)
+    : m_queue(new Queue())
 {
+	m_thread = boost::thread(boost::bind(&LibnotifyNotification::Run, m_queue));
 }
 LibnotifyNotification::~LibnotifyNotification()
 {
+	{
+		boost::mutex::scoped_lock lock(m_queue->mutex);
+		m_queue->quit = true;
+	}
+	m_queue->cond.notify_one();
+	// don't hang on quit if the notification daemon doesn't answer, the worker cleans up once it returns
+	if (!m_thread.timed_join(boost::posix_time::milliseconds(QUIT_TIMEOUT_MS))) {
+		wxLogDebug(_T("Notification daemon doesn't respond, not waiting for it."));
+		m_thread.detach();
+	}
 }
 
 void LibnotifyNotification::Show(const wxBitmap& icon, const size_t /*pos*/, const UiEvents::NotficationData& data)
 {
-	NotifyNotification* n;
-	notify_init("Test");
-#if !defined(NOTIFY_VERSION_MINOR) || (NOTIFY_VERSION_MAJOR == 0 && NOTIFY_VERSION_MINOR < 7)
-	n = notify_notification_new(getSpringlobbyName().c_str(), data.second.mb_str(), NULL, NULL);
-#else
-	n = notify_notification_new(getSpringlobbyName().c_str(), data.second.mb_str(), NULL);
+	Job job;
+	job.text = std::string(data.message.mb_str());
+	job.icon = NULL;
+#ifndef __APPLE__ //FIXME: apple has no icon.GetPixbuf(), see #258
+	job.icon = icon.GetPixbuf();
+	if (job.icon != NULL)
+		g_object_ref(G_OBJECT(job.icon));
 #endif
-	notify_notification_set_timeout(n, sett().GetNotificationPopupDisplayTime() * 1000);
+	job.timeout = sett().GetNotificationPopupDisplayTime() * 1000;
+	{
+		boost::mutex::scoped_lock lock(m_queue->mutex);
+		m_queue->jobs.push_back(job);
+	}
+	m_queue->cond.notify_one();
+}
 
-#ifndef __APPLE__ //FIXME: apple has no icon.GetPixbuf(), see #258
-	notify_notification_set_icon_from_pixbuf(n, icon.GetPixbuf());
+void LibnotifyNotification::Run(QueuePtr queue)
+{
+	notify_init(getSpringlobbyName().c_str());
+	while (true) {
+		Job job;
+		{
+			boost::mutex::scoped_lock lock(queue->mutex);
+			while (queue->jobs.empty() && !queue->quit) {
+				queue->cond.wait(lock);
+			}
+			if (queue->quit)
+				break;
+			job = queue->jobs.front();
+			queue->jobs.pop_front();
+		}
+
+		NotifyNotification* n;
+#if !defined(NOTIFY_VERSION_MINOR) || (NOTIFY_VERSION_MAJOR == 0 && NOTIFY_VERSION_MINOR < 7)
+		n = notify_notification_new(getSpringlobbyName().c_str(), job.text.c_str(), NULL, NULL);
+#else
+		n = notify_notification_new(getSpringlobbyName().c_str(), job.text.c_str(), NULL);
 #endif
-	if (!notify_notification_show(n, NULL)) {
-		wxLogWarning(_T("Failed to send notification."));
+		notify_notification_set_timeout(n, job.timeout);
+		if (job.icon != NULL) {
+			notify_notification_set_icon_from_pixbuf(n, job.icon);
+			g_object_unref(G_OBJECT(job.icon));
+		}
+		if (!notify_notification_show(n, NULL)) {
+			wxLogWarning(_T("Failed to send notification."));
+		}
+		g_object_unref(G_OBJECT(n));
+	}
+	// nothing is pushed anymore once quit is set
+	for (const Job& job : queue->jobs) {
+		if (job.icon != NULL)
+			g_object_unref(G_OBJECT(job.icon));
 	}
-	g_object_unref(G_OBJECT(n));
+	notify_uninit();
 }
 
 #endif // HAVE_LIBNOTIFY
@@ -2,10 +2,45 @@
 
 #include "inotification.h"
 
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/shared_ptr.hpp>
+#include <deque>
+#include <string>
+
+typedef struct _GdkPixbuf GdkPixbuf;
+
+//! shows notifications from a worker thread, so a slow notification daemon doesn't block the ui
 class LibnotifyNotification : public INotification
 {
 public:
 	LibnotifyNotification(wxWindow* parent);
 	virtual ~LibnotifyNotification();
 	virtual void Show(const wxBitmap& icon, const size_t pos, const UiEvents::NotficationData& data);
+
+private:
+	struct Job
+	{
+		std::string text;
+		GdkPixbuf* icon; //!< referenced, released by the worker
+		int timeout;
+	};
+	//! shared with the worker, which may outlive this object if the daemon hangs
+	struct Queue
+	{
+		Queue()
+		    : quit(false)
+		{
+		}
+		std::deque<Job> jobs;
+		bool quit;
+		boost::mutex mutex;
+		boost::condition_variable cond;
+	};
+	typedef boost::shared_ptr<Queue> QueuePtr;
+	static void Run(QueuePtr queue);
+
+	QueuePtr m_queue;
+	boost::thread m_thread;
 };
@@ -58,6 +58,8 @@ NotificationManager::~NotificationManager()
 
 void NotificationManager::OnQuit(wxCommandEvent& /*data*/)
 {
+	m_rate_limit_timer.Stop();
+	m_pending.Clear();
 	delete m_notification_wrapper;
 	m_notification_wrapper = NULL;
 }
@@ -65,7 +67,7 @@ void NotificationManager::OnQuit(wxCommandEvent& /*data*/)
 void NotificationManager::OnShowNotification(UiEvents::NotficationData data)
 {
 	if (m_rate_limit_timer.IsRunning()) {
-		m_eventDataBuffer.push_back(data);
+		m_pending.Push(data);
 		return;
 	}
 	ShowNotification(data);
@@ -78,8 +80,9 @@ void NotificationManager::ShowNotification(const UiEvents::NotficationData& data
 		const bool disable_if_ingame = cfg().ReadBool(_T("/GUI/NotificationPopupDisableIngame"));
 		if (m_notification_wrapper && !(disable_if_ingame && spring().IsRunning())) {
 			//! \todo use image from customizations
-			wxBitmap nmp(charArr2wxBitmap(springlobby_64_png, sizeof(springlobby_64_png)));
-			m_notification_wrapper->Show(nmp, sett().GetNotificationPopupPosition(), data);
+			if (!m_icon.IsOk())
+				m_icon = charArr2wxBitmap(springlobby_64_png, sizeof(springlobby_64_png));
+			m_notification_wrapper->Show(m_icon, sett().GetNotificationPopupPosition(), data);
 		}
 	}
 	if (sett().GetChatPMSoundNotificationEnabled())
@@ -88,13 +91,10 @@ void NotificationManager::ShowNotification(const UiEvents::NotficationData& data
 
 void NotificationManager::OnTimer(wxTimerEvent& /*event*/)
 {
+	// one notification per interval, the others stay queued and keep collecting events
 	UiEvents::NotficationData data;
-	if (!m_eventDataBuffer.empty()) {
-		if (m_eventDataBuffer.size() == 1)
-			data = m_eventDataBuffer.front();
-		else
-			data.second = wxString::Format(_("%d more events"), (int)m_eventDataBuffer.size());
-		m_eventDataBuffer.clear();
-		ShowNotification(data);
-	}
+	if (!m_pending.Pop(data))
+		return;
+	ShowNotification(data);
+	m_rate_limit_timer.Start(m_rate_limit_ms, wxTIMER_ONE_SHOT);
 }
@@ -4,13 +4,14 @@
 #define NOTIFICATIONMANAGER_H
 
 
+#include "notificationqueue.h"
 #include "utils/uievents.h"
 #include "utils/globalevents.h"
 #include "utils/mixins.h"
 #include <lslutils/globalsmanager.h>
 #include <wx/timer.h>
 #include <wx/event.h>
-#include <vector>
+#include <wx/bitmap.h>
 
 class INotification;
 
@@ -29,9 +30,9 @@ private:
 
 	wxTimer m_rate_limit_timer;
 	const unsigned int m_rate_limit_ms;
-	typedef std::vector<UiEvents::NotficationData>
-	    EventDataBuffer;
-	EventDataBuffer m_eventDataBuffer;
+	//! events which arrived while the rate limit was active
+	NotificationQueue m_pending;
+	wxBitmap m_icon; //!< decoded on first use
 
 	void OnTimer(wxTimerEvent& /*event*/);
 	void ShowNotification(const UiEvents::NotficationData& data);
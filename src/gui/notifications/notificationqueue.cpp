@@ -0,0 +1,50 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#include "notificationqueue.h"
+
+#include <wx/intl.h>
+
+const size_t NotificationQueue::MaxPending;
+
+void NotificationQueue::Push(const UiEvents::NotficationData& data)
+{
+	for (Entry& entry : m_entries) {
+		if ((entry.data.type == data.type) && (entry.data.source == data.source)) {
+			entry.data = data;
+			entry.count++;
+			return;
+		}
+	}
+	if (m_entries.size() >= MaxPending) {
+		Entry& last = m_entries.back();
+		last.data = UiEvents::NotficationData(data.type, data.message);
+		last.count++;
+		return;
+	}
+	Entry entry = {data, 1};
+	m_entries.push_back(entry);
+}
+
+bool NotificationQueue::Pop(UiEvents::NotficationData& data)
+{
+	if (m_entries.empty())
+		return false;
+	data = Collapse(m_entries.front());
+	m_entries.pop_front();
+	return true;
+}
+
+UiEvents::NotficationData NotificationQueue::Collapse(const Entry& entry)
+{
+	if (entry.count == 1)
+		return entry.data;
+	wxString summary;
+	if (entry.data.source.StartsWith(_T("#"))) {
+		summary = wxString::Format(_("%d new mentions in %s"), entry.count, entry.data.source.c_str());
+	} else if (!entry.data.source.empty()) {
+		summary = wxString::Format(_("%d new messages from %s"), entry.count, entry.data.source.c_str());
+	} else {
+		summary = wxString::Format(_("%d new events"), entry.count);
+	}
+	return UiEvents::NotficationData(entry.data.type, summary + _T("\n") + entry.data.message, entry.data.source);
+}
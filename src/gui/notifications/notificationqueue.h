@@ -0,0 +1,46 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#ifndef SPRINGLOBBY_NOTIFICATIONQUEUE_H
+#define SPRINGLOBBY_NOTIFICATIONQUEUE_H
+
+#include "utils/uievents.h"
+#include <deque>
+
+/** @brief Notifications waiting for the rate limit.
+ *
+ * Events of the same type and source are merged into one entry which counts
+ * them and keeps the latest message. At most MaxPending entries are kept,
+ * once that many are queued further sources are merged into the newest entry,
+ * which then loses its source.
+ */
+class NotificationQueue
+{
+public:
+	static const size_t MaxPending = 10;
+
+	struct Entry
+	{
+		UiEvents::NotficationData data; //!< the latest event
+		int count;
+	};
+
+	void Push(const UiEvents::NotficationData& data);
+	//! removes the oldest entry, @return false if the queue is empty
+	bool Pop(UiEvents::NotficationData& data);
+	void Clear()
+	{
+		m_entries.clear();
+	}
+	size_t GetCount() const
+	{
+		return m_entries.size();
+	}
+
+	//! @return one notification summarizing @p entry
+	static UiEvents::NotficationData Collapse(const Entry& entry);
+
+private:
+	std::deque<Entry> m_entries;
+};
+
+#endif // SPRINGLOBBY_NOTIFICATIONQUEUE_H
@@ -26,7 +26,7 @@ void ToasterNotification::Show(const wxBitmap& /*icon*/, const size_t pos, const
 	//	m_toasterbox->SetPopupBitmap( icon );
 	//call this before showing everytime to accout for desktop resolution changes
 	SetPopupPosition(pos);
-	m_toasterbox->SetPopupText(data.second, false);
+	m_toasterbox->SetPopupText(data.message, false);
 	m_toasterbox->Play();
 }
 
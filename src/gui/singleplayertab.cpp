@@ -314,10 +314,10 @@ void SinglePlayerTab::OnAddBot(wxCommandEvent& /*unused*/)
 	AddBotDialog dlg(this, m_battle, true);
 	if (dlg.ShowModal() == wxID_OK) {
 		UserBattleStatus bs;
-		bs.owner = m_battle.GetMe().GetNick();
-		bs.aishortname = STD_STRING(dlg.GetAIShortName());
-		bs.airawname = STD_STRING(dlg.GetAiRawName());
-		bs.aiversion = STD_STRING(dlg.GetAIVersion());
+		bs.SetOwner(m_battle.GetMe().GetNick());
+		bs.SetAIShortName(STD_STRING(dlg.GetAIShortName()));
+		bs.SetAIRawName(STD_STRING(dlg.GetAiRawName()));
+		bs.SetAIVersion(STD_STRING(dlg.GetAIVersion()));
 		bs.aitype = dlg.GetAIType();
 		bs.team = m_battle.GetFreeTeam();
 		bs.ally = m_battle.GetFreeAlly();
@@ -372,7 +372,7 @@ void SinglePlayerTab::OnRandomCheck(wxCommandEvent& /*unused*/)
 
 void SinglePlayerTab::OnSpectatorCheck(wxCommandEvent& /*unused*/)
 {
-	m_battle.GetMe().BattleStatus().spectator = m_spectator_check->IsChecked();
+	m_battle.ForceSpectator(m_battle.GetMe(), m_spectator_check->IsChecked());
 	UpdateMinimap();
 }
 
@@ -787,6 +787,7 @@ void Ui::OnUserLeftBattle(IBattle& battle, User& user, bool isbot)
 		return;
 	user.SetSideiconIndex(-1);    //just making sure he's not running around with some icon still set
 	user.BattleStatus().side = 0; // and reset side, so after rejoin we don't potentially stick with a num higher than avail
+	battle.InvalidateScript(IBattle::ScriptCache::Mask(IBattle::ScriptCache::SECTION_TEAMS));
 	mw().GetBattleListTab().UpdateBattle(battle);
 	try {
 		if (mw().GetJoinTab().GetBattleRoomTab().GetBattle() == &battle) {
@@ -14,9 +14,9 @@ EVT_TEXT_ENTER(wxID_ANY, wxTextCtrlHist::OnSendMessage)
 EVT_KEY_DOWN(wxTextCtrlHist::OnChar)
 END_EVENT_TABLE()
 
-void GetArrayStringFromHashMap(const HashMap_String_String& hm, wxArrayString& matches)
+void GetArrayStringFromMatches(const TextCompletionMatches& hm, wxArrayString& matches)
 {
-	for (HashMap_String_String::const_iterator it = hm.begin(); it != hm.end(); ++it)
+	for (TextCompletionMatches::const_iterator it = hm.begin(); it != hm.end(); ++it)
 		matches.Add(it->second);
 }
 
@@ -98,7 +98,7 @@ void wxTextCtrlHist::OnChar(wxKeyEvent& event)
 				wxString selection_Begin_BeforeCurrentWord = this->GetRange(0, pos_Cursor - currentWord.length());
 				// std::cout << "#########: selection_Begin_BeforeCurrentWord: (" << selection_Begin_BeforeCurrentWord.char_str() << ")" << std::endl;
 
-				HashMap_String_String hm = textcompletiondatabase.GetMapping(currentWord);
+				const TextCompletionMatches hm = textcompletiondatabase.GetMapping(currentWord);
 
 				// std::cout << "#########: Mapping-Size: (" << hm.size() << ")" << std::endl;
 
@@ -113,7 +113,7 @@ void wxTextCtrlHist::OnChar(wxKeyEvent& event)
 					//match nearest only makes sense when there's actually more than one match
 					if (hm.size() > 1 && sett().GetCompletionMethod() == Settings::MatchNearest) {
 						wxArrayString matches;
-						GetArrayStringFromHashMap(hm, matches);
+						GetArrayStringFromMatches(hm, matches);
 						wxString newWord = GetBestMatch(matches, currentWord);
 
 						bool realCompletion = newWord.Len() >= currentWord.Len(); // otherwise we have actually less word than before :P
@@ -14,7 +14,6 @@ lsl/battle/ibattle.cpp
 **/
 
 
-#include <wx/tokenzr.h>
 #include <wx/log.h>
 
 #include <list>
@@ -37,6 +36,8 @@ lsl/battle/ibattle.cpp
 #include "serverselector.h"
 #include "log.h"
 #include "utils/lslconversion.h"
+#include "utils/colourassigner.h"
+#include "optionspreset.h"
 
 
 IBattle::IBattle()
@@ -106,63 +107,17 @@ int IBattle::GetPlayerNum(const User& user) const
 	return -1;
 }
 
-class DismissColor
-{
-private:
-	typedef std::vector<LSL::lslColor>
-	    ColorVec;
-	const ColorVec& m_other;
-
-public:
-	DismissColor(const ColorVec& other)
-	    : m_other(other)
-	{
-	}
-
-	bool operator()(LSL::lslColor to_check)
-	{
-		return std::find(m_other.begin(), m_other.end(), to_check) != m_other.end();
-	}
-};
-
-class AreColoursSimilarProxy
-{
-	int m_mindiff;
-
-public:
-	AreColoursSimilarProxy(int mindiff)
-	    : m_mindiff(mindiff)
-	{
-	}
-
-	bool operator()(LSL::lslColor a, LSL::lslColor b)
-	{
-		return AreColoursSimilar(a, b, m_mindiff);
-	}
-};
-
 LSL::lslColor IBattle::GetFreeColour(User*) const
 {
-	typedef std::vector<LSL::lslColor>
-	    ColorVec;
-
-	ColorVec current_used_colors;
+	// the colour farthest away from every colour in use
+	ColourAssigner assigner;
 	for (user_map_t::size_type i = 0; i < GetNumUsers(); ++i) {
-		UserBattleStatus& bs = GetUser(i).BattleStatus();
-		current_used_colors.push_back(bs.colour);
-	}
-
-	int inc = 1;
-	while (true) {
-		ColorVec fixcolourspalette = GetFixColoursPalette(m_teams_sizes.size() + inc++);
-
-		ColorVec::iterator fixcolourspalette_new_end = std::unique(fixcolourspalette.begin(), fixcolourspalette.end(), AreColoursSimilarProxy(20));
-
-		fixcolourspalette_new_end = std::remove_if(fixcolourspalette.begin(), fixcolourspalette.end(), DismissColor(current_used_colors));
-
-		if (fixcolourspalette_new_end != fixcolourspalette.begin())
-			return (*fixcolourspalette.begin());
+		const LSL::lslColor& col = GetUser(i).BattleStatus().colour;
+		assigner.AddFixed(RGBColour(col.Red(), col.Green(), col.Blue()));
 	}
+	assigner.AddPlayer();
+	const RGBColour col = assigner.Assign()[0];
+	return LSL::lslColor(col.r, col.g, col.b);
 }
 
 LSL::lslColor IBattle::GetFreeColour(User& for_whom) const
@@ -202,25 +157,9 @@ int IBattle::GetFreeTeam(bool excludeme) const
 	return lowest;
 }
 
-int IBattle::GetClosestFixColour(const LSL::lslColor& col, const std::vector<int>& excludes, int difference) const
-{
-	std::vector<LSL::lslColor> palette = GetFixColoursPalette(m_teams_sizes.size() + 1);
-	int result = 0;
-	int t1 = palette.size();
-	int t2 = excludes.size();
-	wxLogMessage(_T("GetClosestFixColour %d %d"), t1, t2);
-	for (size_t i = 0; i < palette.size(); ++i) {
-		if ((i >= excludes.size()) || (!excludes[i])) {
-			if (AreColoursSimilar(palette[i], col, difference)) {
-				return i;
-			}
-		}
-	}
-	return result;
-}
-
 User& IBattle::OnUserAdded(User& user)
 {
+	InvalidateScript(ScriptCache::RosterMask());
 	UserList::AddUser(user);
 	UserBattleStatus& bs = user.BattleStatus();
 	bs.spectator = false;
@@ -281,6 +220,7 @@ unsigned int IBattle::GetNumActivePlayers() const
 
 void IBattle::OnUserBattleStatusUpdated(User& user, UserBattleStatus status)
 {
+	InvalidateScript(ScriptCache::RosterMask());
 
 	UserBattleStatus previousstatus = user.BattleStatus();
 
@@ -343,6 +283,7 @@ bool IBattle::ShouldAutoStart() const
 
 void IBattle::OnUserRemoved(User& user)
 {
+	InvalidateScript(ScriptCache::RosterMask());
 	UserBattleStatus& bs = user.BattleStatus();
 	if (!bs.spectator) {
 		PlayerLeftTeam(bs.team);
@@ -397,6 +338,7 @@ bool IBattle::IsEveryoneReady() const
 
 void IBattle::AddStartRect(unsigned int allyno, unsigned int left, unsigned int top, unsigned int right, unsigned int bottom)
 {
+	InvalidateScript(ScriptCache::Mask(ScriptCache::SECTION_ALLYTEAMS));
 	BattleStartRect sr;
 
 	sr.ally = allyno;
@@ -415,6 +357,7 @@ void IBattle::AddStartRect(unsigned int allyno, unsigned int left, unsigned int
 
 void IBattle::RemoveStartRect(unsigned int allyno)
 {
+	InvalidateScript(ScriptCache::Mask(ScriptCache::SECTION_ALLYTEAMS));
 	std::map<unsigned int, BattleStartRect>::iterator rect_it = m_rects.find(allyno);
 	if (rect_it == m_rects.end())
 		return;
@@ -441,6 +384,7 @@ void IBattle::ResizeStartRect(unsigned int allyno)
 
 void IBattle::StartRectRemoved(unsigned int allyno)
 {
+	InvalidateScript(ScriptCache::Mask(ScriptCache::SECTION_ALLYTEAMS));
 	std::map<unsigned int, BattleStartRect>::const_iterator rect_it = m_rects.find(allyno);
 	if (rect_it == m_rects.end())
 		return;
@@ -512,11 +456,13 @@ unsigned int IBattle::GetNextFreeRectIdx() const
 
 void IBattle::ClearStartRects()
 {
+	InvalidateScript(ScriptCache::Mask(ScriptCache::SECTION_ALLYTEAMS));
 	m_rects.clear();
 }
 
 void IBattle::ForceSide(User& user, int side)
 {
+	InvalidateScript(ScriptCache::RosterMask());
 	if (IsFounderMe() || user.BattleStatus().IsBot()) {
 		user.BattleStatus().side = side;
 	}
@@ -524,6 +470,7 @@ void IBattle::ForceSide(User& user, int side)
 
 void IBattle::ForceTeam(User& user, int team)
 {
+	InvalidateScript(ScriptCache::RosterMask());
 	if (IsFounderMe() || user.BattleStatus().IsBot()) {
 		if (!user.BattleStatus().spectator) {
 			PlayerLeftTeam(user.BattleStatus().team);
@@ -536,6 +483,7 @@ void IBattle::ForceTeam(User& user, int team)
 
 void IBattle::ForceAlly(User& user, int ally)
 {
+	InvalidateScript(ScriptCache::RosterMask());
 
 	if (IsFounderMe() || user.BattleStatus().IsBot()) {
 		if (!user.BattleStatus().spectator) {
@@ -549,6 +497,7 @@ void IBattle::ForceAlly(User& user, int ally)
 
 void IBattle::ForceColour(User& user, const LSL::lslColor& col)
 {
+	InvalidateScript(ScriptCache::RosterMask());
 	if (IsFounderMe() || user.BattleStatus().IsBot()) {
 		user.BattleStatus().colour = col;
 	}
@@ -596,6 +545,7 @@ void IBattle::PlayerLeftAlly(int ally)
 
 void IBattle::ForceSpectator(User& user, bool spectator)
 {
+	InvalidateScript(ScriptCache::RosterMask());
 	if (IsFounderMe() || user.BattleStatus().IsBot()) {
 		UserBattleStatus& status = user.BattleStatus();
 
@@ -629,6 +579,7 @@ void IBattle::ForceSpectator(User& user, bool spectator)
 
 void IBattle::SetHandicap(User& user, int handicap)
 {
+	InvalidateScript(ScriptCache::RosterMask());
 	if (IsFounderMe() || user.BattleStatus().IsBot()) {
 		user.BattleStatus().handicap = handicap;
 	}
@@ -700,6 +651,7 @@ void IBattle::SetHostMap(const std::string& _mapname, const std::string& _hash)
 		m_map_loaded = false;
 		m_host_map.name = mapname;
 		m_host_map.hash = hash;
+		InvalidateScript(ScriptCache::Mask(ScriptCache::SECTION_TEAMS));
 	}
 }
 
@@ -711,6 +663,7 @@ void IBattle::SetLocalMap(const std::string& mapname)
 	if (map.name != m_local_map.name || map.hash != m_local_map.hash) {
 		m_local_map = map;
 		m_map_loaded = true;
+		InvalidateScript(ScriptCache::Mask(ScriptCache::SECTION_TEAMS));
 		if (IsFounderMe()) { // save all rects infos
 				     //TODO
 		}
@@ -755,6 +708,7 @@ void IBattle::SetHostMod(const std::string& _modname, const std::string& _hash)
 		m_mod_loaded = false;
 		m_host_mod.name = modname;
 		m_host_mod.hash = hash;
+		InvalidateScript(ScriptCache::Mask(ScriptCache::SECTION_TEAMS));
 	}
 }
 
@@ -765,6 +719,7 @@ void IBattle::SetLocalMod(const LSL::UnitsyncMod& mod)
 		m_previous_local_mod_name = m_local_mod.name;
 		m_local_mod = mod;
 		m_mod_loaded = true;
+		InvalidateScript(ScriptCache::Mask(ScriptCache::SECTION_TEAMS));
 	}
 }
 
@@ -816,6 +771,7 @@ bool IBattle::ModExists(bool comparehash) const
 
 void IBattle::RestrictUnit(const std::string& unitname, int count)
 {
+	InvalidateScript(ScriptCache::Mask(ScriptCache::SECTION_RESTRICTIONS));
 	m_restricted_units[unitname] = count;
 }
 
@@ -826,11 +782,13 @@ void IBattle::UnrestrictUnit(const std::string& unitname)
 	if (pos == m_restricted_units.end())
 		return;
 	m_restricted_units.erase(pos);
+	InvalidateScript(ScriptCache::Mask(ScriptCache::SECTION_RESTRICTIONS));
 }
 
 
 void IBattle::UnrestrictAllUnits()
 {
+	InvalidateScript(ScriptCache::Mask(ScriptCache::SECTION_RESTRICTIONS));
 	m_restricted_units.clear();
 }
 
@@ -842,6 +800,7 @@ std::map<std::string, int> IBattle::RestrictedUnits() const
 
 void IBattle::OnSelfLeftBattle()
 {
+	InvalidateScript(ScriptCache::AllMask());
 	GetMe().BattleStatus().spectator = false; // always reset back yourself to player when rejoining
 	m_is_self_in = false;
 	for (size_t j = 0; j < GetNumUsers(); ++j) {
@@ -879,59 +838,64 @@ bool IBattle::LoadOptionsPreset(const std::string& name)
 	const std::string preset = FixPresetName(name);
 	if (preset.empty())
 		return false; //preset not found
+	OptionsPreset options;
+	if (!sett().GetOptionsPreset(TowxString(preset), options))
+		return false;
 	m_preset = preset;
 
-	for (unsigned int i = 0; i < LSL::Enum::LastOption; i++) {
-		std::map<wxString, wxString> options = sett().GetHostingPreset(TowxString(m_preset), i);
-		if ((LSL::Enum::GameOption)i != LSL::Enum::PrivateOptions) {
-			for (std::map<wxString, wxString>::const_iterator itor = options.begin(); itor != options.end(); ++itor) {
-				wxLogWarning(itor->first + _T(" ::: ") + itor->second);
-				CustomBattleOptions().setSingleOption(STD_STRING(itor->first),
-								      STD_STRING(itor->second),
-								      (LSL::Enum::GameOption)i);
-			}
-		} else {
-			if (!options[_T("mapname")].IsEmpty()) {
-				if (LSL::usync().MapExists(STD_STRING(options[_T("mapname")]))) {
-					SetLocalMap(STD_STRING(options[_T("mapname")]));
-					SendHostInfo(HI_Map);
-				} else if (!ui().OnPresetRequiringMap(options[_T("mapname")])) {
-					//user didn't want to download the missing map, so set to empty to not have it tried to be loaded again
-					options[_T("mapname")] = wxEmptyString;
-					sett().SetHostingPreset(TowxString(m_preset), i, options);
-				}
-			}
-
-			for (unsigned int j = 0; j <= GetLastRectIdx(); ++j) {
-				if (GetStartRect(j).IsOk())
-					RemoveStartRect(j); // remove all rects that might come from map presets
-			}
-			SendHostInfo(IBattle::HI_StartRects);
-
-			unsigned int rectcount = FromwxString(options[_T("numrects")]);
-			for (unsigned int loadrect = 0; loadrect < rectcount; loadrect++) {
-				int ally = FromwxString(options[_T("rect_") + TowxString(loadrect) + _T("_ally")]);
-				if (ally == 0)
-					continue;
-				AddStartRect(ally - 1, FromwxString(options[_T("rect_") + TowxString(loadrect) + _T("_left")]), FromwxString(options[_T("rect_") + TowxString(loadrect) + _T("_top")]), FromwxString(options[_T("rect_") + TowxString(loadrect) + _T("_right")]), FromwxString(options[_T("rect_") + TowxString(loadrect) + _T("_bottom")]));
-			}
-			SendHostInfo(HI_StartRects);
+	for (const auto& section : options.options) {
+		if (section.first == LSL::Enum::PrivateOptions || section.first >= LSL::Enum::LastOption)
+			continue;
+		for (const auto& option : section.second) {
+			CustomBattleOptions().setSingleOption(option.first, option.second.value, (LSL::Enum::GameOption)section.first);
+		}
+	}
 
-			wxStringTokenizer tkr(options[_T("restrictions")], _T('\t'));
-			m_restricted_units.clear();
-			while (tkr.HasMoreTokens()) {
-				wxString unitinfo = tkr.GetNextToken();
-				RestrictUnit(STD_STRING(unitinfo.BeforeLast(_T('='))), FromwxString(unitinfo.AfterLast(_T('='))));
-			}
-			SendHostInfo(HI_Restrictions);
-			Update(stdprintf("%d_restrictions", LSL::Enum::PrivateOptions));
+	if (!options.mapname.empty()) {
+		if (LSL::usync().MapExists(options.mapname)) {
+			SetLocalMap(options.mapname);
+			SendHostInfo(HI_Map);
+		} else if (!ui().OnPresetRequiringMap(TowxString(options.mapname))) {
+			//user didn't want to download the missing map, so set to empty to not have it tried to be loaded again
+			options.mapname.clear();
+			sett().SetOptionsPreset(TowxString(m_preset), options);
 		}
 	}
+
+	for (unsigned int j = 0; j <= GetLastRectIdx(); ++j) {
+		if (GetStartRect(j).IsOk())
+			RemoveStartRect(j); // remove all rects that might come from map presets
+	}
+	SendHostInfo(IBattle::HI_StartRects);
+
+	for (const OptionsPreset::StartRect& rect : options.startrects) {
+		AddStartRect(rect.ally, rect.left, rect.top, rect.right, rect.bottom);
+	}
+	SendHostInfo(HI_StartRects);
+
+	UnrestrictAllUnits();
+	for (const auto& unit : options.restrictions) {
+		RestrictUnit(unit.first, unit.second);
+	}
+	SendHostInfo(HI_Restrictions);
+	Update(stdprintf("%d_restrictions", LSL::Enum::PrivateOptions));
+
 	SendHostInfo(HI_Send_All_opts);
 	ui().ReloadPresetList();
 	return true;
 }
 
+static OptionsPreset::Option::Type PresetOptionType(LSL::Enum::OptionType type)
+{
+	switch (type) {
+		case LSL::Enum::opt_bool:
+			return OptionsPreset::Option::TYPE_BOOL;
+		case LSL::Enum::opt_float:
+			return OptionsPreset::Option::TYPE_NUMBER;
+		default:
+			return OptionsPreset::Option::TYPE_STRING;
+	}
+}
 
 void IBattle::SaveOptionsPreset(const std::string& name)
 {
@@ -939,44 +903,38 @@ void IBattle::SaveOptionsPreset(const std::string& name)
 	if (m_preset == "")
 		m_preset = name; //new preset
 
+	OptionsPreset preset;
 	for (int i = 0; i < (int)LSL::Enum::LastOption; i++) {
-		if ((LSL::Enum::GameOption)i != LSL::Enum::PrivateOptions) {
-			const auto opts = CustomBattleOptions().getOptionsMap((LSL::Enum::GameOption)i);
-			std::map<wxString, wxString> wopts;
-			for (const auto pair : opts)
-				wopts.insert(std::make_pair(TowxString(pair.first), TowxString(pair.second)));
-			sett().SetHostingPreset(TowxString(m_preset), (LSL::Enum::GameOption)i, wopts);
-		} else {
-			std::map<wxString, wxString> opts;
-			opts[_T("mapname")] = TowxString(GetHostMapName());
-			unsigned int validrectcount = 0;
-			if (LSL::Util::FromString<long>(
-				CustomBattleOptions().getSingleValue("startpostype", LSL::Enum::EngineOption)) == ST_Choose) {
-				unsigned int boxcount = GetLastRectIdx();
-				for (unsigned int boxnum = 0; boxnum <= boxcount; boxnum++) {
-					BattleStartRect rect = GetStartRect(boxnum);
-					if (rect.IsOk()) {
-						opts[_T("rect_") + TowxString(validrectcount) + _T("_ally")] = TowxString(rect.ally + 1);
-						opts[_T("rect_") + TowxString(validrectcount) + _T("_left")] = TowxString(rect.left);
-						opts[_T("rect_") + TowxString(validrectcount) + _T("_top")] = TowxString(rect.top);
-						opts[_T("rect_") + TowxString(validrectcount) + _T("_bottom")] = TowxString(rect.bottom);
-						opts[_T("rect_") + TowxString(validrectcount) + _T("_right")] = TowxString(rect.right);
-						validrectcount++;
-					}
-				}
-			}
-			opts[_T("numrects")] = TowxString(validrectcount);
+		if ((LSL::Enum::GameOption)i == LSL::Enum::PrivateOptions)
+			continue;
+		const auto opts = GetCustomBattleOptions().getOptionsMap((LSL::Enum::GameOption)i);
+		OptionsPreset::OptionMap& options = preset.options[i];
+		for (const auto pair : opts) {
+			const OptionsPreset::Option::Type type = PresetOptionType(GetCustomBattleOptions().GetSingleOptionType(pair.first));
+			options[pair.first] = OptionsPreset::Option(type, pair.second);
+		}
+	}
 
-			wxString restrictionsstring;
-			for (std::map<std::string, int>::const_iterator itor = m_restricted_units.begin(); itor != m_restricted_units.end(); ++itor) {
-				restrictionsstring << TowxString(itor->first) << _T('=') << TowxString(itor->second) << _T('\t');
+	preset.mapname = GetHostMapName();
+	if (LSL::Util::FromString<long>(
+		GetCustomBattleOptions().getSingleValue("startpostype", LSL::Enum::EngineOption)) == ST_Choose) {
+		unsigned int boxcount = GetLastRectIdx();
+		for (unsigned int boxnum = 0; boxnum <= boxcount; boxnum++) {
+			BattleStartRect rect = GetStartRect(boxnum);
+			if (rect.IsOk()) {
+				OptionsPreset::StartRect saved;
+				saved.ally = rect.ally;
+				saved.left = rect.left;
+				saved.top = rect.top;
+				saved.right = rect.right;
+				saved.bottom = rect.bottom;
+				preset.startrects.push_back(saved);
 			}
-			opts[_T("restrictions")] = restrictionsstring;
-
-			sett().SetHostingPreset(TowxString(m_preset), (LSL::Enum::GameOption)i, opts);
 		}
 	}
-	sett().SaveSettings();
+	preset.restrictions = m_restricted_units;
+
+	sett().SetOptionsPreset(TowxString(m_preset), preset);
 	ui().ReloadPresetList();
 }
 
@@ -1003,6 +961,7 @@ LSL::StringVector IBattle::GetPresetList()
 
 void IBattle::UserPositionChanged(const User& /*unused*/)
 {
+	InvalidateScript(ScriptCache::Mask(ScriptCache::SECTION_TEAMS));
 }
 
 void IBattle::AddUserFromDemo(User& user)
@@ -1014,6 +973,7 @@ void IBattle::AddUserFromDemo(User& user)
 
 void IBattle::SetProxy(const std::string& value)
 {
+	InvalidateScript(ScriptCache::AllMask());
 	m_opts.proxyhost = value;
 }
 
@@ -1156,12 +1116,12 @@ void IBattle::GetBattleFromScript(bool loadmapmod)
 				user.Status().rank = (UserStatus::RankContainer)player->GetInt("Rank", -1);
 
 				if (bot.ok()) {
-					status.aishortname = bot->GetString("ShortName");
-					status.aiversion = bot->GetString("Version");
+					status.SetAIShortName(bot->GetString("ShortName"));
+					status.SetAIVersion(bot->GetString("Version"));
 					int ownerindex = bot->GetInt("Host");
 					LSL::TDF::PDataList aiowner(replayNode->Find(stdprintf("PLAYER%d", ownerindex)));
 					if (aiowner.ok()) {
-						status.owner = aiowner->GetString("Name");
+						status.SetOwner(aiowner->GetString("Name"));
 					}
 				}
 
@@ -21,6 +21,7 @@ lsl/battle/ibattle.h
 
 #include "user.h"
 #include "userlist.h"
+#include "utils/scriptsections.h"
 #include <lslunitsync/optionswrapper.h>
 
 const unsigned int DEFAULT_SERVER_PORT = 8452;
@@ -294,14 +295,32 @@ public:
 	virtual void UnrestrictAllUnits();
 	virtual std::map<std::string, int> RestrictedUnits() const;
 
+	//! the options may be changed through the returned reference, so the script sections using them are rebuilt
 	virtual LSL::OptionsWrapper& CustomBattleOptions()
 	{
+		m_script_cache.Invalidate(ScriptCache::Mask(ScriptCache::SECTION_OPTIONS) | ScriptCache::RosterMask());
 		return m_opt_wrap;
 	}
 	virtual const LSL::OptionsWrapper& CustomBattleOptions() const
 	{
 		return m_opt_wrap;
 	}
+	//! read-only access, unlike CustomBattleOptions() it keeps the cached script sections
+	const LSL::OptionsWrapper& GetCustomBattleOptions() const
+	{
+		return m_opt_wrap;
+	}
+
+	typedef ScriptSectionCache ScriptCache;
+	//! start script sections kept between launches, see Spring::WriteScriptTxt
+	ScriptCache& GetScriptCache()
+	{
+		return m_script_cache;
+	}
+	void InvalidateScript(unsigned int mask)
+	{
+		m_script_cache.Invalidate(mask);
+	}
 
 	virtual bool LoadOptionsPreset(const std::string& name);
 	virtual void SaveOptionsPreset(const std::string& name);
@@ -310,7 +329,6 @@ public:
 	virtual LSL::StringVector GetPresetList();
 
 	virtual std::vector<LSL::lslColor>& GetFixColoursPalette(int numteams) const;
-	virtual int GetClosestFixColour(const LSL::lslColor& col, const std::vector<int>& excludes, int difference) const;
 	virtual LSL::lslColor GetFixColour(int i) const;
 	virtual LSL::lslColor GetFreeColour(User& for_whom) const;
 	virtual LSL::lslColor GetFreeColour(User* for_whom = NULL) const;
@@ -719,6 +737,7 @@ private:
 	std::map<std::string, int> m_restricted_units;
 
 	LSL::OptionsWrapper m_opt_wrap;
+	ScriptCache m_script_cache;
 
 	std::map<unsigned int, BattleStartRect> m_rects;
 
@@ -185,8 +185,7 @@ IconImageList::IconImageList()
 	//ICON_FIXCOLOURS_PALETTE = Add( wxBitmap(fixcolours_palette_xpm) );
 
 	ICON_UNK_FLAG = Add(wxBitmap(unknown_flag_xpm));
-
-	ICON_FLAGS_BASE = AddFlagImages(*this);
+	m_flag_icons.assign(GetFlagCount(), -1);
 
 	ICON_EMPTY = Add(wxBitmap(empty_xpm));
 
@@ -305,9 +304,14 @@ int IconImageList::GetRankLimitIcon(int rank, bool showlowest) const
 }
 
 
-int IconImageList::GetFlagIcon(const std::string& flagname) const
+int IconImageList::GetFlagIcon(const std::string& flagname)
 {
-	return ICON_FLAGS_BASE + GetFlagIndex(flagname);
+	const int flag = GetFlagIndex(flagname);
+	if (flag == FLAG_NONE)
+		return ICON_UNK_FLAG;
+	if (m_flag_icons[flag] < 0)
+		m_flag_icons[flag] = Add(GetFlagBitmap(flag));
+	return m_flag_icons[flag];
 }
 
 
@@ -393,29 +397,29 @@ void IconImageList::SetColourIcon(const LSL::lslColor& colour)
 
 int IconImageList::GetSideIcon(const std::string& modname, int side)
 {
-	const auto sides = LSL::usync().GetSides(modname);
-	std::string sidename;
-	if (side < (int)sides.size()) {
-		sidename = sides[side];
-	}
-	const std::string cachestring = modname + "_" + sidename;
-	if (m_cached_side_icons.find(cachestring) != m_cached_side_icons.end()) { //already cached
-		return m_cached_side_icons[cachestring];
+	const std::pair<std::string, int> key(modname, side);
+	const std::map<std::pair<std::string, int>, int>::const_iterator it = m_cached_side_icons.find(key);
+	if (it != m_cached_side_icons.end()) { //already cached
+		return it->second;
 	}
+	if (!LSL::usync().IsLoaded()) // don't remember the dummies before the game could be asked
+		return (side == 0) ? ICON_SIDEPIC_0 : ICON_SIDEPIC_1;
 
+	int& icon = m_cached_side_icons[key];
 	try {
+		const auto sides = LSL::usync().GetSides(modname);
+		std::string sidename;
+		if (side < (int)sides.size()) {
+			sidename = sides[side];
+		}
 		const LSL::UnitsyncImage img = LSL::usync().GetSidePicture(modname, sidename);
-		int IconPosition = Add(wxBitmap(img.wxbitmap()), wxNullBitmap);
-		m_cached_side_icons[cachestring] = IconPosition;
-		return IconPosition;
+		icon = Add(wxBitmap(img.wxbitmap()), wxNullBitmap);
+		return icon;
 	} catch (...) {
 	}
-	if (side == 0) { //failed to load, store dummies in cache
-		m_cached_side_icons[cachestring] = ICON_SIDEPIC_0;
-	} else {
-		m_cached_side_icons[cachestring] = ICON_SIDEPIC_1;
-	}
-	return m_cached_side_icons[cachestring];
+	//failed to load, store dummies in cache
+	icon = (side == 0) ? ICON_SIDEPIC_0 : ICON_SIDEPIC_1;
+	return icon;
 }
 
 int IconImageList::GetReadyIcon(const bool& spectator, const bool& ready, const unsigned int& sync, const bool& bot)
@@ -6,6 +6,8 @@
 
 #include <wx/imaglist.h>
 #include <map>
+#include <string>
+#include <utility>
 #include <vector>
 
 class IBattle;
@@ -26,7 +28,8 @@ public:
 
 	int GetRankLimitIcon(int rank, bool showlowest = true) const;
 	int GetRankIcon(const unsigned int& rank, const bool& showlowest = true) const;
-	int GetFlagIcon(const std::string& flagname) const;
+	//! the flag is added to the list the first time it is asked for
+	int GetFlagIcon(const std::string& flagname);
 	int GetBattleStatusIcon(const IBattle& battle) const;
 	wxString GetBattleStatus(const IBattle& battle) const;
 	int GetHostIcon(const bool& spectator = false) const;
@@ -105,7 +108,6 @@ public:
 	//int ICON_FIXCOLOURS_PALETTE;
 
 	int ICON_UNK_FLAG;
-	int ICON_FLAGS_BASE;
 
 	int ICON_WARNING_OVERLAY;
 
@@ -116,7 +118,10 @@ public:
 	int ICON_SPRINGLOBBY;
 
 private:
-	std::map<std::string, int> m_cached_side_icons;
+	//! (game, side number) --> icon, so a hit doesn't have to ask unitsync for the side names
+	std::map<std::pair<std::string, int>, int> m_cached_side_icons;
+	//! flag index --> icon, -1 until the flag is displayed for the first time
+	std::vector<int> m_flag_icons;
 	// why map? because i already included and didn't want to include more stuff, it's not time-critical code anyway
 	typedef std::map<wxString, unsigned int>
 	    PlayerColourMap;
@@ -23,7 +23,8 @@ public:
 	virtual void OnDisconnected()
 	{
 	}
-	virtual void OnDataReceived()
+	//! a command received from the server, already split by the network thread
+	virtual void OnCommand(const std::string& /*cmd*/, const std::string& /*params*/, int /*replyid*/)
 	{
 	}
 	virtual void OnError(const std::string& /*error*/)
@@ -85,7 +85,7 @@ User& IServer::_AddUser(const std::string& user)
 {
 	if (m_users.UserExists(user))
 		return m_users.GetUser(user);
-	User* u = new User(user, *this);
+	User* u = m_user_pool.Create(user, *this);
 	m_users.AddUser(*u);
 	return *u;
 }
@@ -102,7 +102,7 @@ void IServer::_RemoveUser(const std::string& nickname)
 			if (chan.UserExists(nickname))
 				chan.Left(*u, "server idiocy");
 		}
-		delete u;
+		m_user_pool.Destroy(u);
 	} catch (std::runtime_error) {
 	}
 }
@@ -112,7 +112,7 @@ Channel& IServer::_AddChannel(const std::string& chan)
 {
 	if (m_channels.ChannelExists(chan))
 		return m_channels.GetChannel(chan);
-	Channel* c = new Channel(*this);
+	Channel* c = m_channel_pool.Create(*this);
 	c->SetName(chan);
 
 	m_channels.AddChannel(*c);
@@ -125,14 +125,14 @@ void IServer::_RemoveChannel(const std::string& name)
 	Channel* c = &m_channels.GetChannel(name);
 	m_channels.RemoveChannel(name);
 	ASSERT_LOGIC(c != 0, "IServer::_RemoveChannel(\"" + name + "\"): GetChannel returned NULL pointer");
-	delete c;
+	m_channel_pool.Destroy(c);
 }
 
 IBattle& IServer::_AddBattle(const int& id)
 {
 	if (battles_iter->BattleExists(id))
 		return battles_iter->GetBattle(id);
-	IBattle* b = new Battle(*this, id);
+	IBattle* b = m_battle_pool.Create(*this, id);
 
 	m_battles.AddBattle(*b);
 	return *b;
@@ -144,7 +144,7 @@ void IServer::_RemoveBattle(const int& id)
 	IBattle* b = &battles_iter->GetBattle(id);
 	m_battles.RemoveBattle(id);
 	ASSERT_LOGIC(b != 0, "IServer::_RemoveBattle(): GetBattle returned NULL pointer");
-	delete b;
+	m_battle_pool.Destroy(static_cast<Battle*>(b));
 }
 
 
@@ -155,7 +155,7 @@ void IServer::Reset()
 		try {
 			User* u = &m_users.GetUser(0);
 			m_users.RemoveUser(u->GetNick());
-			delete u;
+			m_user_pool.Destroy(u);
 		} catch (std::runtime_error) {
 		}
 	}
@@ -165,12 +165,12 @@ void IServer::Reset()
 		IBattle* b = battles_iter->GetBattle();
 		if (b != 0) {
 			m_battles.RemoveBattle(b->GetBattleId());
-			delete b;
+			m_battle_pool.Destroy(static_cast<Battle*>(b));
 		}
 	}
 	while (m_channels.GetNumChannels() > 0) {
 		Channel* c = &m_channels.GetChannel(0);
 		m_channels.RemoveChannel(c->GetName());
-		delete c;
+		m_channel_pool.Destroy(c);
 	}
 }
@@ -9,11 +9,13 @@
 #include "userlist.h"
 #include "battlelist.h"
 #include "utils/mixins.h"
+#include "utils/objectpool.h"
 #include "ibattle.h"
 
 class ServerEvents;
 class SimpleServerEvents;
 class Channel;
+class Battle;
 class Ui;
 struct BattleOptions;
 class User;
@@ -254,6 +256,11 @@ private:
 
 	bool m_pass_hash;
 	std::string m_required_spring_ver;
+	// a login burst creates thousands of users, the pools avoid an allocation for each.
+	// They are declared before the lists, so they outlive them.
+	ObjectPool<User> m_user_pool;
+	ObjectPool<Channel, 32> m_channel_pool;
+	ObjectPool<Battle, 64> m_battle_pool;
 	UserList m_users;
 	ChannelList m_channels;
 	BattleList m_battles;
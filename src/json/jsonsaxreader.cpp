@@ -0,0 +1,708 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        jsonsaxreader.cpp
+// Purpose:     the wxJSONSaxReader class: an event based JSON text parser
+// Licence:     wxWidgets licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include <wx/jsonsaxreader.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+namespace
+{
+
+enum State {
+	STATE_VALUE_OR_CLOSE, // after '[' or ',' in an array
+	STATE_KEY_OR_CLOSE,   // after '{' or ',' in an object
+	STATE_COLON,	  // after a member name
+	STATE_VALUE,	  // after ':'
+	STATE_COMMA_OR_CLOSE  // after a value
+};
+
+//! the characters which end a literal, the same set wxJSONReader::ReadToken() uses
+inline bool IsTokenEnd(char c)
+{
+	switch (c) {
+		case ' ':
+		case ',':
+		case ':':
+		case '[':
+		case ']':
+		case '{':
+		case '}':
+		case '\t':
+		case '\n':
+		case '\r':
+		case '\b':
+			return true;
+		default:
+			return false;
+	}
+}
+
+inline int HexValue(char c)
+{
+	if (c >= '0' && c <= '9')
+		return c - '0';
+	if (c >= 'a' && c <= 'f')
+		return c - 'a' + 10;
+	if (c >= 'A' && c <= 'F')
+		return c - 'A' + 10;
+	return -1;
+}
+
+void AppendUTF8(std::string& out, unsigned long cp)
+{
+	if (cp < 0x80) {
+		out += (char)cp;
+	} else if (cp < 0x800) {
+		out += (char)(0xC0 | (cp >> 6));
+		out += (char)(0x80 | (cp & 0x3F));
+	} else if (cp < 0x10000) {
+		out += (char)(0xE0 | (cp >> 12));
+		out += (char)(0x80 | ((cp >> 6) & 0x3F));
+		out += (char)(0x80 | (cp & 0x3F));
+	} else {
+		out += (char)(0xF0 | (cp >> 18));
+		out += (char)(0x80 | ((cp >> 12) & 0x3F));
+		out += (char)(0x80 | ((cp >> 6) & 0x3F));
+		out += (char)(0x80 | (cp & 0x3F));
+	}
+}
+
+//! decimal conversion with the same rules as wxJSONReader::DoStrto_ll()
+bool ParseDecimal(const char* begin, const char* end, wxUint64& value, char& sign)
+{
+	sign = ' ';
+	if (begin < end && (*begin == '+' || *begin == '-')) {
+		sign = *begin;
+		++begin;
+	}
+	wxUint64 res = 0;
+	for (const char* p = begin; p < end; ++p) {
+		if (*p < '0' || *p > '9')
+			return false;
+		const unsigned digit = *p - '0';
+		if (res > (wxULL(18446744073709551615) - digit) / 10)
+			return false;
+		res = res * 10 + digit;
+	}
+	value = res;
+	return true;
+}
+
+//! compares a token against a lowercase literal, \c exact is false if only the case differs
+bool IsLiteral(const std::string& token, const char* literal, bool& exact)
+{
+	const size_t len = strlen(literal);
+	if (token.size() != len)
+		return false;
+	exact = true;
+	for (size_t i = 0; i < len; i++) {
+		const char c = token[i];
+		if (c == literal[i])
+			continue;
+		if (c - 'A' + 'a' != literal[i])
+			return false;
+		exact = false;
+	}
+	return true;
+}
+
+} // namespace
+
+wxJSONSaxReader::wxJSONSaxReader(int flags, int maxErrors)
+    : m_flags(flags)
+    , m_maxErrors(maxErrors)
+    , m_pos(NULL)
+    , m_end(NULL)
+    , m_lineNo(1)
+    , m_lineStart(NULL)
+    , m_depth(0)
+    , m_aborted(false)
+    , m_handler(NULL)
+{
+}
+
+//! Parse the JSON document, see wxJSONReader::Parse()
+/*!
+ The string is converted to UTF-8 once and the buffer is scanned directly.
+ Returns the number of errors found in the document.
+*/
+int wxJSONSaxReader::Parse(const wxString& doc, wxJSONSaxHandler& handler)
+{
+	const wxScopedCharBuffer utf8 = doc.ToUTF8();
+	return Parse(utf8.data(), utf8.length(), handler);
+}
+
+//! \overload Parse( const wxString&, wxJSONSaxHandler& )
+int wxJSONSaxReader::Parse(wxInputStream& is, wxJSONSaxHandler& handler)
+{
+	std::vector<char> doc;
+	char block[64 * 1024];
+	while (is.CanRead()) {
+		is.Read(block, sizeof(block));
+		const size_t read = is.LastRead();
+		if (read == 0)
+			break;
+		doc.insert(doc.end(), block, block + read);
+	}
+	if (doc.empty())
+		return Parse("", 0, handler);
+	return Parse(&doc[0], doc.size(), handler);
+}
+
+//! \overload Parse( const wxString&, wxJSONSaxHandler& )
+int wxJSONSaxReader::Parse(const char* doc, size_t len, wxJSONSaxHandler& handler)
+{
+	m_pos = doc;
+	m_end = doc + len;
+	m_lineNo = 1;
+	m_lineStart = doc;
+	m_depth = 0;
+	m_aborted = false;
+	m_handler = &handler;
+	m_stack.clear();
+	m_errors.clear();
+	m_warnings.clear();
+
+	DoParse();
+
+	m_handler = NULL;
+	return m_errors.size();
+}
+
+int wxJSONSaxReader::GetDepth() const
+{
+	return m_depth;
+}
+
+int wxJSONSaxReader::GetErrorCount() const
+{
+	return m_errors.size();
+}
+
+int wxJSONSaxReader::GetWarningCount() const
+{
+	return m_warnings.size();
+}
+
+const wxArrayString& wxJSONSaxReader::GetErrors() const
+{
+	return m_errors;
+}
+
+const wxArrayString& wxJSONSaxReader::GetWarnings() const
+{
+	return m_warnings;
+}
+
+bool wxJSONSaxReader::WasAborted() const
+{
+	return m_aborted;
+}
+
+//! returns the current character and advances, -1 on EOF
+int wxJSONSaxReader::Next()
+{
+	if (m_pos >= m_end)
+		return -1;
+	const char c = *m_pos++;
+	if (c == '\n') {
+		++m_lineNo;
+		m_lineStart = m_pos;
+	}
+	return (unsigned char)c;
+}
+
+//! The parser main loop
+/*!
+ Instead of recursing for each nested object/array like wxJSONReader::DoRead()
+ the open containers are kept in \c m_stack, so deeply nested documents
+ cannot overflow the call stack.
+ Returns false on error or when the handler aborted the parse.
+*/
+bool wxJSONSaxReader::DoParse()
+{
+	// skip everything up to the first open-object/array character
+	while (m_pos < m_end && *m_pos != '{' && *m_pos != '[') {
+		if (*m_pos == '/') {
+			if (!SkipComment())
+				return false;
+		} else {
+			Next();
+		}
+	}
+	if (m_pos >= m_end) {
+		AddError(_T("Cannot find a start object/array character"));
+		return false;
+	}
+
+	State state = STATE_VALUE;
+	while (true) {
+		if (!SkipWhiteSpace())
+			return false;
+
+		if (m_pos >= m_end) {
+			if (state == STATE_COLON || state == STATE_VALUE) {
+				AddError(_T("key or value is missing for JSON value"));
+				return false;
+			}
+			while (!m_stack.empty()) {
+				const bool isArray = m_stack.back() == '[';
+				AddWarning(wxJSONREADER_MISSING, isArray ? _T("\']\' missing at end of file") : _T("\'}\' missing at end of file"));
+				if (!m_errors.empty())
+					return false;
+				m_stack.pop_back();
+				const bool ok = isArray ? m_handler->OnEndArray() : m_handler->OnEndObject();
+				if (!ok) {
+					m_aborted = true;
+					return false;
+				}
+			}
+			return true;
+		}
+
+		const char c = *m_pos;
+		bool ok = true;
+
+		// close-object/array characters
+		if ((c == '}' || c == ']') && (state == STATE_VALUE_OR_CLOSE || state == STATE_KEY_OR_CLOSE || state == STATE_COMMA_OR_CLOSE)) {
+			const bool isArray = m_stack.back() == '[';
+			if (isArray && c == '}') {
+				AddWarning(wxJSONREADER_MISSING, _T("Trying to close an array using the \'}\' (close-object) char"));
+			} else if (!isArray && c == ']') {
+				AddWarning(wxJSONREADER_MISSING, _T("Trying to close an object using the \']\' (close-array) char"));
+			}
+			if (!m_errors.empty())
+				return false;
+			Next();
+			m_stack.pop_back();
+			if (!(isArray ? m_handler->OnEndArray() : m_handler->OnEndObject())) {
+				m_aborted = true;
+				return false;
+			}
+			if (m_stack.empty()) {
+				// anything after the top-level close character is ignored
+				return true;
+			}
+			state = STATE_COMMA_OR_CLOSE;
+			continue;
+		}
+
+		switch (state) {
+			case STATE_COMMA_OR_CLOSE:
+				if (c != ',') {
+					AddError(_T("\',\' or close character missing after a value"));
+					return false;
+				}
+				Next();
+				state = (m_stack.back() == '{') ? STATE_KEY_OR_CLOSE : STATE_VALUE_OR_CLOSE;
+				break;
+
+			case STATE_KEY_OR_CLOSE:
+				if (c != '\"') {
+					AddError(_T("\'name\' is missing for JSON object value"));
+					return false;
+				}
+				Next();
+				if (!ReadString(m_buf))
+					return false;
+				ok = m_handler->OnKey(wxString::FromUTF8(m_buf.data(), m_buf.size()));
+				state = STATE_COLON;
+				break;
+
+			case STATE_COLON:
+				if (c != ':') {
+					AddError(_T("\':\' missing after the \'name\' of a JSON object value"));
+					return false;
+				}
+				Next();
+				state = STATE_VALUE;
+				break;
+
+			case STATE_VALUE:
+			case STATE_VALUE_OR_CLOSE:
+				switch (c) {
+					case '{':
+					case '[':
+						Next();
+						m_stack.push_back(c);
+						if ((int)m_stack.size() > m_depth) {
+							m_depth = m_stack.size();
+						}
+						ok = (c == '{') ? m_handler->OnStartObject() : m_handler->OnStartArray();
+						state = (c == '{') ? STATE_KEY_OR_CLOSE : STATE_VALUE_OR_CLOSE;
+						break;
+					case '\"':
+						Next();
+						if (!ReadString(m_buf))
+							return false;
+						ok = m_handler->OnString(wxString::FromUTF8(m_buf.data(), m_buf.size()));
+						state = STATE_COMMA_OR_CLOSE;
+						break;
+					case '\'':
+						AddError(_T("Memory buffers are not supported by the SAX parser"));
+						return false;
+					case ',':
+					case ':':
+					case '}':
+					case ']':
+						AddError(_T("key or value is missing for JSON value"));
+						return false;
+					default:
+						if (!ReadLiteral())
+							return false;
+						state = STATE_COMMA_OR_CLOSE;
+						break;
+				}
+				break;
+		}
+		if (!ok) {
+			m_aborted = true;
+			return false;
+		}
+	}
+}
+
+//! Skip whitespaces and comments, returns false on error
+bool wxJSONSaxReader::SkipWhiteSpace()
+{
+	while (m_pos < m_end) {
+		switch (*m_pos) {
+			case ' ':
+			case '\t':
+			case '\r':
+				++m_pos;
+				break;
+			case '\n':
+				Next();
+				break;
+			case '/':
+				if (!SkipComment())
+					return false;
+				break;
+			default:
+				return true;
+		}
+	}
+	return true;
+}
+
+//! Skip a C/C++ comment starting at the current '/' character
+bool wxJSONSaxReader::SkipComment()
+{
+	Next(); // the '/'
+	const int ch = Next();
+	if (ch == '/') {
+		while (m_pos < m_end && *m_pos != '\n') {
+			++m_pos;
+		}
+	} else if (ch == '*') {
+		bool closed = false;
+		while (m_pos < m_end && !closed) {
+			closed = (Next() == '*') && m_pos < m_end && *m_pos == '/';
+		}
+		if (closed) {
+			Next();
+		}
+	} else {
+		AddError(_T("Strange \'/\' (did you want to insert a comment?)"));
+		return false;
+	}
+	AddWarning(wxJSONREADER_ALLOW_COMMENTS, _T("Comments may be tolerated in JSON text but they are not part of JSON syntax"));
+	return m_errors.empty();
+}
+
+//! Read a string after its opening quote into \c out as UTF-8
+/*!
+ Adjacent strings are concatenated (wxJSONREADER_MULTISTRING).
+*/
+bool wxJSONSaxReader::ReadString(std::string& out)
+{
+	out.clear();
+	while (true) {
+		// copy unescaped runs in one go
+		const char* run = m_pos;
+		while (m_pos < m_end && *m_pos != '\"' && *m_pos != '\\' && *m_pos != '\n') {
+			++m_pos;
+		}
+		out.append(run, m_pos - run);
+
+		const int ch = Next();
+		if (ch == '\n') {
+			out += '\n';
+			continue;
+		}
+		if (ch < 0) {
+			AddError(_T("String value is not terminated"));
+			return false;
+		}
+		if (ch == '\"') {
+			// look for a following string to concatenate
+			if (!SkipWhiteSpace())
+				return false;
+			if (m_pos < m_end && *m_pos == '\"') {
+				AddWarning(wxJSONREADER_MULTISTRING, _T("Multiline strings are not allowed by JSON syntax"));
+				if (!m_errors.empty())
+					return false;
+				Next();
+				continue;
+			}
+			break;
+		}
+
+		// an escape sequence
+		const int esc = Next();
+		switch (esc) {
+			case 't':
+				out += '\t';
+				break;
+			case 'n':
+				out += '\n';
+				break;
+			case 'b':
+				out += '\b';
+				break;
+			case 'r':
+				out += '\r';
+				break;
+			case '\"':
+				out += '\"';
+				break;
+			case '\\':
+				out += '\\';
+				break;
+			case '/':
+				out += '/';
+				break;
+			case 'f':
+				out += '\f';
+				break;
+			case 'u': {
+				if (m_end - m_pos < 4) {
+					AddError(_T("String value is not terminated"));
+					return false;
+				}
+				unsigned long cp = 0;
+				for (int i = 0; i < 4; i++) {
+					const int h = HexValue(m_pos[i]);
+					if (h < 0) {
+						AddError(_T("Invalid Unicode Escaped Sequence"));
+						return false;
+					}
+					cp = (cp << 4) | h;
+				}
+				m_pos += 4;
+				// combine surrogate pairs
+				if (cp >= 0xD800 && cp < 0xDC00 && m_end - m_pos >= 6 && m_pos[0] == '\\' && m_pos[1] == 'u') {
+					unsigned long low = 0;
+					bool valid = true;
+					for (int i = 2; i < 6 && valid; i++) {
+						const int h = HexValue(m_pos[i]);
+						valid = h >= 0;
+						low = (low << 4) | h;
+					}
+					if (valid && low >= 0xDC00 && low < 0xE000) {
+						cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+						m_pos += 6;
+					}
+				}
+				AppendUTF8(out, cp);
+				break;
+			}
+			case -1:
+				AddError(_T("String value is not terminated"));
+				return false;
+			default:
+				AddError(wxString::Format(_T("Unknow escaped character \'\\%c\'"), (wxChar)esc));
+				return false;
+		}
+	}
+	if (!out.empty() && wxString::FromUTF8(out.data(), out.size()).empty()) {
+		AddError(_T("String value: the UTF-8 stream is invalid"));
+		return false;
+	}
+	return true;
+}
+
+//! Read a literal or number and report it, see wxJSONReader::ReadValue()
+bool wxJSONSaxReader::ReadLiteral()
+{
+	const char* begin = m_pos;
+	while (m_pos < m_end && !IsTokenEnd(*m_pos)) {
+		++m_pos;
+	}
+	const char* end = m_pos;
+	m_buf.assign(begin, end);
+
+	bool exact = true;
+	bool ok;
+	if (IsLiteral(m_buf, "null", exact)) {
+		ok = m_handler->OnNull();
+	} else if (IsLiteral(m_buf, "true", exact)) {
+		ok = m_handler->OnBool(true);
+	} else if (IsLiteral(m_buf, "false", exact)) {
+		ok = m_handler->OnBool(false);
+	} else {
+		exact = true;
+		bool tSigned = true, tUnsigned = true;
+		switch (*begin) {
+			case '+':
+				tSigned = false;
+				break;
+			case '-':
+				tUnsigned = false;
+				break;
+			default:
+				if (*begin < '0' || *begin > '9') {
+					AddError(wxString::Format(_T("Literal \'%s\' is incorrect (did you forget quotes?)"), wxString::FromUTF8(m_buf.c_str()).c_str()));
+					return false;
+				}
+		}
+
+		wxUint64 ui64;
+		char sign;
+		const bool isInteger = ParseDecimal(begin, end, ui64, sign);
+		if (tSigned && isInteger && sign == '-' && ui64 <= (wxUint64)LLONG_MAX + 1) {
+			ok = m_handler->OnInt((wxInt64)(ui64 * -1));
+		} else if (tSigned && isInteger && sign != '-' && ui64 <= LLONG_MAX) {
+			ok = m_handler->OnInt((wxInt64)ui64);
+		} else if (tUnsigned && isInteger && sign != '-') {
+			ok = m_handler->OnUInt(ui64);
+		} else {
+			char* parsed = NULL;
+			const double d = strtod(m_buf.c_str(), &parsed);
+			if (m_buf.empty() || parsed != m_buf.c_str() + m_buf.size()) {
+				AddError(wxString::Format(_T("Literal \'%s\' is incorrect (did you forget quotes?)"), wxString::FromUTF8(m_buf.c_str()).c_str()));
+				return false;
+			}
+			ok = m_handler->OnDouble(d);
+		}
+	}
+	if (!exact) {
+		AddWarning(wxJSONREADER_CASE, _T("literals must be lowercase"));
+		if (!m_errors.empty())
+			return false;
+	}
+	if (!ok) {
+		m_aborted = true;
+	}
+	return ok;
+}
+
+void wxJSONSaxReader::AddError(const wxString& msg)
+{
+	const int colNo = m_pos - m_lineStart + 1;
+	if ((int)m_errors.size() < m_maxErrors) {
+		m_errors.Add(wxString::Format(_T("Error: line %d, col %d - %s"), m_lineNo, colNo, msg.c_str()));
+	}
+}
+
+//! see wxJSONReader::AddWarning(), disabled extensions are reported as errors
+void wxJSONSaxReader::AddWarning(int type, const wxString& msg)
+{
+	if (type != 0 && (type & m_flags) == 0) {
+		AddError(msg);
+		return;
+	}
+	const int colNo = m_pos - m_lineStart + 1;
+	if ((int)m_warnings.size() < m_maxErrors) {
+		m_warnings.Add(wxString::Format(_T("Warning: line %d, col %d - %s"), m_lineNo, colNo, msg.c_str()));
+	}
+}
+
+
+wxJSONValueBuilder::wxJSONValueBuilder(wxJSONValue& root)
+    : m_root(root)
+{
+}
+
+//! add a value to the innermost open object/array
+wxJSONValue& wxJSONValueBuilder::Store(const wxJSONValue& value)
+{
+	wxJSONValue& parent = *m_stack.back();
+	if (parent.IsArray()) {
+		return parent.Append(value);
+	}
+	wxJSONValue& member = parent[m_key];
+	member = value;
+	return member;
+}
+
+bool wxJSONValueBuilder::OnStartObject()
+{
+	if (m_stack.empty()) {
+		m_root.SetType(wxJSONTYPE_OBJECT);
+		m_stack.push_back(&m_root);
+	} else {
+		m_stack.push_back(&Store(wxJSONValue(wxJSONTYPE_OBJECT)));
+	}
+	return true;
+}
+
+bool wxJSONValueBuilder::OnEndObject()
+{
+	m_stack.pop_back();
+	return true;
+}
+
+bool wxJSONValueBuilder::OnStartArray()
+{
+	if (m_stack.empty()) {
+		m_root.SetType(wxJSONTYPE_ARRAY);
+		m_stack.push_back(&m_root);
+	} else {
+		m_stack.push_back(&Store(wxJSONValue(wxJSONTYPE_ARRAY)));
+	}
+	return true;
+}
+
+bool wxJSONValueBuilder::OnEndArray()
+{
+	m_stack.pop_back();
+	return true;
+}
+
+bool wxJSONValueBuilder::OnKey(const wxString& key)
+{
+	m_key = key;
+	return true;
+}
+
+bool wxJSONValueBuilder::OnString(const wxString& value)
+{
+	Store(wxJSONValue(value));
+	return true;
+}
+
+bool wxJSONValueBuilder::OnInt(wxInt64 value)
+{
+	Store(wxJSONValue(value));
+	return true;
+}
+
+bool wxJSONValueBuilder::OnUInt(wxUint64 value)
+{
+	Store(wxJSONValue(value));
+	return true;
+}
+
+bool wxJSONValueBuilder::OnDouble(double value)
+{
+	Store(wxJSONValue(value));
+	return true;
+}
+
+bool wxJSONValueBuilder::OnBool(bool value)
+{
+	Store(wxJSONValue(value));
+	return true;
+}
+
+bool wxJSONValueBuilder::OnNull()
+{
+	Store(wxJSONValue(wxJSONTYPE_NULL));
+	return true;
+}
@@ -0,0 +1,179 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        jsonsaxreader.h
+// Purpose:     an event based (SAX-style) parser of JSON text
+// Licence:     wxWidgets licence
+/////////////////////////////////////////////////////////////////////////////
+
+#if !defined(_WX_JSONSAXREADER_H)
+#define _WX_JSONSAXREADER_H
+
+#include <string>
+#include <vector>
+
+#include <wx/stream.h>
+#include <wx/string.h>
+#include <wx/arrstr.h>
+
+#include "json_defs.h"
+#include "jsonval.h"
+#include "jsonreader.h"
+
+//! Receives the events generated by wxJSONSaxReader
+/*!
+ All callbacks return \b true to continue parsing; returning \b false
+ aborts the parse (wxJSONSaxReader::WasAborted() then returns true).
+ The default implementations ignore the event.
+*/
+class WXDLLIMPEXP_JSON wxJSONSaxHandler
+{
+public:
+	virtual ~wxJSONSaxHandler()
+	{
+	}
+
+	virtual bool OnStartObject()
+	{
+		return true;
+	}
+	virtual bool OnEndObject()
+	{
+		return true;
+	}
+	virtual bool OnStartArray()
+	{
+		return true;
+	}
+	virtual bool OnEndArray()
+	{
+		return true;
+	}
+	//! called for the name of each object member, before its value
+	virtual bool OnKey(const wxString& /*key*/)
+	{
+		return true;
+	}
+	virtual bool OnString(const wxString& /*value*/)
+	{
+		return true;
+	}
+	virtual bool OnInt(wxInt64 /*value*/)
+	{
+		return true;
+	}
+	virtual bool OnUInt(wxUint64 /*value*/)
+	{
+		return true;
+	}
+	virtual bool OnDouble(double /*value*/)
+	{
+		return true;
+	}
+	virtual bool OnBool(bool /*value*/)
+	{
+		return true;
+	}
+	virtual bool OnNull()
+	{
+		return true;
+	}
+};
+
+//! The SAX-style JSON parser
+/*!
+ Unlike wxJSONReader, which reads one character at a time from a
+ wxInputStream and builds a tree of wxJSONValue objects, this parser
+ scans a contiguous UTF-8 buffer and reports every value to a
+ wxJSONSaxHandler as soon as it is read, so the caller can consume large
+ documents incrementally without building the whole tree.
+
+ The parser accepts the same documents as wxJSONReader: text before the
+ first open-object/array character and after the matching close character
+ is ignored, and the wxJSONREADER_ALLOW_COMMENTS, wxJSONREADER_CASE,
+ wxJSONREADER_MISSING and wxJSONREADER_MULTISTRING extensions are
+ honoured (a warning is reported if enabled, an error otherwise).
+ Numbers are reported with the same typing rules as wxJSONReader: a
+ signed integer if it fits, then an unsigned integer, then a double.
+ Memory buffers (single-quoted strings) are not supported.
+
+ Contrary to wxJSONReader the parser stops at the first error.
+*/
+class WXDLLIMPEXP_JSON wxJSONSaxReader
+{
+public:
+	wxJSONSaxReader(int flags = wxJSONREADER_TOLERANT, int maxErrors = 30);
+
+	int Parse(const wxString& doc, wxJSONSaxHandler& handler);
+	int Parse(wxInputStream& doc, wxJSONSaxHandler& handler);
+	int Parse(const char* doc, size_t len, wxJSONSaxHandler& handler);
+
+	int GetDepth() const;
+	int GetErrorCount() const;
+	int GetWarningCount() const;
+	const wxArrayString& GetErrors() const;
+	const wxArrayString& GetWarnings() const;
+	//! true if the handler stopped the last Parse() call
+	bool WasAborted() const;
+
+private:
+	bool DoParse();
+	bool ReadString(std::string& out);
+	bool ReadLiteral();
+	bool SkipWhiteSpace();
+	bool SkipComment();
+	bool IsMemberPending() const;
+	void AddError(const wxString& msg);
+	void AddWarning(int type, const wxString& msg);
+	int Next();
+
+	int m_flags;
+	int m_maxErrors;
+
+	const char* m_pos;
+	const char* m_end;
+	int m_lineNo;
+	const char* m_lineStart;
+
+	int m_depth;
+	bool m_aborted;
+	wxJSONSaxHandler* m_handler;
+
+	//! the open containers: '{' or '['
+	std::vector<char> m_stack;
+	//! scratch buffer for strings, reused across values
+	std::string m_buf;
+
+	wxArrayString m_errors;
+	wxArrayString m_warnings;
+};
+
+//! A wxJSONSaxHandler which builds a wxJSONValue tree
+/*!
+ Produces the same tree as wxJSONReader::Parse() for documents which are
+ accepted by both parsers.
+*/
+class WXDLLIMPEXP_JSON wxJSONValueBuilder : public wxJSONSaxHandler
+{
+public:
+	explicit wxJSONValueBuilder(wxJSONValue& root);
+
+	virtual bool OnStartObject();
+	virtual bool OnEndObject();
+	virtual bool OnStartArray();
+	virtual bool OnEndArray();
+	virtual bool OnKey(const wxString& key);
+	virtual bool OnString(const wxString& value);
+	virtual bool OnInt(wxInt64 value);
+	virtual bool OnUInt(wxUint64 value);
+	virtual bool OnDouble(double value);
+	virtual bool OnBool(bool value);
+	virtual bool OnNull();
+
+private:
+	wxJSONValue& Store(const wxJSONValue& value);
+
+	wxJSONValue& m_root;
+	std::vector<wxJSONValue*> m_stack;
+	wxString m_key;
+};
+
+#endif // not defined _WX_JSONSAXREADER_H
@@ -0,0 +1,300 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#include "optionspreset.h"
+
+#include <wx/config.h>
+#include <wx/ffile.h>
+#include <wx/filefn.h>
+#include <wx/log.h>
+#include <wx/tokenzr.h>
+
+#include <locale>
+#include <sstream>
+
+#include "json/wx/jsonreader.h"
+#include "json/wx/jsonwriter.h"
+#include "utils/conversion.h"
+
+// numbers are always written with a '.', independent of the locale in use
+static bool ParseNumber(const std::string& str, double& number)
+{
+	std::istringstream stream(str);
+	stream.imbue(std::locale::classic());
+	stream >> number;
+	return !stream.fail() && stream.eof();
+}
+
+static std::string FormatNumber(double number)
+{
+	std::ostringstream stream;
+	stream.imbue(std::locale::classic());
+	stream.precision(15);
+	stream << number;
+	return stream.str();
+}
+
+static wxJSONValue OptionToJSON(const OptionsPreset::Option& option)
+{
+	switch (option.type) {
+		case OptionsPreset::Option::TYPE_BOOL:
+			return wxJSONValue(option.value == "1" || option.value == "true");
+		case OptionsPreset::Option::TYPE_NUMBER: {
+			double number;
+			if (ParseNumber(option.value, number))
+				return wxJSONValue(number);
+			break;
+		}
+		case OptionsPreset::Option::TYPE_STRING:
+			break;
+	}
+	return wxJSONValue(TowxString(option.value));
+}
+
+static bool OptionFromJSON(const wxJSONValue& value, OptionsPreset::Option& option)
+{
+	if (value.IsBool()) {
+		option = OptionsPreset::Option(OptionsPreset::Option::TYPE_BOOL, value.AsBool() ? "1" : "0");
+	} else if (value.IsDouble()) {
+		option = OptionsPreset::Option(OptionsPreset::Option::TYPE_NUMBER, FormatNumber(value.AsDouble()));
+	} else if (value.IsLong()) {
+		option = OptionsPreset::Option(OptionsPreset::Option::TYPE_NUMBER, stdprintf("%ld", value.AsLong()));
+	} else if (value.IsString()) {
+		option = OptionsPreset::Option(OptionsPreset::Option::TYPE_STRING, STD_STRING(value.AsString()));
+	} else {
+		return false;
+	}
+	return true;
+}
+
+static wxJSONValue PresetToJSON(const OptionsPreset& preset)
+{
+	wxJSONValue res(wxJSONTYPE_OBJECT);
+	wxJSONValue& options = res[_T("options")];
+	options.SetType(wxJSONTYPE_OBJECT);
+	for (const auto& section : preset.options) {
+		wxJSONValue& values = options[TowxString(section.first)];
+		values.SetType(wxJSONTYPE_OBJECT);
+		for (const auto& option : section.second) {
+			values[TowxString(option.first)] = OptionToJSON(option.second);
+		}
+	}
+	res[_T("map")] = TowxString(preset.mapname);
+	wxJSONValue& rects = res[_T("startrects")];
+	rects.SetType(wxJSONTYPE_ARRAY);
+	for (const OptionsPreset::StartRect& rect : preset.startrects) {
+		wxJSONValue value(wxJSONTYPE_OBJECT);
+		value[_T("ally")] = rect.ally;
+		value[_T("left")] = rect.left;
+		value[_T("top")] = rect.top;
+		value[_T("right")] = rect.right;
+		value[_T("bottom")] = rect.bottom;
+		rects.Append(value);
+	}
+	wxJSONValue& restrictions = res[_T("restrictions")];
+	restrictions.SetType(wxJSONTYPE_OBJECT);
+	for (const auto& unit : preset.restrictions) {
+		restrictions[TowxString(unit.first)] = unit.second;
+	}
+	return res;
+}
+
+static OptionsPreset PresetFromJSON(const wxJSONValue& value)
+{
+	OptionsPreset preset;
+	const wxJSONValue options = value.ItemAt(_T("options"));
+	const wxArrayString sections = options.GetMemberNames();
+	for (size_t i = 0; i < sections.GetCount(); i++) {
+		long section;
+		if (!sections[i].ToLong(&section))
+			continue;
+		const wxJSONValue values = options.ItemAt(sections[i]);
+		const wxArrayString keys = values.GetMemberNames();
+		OptionsPreset::OptionMap& map = preset.options[section];
+		for (size_t k = 0; k < keys.GetCount(); k++) {
+			OptionsPreset::Option option;
+			if (OptionFromJSON(values.ItemAt(keys[k]), option))
+				map[STD_STRING(keys[k])] = option;
+		}
+	}
+	preset.mapname = STD_STRING(value.ItemAt(_T("map")).AsString());
+	const wxJSONValue rects = value.ItemAt(_T("startrects"));
+	const int rectcount = rects.IsArray() ? rects.Size() : 0;
+	for (int i = 0; i < rectcount; i++) {
+		const wxJSONValue rect = rects.ItemAt(static_cast<unsigned>(i));
+		OptionsPreset::StartRect startrect;
+		startrect.ally = rect.ItemAt(_T("ally")).AsInt();
+		startrect.left = rect.ItemAt(_T("left")).AsInt();
+		startrect.top = rect.ItemAt(_T("top")).AsInt();
+		startrect.right = rect.ItemAt(_T("right")).AsInt();
+		startrect.bottom = rect.ItemAt(_T("bottom")).AsInt();
+		preset.startrects.push_back(startrect);
+	}
+	const wxJSONValue restrictions = value.ItemAt(_T("restrictions"));
+	const wxArrayString units = restrictions.GetMemberNames();
+	for (size_t i = 0; i < units.GetCount(); i++) {
+		preset.restrictions[STD_STRING(units[i])] = restrictions.ItemAt(units[i]).AsInt();
+	}
+	return preset;
+}
+
+//! @return the names of the groups or entries in @p path
+static wxArrayString GetConfigChildren(wxConfigBase& config, const wxString& path, bool groups)
+{
+	const wxString oldpath = config.GetPath();
+	config.SetPath(path);
+	wxString name;
+	long index;
+	wxArrayString res;
+	bool exists = groups ? config.GetFirstGroup(name, index) : config.GetFirstEntry(name, index);
+	while (exists) {
+		res.Add(name);
+		exists = groups ? config.GetNextGroup(name, index) : config.GetNextEntry(name, index);
+	}
+	config.SetPath(oldpath);
+	return res;
+}
+
+PresetStore::PresetStore()
+    : m_writable(true)
+{
+}
+
+bool PresetStore::Load(const wxString& path)
+{
+	m_path = path;
+	m_writable = true;
+	m_presets.clear();
+	if (!wxFileExists(path))
+		return false;
+
+	wxFFile file(path, _T("rb"));
+	wxString content;
+	if (!file.IsOpened() || !file.ReadAll(&content, wxConvUTF8)) {
+		m_writable = false;
+		return false;
+	}
+	wxJSONReader reader;
+	wxJSONValue root;
+	if (reader.Parse(content, &root) > 0 || !root.IsObject()) {
+		wxLogWarning(_T("Couldn't parse option presets in %s"), path.c_str());
+		m_writable = false;
+		return false;
+	}
+	const int version = root.ItemAt(_T("version")).AsInt();
+	if (version > Version) {
+		wxLogWarning(_T("Option presets in %s were saved by a newer version of SpringLobby"), path.c_str());
+		m_writable = false;
+		return false;
+	}
+
+	const wxJSONValue presets = root.ItemAt(_T("presets"));
+	const wxArrayString names = presets.GetMemberNames();
+	for (size_t i = 0; i < names.GetCount(); i++) {
+		m_presets[names[i]] = PresetFromJSON(presets.ItemAt(names[i]));
+	}
+	return true;
+}
+
+bool PresetStore::Save() const
+{
+	if (m_path.empty() || !m_writable)
+		return false;
+	wxJSONValue root(wxJSONTYPE_OBJECT);
+	root[_T("version")] = Version;
+	wxJSONValue& presets = root[_T("presets")];
+	presets.SetType(wxJSONTYPE_OBJECT);
+	for (const auto& preset : m_presets) {
+		presets[preset.first] = PresetToJSON(preset.second);
+	}
+	wxString content;
+	wxJSONWriter writer(wxJSONWRITER_STYLED);
+	writer.Write(root, content);
+
+	// write to a temporary file first, so an interrupted write never loses all presets
+	const wxString tmpfile = m_path + _T(".tmp");
+	{
+		wxFFile file(tmpfile, _T("wb"));
+		if (!file.IsOpened() || !file.Write(content, wxConvUTF8))
+			return false;
+	}
+	return wxRenameFile(tmpfile, m_path, true);
+}
+
+wxArrayString PresetStore::GetNames() const
+{
+	wxArrayString names;
+	for (const auto& preset : m_presets) {
+		names.Add(preset.first);
+	}
+	return names;
+}
+
+bool PresetStore::Get(const wxString& name, OptionsPreset& preset) const
+{
+	const std::map<wxString, OptionsPreset>::const_iterator it = m_presets.find(name);
+	if (it == m_presets.end())
+		return false;
+	preset = it->second;
+	return true;
+}
+
+void PresetStore::Set(const wxString& name, const OptionsPreset& preset)
+{
+	m_presets[name] = preset;
+}
+
+void PresetStore::Remove(const wxString& name)
+{
+	m_presets.erase(name);
+}
+
+bool PresetStore::Import(wxConfigBase& config, const wxString& base, int privatetype)
+{
+	const wxArrayString names = GetConfigChildren(config, base, true);
+	for (size_t n = 0; n < names.GetCount(); n++) {
+		OptionsPreset preset;
+		const wxArrayString types = GetConfigChildren(config, base + _T("/") + names[n], true);
+		for (size_t t = 0; t < types.GetCount(); t++) {
+			long optiontype;
+			if (!types[t].ToLong(&optiontype))
+				continue;
+			const wxString path = base + _T("/") + names[n] + _T("/") + types[t];
+			const wxArrayString keys = GetConfigChildren(config, path, false);
+			std::map<wxString, wxString> values;
+			for (size_t k = 0; k < keys.GetCount(); k++) {
+				values[keys[k]] = config.Read(path + _T("/") + keys[k]);
+			}
+			if (optiontype != privatetype) {
+				// old presets only stored strings, the type is known again after the preset was saved
+				for (std::map<wxString, wxString>::const_iterator it = values.begin(); it != values.end(); ++it) {
+					preset.options[optiontype][STD_STRING(it->first)] = OptionsPreset::Option(OptionsPreset::Option::TYPE_STRING, STD_STRING(it->second));
+				}
+				continue;
+			}
+			preset.mapname = STD_STRING(values[_T("mapname")]);
+			const long rectcount = FromwxString(values[_T("numrects")]);
+			for (long r = 0; r < rectcount; r++) {
+				const wxString prefix = _T("rect_") + TowxString(r);
+				OptionsPreset::StartRect rect;
+				rect.ally = FromwxString(values[prefix + _T("_ally")]);
+				if (rect.ally == 0)
+					continue;
+				rect.ally--; // stored 1-based to tell missing entries apart
+				rect.left = FromwxString(values[prefix + _T("_left")]);
+				rect.top = FromwxString(values[prefix + _T("_top")]);
+				rect.right = FromwxString(values[prefix + _T("_right")]);
+				rect.bottom = FromwxString(values[prefix + _T("_bottom")]);
+				preset.startrects.push_back(rect);
+			}
+			wxStringTokenizer tkr(values[_T("restrictions")], _T('\t'));
+			while (tkr.HasMoreTokens()) {
+				const wxString unitinfo = tkr.GetNextToken();
+				preset.restrictions[STD_STRING(unitinfo.BeforeLast(_T('=')))] = FromwxString(unitinfo.AfterLast(_T('=')));
+			}
+		}
+		// presets saved with the current version take precedence
+		if (m_presets.find(names[n]) == m_presets.end())
+			m_presets[names[n]] = preset;
+	}
+	return !names.IsEmpty();
+}
@@ -0,0 +1,94 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#ifndef SPRINGLOBBY_OPTIONSPRESET_H_INCLUDED
+#define SPRINGLOBBY_OPTIONSPRESET_H_INCLUDED
+
+#include <wx/arrstr.h>
+#include <wx/string.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+class wxConfigBase;
+
+//! a saved set of battle options, see IBattle::SaveOptionsPreset
+struct OptionsPreset
+{
+	struct Option
+	{
+		enum Type {
+			TYPE_STRING,
+			TYPE_BOOL,
+			TYPE_NUMBER
+		};
+
+		Option()
+		    : type(TYPE_STRING)
+		{
+		}
+		Option(Type type_, const std::string& value_)
+		    : type(type_)
+		    , value(value_)
+		{
+		}
+
+		Type type;
+		//! the value as it's passed to the battle options
+		std::string value;
+	};
+	typedef std::map<std::string, Option> OptionMap;
+
+	struct StartRect
+	{
+		int ally;
+		int left;
+		int top;
+		int right;
+		int bottom;
+	};
+
+	//! key is a LSL::Enum::GameOption, private options are stored in the fields below
+	std::map<int, OptionMap> options;
+	std::string mapname;
+	std::vector<StartRect> startrects;
+	std::map<std::string, int> restrictions;
+};
+
+/** @brief All option presets, stored in one versioned json document.
+ *
+ * The document is read at once when loading, options keep their type
+ * (bool, number or string) so they don't have to be guessed from strings.
+ */
+class PresetStore
+{
+public:
+	static const int Version = 1;
+
+	PresetStore();
+
+	//! @return false if the file doesn't exist or can't be parsed, a damaged file isn't overwritten by Save()
+	bool Load(const wxString& path);
+	bool Save() const;
+
+	wxArrayString GetNames() const;
+	bool Get(const wxString& name, OptionsPreset& preset) const;
+	void Set(const wxString& name, const OptionsPreset& preset);
+	void Remove(const wxString& name);
+
+	/** @brief Imports the presets old versions kept in @p config below @p base.
+	 * Options were stored as strings in one group per option type, group
+	 * @p privatetype holds the map, start rects and restrictions. Presets
+	 * which are already in the store are kept.
+	 * @return false if there was nothing to import
+	 */
+	bool Import(wxConfigBase& config, const wxString& base, int privatetype);
+
+private:
+	wxString m_path;
+	//! false if the file couldn't be read or was written by a newer version, it isn't overwritten then
+	bool m_writable;
+	std::map<wxString, OptionsPreset> m_presets;
+};
+
+#endif // SPRINGLOBBY_OPTIONSPRESET_H_INCLUDED
@@ -2,11 +2,13 @@
 
 #include "savegamelist.h"
 
-#include <fstream>
+#include <wx/filefn.h>
 #include <wx/filename.h>
+#include <wx/log.h>
 
 #include "storedgame.h"
 #include "utils/conversion.h"
+#include "utils/savegamereader.h"
 
 SavegameList::SavegameList()
 {
@@ -16,6 +18,15 @@ SavegameList::SavegameList()
 void SavegameList::LoadPlaybacks(const std::vector<std::string>& filenames)
 {
 	m_replays.clear();
+	// forget savegames which were deleted since the last scan
+	std::map<std::string, CachedScript> cache;
+	for (size_t i = 0; i < filenames.size(); ++i) {
+		const std::map<std::string, CachedScript>::iterator it = m_scriptCache.find(filenames[i]);
+		if (it != m_scriptCache.end())
+			cache.insert(*it);
+	}
+	m_scriptCache.swap(cache);
+
 	const size_t size = filenames.size();
 	for (size_t i = 0; i < size; ++i) {
 		const std::string fn = filenames[i];
@@ -53,16 +64,18 @@ bool SavegameList::GetSavegameInfos(const std::string& SavegamePath, StoredGame&
 
 std::string SavegameList::GetScriptFromSavegame(const std::string& SavegamePath) const
 {
-	// blatantly copied from spring source
-	std::ifstream file(SavegamePath.c_str(), std::ios::in | std::ios::binary);
-	std::string script;
-	char c;
-	if (file.is_open()) {
-		do {
-			file.read(&c, sizeof(char));
-			if (c)
-				script += c;
-		} while ((c != 0) && !file.fail());
+	const wxString path = TowxString(SavegamePath);
+	const unsigned long size = wxFileName::GetSize(path).ToULong();
+	const time_t mtime = wxFileModificationTime(path);
+	const std::map<std::string, CachedScript>::const_iterator it = m_scriptCache.find(SavegamePath);
+	if (it != m_scriptCache.end() && it->second.size == size && it->second.mtime == mtime)
+		return it->second.script;
+
+	CachedScript& entry = m_scriptCache[SavegamePath];
+	entry.size = size;
+	entry.mtime = mtime;
+	if (!SavegameReader::ReadScript(SavegamePath, entry.script)) {
+		wxLogWarning(_T("Savegame %s is truncated or corrupt"), path.c_str());
 	}
-	return script;
+	return entry.script;
 }
@@ -3,6 +3,10 @@
 #ifndef SAVEGAMELIST_H
 #define SAVEGAMELIST_H
 
+#include <ctime>
+#include <map>
+#include <string>
+
 #include "iplaybacklist.h"
 
 struct StoredGame;
@@ -18,6 +22,15 @@ private:
 private:
 	bool GetSavegameInfos(const std::string& SavegamePath, StoredGame& ret) const;
 	std::string GetScriptFromSavegame(const std::string& SavegamePath) const;
+
+	//! script of a savegame as read from disk, reused as long as the file is unchanged
+	struct CachedScript
+	{
+		unsigned long size;
+		time_t mtime;
+		std::string script;
+	};
+	mutable std::map<std::string, CachedScript> m_scriptCache;
 };
 
 #endif // SAVEGAMELIST_H
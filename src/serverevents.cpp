@@ -157,6 +157,8 @@ void ServerEvents::OnUserStatus(const std::string& nick, UserStatus status)
 		ui().OnUserStatusChanged(user);
 		if (user.GetBattle() != 0) {
 			IBattle& battle = *user.GetBattle();
+			if (status.rank != oldStatus.rank)
+				battle.InvalidateScript(IBattle::ScriptCache::Mask(IBattle::ScriptCache::SECTION_PLAYERS));
 			try {
 				if (battle.GetFounder().GetNick() == user.GetNick()) {
 					if (status.in_game != battle.GetInGame()) {
@@ -327,7 +329,7 @@ void ServerEvents::OnUserJoinedBattle(int battleid, const std::string& nick, con
 		IBattle& battle = m_serv.GetBattle(battleid);
 
 		battle.OnUserAdded(user);
-		user.BattleStatus().scriptPassword = userScriptPassword;
+		user.BattleStatus().SetScriptPassword(userScriptPassword);
 		ui().OnUserJoinedBattle(battle, user);
 		try {
 			if (&user == &battle.GetFounder()) {
@@ -351,7 +353,7 @@ void ServerEvents::OnUserLeftBattle(int battleid, const std::string& nick)
 		User& user = battle.GetUser(nick);
 		// this is necessary since the user will be deleted when the gui function is called
 		bool isbot = user.BattleStatus().IsBot();
-		user.BattleStatus().scriptPassword.clear();
+		user.BattleStatus().SetScriptPassword("");
 		battle.OnUserRemoved(user);
 		ui().OnUserLeftBattle(battle, user, isbot);
 	} catch (std::runtime_error& except) {
@@ -773,9 +775,10 @@ void ServerEvents::OnClientIPPort(const std::string& username, const std::string
 	try {
 		User& user = m_serv.GetCurrentBattle()->GetUser(username);
 
-		user.BattleStatus().ip = ip;
+		user.BattleStatus().SetIP(ip);
 		user.BattleStatus().udpport = udpport;
-		wxLogMessage(_T("set to %s %d "), user.BattleStatus().ip.c_str(), user.BattleStatus().udpport);
+		m_serv.GetCurrentBattle()->InvalidateScript(IBattle::ScriptCache::Mask(IBattle::ScriptCache::SECTION_PLAYERS));
+		wxLogMessage(_T("set to %s %d "), user.BattleStatus().GetIP().c_str(), user.BattleStatus().udpport);
 
 		if (sett().GetShowIPAddresses()) {
 			UiEvents::GetUiEventSender(UiEvents::OnBattleActionEvent).SendEvent(
@@ -26,10 +26,13 @@
 #include <lslutils/misc.h>
 #include <lslutils/globalsmanager.h>
 #include <lslunitsync/unitsync.h>
+#include <lslunitsync/optionswrapper.h>
 
 #include "utils/conversion.h"
+#include "utils/multipatternmatcher.h"
 #include "utils/platform.h"
 #include "utils/slpaths.h"
+#include "optionspreset.h"
 #include "playbackfiltervalues.h"
 #include "springsettings/presets.h"
 
@@ -58,6 +61,8 @@ Settings& sett()
 }
 
 Settings::Settings()
+    : m_presets_loaded(false)
+    , m_highlight_matcher_valid(false)
 {
 }
 
@@ -598,41 +603,51 @@ void Settings::SetLastHostRelayedMode(bool value)
 	cfg().Write(_T( "/Hosting/LastRelayedMode" ), value);
 }
 
-void Settings::SetHostingPreset(const wxString& name, int optiontype, std::map<wxString, wxString> options)
+PresetStore& Settings::GetPresetStore()
 {
-	cfg().DeleteGroup(_T( "/Hosting/Preset/" ) + name + _T( "/" ) + TowxString(optiontype));
-	for (std::map<wxString, wxString>::const_iterator it = options.begin(); it != options.end(); ++it) {
-		cfg().Write(_T( "/Hosting/Preset/" ) + name + _T( "/" ) + TowxString(optiontype) + _T( "/" ) + it->first, it->second);
+	if (!m_presets_loaded) {
+		m_presets_loaded = true;
+		m_presets.Load(TowxString(SlPaths::GetLobbyWriteDir() + "presets.json"));
+		MigrateHostingPresets();
 	}
+	return m_presets;
 }
 
-std::map<wxString, wxString> Settings::GetHostingPreset(const wxString& name, int optiontype)
+void Settings::MigrateHostingPresets()
 {
-	wxString path_base = _T( "/Hosting/Preset/" ) + name + _T( "/" ) + TowxString(optiontype);
-	std::map<wxString, wxString> ret;
-	wxArrayString list = cfg().GetEntryList(path_base);
+	const wxString base = _T( "/Hosting/Preset" );
+	if (!m_presets.Import(cfg(), base, LSL::Enum::PrivateOptions))
+		return;
+	if (m_presets.Save()) {
+		cfg().DeleteGroup(base);
+		SaveSettings();
+	}
+}
 
-	slConfig::PathGuard pathGuard(&cfg(), path_base);
+void Settings::SetOptionsPreset(const wxString& name, const OptionsPreset& preset)
+{
+	PresetStore& store = GetPresetStore();
+	store.Set(name, preset);
+	store.Save();
+}
 
-	int count = list.GetCount();
-	for (int i = 0; i < count; i++) {
-		wxString keyname = list[i];
-		wxString val = cfg().Read(keyname);
-		ret[keyname] = val;
-	}
-	return ret;
+bool Settings::GetOptionsPreset(const wxString& name, OptionsPreset& preset)
+{
+	return GetPresetStore().Get(name, preset);
 }
 
 
 wxArrayString Settings::GetPresetList()
 {
-	return cfg().GetGroupList(_T( "/Hosting/Preset" ));
+	return GetPresetStore().GetNames();
 }
 
 
 void Settings::DeletePreset(const wxString& name)
 {
-	cfg().DeleteGroup(_T( "/Hosting/Preset/" ) + name);
+	PresetStore& store = GetPresetStore();
+	store.Remove(name);
+	store.Save();
 
 	//delete mod default preset associated
 	wxArrayString list = cfg().GetEntryList(_T( "/Hosting/ModDefaultPreset" ));
@@ -961,6 +976,7 @@ wxArrayString Settings::getFromList(const wxString& path)
 void Settings::SetHighlightedWords(const wxArrayString& words)
 {
 	setFromList(words, _T("/Chat/HighlightedWords"));
+	m_highlight_matcher_valid = false;
 }
 
 wxArrayString Settings::GetHighlightedWords()
@@ -968,6 +984,21 @@ wxArrayString Settings::GetHighlightedWords()
 	return getFromList(_T("/Chat/HighlightedWords"));
 }
 
+const MultiPatternMatcher& Settings::GetHighlightMatcher()
+{
+	if (!m_highlight_matcher_valid) {
+		const wxArrayString words = GetHighlightedWords();
+		std::vector<std::wstring> patterns;
+		patterns.reserve(words.GetCount());
+		for (size_t i = 0; i < words.GetCount(); i++) {
+			patterns.push_back(words[i].ToStdWstring());
+		}
+		m_highlight_matcher.Build(patterns);
+		m_highlight_matcher_valid = true;
+	}
+	return m_highlight_matcher;
+}
+
 void Settings::ConvertLists()
 {
 	const wxArrayString current_hl = cfg().GetEntryList(_T( "/Chat/HighlightedWords" ));
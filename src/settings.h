@@ -11,6 +11,8 @@
 #include "utils/mixins.h"
 #include "useractions.h"
 #include "utils/sortutil.h"
+#include "utils/multipatternmatcher.h"
+#include "optionspreset.h"
 
 const long CACHE_VERSION = 14;
 const long SETTINGS_VERSION = 31;
@@ -312,6 +314,8 @@ public:
 
 	void SetHighlightedWords(const wxArrayString& words);
 	wxArrayString GetHighlightedWords();
+	//! the highlighted words compiled into one automaton, rebuilt only after SetHighlightedWords()
+	const MultiPatternMatcher& GetHighlightMatcher();
 
 	//!\brief controls if user attention is requested when highlighting a line
 	void SetRequestAttOnHighlight(const bool req);
@@ -360,8 +364,9 @@ public:
 	void SetLastAutolockStatus(bool value);
 	void SetLastHostRelayedMode(bool value);
 
-	void SetHostingPreset(const wxString& name, int optiontype, std::map<wxString, wxString> options);
-	std::map<wxString, wxString> GetHostingPreset(const wxString& name, int optiontype);
+	//! stores the preset and writes all presets to disk
+	void SetOptionsPreset(const wxString& name, const OptionsPreset& preset);
+	bool GetOptionsPreset(const wxString& name, OptionsPreset& preset);
 	wxArrayString GetPresetList();
 	void DeletePreset(const wxString& name);
 
@@ -550,8 +555,18 @@ private:
      */
 
 	int GetChannelJoinIndex(const wxString& name);
+	//! loads the presets on first use
+	PresetStore& GetPresetStore();
+	//! moves presets saved in the config file by old versions to the preset store
+	void MigrateHostingPresets();
 	void setFromList(const wxArrayString& list, const wxString& path);
 	wxArrayString getFromList(const wxString& path);
+
+	PresetStore m_presets;
+	bool m_presets_loaded;
+	//! built from the highlighted words on first use
+	MultiPatternMatcher m_highlight_matcher;
+	bool m_highlight_matcher_valid;
 };
 
 Settings& sett();
@@ -53,7 +53,7 @@ void SinglePlayerBattle::SendHostInfo(HostInfo update)
 	}
 	if ((update & HI_Send_All_opts) != 0) {
 		for (int i = 0; i < (int)LSL::Enum::LastOption; i++) {
-			for (const auto pair : CustomBattleOptions().getOptionsMap((LSL::Enum::GameOption)i)) {
+			for (const auto pair : GetCustomBattleOptions().getOptionsMap((LSL::Enum::GameOption)i)) {
 				Update(stdprintf("%d_%s", i, pair.first.c_str()));
 			}
 		}
@@ -69,7 +69,7 @@ void SinglePlayerBattle::RemoveUnfittingBots()
 	for (auto it = diff.begin(); it != end; ++it) {
 		for (size_t j = 0; j < GetNumUsers(); ++j) {
 			User& u = GetUser(j);
-			if (u.GetBattleStatus().airawname == *it)
+			if (u.GetBattleStatus().GetAIRawName() == *it)
 				KickPlayer(u);
 		}
 	}
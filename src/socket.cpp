@@ -12,9 +12,7 @@ lsl/networking/socket.cpp
 !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
 **/
 
-#include <wx/socket.h>
 #include <wx/string.h>
-#include <wx/convauto.h>
 #include <wx/log.h>
 
 #ifdef WIN32
@@ -27,6 +25,10 @@ lsl/networking/socket.cpp
 
 #include <stdexcept>
 #include <algorithm>
+#include <deque>
+#include <map>
+#include <vector>
+#include <boost/bind.hpp>
 
 #include "socket.h"
 #include "inetclass.h"
@@ -132,37 +134,109 @@ std::string _GetHandle()
 	return res;
 }
 
+static const wxEventType SocketFlushEvent = wxNewEventType();
+static const wxEventType SocketBatchEvent = wxNewEventType();
+
+//! @brief Owns the network thread and passes its events to the sockets on the gui thread.
+class SocketDispatcher : public wxEvtHandler
+{
+public:
+	SocketDispatcher()
+	    : m_thread(boost::bind(&SocketDispatcher::OnEventsQueued, this))
+	{
+	}
+
+	NetworkThread& GetThread()
+	{
+		return m_thread;
+	}
+	void Register(NetworkThread::SessionId session, Socket* socket)
+	{
+		m_sockets[session] = socket;
+	}
+	void Unregister(NetworkThread::SessionId session)
+	{
+		m_sockets.erase(session);
+	}
+
+private:
+	//! called on the network thread when a new batch starts
+	void OnEventsQueued()
+	{
+		wxCommandEvent evt(SocketBatchEvent, SOCKET_ID);
+		AddPendingEvent(evt);
+	}
+
+	void OnBatch(wxCommandEvent& /*event*/)
+	{
+		std::vector<NetworkThread::Event> batch;
+		m_thread.TakeEvents(batch);
+		m_pending.insert(m_pending.end(), batch.begin(), batch.end());
+		// a handler may run a modal loop which dispatches the next batch, taking
+		// one event at a time keeps the order then
+		while (!m_pending.empty()) {
+			const NetworkThread::Event event = m_pending.front();
+			m_pending.pop_front();
+			// looked up for each event, a handler may delete or reconnect sockets
+			std::map<NetworkThread::SessionId, Socket*>::iterator it = m_sockets.find(event.session);
+			if (it != m_sockets.end())
+				it->second->OnNetworkEvent(event);
+		}
+	}
+
+	std::map<NetworkThread::SessionId, Socket*> m_sockets;
+	std::deque<NetworkThread::Event> m_pending;
+	NetworkThread m_thread;
+
+	DECLARE_EVENT_TABLE()
+};
+
+BEGIN_EVENT_TABLE(SocketDispatcher, wxEvtHandler)
+EVT_COMMAND(SOCKET_ID, SocketBatchEvent, SocketDispatcher::OnBatch)
+END_EVENT_TABLE()
+
+//! not a global object like the others, it must outlive the servers owned by them
+static SocketDispatcher& socketDispatcher()
+{
+	static SocketDispatcher dispatcher;
+	return dispatcher;
+}
+
+
 BEGIN_EVENT_TABLE(Socket, wxEvtHandler)
-EVT_SOCKET(SOCKET_ID, Socket::OnSocketEvent)
+EVT_COMMAND(SOCKET_ID, SocketFlushEvent, Socket::OnFlush)
 END_EVENT_TABLE()
 
 
-void Socket::OnSocketEvent(wxSocketEvent& event)
+void Socket::OnNetworkEvent(const NetworkThread::Event& event)
 {
-	switch (event.GetSocketEvent()) {
-		case wxSOCKET_INPUT:
-			m_net_class.OnDataReceived();
-			break;
-		case wxSOCKET_LOST:
-			m_net_class.OnDisconnected();
-			break;
-		case wxSOCKET_CONNECTION:
+	switch (event.type) {
+		case NetworkThread::Event::EVENT_CONNECTED:
+			m_state = SS_Open;
+			m_local_address = event.params;
 			m_net_class.OnConnected();
 			break;
-		default:
-			m_net_class.OnError("Unknown socket event.");
+		case NetworkThread::Event::EVENT_COMMAND:
+			m_net_class.OnCommand(event.command, event.params, event.replyid);
+			break;
+		case NetworkThread::Event::EVENT_DISCONNECTED:
+			if (!event.params.empty())
+				wxLogMessage(_T("connection lost: %s"), TowxString(event.params).c_str());
+			Detach();
+			m_net_class.OnDisconnected();
 			break;
 	}
+	// the handlers may have deleted this socket
 }
 
 
 //! @brief Constructor
 Socket::Socket(iNetClass& netclass)
-    : m_handle(_GetHandle())
-    , m_connecting(false)
+    : m_session(-1)
+    , m_state(SS_Closed)
+    , m_handle(_GetHandle())
     , m_net_class(netclass)
-    , m_rate(-1)
-    , m_sent(0)
+    , m_flush_pending(false)
 {
 }
 
@@ -170,154 +244,95 @@ Socket::Socket(iNetClass& netclass)
 //! @brief Destructor
 Socket::~Socket()
 {
-	Disconnect();
+	if (m_session != -1) {
+		socketDispatcher().GetThread().Close(m_session);
+		Detach();
+	}
 }
 
 
-//! @brief Creates an TCP socket and sets it up.
-void Socket::InitSocket(wxSocketClient& sock)
-{
-	sock.SetFlags(wxSOCKET_NOWAIT);
-	sock.SetEventHandler(*this, SOCKET_ID);
-	sock.SetNotify(wxSOCKET_CONNECTION_FLAG | wxSOCKET_INPUT_FLAG | wxSOCKET_LOST_FLAG);
-	sock.Notify(true);
-}
-
 //! @brief Connect to remote host.
 void Socket::Connect(const wxString& addr, const int port)
 {
-	wxIPV4address wxaddr;
-	m_connecting = true;
-	m_buffer = "";
-
-	if (!wxaddr.Hostname(addr)) {
-		m_net_class.OnError("Invalid Hostname");
-		return;
-	}
-	if (!wxaddr.Service(port)) {
-		m_net_class.OnError("Invalid Port");
-		return;
+	if (m_session != -1) {
+		socketDispatcher().GetThread().Close(m_session);
+		Detach();
 	}
-
-	InitSocket(m_sock);
-	m_sock.Connect(wxaddr, false);
-	m_sock.SetTimeout(40);
+	m_queue.Clear();
+	m_state = SS_Connecting;
+	m_session = socketDispatcher().GetThread().Open(STD_STRING(addr), port);
+	socketDispatcher().Register(m_session, this);
 }
 
-void Socket::SetTimeout(const int seconds)
+void Socket::Detach()
 {
-	m_sock.SetTimeout(seconds);
+	socketDispatcher().Unregister(m_session);
+	m_session = -1;
+	m_state = SS_Closed;
+	m_local_address.clear();
 }
 
 //! @brief Disconnect from remote host if connected.
 void Socket::Disconnect()
 {
-	m_buffer.clear();
-
-	m_sock.Notify(false);
+	if (m_session != -1) {
+		// last chance for queued commands like EXIT, the network thread writes them before closing
+		Flush();
+		socketDispatcher().GetThread().Close(m_session);
+		Detach();
+	}
+	m_queue.Clear();
 	m_net_class.OnDisconnected();
 }
 
 
 //! @brief Send data over connection.
-bool Socket::Send(const wxString& data)
+//! @note Commands sent in the same event loop iteration are written at once.
+bool Socket::Send(const wxString& data, SendQueue::Priority priority)
 {
-	return _Send(data);
+	if (m_session == -1)
+		return false;
+	m_queue.Push((const char*)data.mb_str(wxConvUTF8), priority);
+	ScheduleFlush();
+	return true;
 }
 
 
-//! @brief Internal send function.
-//! @note Does not lock the criticalsection.
-bool Socket::_Send(const wxString& data)
+void Socket::ScheduleFlush()
 {
-	m_buffer += (const char*)data.mb_str(wxConvUTF8);
-	int crop = m_buffer.length();
-	if (m_rate > 0) {
-		int max = m_rate - m_sent;
-		if (crop > 0)
-			crop = max;
-	}
-	std::string send = m_buffer.substr(0, crop);
-	//wxLogMessage( _T("send: %d  sent: %d  max: %d   :  buff: %d"), send.length() , m_sent, max, m_buffer.length() );
-	m_sock.Write(send.c_str(), send.length());
-	if (!m_sock.Error()) {
-		wxUint32 sentdata = m_sock.LastCount();
-		m_buffer.erase(0, sentdata);
-		m_sent += sentdata;
-	}
-	return !m_sock.Error();
+	if (m_flush_pending)
+		return;
+	m_flush_pending = true;
+	wxCommandEvent evt(SocketFlushEvent, SOCKET_ID);
+	AddPendingEvent(evt);
 }
 
 
-wxString convert(char* buff, const int len)
+void Socket::OnFlush(wxCommandEvent& /*event*/)
 {
-	wxString ret = wxString(buff, wxConvUTF8, len);
-	if (!ret.IsEmpty()) {
-		return ret;
-	}
-	ret = wxString(buff, wxConvLibc, len);
-	if (!ret.empty()) {
-		return ret;
-	}
-	ret = wxString(buff, wxConvLocal, len);
-	if (!ret.IsEmpty()) {
-		return ret;
-	}
-	ret = wxString(buff, wxConvISO8859_1, len);
-	if (!ret.empty()) {
-		return ret;
-	}
-	ret = wxString(buff, wxConvAuto(), len);
-	if (!ret.empty()) {
-		return ret;
-	}
-	std::string tmp(buff, len);
-	wxLogDebug(_T("Error: invalid charset, replacing invalid chars: '%s'"), TowxString(tmp).c_str());
-
-	//worst case, couldn't convert, replace unknown chars!
-	for (int i = 0; i < len; i++) {
-		if ((buff[i] < '!') || (buff[i] > '~')) {
-			buff[i] = '_';
-		}
-	}
-	ret = wxString(buff, wxConvUTF8, len);
-	if (!ret.empty()) {
-		return ret;
-	}
-	wxLogDebug(_T("Fatal Error: couldn't convert: '%s' in socket.receive()"), TowxString(tmp).c_str());
-	return wxEmptyString;
+	m_flush_pending = false;
+	Flush();
 }
 
-//! @brief Receive data from connection
-wxString Socket::Receive()
+
+//! @brief Hands everything the rate limit allows to the network thread at once.
+bool Socket::Flush()
 {
-	wxString ret;
-	static const int chunk_size = 1500;
-	char buf[chunk_size];
-	int readnum = 0;
-
-	do {
-		m_sock.Read(buf, chunk_size);
-		const int readnum = m_sock.LastCount();
-		ret += convert(buf, readnum);
-	} while (readnum > 0);
-
-	return ret;
+	if (m_session == -1)
+		return false;
+	std::string data;
+	m_queue.Take(data);
+	if (data.empty())
+		return true;
+	//wxLogMessage( _T("send: %d  queued: %d"), data.length(), m_queue.GetQueuedBytes() );
+	return socketDispatcher().GetThread().Send(m_session, data);
 }
 
+
 //! @brief Get curent socket state
 SockState Socket::State()
 {
-	if (m_sock.IsConnected()) {
-		m_connecting = false;
-		return SS_Open;
-	} else {
-		if (m_connecting) {
-			return SS_Connecting;
-		} else {
-			return SS_Closed;
-		}
-	}
+	return m_state;
 }
 
 
@@ -329,36 +344,18 @@ SockError Socket::Error() const
 }
 
 
-//! @brief used to retrieve local ip address behind NAT to communicate to the server on login
-std::string Socket::GetLocalAddress() const
-{
-	if (!m_sock.IsConnected())
-		return "";
-
-	wxIPV4address localaddr;
-	m_sock.GetLocal(localaddr);
-
-	return STD_STRING(localaddr.IPAddress());
-}
-
-
 //! @brief Set the maximum upload ratio.
-void Socket::SetSendRateLimit(int Bps)
+//! @param burst bytes which may be sent at once, defaults to Bps
+void Socket::SetSendRateLimit(int Bps, int burst)
 {
-	m_rate = Bps;
+	m_queue.SetRate(Bps, burst);
 }
 
 
 void Socket::Update(int mselapsed)
 {
-	if (m_rate > 0) {
-		m_sent -= int((mselapsed / 1000.0) * m_rate);
-		if (m_sent < 0)
-			m_sent = 0;
-		if (m_buffer.length() > 0) {
-			_Send(wxEmptyString);
-		}
-	} else {
-		m_sent = 0;
+	m_queue.Refill(mselapsed);
+	if (!m_queue.IsEmpty()) {
+		Flush();
 	}
 }
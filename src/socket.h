@@ -19,11 +19,12 @@ lsl/networking/socket.h
 
 #include <wx/string.h>
 #include <wx/event.h>
-#include <wx/socket.h>
 #include <string>
 
+#include "utils/netthread.h"
+#include "utils/sendqueue.h"
+
 class iNetClass;
-class wxCriticalSection;
 
 enum SockState {
 	SS_Closed,
@@ -41,9 +42,13 @@ enum SockError {
 const int SOCKET_ID = 100;
 
 
-class wxSocketEvent;
-
-//! @brief Class that implements a TCP client socket.
+/** @brief Class that implements a TCP client socket.
+ *
+ * All sockets share one network thread which does the socket io and splits
+ * the received data into commands, see NetworkThread. The commands are
+ * passed to the iNetClass on the gui thread, all commands received since
+ * the last event loop iteration at once.
+ */
 class Socket : public wxEvtHandler
 {
 public:
@@ -55,9 +60,12 @@ public:
 	void Connect(const wxString& addr, const int port);
 	void Disconnect();
 
-	bool Send(const wxString& data);
-	wxString Receive();
-	std::string GetLocalAddress() const;
+	//! queues @p data, it's written when the send rate limit allows it
+	bool Send(const wxString& data, SendQueue::Priority priority = SendQueue::PRIORITY_BULK);
+	std::string GetLocalAddress() const
+	{
+		return m_local_address;
+	}
 	std::string GetHandle() const
 	{
 		return m_handle;
@@ -66,30 +74,32 @@ public:
 	SockState State();
 	SockError Error() const;
 
-	void SetSendRateLimit(int Bps = -1);
+	void SetSendRateLimit(int Bps = -1, int burst = 0);
 	int GetSendRateLimit()
 	{
-		return m_rate;
+		return m_queue.GetRate();
 	}
 	void Update(int mselapsed);
 
-	void SetTimeout(const int seconds);
+	//! called on the gui thread for each event of this socket's connection
+	void OnNetworkEvent(const NetworkThread::Event& event);
 
 private:
-	void OnSocketEvent(wxSocketEvent& event);
-	bool _Send(const wxString& data);
-	void InitSocket(wxSocketClient& socket);
+	void OnFlush(wxCommandEvent& event);
+	void ScheduleFlush();
+	bool Flush();
+	//! forgets the connection without notifying the network thread
+	void Detach();
 
 	// Socket variables
 
-	wxSocketClient m_sock;
-	wxString m_ping_msg;
+	NetworkThread::SessionId m_session;
+	SockState m_state;
+	std::string m_local_address;
 	std::string m_handle;
-	bool m_connecting;
 	iNetClass& m_net_class;
-	int m_rate;
-	int m_sent;
-	std::string m_buffer;
+	SendQueue m_queue;
+	bool m_flush_pending;
 
 	DECLARE_EVENT_TABLE();
 };
@@ -49,6 +49,7 @@
 #include "utils/wxTranslationHelper.h"
 #include "gui/playback/playbacktab.h"
 #include "utils/slpaths.h"
+#include "utils/globalevents.h"
 #include "downloader/lib/src/FileSystem/FileSystem.h"
 #include "log.h"
 #include "utils/conversion.h"
@@ -57,6 +58,9 @@
 #include <wx/debugrpt.h>
 #include <wx/intl.h>
 
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+
 #if wxUSE_UNIX
 #include <X11/Xlib.h>
 #endif
@@ -66,12 +70,30 @@ SLCONFIG("/ResetLayout", false, "reset layout on restart");
 
 IMPLEMENT_APP(SpringLobbyApp)
 
+static const wxEventType StartupLoadedEvent = wxNewEventType();
+
 BEGIN_EVENT_TABLE(SpringLobbyApp, wxApp)
+EVT_COMMAND(wxID_ANY, StartupLoadedEvent, SpringLobbyApp::OnStartupLoaded)
 END_EVENT_TABLE()
 
+struct StartupLoader
+{
+	SlPaths::SpringVersionMap versions;
+	boost::thread thread;
+};
+
+//! runs on StartupLoader::thread, must not touch the config, unitsync or any gui object
+static void LoadEngines(wxEvtHandler* handler, SlPaths::SpringVersionMap* versions, const std::list<LSL::SpringBundle>& candidates, const std::string& cachefile)
+{
+	*versions = SlPaths::DiscoverSpringVersions(candidates, cachefile);
+	wxCommandEvent evt(StartupLoadedEvent);
+	wxPostEvent(handler, evt);
+}
+
 SpringLobbyApp::SpringLobbyApp()
     : quit_called(false)
     , m_translationhelper(NULL)
+    , m_startup_loader(NULL)
     , m_log_verbosity(3)
     , m_log_console(true)
     , m_log_window_show(false)
@@ -156,23 +178,38 @@ bool SpringLobbyApp::OnInit()
 	// configure unitsync paths before trying to load
 	SlPaths::ReconfigureUnitsync();
 
-	//unitsync first load, NEEDS to be blocking
-	SlPaths::RefreshSpringVersionList();
-	LSL::usync().ReloadUnitSyncLib();
-
-
 	sett().Setup(m_translationhelper);
 
 	notificationManager(); //needs to be initialized too
 	ui().ShowMainWindow();
 	SetTopWindow(&ui().mw());
-
-	ui().OnInit();
-
 	ui().mw().SetLogWin(loggerwin);
+
+	// scanning the engines can take many seconds, do it while the main window is shown.
+	// the candidates are collected here, as that reads the config. OnStartupLoaded continues.
+	m_startup_loader = new StartupLoader();
+	m_startup_loader->thread = boost::thread(boost::bind(&LoadEngines, this, &m_startup_loader->versions,
+							      SlPaths::GetSpringCandidates(), SlPaths::GetEngineCacheFile()));
 	return true;
 }
 
+void SpringLobbyApp::OnStartupLoaded(wxCommandEvent& /*data*/)
+{
+	if (m_startup_loader == NULL)
+		return;
+	m_startup_loader->thread.join();
+	SlPaths::SetSpringVersionList(m_startup_loader->versions);
+	wxDELETE(m_startup_loader);
+	if (quit_called)
+		return;
+
+	// the gui uses unitsync from the main thread only, so it's loaded here
+	LSL::usync().ReloadUnitSyncLib();
+	GlobalEvent::Send(GlobalEvent::OnUnitsyncReloaded);
+	// autoconnect needs the engine list to check the server's engine version
+	ui().OnInit();
+}
+
 
 //! @brief Finalizes the application
 int SpringLobbyApp::OnExit()
@@ -187,6 +224,11 @@ int SpringLobbyApp::OnExit()
 		wxDELETE(m_translationhelper);
 	}
 
+	if (m_startup_loader != NULL) {
+		m_startup_loader->thread.join();
+		wxDELETE(m_startup_loader);
+	}
+
 	sett().SaveSettings(); // to make sure that cache path gets saved before destroying unitsync
 
 	SetEvtHandlerEnabled(false);
@@ -8,6 +8,7 @@
 class wxIcon;
 class wxLocale;
 class wxTranslationHelper;
+struct StartupLoader;
 
 //! @brief SpringLobby wxApp
 class SpringLobbyApp : public wxApp
@@ -27,11 +28,14 @@ public:
 	virtual bool OnCmdLineParsed(wxCmdLineParser& parser);
 
 	void OnQuit(wxCommandEvent& data);
+	void OnStartupLoaded(wxCommandEvent& data);
 
 private:
 	bool quit_called;
 
 	wxTranslationHelper* m_translationhelper;
+	//! engines and unitsync are loaded on this while the main window is shown already
+	StartupLoader* m_startup_loader;
 
 	long m_log_verbosity;
 	bool m_log_console;
@@ -18,8 +18,14 @@ lsl/spring/springprocess.cpp
 #include "springprocess.h"
 #include "spring.h"
 #include "utils/platform.h"
+#include "utils/childprocess.h"
+#include "utils/conversion.h"
 #include "log.h"
 
+#ifndef __WXMSW__
+#include <string.h>
+#endif
+
 DEFINE_LOCAL_EVENT_TYPE(wxEVT_SPRING_EXIT)
 
 SpringProcess::SpringProcess(Spring& sp)
@@ -43,6 +49,12 @@ void SpringProcess::SetCommand(const wxString& cmd, const wxArrayString& params)
 }
 
 
+void SpringProcess::SetChild(const std::shared_ptr<ChildProcess>& child)
+{
+	m_child = child;
+}
+
+
 void SpringProcess::OnExit()
 {
 	slLogDebugFunc("");
@@ -54,6 +66,36 @@ void SpringProcess::OnExit()
 void* SpringProcess::Entry()
 {
 	slLogDebugFunc("");
-	RunProcess(m_cmd, m_params);
+#ifdef __WXMSW__
+	m_exit_code = RunProcess(m_cmd, m_params);
+#else
+	std::vector<std::string> args;
+	for (const wxString& param : m_params) {
+		args.push_back(STD_STRING(param));
+	}
+	if (!m_child)
+		m_child = std::make_shared<ChildProcess>();
+	std::string error;
+	if (!m_child->Start(STD_STRING(m_cmd), args, error)) {
+		wxLogError(_T("Couldn't start %s: %s"), m_cmd.c_str(), TowxString(error).c_str());
+		m_exit_code = -1;
+		return NULL;
+	}
+	wxLogMessage(_T("spring started with pid %d"), (int)m_child->GetPid());
+
+	const ChildProcess::ExitStatus status = m_child->Wait([](ChildProcess::Stream stream, const std::string& line) {
+		if (stream == ChildProcess::STREAM_STDERR)
+			wxLogMessage(_T("[spring stderr] %s"), TowxString(line).c_str());
+		else
+			wxLogMessage(_T("[spring] %s"), TowxString(line).c_str());
+	});
+	if (status.signaled) {
+		wxLogWarning(_T("spring was terminated by signal %d (%s)"), status.signal, TowxString(strsignal(status.signal)).c_str());
+		m_exit_code = 128 + status.signal; // like a shell reports it
+	} else {
+		wxLogMessage(_T("spring exited with code %d"), status.code);
+		m_exit_code = status.code;
+	}
+#endif
 	return NULL;
 }
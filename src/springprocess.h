@@ -20,11 +20,14 @@ lsl/spring/springprocess.h
 #include <wx/string.h>
 #include <wx/process.h>
 
+#include <memory>
+
 BEGIN_DECLARE_EVENT_TYPES()
 DECLARE_LOCAL_EVENT_TYPE(wxEVT_SPRING_EXIT, 1)
 END_DECLARE_EVENT_TYPES()
 
 class Spring;
+class ChildProcess;
 
 class SpringProcess : public wxThread
 {
@@ -33,6 +36,8 @@ public:
 	~SpringProcess();
 	void OnExit();
 	void SetCommand(const wxString& cmd, const wxArrayString& params);
+	//! the process spring is run in, shared with Spring so it can still be terminated from there
+	void SetChild(const std::shared_ptr<ChildProcess>& child);
 	void* Entry();
 
 private:
@@ -40,6 +45,7 @@ private:
 	wxString m_cmd;
 	wxArrayString m_params;
 	int m_exit_code;
+	std::shared_ptr<ChildProcess> m_child;
 };
 
 const int PROC_SPRING = wxID_HIGHEST;
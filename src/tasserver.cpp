@@ -31,6 +31,7 @@ lsl/networking/tasserver.cpp
 #include "settings.h"
 #include "utils/base64.h"
 #include "utils/md5.h"
+#include "utils/netthread.h"
 #include "utils/tasutil.h"
 #include "utils/conversion.h"
 #include "utils/slconfig.h"
@@ -38,6 +39,8 @@ lsl/networking/tasserver.cpp
 
 
 SLCONFIG("/Server/ExitMessage", "Using http://springlobby.info/", "Message which is send when leaving server");
+SLCONFIG("/Server/SendRate", 800l, "Bytes per second sent to the server at most"); // 1250 is the server limit but 800 just to make sure :)
+SLCONFIG("/Server/SendBurst", 800l, "Bytes which may be sent to the server at once");
 
 // times in milliseconds
 #define PING_TIME 30000
@@ -45,6 +48,7 @@ SLCONFIG("/Server/ExitMessage", "Using http://springlobby.info/", "Message which
 #define PING_DELAY 5000 //first ping is sent after PING_DELAY
 #define UDP_KEEP_ALIVE 15000
 #define UDP_REPLY_TIMEOUT 10000
+#define HOSTINFO_DELAY 250 // changes to a hosted battle are collected this long before they're sent
 
 
 #define CHECK_BATTLE_ID()                                                         \
@@ -85,7 +89,6 @@ TASServer::TASServer()
     , m_debug_dont_catch(false)
     , m_id_transmission(true)
     , m_redirecting(false)
-    , m_buffer("")
     , m_last_udp_ping(0)
     , m_last_ping(PING_DELAY)
     , //no instant ping, delay first ping for PING_DELAY seconds
@@ -95,6 +98,8 @@ TASServer::TASServer()
     , m_udp_private_port(0)
     , m_nat_helper_port(0)
     , m_battle_id(-1)
+    , m_hostinfo_pending(IBattle::HI_None)
+    , m_hostinfo_age(0)
     , m_server_lanmode(false)
     , m_account_id_count(0)
     , m_do_finalize_join_battle(false)
@@ -258,14 +263,13 @@ void TASServer::Connect(const std::string& servername, const std::string& addr,
 {
 	m_server_name = servername;
 	m_addr = addr;
-	m_buffer.clear();
 	m_subscriptions.clear();
 	if (m_sock != NULL) {
 		Disconnect();
 	}
 	m_sock = new Socket(*this);
 	m_sock->Connect(TowxString(addr), port);
-	m_sock->SetSendRateLimit(800); // 1250 is the server limit but 800 just to make sure :)
+	m_sock->SetSendRateLimit(cfg().ReadLong(_T("/Server/SendRate")), cfg().ReadLong(_T("/Server/SendBurst")));
 	m_connected = false;
 	m_online = false;
 	m_redirecting = false;
@@ -287,6 +291,7 @@ void TASServer::Disconnect()
 
 	m_connected = false;
 	m_battle_id = -1;
+	ResetHostInfo();
 	SendCmd("EXIT " + STD_STRING(cfg().ReadString(_T("/Server/ExitMessage")))); // EXIT command for new protocol compatibility
 	m_sock->Disconnect();
 	delete m_sock;
@@ -413,6 +418,12 @@ void TASServer::Notify()
 	if (!IsConnected())
 		return;
 
+	if ((m_hostinfo_pending != IBattle::HI_None) || m_script_tags.HasPending()) {
+		m_hostinfo_age += interval;
+		if (m_hostinfo_age >= HOSTINFO_DELAY) {
+			FlushHostInfo();
+		}
+	}
 
 	if (m_last_ping > PING_TIME) { //Send a PING every 30 seconds
 		if (interval > PING_TIME) {
@@ -463,34 +474,9 @@ void TASServer::Notify()
 
 void TASServer::ExecuteCommand(const std::string& in)
 {
-	wxLogMessage(_T("%s"), TowxString(in).c_str());
-	wxString cmd;
-	wxString params = TowxString(in);
-	long replyid = 0;
-
-	if (in.empty())
-		return;
-	try {
-		ASSERT_LOGIC(params.AfterFirst('\n').IsEmpty(), "losing data");
-	} catch (...) {
-		return;
-	}
-	if (params[0] == '#') {
-		wxString id = params.BeforeFirst(' ').AfterFirst('#');
-		params = params.AfterFirst(' ');
-		id.ToLong(&replyid);
-	}
-	cmd = params.BeforeFirst(' ').MakeUpper();
-	params = params.AfterFirst(' ');
-
-	if (m_debug_dont_catch) {
-		ExecuteCommand(STD_STRING(cmd), STD_STRING(params), replyid);
-	} else {
-		try {
-			ExecuteCommand(STD_STRING(cmd), STD_STRING(params), replyid);
-		} catch (...) { // catch everything so the app doesn't crash, may makes odd beahviours but it's better than crashing randomly for normal users
-		}
-	}
+	NetworkThread::Event event;
+	if (NetworkThread::ParseLine(in, event))
+		OnCommand(event.command, event.params, event.replyid);
 }
 
 
@@ -607,6 +593,7 @@ void TASServer::ExecuteCommand(const std::string& cmd, const std::string& inpara
 		if (m_battle_id == id) {
 			m_relay_host_bot.clear();
 			m_battle_id = -1;
+			ResetHostInfo();
 		}
 		m_se->OnBattleClosed(id);
 	} else if (cmd == "LEFTBATTLE") {
@@ -614,6 +601,7 @@ void TASServer::ExecuteCommand(const std::string& cmd, const std::string& inpara
 		nick = GetWordParam(params);
 		if ((id == m_battle_id) && (nick == GetMe().GetNick())) {
 			m_battle_id = -1;
+			ResetHostInfo();
 		}
 		m_se->OnUserLeftBattle(id, nick);
 	} else if (cmd == "PONG") {
@@ -678,9 +666,10 @@ void TASServer::ExecuteCommand(const std::string& cmd, const std::string& inpara
 				const std::string userScriptPassword = GetWordParam(params);
 				try {
 					User& usr = GetUser(usernick);
-					usr.BattleStatus().scriptPassword = userScriptPassword;
+					usr.BattleStatus().SetScriptPassword(userScriptPassword);
 					IBattle* battle = GetCurrentBattle();
 					if (battle) {
+						battle->InvalidateScript(IBattle::ScriptCache::Mask(IBattle::ScriptCache::SECTION_PLAYERS));
 						if (battle->CheckBan(usr))
 							return;
 					}
@@ -714,6 +703,7 @@ void TASServer::ExecuteCommand(const std::string& cmd, const std::string& inpara
 		const int id = GetIntParam(params);
 		const std::string hash = LSL::Util::MakeHashUnsigned(GetWordParam(params));
 		m_battle_id = id;
+		ResetHostInfo();
 		m_se->OnJoinedBattle(id, hash);
 		m_se->OnBattleInfoUpdated(m_battle_id);
 		try {
@@ -776,6 +766,7 @@ void TASServer::ExecuteCommand(const std::string& cmd, const std::string& inpara
 		m_agreement.clear();
 	} else if (cmd == "OPENBATTLE") {
 		m_battle_id = GetIntParam(params);
+		ResetHostInfo();
 		m_se->OnHostedBattle(m_battle_id);
 	} else if (cmd == "ADDBOT") {
 		// ADDBOT BATTLE_ID name owner battlestatus teamcolor {AIDLL}
@@ -791,11 +782,11 @@ void TASServer::ExecuteCommand(const std::string& cmd, const std::string& inpara
 			ai = _T("INVALID|INVALID");
 		}
 		if (ai.Find(_T('|')) != -1) {
-			bstatus.aiversion = STD_STRING(ai.AfterLast(_T('|')));
+			bstatus.SetAIVersion(STD_STRING(ai.AfterLast(_T('|'))));
 			ai = ai.BeforeLast(_T('|'));
 		}
-		bstatus.aishortname = STD_STRING(ai);
-		bstatus.owner = owner;
+		bstatus.SetAIShortName(STD_STRING(ai));
+		bstatus.SetOwner(owner);
 		m_se->OnBattleAddBot(id, nick, bstatus);
 	} else if (cmd == "UPDATEBOT") {
 		const int id = GetIntParam(params);
@@ -958,6 +949,26 @@ void TASServer::RelayCmd(const std::string& command, const std::string& param)
 }
 
 
+//! pings and chat are sent before queued bulk commands, like battle status updates
+static SendQueue::Priority GetCmdPriority(const std::string& command, const std::string& param, const std::string& relayhost)
+{
+	if (command == "SAYPRIVATE" || command == "SAYPRIVATEEX") {
+		// commands for the relay host are sent as private messages, see RelayCmd
+		const std::string prefix = relayhost + " ";
+		if (!relayhost.empty() && param.compare(0, prefix.size(), prefix) == 0)
+			return SendQueue::PRIORITY_BULK;
+		return SendQueue::PRIORITY_INTERACTIVE;
+	}
+	if (command == "PING" || command == "SAY" || command == "SAYEX" || command == "SAYBATTLE" || command == "SAYBATTLEEX") {
+		return SendQueue::PRIORITY_INTERACTIVE;
+	}
+	// chat may depend on these, so they must not be overtaken by it
+	if (command == "JOIN" || command == "LEAVE" || command == "JOINBATTLE" || command == "LEAVEBATTLE" || command == "OPENBATTLE") {
+		return SendQueue::PRIORITY_INTERACTIVE;
+	}
+	return SendQueue::PRIORITY_BULK;
+}
+
 void TASServer::SendCmd(const std::string& command, const std::string& param, bool relay)
 {
 	if (relay) {
@@ -975,7 +986,7 @@ void TASServer::SendCmd(const std::string& command, const std::string& param, bo
 		msg = msg + cmd + _T("\n");
 	else
 		msg = msg + cmd + _T(" ") + TowxString(param) + _T("\n");
-	bool send_success = m_sock->Send(msg);
+	bool send_success = m_sock->Send(msg, GetCmdPriority(command, param, m_relay_host_bot));
 	if ((command == "LOGIN") || command == "CHANGEPASSWORD") {
 		wxLogMessage(_T("sent: %s ... <password removed>"), TowxString(command).c_str());
 		return;
@@ -996,7 +1007,7 @@ void TASServer::SetRelayIngamePassword(const User& user)
 		if (!battle->GetInGame())
 			return;
 	}
-	RelayCmd("SETINGAMEPASSWORD", user.GetNick() + std::string(" ") + user.BattleStatus().scriptPassword);
+	RelayCmd("SETINGAMEPASSWORD", user.GetNick() + std::string(" ") + user.BattleStatus().GetScriptPassword());
 }
 
 void TASServer::Ping()
@@ -1334,68 +1345,106 @@ void TASServer::SendHostInfo(HostInfo update)
 		return;
 	}
 
-	//BattleOptions bo = battle.opts();
+	// sent by FlushHostInfo(), so a burst of changes results in one update
+	m_hostinfo_pending |= update;
+}
+
+
+void TASServer::SendHostInfo(const std::string& Tag)
+{
+	slLogDebugFunc("");
+
+	CHECK_BATTLE_ID();
+
+	IBattle& battle = GetBattle(m_battle_id);
+
+	try {
+		ASSERT_LOGIC(battle.IsFounderMe(), "I'm not founder");
+	} catch (...) {
+		return;
+	}
+
+	const long type = LSL::Util::FromString<long>(LSL::Util::BeforeFirst(Tag, "_"));
+	const std::string key = LSL::Util::AfterFirst(Tag, "_");
+
+	switch (type) {
+		case LSL::Enum::MapOption:
+			m_script_tags.Set("game/mapoptions/" + key, battle.GetCustomBattleOptions().getSingleValue(key, LSL::Enum::MapOption));
+			break;
+		case LSL::Enum::ModOption:
+			m_script_tags.Set("game/modoptions/" + key, battle.GetCustomBattleOptions().getSingleValue(key, LSL::Enum::ModOption));
+			break;
+		case LSL::Enum::EngineOption:
+			m_script_tags.Set("game/" + key, battle.GetCustomBattleOptions().getSingleValue(key, LSL::Enum::EngineOption));
+			break;
+	}
+}
+
+
+//! @brief Sends what changed since the last call to SendHostInfo
+void TASServer::FlushHostInfo()
+{
+	const HostInfo update = m_hostinfo_pending;
+	m_hostinfo_pending = IBattle::HI_None;
+	m_hostinfo_age = 0;
+
+	IBattle* battle = GetCurrentBattle();
+	if ((battle == NULL) || !battle->IsFounderMe()) {
+		ResetHostInfo();
+		return;
+	}
+	const bool relay = battle->IsProxy();
 
 	if ((update & (IBattle::HI_Map | IBattle::HI_Locked | IBattle::HI_Spectators)) > 0) {
 		// UPDATEBATTLEINFO Spectatorsize locked maphash {mapname}
-		wxString cmd = wxString::Format(_T("%d %d "), battle.GetSpectators(), battle.IsLocked());
-		cmd += TowxString(LSL::Util::MakeHashSigned(battle.LoadMap().hash) + " ");
-		cmd += TowxString(battle.LoadMap().name);
+		wxString cmd = wxString::Format(_T("%d %d "), battle->GetSpectators(), battle->IsLocked());
+		cmd += TowxString(LSL::Util::MakeHashSigned(battle->LoadMap().hash) + " ");
+		cmd += TowxString(battle->LoadMap().name);
 
-		SendCmd("UPDATEBATTLEINFO", STD_STRING(cmd), battle.IsProxy());
+		if (STD_STRING(cmd) != m_last_battleinfo) {
+			m_last_battleinfo = STD_STRING(cmd);
+			SendCmd("UPDATEBATTLEINFO", m_last_battleinfo, relay);
+		}
 	}
 	if ((update & IBattle::HI_Send_All_opts) > 0) {
-		std::string cmd;
-		for (const auto& it : battle.CustomBattleOptions().getOptions(LSL::Enum::MapOption)) {
-			const std::string newcmd = "game/mapoptions/" + it.first + "=" + it.second.second + "\t";
-			if (cmd.size() + newcmd.size() > 900) { // should be 1024 add margin for relayhost name and command itself
-				SendCmd("SETSCRIPTTAGS", cmd, battle.IsProxy());
-				cmd.clear();
-			}
-			cmd += newcmd;
+		for (const auto& it : battle->GetCustomBattleOptions().getOptions(LSL::Enum::MapOption)) {
+			m_script_tags.Set("game/mapoptions/" + it.first, it.second.second);
 		}
-		for (const auto& it : battle.CustomBattleOptions().getOptions(LSL::Enum::ModOption)) {
-			const std::string newcmd = "game/modoptions/" + it.first + "=" + it.second.second + "\t";
-			if (cmd.size() + newcmd.size() > 900) { // should be 1024 add margin for relayhost name and command itself
-				SendCmd("SETSCRIPTTAGS", cmd, battle.IsProxy());
-				cmd.clear();
-			}
-			cmd += newcmd;
+		for (const auto& it : battle->GetCustomBattleOptions().getOptions(LSL::Enum::ModOption)) {
+			m_script_tags.Set("game/modoptions/" + it.first, it.second.second);
 		}
-		for (const auto& it : battle.CustomBattleOptions().getOptions(LSL::Enum::EngineOption)) {
-			const std::string newcmd = "game/" + it.first + "=" + it.second.second + "\t";
-			if (cmd.size() + newcmd.size() > 900) { // should be 1024 add margin for relayhost name and command itself
-				SendCmd("SETSCRIPTTAGS", cmd, battle.IsProxy());
-				cmd.clear();
-			}
-			cmd += newcmd;
+		for (const auto& it : battle->GetCustomBattleOptions().getOptions(LSL::Enum::EngineOption)) {
+			m_script_tags.Set("game/" + it.first, it.second.second);
 		}
-		SendCmd("SETSCRIPTTAGS", cmd, battle.IsProxy());
 	}
-
+	// should be 1024 add margin for relayhost name and command itself
+	const std::vector<std::string> tags = m_script_tags.TakePending(900);
+	for (const std::string& tag : tags) {
+		SendCmd("SETSCRIPTTAGS", tag, relay);
+	}
 	if ((update & IBattle::HI_StartRects) > 0) { // Startrects should be updated.
-		unsigned int numrects = battle.GetLastRectIdx();
+		unsigned int numrects = battle->GetLastRectIdx();
 		for (unsigned int i = 0; i <= numrects; i++) { // Loop through all, and remove updated or deleted.
 			wxString cmd;
-			BattleStartRect sr = battle.GetStartRect(i);
+			BattleStartRect sr = battle->GetStartRect(i);
 			if (!sr.exist)
 				continue;
 			if (sr.todelete) {
-				SendCmd("REMOVESTARTRECT", stdprintf("%d", i), battle.IsProxy());
-				battle.StartRectRemoved(i);
+				SendCmd("REMOVESTARTRECT", stdprintf("%d", i), relay);
+				battle->StartRectRemoved(i);
 			} else if (sr.toadd) {
-				SendCmd("ADDSTARTRECT", stdprintf("%d %d %d %d %d", sr.ally, sr.left, sr.top, sr.right, sr.bottom), battle.IsProxy());
-				battle.StartRectAdded(i);
+				SendCmd("ADDSTARTRECT", stdprintf("%d %d %d %d %d", sr.ally, sr.left, sr.top, sr.right, sr.bottom), relay);
+				battle->StartRectAdded(i);
 			} else if (sr.toresize) {
-				SendCmd("REMOVESTARTRECT", stdprintf("%d", i), battle.IsProxy());
-				SendCmd("ADDSTARTRECT", stdprintf("%d %d %d %d %d", sr.ally, sr.left, sr.top, sr.right, sr.bottom), battle.IsProxy());
-				battle.StartRectResized(i);
+				SendCmd("REMOVESTARTRECT", stdprintf("%d", i), relay);
+				SendCmd("ADDSTARTRECT", stdprintf("%d %d %d %d %d", sr.ally, sr.left, sr.top, sr.right, sr.bottom), relay);
+				battle->StartRectResized(i);
 			}
 		}
 	}
 	if ((update & IBattle::HI_Restrictions) > 0) {
-		std::map<std::string, int> units = battle.RestrictedUnits();
-		SendCmd("ENABLEALLUNITS", "", battle.IsProxy());
+		std::map<std::string, int> units = battle->RestrictedUnits();
+		SendCmd("ENABLEALLUNITS", "", relay);
 		if (!units.empty()) {
 			wxString msg;
 			wxString scriptmsg;
@@ -1403,43 +1452,20 @@ void TASServer::SendHostInfo(HostInfo update)
 				msg << TowxString(itor->first) + _T(" ");
 				scriptmsg << _T("game/restrict/") + TowxString(itor->first) + _T("=") + TowxString(itor->second) + _T('\t'); // this is a serious protocol abuse, but on the other hand, the protocol fucking suck and it's unmaintained so it will do for now
 			}
-			SendCmd("DISABLEUNITS", STD_STRING(msg), battle.IsProxy());
-			SendCmd("SETSCRIPTTAGS", STD_STRING(scriptmsg), battle.IsProxy());
+			SendCmd("DISABLEUNITS", STD_STRING(msg), relay);
+			SendCmd("SETSCRIPTTAGS", STD_STRING(scriptmsg), relay);
 		}
 	}
 }
 
 
-void TASServer::SendHostInfo(const std::string& Tag)
-{
-	slLogDebugFunc("");
-
-	CHECK_BATTLE_ID();
-
-	IBattle& battle = GetBattle(m_battle_id);
 
-	try {
-		ASSERT_LOGIC(battle.IsFounderMe(), "I'm not founder");
-	} catch (...) {
-		return;
-	}
-
-	std::string cmd;
-	const long type = LSL::Util::FromString<long>(LSL::Util::BeforeFirst(Tag, "_"));
-	const std::string key = LSL::Util::AfterFirst(Tag, "_");
-
-	switch (type) {
-		case LSL::Enum::MapOption:
-			cmd = "game/mapoptions/" + key + "=" + battle.CustomBattleOptions().getSingleValue(key, LSL::Enum::MapOption);
-			break;
-		case LSL::Enum::ModOption:
-			cmd = "game/modoptions/" + key + "=" + battle.CustomBattleOptions().getSingleValue(key, LSL::Enum::ModOption);
-			break;
-		case LSL::Enum::EngineOption:
-			cmd = "game/" + key + "=" + battle.CustomBattleOptions().getSingleValue(key, LSL::Enum::EngineOption);
-			break;
-	}
-	SendCmd("SETSCRIPTTAGS", cmd, battle.IsProxy());
+void TASServer::ResetHostInfo()
+{
+	m_hostinfo_pending = IBattle::HI_None;
+	m_hostinfo_age = 0;
+	m_script_tags.Reset();
+	m_last_battleinfo.clear();
 }
 
 
@@ -1455,10 +1481,8 @@ void TASServer::SendUserPosition(const User& user)
 		ASSERT_LOGIC(battle.IsFounderMe(), "I'm not founder");
 
 		UserBattleStatus status = user.BattleStatus();
-		std::string msgx = stdprintf("game/Team%d/StartPosX=%d", status.team, status.pos.x);
-		std::string msgy = stdprintf("game/Team%d/StartPosY=%d", status.team, status.pos.y);
-		std::string netmessage = msgx + "\t" + msgy;
-		SendCmd("SETSCRIPTTAGS", netmessage, battle.IsProxy());
+		m_script_tags.Set(stdprintf("game/Team%d/StartPosX", status.team), stdprintf("%d", status.pos.x));
+		m_script_tags.Set(stdprintf("game/Team%d/StartPosY", status.team), stdprintf("%d", status.pos.y));
 	} catch (...) {
 		return;
 	}
@@ -1505,6 +1529,9 @@ void TASServer::StartHostedBattle()
 	slLogDebugFunc("");
 	CHECK_BATTLE_ID();
 
+	// clients have to know all options before the game starts
+	FlushHostInfo();
+
 	IBattle* battle = GetCurrentBattle();
 	if (battle) {
 		if ((battle->GetNatType() == NAT_Hole_punching) || (battle->GetNatType() == NAT_Fixed_source_ports)) {
@@ -1662,7 +1689,7 @@ void TASServer::BattleKickPlayer(int battleid, User& user)
 
 	//KICKFROMBATTLE username
 	if (!GetBattle(battleid).IsProxy()) {
-		user.BattleStatus().scriptPassword = stdprintf("%04x%04x", rand() & 0xFFFF, rand() & 0xFFFF); // reset his password to something random, so he can't rejoin
+		user.BattleStatus().SetScriptPassword(stdprintf("%04x%04x", rand() & 0xFFFF, rand() & 0xFFFF)); // reset his password to something random, so he can't rejoin
 		SetRelayIngamePassword(user);
 	}
 	SendCmd("KICKFROMBATTLE", user.GetNick(), GetBattle(battleid).IsProxy());
@@ -1694,7 +1721,7 @@ void TASServer::AddBot(int battleid, const std::string& nick, UserBattleStatus&
 	CHECK_CURRENT_BATTLE_ID(battleid)
 	const int tasbs = UserBattleStatus::ToInt(status);
 	//ADDBOT name battlestatus teamcolor {AIDLL}
-	SendCmd("ADDBOT", stdprintf("%s %d %d %s|%s", nick.c_str(), tasbs, status.colour.GetLobbyColor(), status.aishortname.c_str(), status.aiversion.c_str()));
+	SendCmd("ADDBOT", stdprintf("%s %d %d %s|%s", nick.c_str(), tasbs, status.colour.GetLobbyColor(), status.GetAIShortName().c_str(), status.GetAIVersion().c_str()));
 }
 
 
@@ -1705,7 +1732,7 @@ void TASServer::RemoveBot(int battleid, User& bot)
 	IBattle& battle = GetBattle(battleid);
 	ASSERT_LOGIC(&bot != 0, "Bot does not exist.");
 
-	if (!(battle.IsFounderMe() || (bot.BattleStatus().owner == GetMe().GetNick()))) {
+	if (!(battle.IsFounderMe() || (bot.BattleStatus().GetOwner() == GetMe().GetNick()))) {
 		DoActionBattle(battleid, "thinks the bot " + bot.GetNick() + " should be removed.");
 		return;
 	}
@@ -1744,7 +1771,6 @@ void TASServer::OnDisconnected()
 	m_connected = false;
 	m_online = false;
 	m_redirecting = false;
-	m_buffer.clear();
 	m_relay_host_manager_list.clear();
 	m_last_id = 0;
 	m_pinglist.clear();
@@ -1755,22 +1781,17 @@ void TASServer::OnDisconnected()
 }
 
 
-void TASServer::OnDataReceived()
+void TASServer::OnCommand(const std::string& cmd, const std::string& params, int replyid)
 {
-	if (m_sock == NULL)
-		return;
-
 	m_last_net_packet = 0;
-	wxString data = m_sock->Receive();
-	m_buffer += STD_STRING(data);
-	LSL::Util::Replace(m_buffer, "\r\n", "\n");
-
-	size_t returnpos = m_buffer.find("\n");
-	while (returnpos != std::string::npos) {
-		const std::string cmd = m_buffer.substr(0, returnpos);
-		m_buffer = m_buffer.substr(returnpos + 1, m_buffer.size() - (returnpos + 1));
-		ExecuteCommand(cmd);
-		returnpos = m_buffer.find("\n");
+	wxLogMessage(_T("%s %s"), TowxString(cmd).c_str(), TowxString(params).c_str());
+	if (m_debug_dont_catch) {
+		ExecuteCommand(cmd, params, replyid);
+	} else {
+		try {
+			ExecuteCommand(cmd, params, replyid);
+		} catch (...) { // catch everything so the app doesn't crash, may makes odd beahviours but it's better than crashing randomly for normal users
+		}
 	}
 }
 
@@ -1874,7 +1895,7 @@ void TASServer::UdpPingAllClients() // used when hosting with nat holepunching.
 	for (int i = 0; i < int(ordered_users.size()); ++i) {
 		User& user = battle->GetUser(ordered_users[i].index);
 
-		wxString ip = TowxString(user.BattleStatus().ip);
+		wxString ip = TowxString(user.BattleStatus().GetIP());
 		unsigned int port = user.BattleStatus().udpport;
 
 		unsigned int src_port = m_udp_private_port;
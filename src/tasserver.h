@@ -23,6 +23,7 @@ lsl/networking/tasserver.h
 #include "iserver.h"
 #include "inetclass.h"
 #include "utils/crc.h"
+#include "utils/scripttagsync.h"
 
 const unsigned int FIRST_UDP_SOURCEPORT = 8300;
 
@@ -147,7 +148,7 @@ public:
 
 private:
 	void OnConnected();
-	void OnDataReceived();
+	void OnCommand(const std::string& cmd, const std::string& params, int replyid);
 	void OnDisconnected();
 
 	void UDPPing(); /// used for nat travelsal
@@ -174,6 +175,9 @@ private:
 	void RelayCmd(const std::string& command, const std::string& param = "");
 	void Notify();
 
+	void FlushHostInfo();
+	void ResetHostInfo();
+
 	//! @brief Struct used internally by the TASServer class to calculate ping roundtimes.
 	struct TASPingListItem
 	{
@@ -196,7 +200,6 @@ private:
 	bool m_debug_dont_catch;
 	bool m_id_transmission;
 	bool m_redirecting;
-	std::string m_buffer;
 	int m_last_udp_ping;
 	int m_last_ping;       //time last ping was sent
 	int m_last_net_packet; //time last packet was received
@@ -209,6 +212,11 @@ private:
 	unsigned long m_nat_helper_port;
 
 	int m_battle_id;
+	//! changes to the hosted battle which weren't sent yet, see FlushHostInfo()
+	HostInfo m_hostinfo_pending;
+	int m_hostinfo_age; //time since the first pending change
+	ScriptTagSync m_script_tags;
+	std::string m_last_battleinfo;
 
 	bool m_server_lanmode;
 	unsigned int m_account_id_count;
@@ -0,0 +1,95 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#define BOOST_TEST_MODULE availabilitycache
+#include <boost/test/unit_test.hpp>
+
+#include "utils/availabilitycache.h"
+
+#include <boost/bind.hpp>
+
+//! stands in for unitsync, counts the queries
+struct FakeContent
+{
+	int queries;
+	bool installed;
+	AvailabilityCache* clear_during_query; //!< cleared while a query runs, like a concurrent reload
+
+	FakeContent()
+	    : queries(0)
+	    , installed(true)
+	    , clear_during_query(NULL)
+	{
+	}
+	bool ArchiveExists(const std::string& name, const std::string& hash)
+	{
+		queries++;
+		if (clear_during_query != NULL)
+			clear_during_query->ClearContent();
+		return installed && name == "Comet Catcher Redux" && (hash.empty() || hash == "1234");
+	}
+	bool EngineExists(const std::string& version)
+	{
+		queries++;
+		if (clear_during_query != NULL)
+			clear_during_query->ClearEngines();
+		return installed && version == "104.0";
+	}
+};
+
+struct Fixture
+{
+	FakeContent content;
+	AvailabilityCache cache;
+
+	Fixture()
+	    : cache(boost::bind(&FakeContent::ArchiveExists, &content, _1, _2),
+		    boost::bind(&FakeContent::ArchiveExists, &content, _1, _2),
+		    boost::bind(&FakeContent::EngineExists, &content, _1))
+	{
+	}
+};
+
+BOOST_FIXTURE_TEST_CASE(cached, Fixture)
+{
+	BOOST_CHECK(cache.MapExists("Comet Catcher Redux"));
+	BOOST_CHECK(cache.MapExists("Comet Catcher Redux"));
+	BOOST_CHECK_EQUAL(content.queries, 1);
+	// the hash is part of the key
+	BOOST_CHECK(!cache.MapExists("Comet Catcher Redux", "5678"));
+	BOOST_CHECK(cache.MapExists("Comet Catcher Redux", "1234"));
+	BOOST_CHECK_EQUAL(content.queries, 3);
+	// maps and games are kept apart
+	BOOST_CHECK(cache.ModExists("Comet Catcher Redux"));
+	BOOST_CHECK_EQUAL(content.queries, 4);
+	BOOST_CHECK(cache.EngineExists("104.0"));
+	BOOST_CHECK(!cache.EngineExists("98.0"));
+	BOOST_CHECK(cache.EngineExists("104.0"));
+	BOOST_CHECK_EQUAL(content.queries, 6);
+}
+
+BOOST_FIXTURE_TEST_CASE(clear, Fixture)
+{
+	BOOST_CHECK(cache.MapExists("Comet Catcher Redux"));
+	BOOST_CHECK(cache.EngineExists("104.0"));
+	content.installed = false;
+	cache.ClearContent();
+	BOOST_CHECK(!cache.MapExists("Comet Catcher Redux"));
+	// engines are cleared separately
+	BOOST_CHECK(cache.EngineExists("104.0"));
+	cache.ClearEngines();
+	BOOST_CHECK(!cache.EngineExists("104.0"));
+	BOOST_CHECK_EQUAL(content.queries, 4);
+}
+
+BOOST_FIXTURE_TEST_CASE(cleared_during_query, Fixture)
+{
+	content.clear_during_query = &cache;
+	BOOST_CHECK(cache.MapExists("Comet Catcher Redux"));
+	BOOST_CHECK(cache.EngineExists("104.0"));
+	content.clear_during_query = NULL;
+	// the results might be outdated, so they weren't kept
+	content.installed = false;
+	BOOST_CHECK(!cache.MapExists("Comet Catcher Redux"));
+	BOOST_CHECK(!cache.EngineExists("104.0"));
+	BOOST_CHECK_EQUAL(content.queries, 4);
+}
@@ -0,0 +1,119 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#define BOOST_TEST_MODULE childprocess
+#include <boost/test/unit_test.hpp>
+
+#include "utils/childprocess.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+
+#include <signal.h>
+#include <sys/stat.h>
+
+//! a local executable standing in for the engine, removed again when going out of scope
+struct DummyEngine
+{
+	std::string path;
+
+	explicit DummyEngine(const std::string& body)
+	    : path("./childprocess_dummy_engine.sh")
+	{
+		std::ofstream file(path.c_str(), std::ios::out | std::ios::trunc);
+		file << "#!/bin/sh\n"
+		     << body;
+		file.close();
+		chmod(path.c_str(), 0755);
+	}
+	~DummyEngine()
+	{
+		remove(path.c_str());
+	}
+};
+
+struct Output
+{
+	std::vector<std::string> out;
+	std::vector<std::string> err;
+
+	ChildProcess::LineHandler Handler()
+	{
+		return [this](ChildProcess::Stream stream, const std::string& line) {
+			(stream == ChildProcess::STREAM_STDOUT ? out : err).push_back(line);
+		};
+	}
+};
+
+BOOST_AUTO_TEST_CASE(output_and_exit_code)
+{
+	DummyEngine engine("echo \"script: $1\"\necho 'loading failed' >&2\nprintf 'no newline'\nexit 3\n");
+	ChildProcess proc;
+	std::string error;
+	std::vector<std::string> args;
+	args.push_back("/tmp/script with spaces.txt");
+	BOOST_REQUIRE(proc.Start(engine.path, args, error));
+	BOOST_CHECK(proc.GetPid() > 0);
+
+	Output output;
+	const ChildProcess::ExitStatus status = proc.Wait(output.Handler());
+	BOOST_CHECK(status.exited);
+	BOOST_CHECK(!status.signaled);
+	BOOST_CHECK_EQUAL(status.code, 3);
+	BOOST_REQUIRE_EQUAL(output.out.size(), 2u);
+	BOOST_CHECK_EQUAL(output.out[0], "script: /tmp/script with spaces.txt");
+	BOOST_CHECK_EQUAL(output.out[1], "no newline");
+	BOOST_REQUIRE_EQUAL(output.err.size(), 1u);
+	BOOST_CHECK_EQUAL(output.err[0], "loading failed");
+	BOOST_CHECK(!proc.Terminate(SIGTERM));
+}
+
+BOOST_AUTO_TEST_CASE(signal_report)
+{
+	DummyEngine engine("kill -SEGV $$\n");
+	ChildProcess proc;
+	std::string error;
+	BOOST_REQUIRE(proc.Start(engine.path, std::vector<std::string>(), error));
+	Output output;
+	const ChildProcess::ExitStatus status = proc.Wait(output.Handler());
+	BOOST_CHECK(!status.exited);
+	BOOST_CHECK(status.signaled);
+	BOOST_CHECK_EQUAL(status.signal, SIGSEGV);
+}
+
+BOOST_AUTO_TEST_CASE(terminate)
+{
+	DummyEngine engine("echo started\nexec sleep 30\n");
+	ChildProcess proc;
+	std::string error;
+	BOOST_REQUIRE(proc.Start(engine.path, std::vector<std::string>(), error));
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	std::thread killer([&proc]() {
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+		proc.Terminate(SIGTERM);
+	});
+	Output output;
+	const ChildProcess::ExitStatus status = proc.Wait(output.Handler());
+	killer.join();
+	BOOST_CHECK(status.signaled);
+	BOOST_CHECK_EQUAL(status.signal, SIGTERM);
+	BOOST_REQUIRE_EQUAL(output.out.size(), 1u);
+	BOOST_CHECK_EQUAL(output.out[0], "started");
+	BOOST_CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds(10));
+}
+
+BOOST_AUTO_TEST_CASE(missing_executable)
+{
+	ChildProcess proc;
+	std::string error;
+	if (proc.Start("./childprocess_does_not_exist", std::vector<std::string>(), error)) {
+		// older C libraries report a failed exec as exit code 127
+		Output output;
+		const ChildProcess::ExitStatus status = proc.Wait(output.Handler());
+		BOOST_CHECK(status.exited);
+		BOOST_CHECK_EQUAL(status.code, 127);
+	} else {
+		BOOST_CHECK(!error.empty());
+	}
+}
@@ -0,0 +1,59 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#define BOOST_TEST_MODULE colourassigner
+#include <boost/test/unit_test.hpp>
+
+#include "utils/colourassigner.h"
+
+#include <chrono>
+
+static double MinPairDistance(const std::vector<RGBColour>& colours)
+{
+	double res = 1e30;
+	for (size_t i = 0; i < colours.size(); i++) {
+		for (size_t j = i + 1; j < colours.size(); j++) {
+			res = std::min(res, ColourDistance(colours[i], colours[j]));
+		}
+	}
+	return res;
+}
+
+BOOST_AUTO_TEST_CASE(lab)
+{
+	const LabColour white = RGBToLab(RGBColour(255, 255, 255));
+	BOOST_CHECK_CLOSE(white.L, 100.0, 0.1);
+	BOOST_CHECK_SMALL(white.a, 0.5);
+	BOOST_CHECK_SMALL(white.b, 0.5);
+	const LabColour black = RGBToLab(RGBColour(0, 0, 0));
+	BOOST_CHECK_SMALL(black.L, 0.001);
+	BOOST_CHECK(ColourDistance(RGBColour(255, 0, 0), RGBColour(250, 0, 0)) < ColourDistance(RGBColour(255, 0, 0), RGBColour(0, 255, 0)));
+}
+
+BOOST_AUTO_TEST_CASE(keeps_distinct_preferences)
+{
+	ColourAssigner assigner;
+	assigner.AddFixed(RGBColour(255, 0, 0));
+	assigner.AddPlayer(RGBColour(0, 0, 255));
+	assigner.AddPlayer(RGBColour(0, 255, 0));
+	assigner.AddPlayer(RGBColour(250, 5, 5)); // almost the fixed red
+	const std::vector<RGBColour> colours = assigner.Assign();
+	BOOST_CHECK(colours[0] == RGBColour(0, 0, 255));
+	BOOST_CHECK(colours[1] == RGBColour(0, 255, 0));
+	BOOST_CHECK(ColourDistance(colours[2], RGBColour(255, 0, 0)) >= ColourAssigner::MinDistance);
+}
+
+BOOST_AUTO_TEST_CASE(ffa_32)
+{
+	// everybody wants the same colour
+	ColourAssigner assigner;
+	for (int i = 0; i < 32; i++) {
+		assigner.AddPlayer(RGBColour(200, 20, 20));
+	}
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	const std::vector<RGBColour> colours = assigner.Assign();
+	const long us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+	BOOST_TEST_MESSAGE("32 players: " << us << "us, min distance " << MinPairDistance(colours));
+	BOOST_CHECK_EQUAL(colours.size(), 32u);
+	BOOST_CHECK(colours[0] == RGBColour(200, 20, 20));
+	BOOST_CHECK(MinPairDistance(colours) > 10.0);
+}
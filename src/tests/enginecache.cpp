@@ -0,0 +1,78 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#define BOOST_TEST_MODULE enginecache
+#include <boost/test/unit_test.hpp>
+
+#include "utils/enginecache.h"
+
+#include <cstdio>
+#include <fstream>
+
+#include <wx/datetime.h>
+#include <wx/filename.h>
+
+static EngineCache::EngineList Candidates(const std::string& unitsync)
+{
+	EngineCache::Engine engine;
+	engine.version = "104.0";
+	engine.path = "enginecache_test_engine";
+	engine.unitsync = unitsync;
+	engine.spring = "";
+	return EngineCache::EngineList(1, engine);
+}
+
+BOOST_AUTO_TEST_CASE(roundtrip)
+{
+	const std::string cachefile = "enginecache_test.txt";
+	const EngineCache::EngineList engines = Candidates("libunitsync.so");
+	const std::string signature = EngineCache::Signature(engines);
+	EngineCache::Save(cachefile, signature, engines);
+
+	EngineCache::EngineList loaded;
+	BOOST_REQUIRE(EngineCache::Load(cachefile, signature, loaded));
+	BOOST_REQUIRE_EQUAL(loaded.size(), 1u);
+	BOOST_CHECK_EQUAL(loaded[0].version, "104.0");
+	BOOST_CHECK_EQUAL(loaded[0].path, "enginecache_test_engine");
+	BOOST_CHECK_EQUAL(loaded[0].unitsync, "libunitsync.so");
+	BOOST_CHECK_EQUAL(loaded[0].spring, "");
+
+	// other candidates don't use the cache
+	BOOST_CHECK(!EngineCache::Load(cachefile, EngineCache::Signature(Candidates("other.so")), loaded));
+	BOOST_CHECK(!EngineCache::Load("enginecache_missing.txt", signature, loaded));
+	BOOST_CHECK(std::remove(cachefile.c_str()) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(damaged)
+{
+	const std::string cachefile = "enginecache_test.txt";
+	const EngineCache::EngineList engines = Candidates("libunitsync.so");
+	const std::string signature = EngineCache::Signature(engines);
+	{
+		std::ofstream out(cachefile.c_str(), std::ios::binary);
+		out << "springlobby engine cache 1\n"
+		    << signature << "engine\t104.0\tonly three fields\n";
+	}
+	EngineCache::EngineList loaded;
+	BOOST_CHECK(!EngineCache::Load(cachefile, signature, loaded));
+	BOOST_CHECK(loaded.empty());
+	BOOST_CHECK(std::remove(cachefile.c_str()) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(modification_time)
+{
+	const std::string unitsync = "enginecache_test_unitsync";
+	{
+		std::ofstream out(unitsync.c_str());
+		out << "not really a library";
+	}
+	wxFileName file(wxString::FromUTF8(unitsync.c_str()));
+	const wxDateTime old = wxDateTime::Now() - wxTimeSpan::Hours(1);
+	BOOST_REQUIRE(file.SetTimes(&old, &old, NULL));
+	const std::string before = EngineCache::Signature(Candidates(unitsync));
+	BOOST_CHECK_EQUAL(before, EngineCache::Signature(Candidates(unitsync)));
+
+	// an updated unitsync invalidates the cache
+	BOOST_REQUIRE(file.Touch());
+	BOOST_CHECK(before != EngineCache::Signature(Candidates(unitsync)));
+	BOOST_CHECK(std::remove(unitsync.c_str()) == 0);
+}
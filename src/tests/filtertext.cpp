@@ -0,0 +1,58 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#define BOOST_TEST_MODULE filtertext
+#include <boost/test/unit_test.hpp>
+
+#include "gui/battlelist/filtertext.h"
+
+#include <wx/log.h>
+#include <wx/regex.h>
+
+BOOST_AUTO_TEST_CASE(plain_text)
+{
+	BOOST_CHECK(FilterText::IsPlainText(_T("Comet Catcher")));
+	BOOST_CHECK(FilterText::IsPlainText(_T("")));
+	BOOST_CHECK(!FilterText::IsPlainText(_T("Comet.*")));
+	BOOST_CHECK(!FilterText::IsPlainText(_T("^BA")));
+	BOOST_CHECK(!FilterText::IsPlainText(_T("a|b")));
+
+	const wxRegEx expression(_T("comet"), wxRE_ICASE);
+	FilterText filter;
+	filter.Set(_T("comet"), &expression);
+	BOOST_CHECK(!filter.IsEmpty());
+	BOOST_CHECK(filter.Matches(_T("Comet Catcher Redux")));
+	BOOST_CHECK(filter.Matches(_T("COMET")));
+	BOOST_CHECK(!filter.Matches(_T("Delta Siege")));
+}
+
+BOOST_AUTO_TEST_CASE(empty)
+{
+	FilterText filter;
+	BOOST_CHECK(filter.IsEmpty());
+	BOOST_CHECK(filter.Matches(_T("anything")));
+	filter.Set(wxEmptyString, NULL);
+	BOOST_CHECK(filter.IsEmpty());
+	BOOST_CHECK(filter.Matches(wxEmptyString));
+}
+
+BOOST_AUTO_TEST_CASE(regex)
+{
+	const wxRegEx expression(_T("^delta.*siege$"), wxRE_ICASE);
+	FilterText filter;
+	filter.Set(_T("^delta.*siege$"), &expression);
+	BOOST_CHECK(filter.Matches(_T("Delta Siege")));
+	BOOST_CHECK(filter.Matches(_T("Delta Siege Dry Siege")));
+	BOOST_CHECK(!filter.Matches(_T("Delta Siege v2")));
+
+	// an invalid regex only matches as plain text
+	wxLogNull nolog;
+	const wxRegEx invalid(_T("[BA"), wxRE_ICASE);
+	filter.Set(_T("[BA"), &invalid);
+	BOOST_CHECK(filter.Matches(_T("[ba] clan game")));
+	BOOST_CHECK(!filter.Matches(_T("BA game")));
+
+	// without a regex only the plain text search is done
+	filter.Set(_T("delta.*"), NULL);
+	BOOST_CHECK(!filter.Matches(_T("Delta Siege")));
+	BOOST_CHECK(filter.Matches(_T("delta.* literally")));
+}
@@ -0,0 +1,132 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#define BOOST_TEST_MODULE fuzzymatcher
+#include <boost/test/unit_test.hpp>
+
+#include "utils/fuzzymatcher.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cwctype>
+
+//! textbook dynamic programming reference
+static size_t NaiveDistance(const std::wstring& a, const std::wstring& b)
+{
+	std::vector<size_t> prev(b.size() + 1), curr(b.size() + 1);
+	for (size_t j = 0; j <= b.size(); j++) {
+		prev[j] = j;
+	}
+	for (size_t i = 1; i <= a.size(); i++) {
+		curr[0] = i;
+		for (size_t j = 1; j <= b.size(); j++) {
+			const size_t cost = (std::towlower(a[i - 1]) != std::towlower(b[j - 1])) ? 1 : 0;
+			curr[j] = std::min(std::min(prev[j] + 1, curr[j - 1] + 1), prev[j - 1] + cost);
+		}
+		prev.swap(curr);
+	}
+	return prev[b.size()];
+}
+
+static std::wstring RandomString(size_t len, int alphabet)
+{
+	std::wstring res;
+	for (size_t i = 0; i < len; i++) {
+		const int c = rand() % alphabet;
+		res += (c < 26) ? wchar_t(L'a' + c) : wchar_t(0x430 + c - 26); // some cyrillic letters
+	}
+	return res;
+}
+
+BOOST_AUTO_TEST_CASE(distance)
+{
+	BOOST_CHECK_EQUAL(FuzzyMatcher::EditDistance(L"", L""), 0u);
+	BOOST_CHECK_EQUAL(FuzzyMatcher::EditDistance(L"abc", L""), 3u);
+	BOOST_CHECK_EQUAL(FuzzyMatcher::EditDistance(L"", L"abc"), 3u);
+	BOOST_CHECK_EQUAL(FuzzyMatcher::EditDistance(L"kitten", L"sitting"), 3u);
+	BOOST_CHECK_EQUAL(FuzzyMatcher::EditDistance(L"DeltaSiegeDry", L"deltasiegedry"), 0u);
+	BOOST_CHECK_CLOSE(FuzzyMatcher::NormalizedDistance(L"abcd", L"abce"), 0.25, 1e-9);
+
+	srand(3);
+	for (int i = 0; i < 2000; i++) {
+		// lengths around the block size and beyond 255, which overflowed the old byte matrix
+		const size_t la = rand() % ((i % 10 == 0) ? 400 : 140);
+		const size_t lb = rand() % ((i % 10 == 0) ? 400 : 140);
+		const int alphabet = 2 + rand() % 30;
+		const std::wstring a = RandomString(la, alphabet);
+		const std::wstring b = RandomString(lb, alphabet);
+		BOOST_REQUIRE_EQUAL(FuzzyMatcher::EditDistance(a, b), NaiveDistance(a, b));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(ranking)
+{
+	std::vector<std::wstring> maps;
+	maps.push_back(L"DeltaSiegeDry");
+	maps.push_back(L"Delta Siege v2");
+	maps.push_back(L"Comet Catcher Redux");
+	maps.push_back(L"Tabula-v4");
+	maps.push_back(L"DeltaSiegeDry");
+	FuzzyMatcher matcher(maps);
+
+	std::vector<FuzzyMatcher::Match> res = matcher.Find(L"deltasiege", 3);
+	BOOST_REQUIRE_EQUAL(res.size(), 3u);
+	// equal candidates are ordered by index
+	BOOST_CHECK_EQUAL(res[0].index, 0u);
+	BOOST_CHECK_EQUAL(res[1].index, 4u);
+	BOOST_CHECK_EQUAL(res[2].index, 1u);
+	BOOST_CHECK(res[0].distance <= res[2].distance);
+
+	res = matcher.Find(L"tabula", 1);
+	BOOST_REQUIRE_EQUAL(res.size(), 1u);
+	BOOST_CHECK_EQUAL(res[0].index, 3u);
+
+	BOOST_CHECK(matcher.Find(L"tabula", 5, 0.1).empty());
+	BOOST_CHECK(matcher.Find(L"tabula", 0).empty());
+}
+
+BOOST_AUTO_TEST_CASE(same_as_exhaustive)
+{
+	srand(5);
+	std::vector<std::wstring> candidates;
+	for (int i = 0; i < 500; i++) {
+		candidates.push_back(RandomString(3 + rand() % 30, 6));
+	}
+	FuzzyMatcher matcher(candidates);
+	for (int q = 0; q < 50; q++) {
+		const std::wstring query = RandomString(rand() % 35, 6);
+		std::vector<FuzzyMatcher::Match> expected;
+		for (size_t i = 0; i < candidates.size(); i++) {
+			FuzzyMatcher::Match m;
+			m.index = i;
+			m.distance = FuzzyMatcher::NormalizedDistance(query, candidates[i]);
+			expected.push_back(m);
+		}
+		std::stable_sort(expected.begin(), expected.end(), [](const FuzzyMatcher::Match& a, const FuzzyMatcher::Match& b) { return a.distance < b.distance; });
+		const std::vector<FuzzyMatcher::Match> res = matcher.Find(query, 10);
+		BOOST_REQUIRE_EQUAL(res.size(), 10u);
+		for (size_t i = 0; i < res.size(); i++) {
+			BOOST_CHECK_EQUAL(res[i].index, expected[i].index);
+			BOOST_CHECK_CLOSE(res[i].distance, expected[i].distance, 1e-9);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(benchmark)
+{
+	srand(7);
+	FuzzyMatcher matcher;
+	for (int i = 0; i < 5000; i++) {
+		matcher.Add(RandomString(8 + rand() % 25, 26));
+	}
+	const int queries = 200;
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	size_t found = 0;
+	for (int q = 0; q < queries; q++) {
+		found += matcher.Find(RandomString(6 + rand() % 20, 26), 5).size();
+	}
+	const double us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count() / (double)queries;
+	BOOST_TEST_MESSAGE("5000 candidates: " << us << "us per query");
+	BOOST_CHECK_EQUAL(found, 5u * queries);
+	BOOST_CHECK(us < 1000);
+}
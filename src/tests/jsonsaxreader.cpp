@@ -0,0 +1,144 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#define BOOST_TEST_MODULE jsonsaxreader
+#include <boost/test/unit_test.hpp>
+
+#include "json/wx/jsonreader.h"
+#include "json/wx/jsonsaxreader.h"
+
+#include <wx/string.h>
+#include <wx/stopwatch.h>
+
+static const char* conformance[] = {
+    "[]",
+    "{}",
+    "[1, -2, +3, 0, -0]",
+    "[2147483647, 2147483648, -2147483649, 9223372036854775807, 9223372036854775808, 18446744073709551615, 18446744073709551616]",
+    "[1.5, -0.25, 1e10, 2E-3, -1.0e+2]",
+    "[true, false, null]",
+    "[TRUE, False, NULL]",
+    "{\"a\": 1, \"b\": [1, 2, {\"c\": \"d\"}], \"e\": {}}",
+    "{\"esc\": \"\\\"\\\\\\/\\b\\f\\n\\r\\t\"}",
+    "{\"unicode\": \"\\u00e4\\u20ac \xc3\xb6\xe2\x82\xac\"}",
+    "{\"dup\": 1, \"dup\": 2}",
+    "[1, 2, ]",
+    "some leading text [\"x\"] trailing text",
+    "// comment\n{ /* inline */ \"a\" : 1 // end\n}",
+    "[\"multi\" \"string\"]",
+    "[[[[[[[[[[1]]]]]]]]]]",
+    "{\"category\":\"map\",\"springname\":\"Small Divide\",\"size\":12345678,\"mirrors\":[\"http://a\",\"http://b\"]}",
+    "[1, 2",
+};
+
+static wxString Utf8(const char* str)
+{
+	return wxString::FromUTF8(str);
+}
+
+BOOST_AUTO_TEST_CASE(conformance_corpus)
+{
+	for (size_t i = 0; i < sizeof(conformance) / sizeof(conformance[0]); i++) {
+		const wxString doc = Utf8(conformance[i]);
+
+		wxJSONReader reader;
+		wxJSONValue expected;
+		const int expectedErrors = reader.Parse(doc, &expected);
+
+		wxJSONSaxReader saxReader;
+		wxJSONValue actual;
+		wxJSONValueBuilder builder(actual);
+		const int errors = saxReader.Parse(doc, builder);
+
+		BOOST_CHECK_MESSAGE(errors == expectedErrors, conformance[i]);
+		BOOST_CHECK_MESSAGE(actual.IsSameAs(expected), conformance[i]);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(strict_and_errors)
+{
+	static const char* invalid[] = {
+	    "",
+	    "no json here",
+	    "[1 2]",
+	    "{\"a\" 1}",
+	    "{1: 2}",
+	    "[,1]",
+	    "[\"unterminated]",
+	    "[nope]",
+	};
+	for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+		wxJSONSaxHandler ignore;
+		wxJSONSaxReader reader;
+		BOOST_CHECK_MESSAGE(reader.Parse(Utf8(invalid[i]), ignore) > 0, invalid[i]);
+	}
+
+	// extensions are errors for a strict parser
+	wxJSONSaxHandler ignore;
+	wxJSONSaxReader strict(wxJSONREADER_STRICT);
+	BOOST_CHECK(strict.Parse(Utf8("[1] // comment"), ignore) == 0);
+	BOOST_CHECK(strict.Parse(Utf8("[/* comment */ 1]"), ignore) > 0);
+	BOOST_CHECK(strict.Parse(Utf8("[TRUE]"), ignore) > 0);
+	BOOST_CHECK(strict.Parse(Utf8("[1"), ignore) > 0);
+}
+
+namespace
+{
+class StopAfter : public wxJSONSaxHandler
+{
+public:
+	int count;
+	StopAfter()
+	    : count(0)
+	{
+	}
+	virtual bool OnInt(wxInt64 /*value*/)
+	{
+		return ++count < 2;
+	}
+};
+}
+
+BOOST_AUTO_TEST_CASE(abort)
+{
+	StopAfter handler;
+	wxJSONSaxReader reader;
+	BOOST_CHECK(reader.Parse(Utf8("[1, 2, 3, 4]"), handler) == 0);
+	BOOST_CHECK(reader.WasAborted());
+	BOOST_CHECK(handler.count == 2);
+}
+
+BOOST_AUTO_TEST_CASE(benchmark)
+{
+	// a content search result like document of a few megabytes
+	wxString doc = _T("[");
+	for (int i = 0; i < 20000; i++) {
+		if (i > 0)
+			doc += _T(",\n");
+		doc += wxString::Format(_T("{\"category\": \"map\", \"springname\": \"Some Map Name v%d\", \"size\": %d, \"md5\": \"0123456789abcdef0123456789abcdef\", ")
+					_T("\"mirrors\": [\"http://springfiles.com/files/maps/some_map_%d.sd7\", \"http://spring.example.org/maps/some_map_%d.sd7\"], \"tags\": [\"1v1\", \"metal\"]}"),
+					i, 1000000 + i, i, i);
+	}
+	doc += _T("]");
+	BOOST_TEST_MESSAGE("document size: " << doc.length() << " chars");
+
+	wxStopWatch watch;
+	wxJSONReader reader;
+	wxJSONValue expected;
+	BOOST_CHECK(reader.Parse(doc, &expected) == 0);
+	const long readerTime = watch.Time();
+
+	watch.Start();
+	wxJSONSaxHandler ignore;
+	wxJSONSaxReader saxReader;
+	BOOST_CHECK(saxReader.Parse(doc, ignore) == 0);
+	const long saxTime = watch.Time();
+
+	watch.Start();
+	wxJSONValue actual;
+	wxJSONValueBuilder builder(actual);
+	BOOST_CHECK(saxReader.Parse(doc, builder) == 0);
+	const long builderTime = watch.Time();
+
+	BOOST_CHECK(actual.IsSameAs(expected));
+	BOOST_TEST_MESSAGE("wxJSONReader: " << readerTime << "ms, wxJSONSaxReader: " << saxTime << "ms, wxJSONSaxReader + wxJSONValueBuilder: " << builderTime << "ms");
+}
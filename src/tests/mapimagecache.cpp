@@ -0,0 +1,77 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#define BOOST_TEST_MODULE mapimagecache
+#include <boost/test/unit_test.hpp>
+
+#include "gui/mapimagecache.h"
+
+static wxImage Image(int width, int height)
+{
+	wxImage image(width, height);
+	image.SetRGB(wxRect(0, 0, width, height), 10, 20, 30);
+	return image;
+}
+
+BOOST_AUTO_TEST_CASE(fetch_resolution)
+{
+	BOOST_CHECK_EQUAL(MapImageCache::FetchResolution(10, 10), MapImageCache::MinLevelSize);
+	BOOST_CHECK_EQUAL(MapImageCache::FetchResolution(200, 150), 256);
+	BOOST_CHECK_EQUAL(MapImageCache::FetchResolution(150, 256), 256);
+	BOOST_CHECK_EQUAL(MapImageCache::FetchResolution(5000, 3000), MapImageCache::MaxResolution);
+}
+
+BOOST_AUTO_TEST_CASE(get)
+{
+	MapImageCache cache;
+	const std::string key = MapImageCache::MakeKey("Comet Catcher Redux", "1234");
+	BOOST_CHECK(!cache.Get(key, MapImageCache::Minimap, 100, 100).IsOk());
+	cache.Add(key, MapImageCache::Minimap, Image(256, 128), 256);
+
+	// fits into the requested size, keeping the aspect ratio
+	const wxImage img = cache.Get(key, MapImageCache::Minimap, 100, 100);
+	BOOST_REQUIRE(img.IsOk());
+	BOOST_CHECK_EQUAL(img.GetWidth(), 100);
+	BOOST_CHECK_EQUAL(img.GetHeight(), 50);
+	BOOST_CHECK_EQUAL(img.GetRed(10, 10), 10);
+	BOOST_CHECK_EQUAL(cache.GetFull(key, MapImageCache::Minimap).GetWidth(), 256);
+	BOOST_CHECK(!cache.Get(key, MapImageCache::Metalmap, 100, 100).IsOk());
+}
+
+BOOST_AUTO_TEST_CASE(resolution_and_hash)
+{
+	MapImageCache cache;
+	const std::string key = MapImageCache::MakeKey("Comet Catcher Redux", "1234");
+	cache.Add(key, MapImageCache::Minimap, Image(128, 128), 128);
+	BOOST_CHECK(cache.Contains(key, MapImageCache::Minimap));
+	BOOST_CHECK(cache.Contains(key, MapImageCache::Minimap, 128));
+	// a larger view has to fetch again
+	BOOST_CHECK(!cache.Contains(key, MapImageCache::Minimap, 256));
+	BOOST_CHECK(!cache.Contains(key, MapImageCache::Metalmap));
+	// another version of the map
+	BOOST_CHECK(!cache.Contains(MapImageCache::MakeKey("Comet Catcher Redux", "5678"), MapImageCache::Minimap));
+
+	cache.Add(key, MapImageCache::Minimap, Image(256, 256), 256);
+	BOOST_CHECK(cache.Contains(key, MapImageCache::Minimap, 256));
+
+	cache.Clear();
+	BOOST_CHECK(!cache.Contains(key, MapImageCache::Minimap));
+	BOOST_CHECK_EQUAL(cache.GetBytes(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(eviction)
+{
+	MapImageCache cache;
+	// a 1024x1024 pyramid takes about 4MB, so some of these have to go
+	const int count = MapImageCache::MaxBytes / (3 * 1024 * 1024) + 2;
+	for (int i = 0; i < count; i++) {
+		const std::string key = MapImageCache::MakeKey("map" + std::to_string(i), "");
+		cache.Add(key, MapImageCache::Minimap, Image(1024, 1024), 1024);
+		// the first map stays recently used
+		BOOST_CHECK(cache.Contains(MapImageCache::MakeKey("map0", ""), MapImageCache::Minimap));
+		cache.Get(MapImageCache::MakeKey("map0", ""), MapImageCache::Minimap, 10, 10);
+	}
+	BOOST_CHECK(cache.GetBytes() <= MapImageCache::MaxBytes);
+	BOOST_CHECK(cache.Contains(MapImageCache::MakeKey("map0", ""), MapImageCache::Minimap));
+	BOOST_CHECK(!cache.Contains(MapImageCache::MakeKey("map1", ""), MapImageCache::Minimap));
+	BOOST_CHECK(cache.Contains(MapImageCache::MakeKey("map" + std::to_string(count - 1), ""), MapImageCache::Minimap));
+}
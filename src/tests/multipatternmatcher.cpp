@@ -0,0 +1,83 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#define BOOST_TEST_MODULE multipatternmatcher
+#include <boost/test/unit_test.hpp>
+
+#include "utils/multipatternmatcher.h"
+
+#include <cstdlib>
+
+//! what ChatPanel did before: one substring search per pattern
+static bool NaiveContains(const std::vector<std::wstring>& patterns, const std::wstring& text)
+{
+	for (size_t i = 0; i < patterns.size(); i++) {
+		if (!patterns[i].empty() && text.find(patterns[i]) != std::wstring::npos)
+			return true;
+	}
+	return false;
+}
+
+static std::wstring RandomString(size_t len, int alphabet)
+{
+	std::wstring res;
+	for (size_t i = 0; i < len; i++) {
+		const int c = rand() % alphabet;
+		res += (c < 3) ? wchar_t(L'a' + c) : wchar_t(0x430 + c - 3); // mix in some cyrillic letters
+	}
+	return res;
+}
+
+BOOST_AUTO_TEST_CASE(basic)
+{
+	std::vector<std::wstring> patterns;
+	patterns.push_back(L"he");
+	patterns.push_back(L"she");
+	patterns.push_back(L"his");
+	patterns.push_back(L"hers");
+	patterns.push_back(L"");
+	const MultiPatternMatcher matcher(patterns);
+	BOOST_CHECK_EQUAL(matcher.GetPatternCount(), 4u);
+	BOOST_CHECK(matcher.ContainsAny(L"ushers"));
+	BOOST_CHECK_EQUAL(matcher.FindFirst(L"ushers"), 1); // "she" and "he" end at the same position
+	BOOST_CHECK_EQUAL(matcher.FindFirst(L"the"), 0);
+	BOOST_CHECK(matcher.ContainsAny(L"this"));
+	BOOST_CHECK(!matcher.ContainsAny(L"hi s"));
+	BOOST_CHECK(!matcher.ContainsAny(L"HE"));
+	BOOST_CHECK(!matcher.ContainsAny(L""));
+
+	MultiPatternMatcher empty;
+	BOOST_CHECK(empty.IsEmpty());
+	BOOST_CHECK(!empty.ContainsAny(L"anything"));
+}
+
+BOOST_AUTO_TEST_CASE(non_ascii)
+{
+	std::vector<std::wstring> patterns;
+	patterns.push_back(L"\x43f\x440\x438\x432\x435\x442");
+	patterns.push_back(L"caf\xe9");
+	const MultiPatternMatcher matcher(patterns);
+	BOOST_CHECK(matcher.ContainsAny(L"oh \x43f\x440\x438\x432\x435\x442!"));
+	BOOST_CHECK(matcher.ContainsAny(L"un caf\xe9"));
+	BOOST_CHECK(!matcher.ContainsAny(L"un cafe"));
+}
+
+BOOST_AUTO_TEST_CASE(matches_naive)
+{
+	srand(42);
+	for (int round = 0; round < 200; round++) {
+		std::vector<std::wstring> patterns;
+		const int count = 1 + rand() % 8;
+		for (int i = 0; i < count; i++) {
+			patterns.push_back(RandomString(rand() % 5, 5));
+		}
+		const MultiPatternMatcher matcher(patterns);
+		for (int t = 0; t < 20; t++) {
+			const std::wstring text = RandomString(rand() % 30, 5);
+			const int found = matcher.FindFirst(text);
+			BOOST_CHECK_EQUAL(found >= 0, NaiveContains(patterns, text));
+			if (found >= 0) {
+				BOOST_CHECK(text.find(patterns[found]) != std::wstring::npos);
+			}
+		}
+	}
+}
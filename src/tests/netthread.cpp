@@ -0,0 +1,258 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#define BOOST_TEST_MODULE netthread
+#include <boost/test/unit_test.hpp>
+
+#include "utils/netthread.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+//! a lobby server on a local port which accepts one client
+struct FakeServer
+{
+	int listen_fd;
+	int client_fd;
+	int port;
+
+	explicit FakeServer(int backlog = 1)
+	    : listen_fd(socket(AF_INET, SOCK_STREAM, 0))
+	    , client_fd(-1)
+	    , port(0)
+	{
+		sockaddr_in addr;
+		memset(&addr, 0, sizeof(addr));
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		socklen_t len = sizeof(addr);
+		BOOST_REQUIRE(bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+		BOOST_REQUIRE(listen(listen_fd, backlog) == 0);
+		BOOST_REQUIRE(getsockname(listen_fd, reinterpret_cast<sockaddr*>(&addr), &len) == 0);
+		port = ntohs(addr.sin_port);
+	}
+	~FakeServer()
+	{
+		if (client_fd >= 0)
+			close(client_fd);
+		close(listen_fd);
+	}
+	void Accept()
+	{
+		client_fd = accept(listen_fd, NULL, NULL);
+		BOOST_REQUIRE(client_fd >= 0);
+	}
+	void Write(const std::string& data)
+	{
+		BOOST_REQUIRE(write(client_fd, data.data(), data.size()) == (ssize_t)data.size());
+	}
+	//! reads until @p expected bytes arrived
+	std::string Read(size_t expected)
+	{
+		std::string res;
+		char buf[256];
+		while (res.size() < expected) {
+			const ssize_t len = read(client_fd, buf, sizeof(buf));
+			if (len <= 0)
+				break;
+			res.append(buf, len);
+		}
+		return res;
+	}
+	void CloseClient()
+	{
+		close(client_fd);
+		client_fd = -1;
+	}
+};
+
+//! collects the events like the gui thread does, one batch per notification
+struct Receiver
+{
+	std::mutex mutex;
+	std::condition_variable cond;
+	int notifications;
+	std::vector<NetworkThread::Event> events;
+	NetworkThread* thread;
+
+	Receiver()
+	    : notifications(0)
+	    , thread(NULL)
+	{
+	}
+	void Notify()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		notifications++;
+		cond.notify_all();
+	}
+	//! fetches batches until @p count events arrived
+	bool WaitFor(size_t count)
+	{
+		const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+		while (events.size() < count) {
+			std::unique_lock<std::mutex> lock(mutex);
+			cond.wait_until(lock, deadline, [this]() { return notifications > 0; });
+			if (notifications == 0)
+				return false;
+			notifications = 0;
+			lock.unlock();
+			std::vector<NetworkThread::Event> batch;
+			thread->TakeEvents(batch);
+			events.insert(events.end(), batch.begin(), batch.end());
+		}
+		return true;
+	}
+	std::vector<NetworkThread::Event> Of(NetworkThread::SessionId session) const
+	{
+		std::vector<NetworkThread::Event> res;
+		for (size_t i = 0; i < events.size(); i++) {
+			if (events[i].session == session)
+				res.push_back(events[i]);
+		}
+		return res;
+	}
+};
+
+BOOST_AUTO_TEST_CASE(parse_line)
+{
+	NetworkThread::Event event;
+	BOOST_CHECK(NetworkThread::ParseLine("said #main nick hello world", event));
+	BOOST_CHECK_EQUAL(event.command, "SAID");
+	BOOST_CHECK_EQUAL(event.params, "#main nick hello world");
+	BOOST_CHECK_EQUAL(event.replyid, 0);
+
+	BOOST_CHECK(NetworkThread::ParseLine("#42 PONG", event));
+	BOOST_CHECK_EQUAL(event.command, "PONG");
+	BOOST_CHECK_EQUAL(event.params, "");
+	BOOST_CHECK_EQUAL(event.replyid, 42);
+
+	BOOST_CHECK(!NetworkThread::ParseLine("", event));
+	BOOST_CHECK(!NetworkThread::ParseLine("#7", event));
+}
+
+BOOST_AUTO_TEST_CASE(to_utf8)
+{
+	BOOST_CHECK_EQUAL(NetworkThread::ToUtf8("plain"), "plain");
+	BOOST_CHECK_EQUAL(NetworkThread::ToUtf8("gr\xc3\xbc\xc3\x9f"), "gr\xc3\xbc\xc3\x9f");
+	BOOST_CHECK_EQUAL(NetworkThread::ToUtf8("gr\xfc\xdf"), "gr\xc3\xbc\xc3\x9f"); // latin-1
+	BOOST_CHECK_EQUAL(NetworkThread::ToUtf8("cut \xc3"), "cut \xc3\x83");
+}
+
+BOOST_AUTO_TEST_CASE(two_servers)
+{
+	FakeServer main;
+	FakeServer test;
+	Receiver receiver;
+	NetworkThread thread([&receiver]() { receiver.Notify(); });
+	receiver.thread = &thread;
+
+	const NetworkThread::SessionId main_id = thread.Open("127.0.0.1", main.port);
+	const NetworkThread::SessionId test_id = thread.Open("localhost", test.port);
+	BOOST_CHECK(main_id != test_id);
+	main.Accept();
+	test.Accept();
+	BOOST_REQUIRE(receiver.WaitFor(2));
+	BOOST_CHECK_EQUAL(receiver.Of(main_id).at(0).type, NetworkThread::Event::EVENT_CONNECTED);
+	BOOST_CHECK_EQUAL(receiver.Of(main_id).at(0).params, "127.0.0.1");
+	BOOST_CHECK_EQUAL(receiver.Of(test_id).at(0).type, NetworkThread::Event::EVENT_CONNECTED);
+
+	// a burst arrives in few batches, a line split across reads is joined
+	std::string burst;
+	for (int i = 0; i < 500; i++) {
+		burst += "ADDUSER user" + std::to_string(i) + " DE 0 " + std::to_string(i) + "\r\n";
+	}
+	main.Write(burst + "SAID #main us");
+	test.Write("TASServer 0.36 * 8201 0\n");
+	main.Write("er hi\n");
+	BOOST_REQUIRE(receiver.WaitFor(2 + 500 + 1 + 1));
+	const std::vector<NetworkThread::Event> main_events = receiver.Of(main_id);
+	BOOST_REQUIRE_EQUAL(main_events.size(), 502u);
+	BOOST_CHECK_EQUAL(main_events[1].command, "ADDUSER");
+	BOOST_CHECK_EQUAL(main_events[1].params, "user0 DE 0 0");
+	BOOST_CHECK_EQUAL(main_events[500].params, "user499 DE 0 499");
+	BOOST_CHECK_EQUAL(main_events[501].command, "SAID");
+	BOOST_CHECK_EQUAL(main_events[501].params, "#main user hi");
+	const std::vector<NetworkThread::Event> test_events = receiver.Of(test_id);
+	BOOST_REQUIRE_EQUAL(test_events.size(), 2u);
+	BOOST_CHECK_EQUAL(test_events[1].command, "TASSERVER");
+
+	// each session writes to its own server
+	BOOST_CHECK(thread.Send(main_id, "PING\n"));
+	BOOST_CHECK(thread.Send(test_id, "LOGIN test\n"));
+	BOOST_CHECK_EQUAL(main.Read(5), "PING\n");
+	BOOST_CHECK_EQUAL(test.Read(11), "LOGIN test\n");
+
+	// closing one session leaves the other one working
+	test.CloseClient();
+	BOOST_REQUIRE(receiver.WaitFor(2 + 502 + 1));
+	BOOST_CHECK_EQUAL(receiver.Of(test_id).back().type, NetworkThread::Event::EVENT_DISCONNECTED);
+	BOOST_CHECK(!thread.Send(test_id, "PING\n"));
+	main.Write("PONG\n");
+	BOOST_REQUIRE(receiver.WaitFor(2 + 502 + 1 + 1));
+	BOOST_CHECK_EQUAL(receiver.events.back().command, "PONG");
+
+	// queued data is written before a local close
+	BOOST_CHECK(thread.Send(main_id, "EXIT\n"));
+	thread.Close(main_id);
+	BOOST_CHECK_EQUAL(main.Read(100), "EXIT\n");
+}
+
+BOOST_AUTO_TEST_CASE(connect_failure)
+{
+	int port;
+	{
+		FakeServer gone; // nothing listens on the port anymore
+		port = gone.port;
+	}
+	Receiver receiver;
+	NetworkThread thread([&receiver]() { receiver.Notify(); });
+	receiver.thread = &thread;
+	const NetworkThread::SessionId id = thread.Open("127.0.0.1", port);
+	BOOST_REQUIRE(receiver.WaitFor(1));
+	BOOST_CHECK_EQUAL(receiver.events[0].session, id);
+	BOOST_CHECK_EQUAL(receiver.events[0].type, NetworkThread::Event::EVENT_DISCONNECTED);
+	BOOST_CHECK(!receiver.events[0].params.empty());
+}
+
+BOOST_AUTO_TEST_CASE(connect_timeout)
+{
+	// a server which never accepts, once its backlog is full further connects don't finish
+	FakeServer busy(0);
+	std::vector<int> fillers;
+	for (int i = 0; i < 8; i++) {
+		const int fd = socket(AF_INET, SOCK_STREAM, 0);
+		const int flags = fcntl(fd, F_GETFL, 0);
+		fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+		sockaddr_in addr;
+		memset(&addr, 0, sizeof(addr));
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		addr.sin_port = htons(busy.port);
+		connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+		fillers.push_back(fd);
+	}
+	Receiver receiver;
+	NetworkThread thread([&receiver]() { receiver.Notify(); });
+	receiver.thread = &thread;
+	thread.SetConnectTimeout(300);
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	const NetworkThread::SessionId id = thread.Open("127.0.0.1", busy.port);
+	BOOST_REQUIRE(receiver.WaitFor(1));
+	BOOST_CHECK_EQUAL(receiver.events[0].session, id);
+	BOOST_CHECK_EQUAL(receiver.events[0].type, NetworkThread::Event::EVENT_DISCONNECTED);
+	BOOST_CHECK_EQUAL(receiver.events[0].params, "Connection timed out");
+	BOOST_CHECK(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(300));
+	for (size_t i = 0; i < fillers.size(); i++) {
+		close(fillers[i]);
+	}
+}
@@ -0,0 +1,65 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#define BOOST_TEST_MODULE notificationqueue
+#include <boost/test/unit_test.hpp>
+
+#include "gui/notifications/notificationqueue.h"
+
+using UiEvents::NotficationData;
+
+BOOST_AUTO_TEST_CASE(collapse)
+{
+	NotificationQueue::Entry single = {NotficationData(UiEvents::PrivateMessage, _T("hi"), _T("#main")), 1};
+	BOOST_CHECK(NotificationQueue::Collapse(single).message == _T("hi"));
+
+	NotificationQueue::Entry channel = {NotficationData(UiEvents::PrivateMessage, _T("latest"), _T("#main")), 5};
+	const NotficationData collapsed = NotificationQueue::Collapse(channel);
+	BOOST_CHECK(collapsed.message == _T("5 new mentions in #main\nlatest"));
+	BOOST_CHECK(collapsed.source == _T("#main"));
+	BOOST_CHECK_EQUAL(collapsed.type, UiEvents::PrivateMessage);
+
+	NotificationQueue::Entry nick = {NotficationData(UiEvents::PrivateMessage, _T("latest"), _T("bob")), 2};
+	BOOST_CHECK(NotificationQueue::Collapse(nick).message == _T("2 new messages from bob\nlatest"));
+
+	NotificationQueue::Entry other = {NotficationData(UiEvents::UserAction, _T("latest")), 3};
+	BOOST_CHECK(NotificationQueue::Collapse(other).message == _T("3 new events\nlatest"));
+}
+
+BOOST_AUTO_TEST_CASE(merge_by_source)
+{
+	NotificationQueue queue;
+	queue.Push(NotficationData(UiEvents::PrivateMessage, _T("one"), _T("#main")));
+	queue.Push(NotficationData(UiEvents::PrivateMessage, _T("two"), _T("bob")));
+	queue.Push(NotficationData(UiEvents::PrivateMessage, _T("three"), _T("#main")));
+	queue.Push(NotficationData(UiEvents::ServerConnection, _T("lost"), _T("#main")));
+	BOOST_CHECK_EQUAL(queue.GetCount(), 3u);
+
+	NotficationData data;
+	BOOST_REQUIRE(queue.Pop(data));
+	BOOST_CHECK(data.message == _T("2 new mentions in #main\nthree"));
+	BOOST_REQUIRE(queue.Pop(data));
+	BOOST_CHECK(data.message == _T("two"));
+	BOOST_REQUIRE(queue.Pop(data));
+	BOOST_CHECK(data.message == _T("lost"));
+	BOOST_CHECK(!queue.Pop(data));
+}
+
+BOOST_AUTO_TEST_CASE(capped)
+{
+	NotificationQueue queue;
+	for (size_t i = 0; i < NotificationQueue::MaxPending + 5; i++) {
+		queue.Push(NotficationData(UiEvents::PrivateMessage, wxString::Format(_T("msg %d"), int(i)), wxString::Format(_T("user%d"), int(i))));
+	}
+	BOOST_CHECK_EQUAL(queue.GetCount(), NotificationQueue::MaxPending);
+
+	NotficationData data;
+	for (size_t i = 0; i + 1 < NotificationQueue::MaxPending; i++) {
+		BOOST_REQUIRE(queue.Pop(data));
+		BOOST_CHECK(data.source == wxString::Format(_T("user%d"), int(i)));
+	}
+	// the overflow went into the last entry, which lost its source
+	BOOST_REQUIRE(queue.Pop(data));
+	BOOST_CHECK(data.source.empty());
+	BOOST_CHECK(data.message == _T("6 new events\nmsg 14"));
+	BOOST_CHECK_EQUAL(queue.GetCount(), 0u);
+}
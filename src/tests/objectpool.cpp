@@ -0,0 +1,80 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#define BOOST_TEST_MODULE objectpool
+#include <boost/test/unit_test.hpp>
+
+#include "utils/objectpool.h"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+struct Item
+{
+	Item(const std::string& name_, int* alive_)
+	    : name(name_)
+	    , alive(alive_)
+	{
+		if (name.empty())
+			throw std::runtime_error("empty name");
+		(*alive)++;
+	}
+	~Item()
+	{
+		(*alive)--;
+	}
+	std::string name;
+	int* alive;
+};
+}
+
+BOOST_AUTO_TEST_CASE(burst_uses_chunks)
+{
+	int alive = 0;
+	ObjectPool<Item, 64> pool;
+	std::vector<Item*> items;
+	for (int i = 0; i < 5000; i++) {
+		items.push_back(pool.Create("user", &alive));
+	}
+	BOOST_CHECK_EQUAL(alive, 5000);
+	BOOST_CHECK_EQUAL(pool.GetLiveCount(), 5000u);
+	BOOST_CHECK_EQUAL(pool.GetChunkCount(), 79u); // ceil(5000 / 64)
+	for (size_t i = 0; i < items.size(); i++) {
+		pool.Destroy(items[i]);
+	}
+	BOOST_CHECK_EQUAL(alive, 0);
+	BOOST_CHECK_EQUAL(pool.GetLiveCount(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(slots_are_reused)
+{
+	int alive = 0;
+	ObjectPool<Item, 4> pool;
+	Item* a = pool.Create("a", &alive);
+	Item* b = pool.Create("b", &alive);
+	pool.Destroy(a);
+	Item* c = pool.Create("c", &alive);
+	BOOST_CHECK(c == a);
+	BOOST_CHECK_EQUAL(c->name, "c");
+	for (int round = 0; round < 100; round++) {
+		pool.Destroy(pool.Create("tmp", &alive));
+	}
+	BOOST_CHECK_EQUAL(pool.GetChunkCount(), 1u);
+	pool.Destroy(b);
+	pool.Destroy(c);
+	BOOST_CHECK_EQUAL(alive, 0);
+}
+
+BOOST_AUTO_TEST_CASE(throwing_constructor)
+{
+	int alive = 0;
+	ObjectPool<Item, 4> pool;
+	BOOST_CHECK_THROW(pool.Create("", &alive), std::runtime_error);
+	BOOST_CHECK_EQUAL(pool.GetLiveCount(), 0u);
+	Item* a = pool.Create("a", &alive);
+	BOOST_CHECK_EQUAL(pool.GetLiveCount(), 1u);
+	pool.Destroy(a);
+	BOOST_CHECK_EQUAL(alive, 0);
+}
@@ -0,0 +1,122 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#define BOOST_TEST_MODULE optionspreset
+#include <boost/test/unit_test.hpp>
+
+#include "optionspreset.h"
+
+#include <cstdio>
+#include <string>
+
+#include <wx/fileconf.h>
+#include <wx/sstream.h>
+#include <lslunitsync/enum.h>
+
+BOOST_AUTO_TEST_CASE(roundtrip)
+{
+	const wxString path = _T("optionspreset_test.json");
+	OptionsPreset preset;
+	preset.options[0]["startmetal"] = OptionsPreset::Option(OptionsPreset::Option::TYPE_NUMBER, "1000.5");
+	preset.options[0]["fixedallies"] = OptionsPreset::Option(OptionsPreset::Option::TYPE_BOOL, "1");
+	preset.options[1]["mode"] = OptionsPreset::Option(OptionsPreset::Option::TYPE_STRING, "123");
+	preset.mapname = "Comet Catcher Redux";
+	OptionsPreset::StartRect rect = {1, 0, 10, 100, 200};
+	preset.startrects.push_back(rect);
+	preset.restrictions["armcom"] = 2;
+
+	PresetStore store;
+	BOOST_CHECK(!store.Load(path));
+	store.Set(_T("mine"), preset);
+	BOOST_REQUIRE(store.Save());
+
+	PresetStore loaded;
+	BOOST_REQUIRE(loaded.Load(path));
+	BOOST_REQUIRE_EQUAL(loaded.GetNames().GetCount(), 1u);
+	OptionsPreset res;
+	BOOST_REQUIRE(loaded.Get(_T("mine"), res));
+	// the types survive, so a string which looks like a number stays a string
+	BOOST_CHECK_EQUAL(res.options[0]["startmetal"].type, OptionsPreset::Option::TYPE_NUMBER);
+	BOOST_CHECK_EQUAL(res.options[0]["startmetal"].value, "1000.5");
+	BOOST_CHECK_EQUAL(res.options[0]["fixedallies"].type, OptionsPreset::Option::TYPE_BOOL);
+	BOOST_CHECK_EQUAL(res.options[0]["fixedallies"].value, "1");
+	BOOST_CHECK_EQUAL(res.options[1]["mode"].type, OptionsPreset::Option::TYPE_STRING);
+	BOOST_CHECK_EQUAL(res.options[1]["mode"].value, "123");
+	BOOST_CHECK_EQUAL(res.mapname, "Comet Catcher Redux");
+	BOOST_REQUIRE_EQUAL(res.startrects.size(), 1u);
+	BOOST_CHECK_EQUAL(res.startrects[0].ally, 1);
+	BOOST_CHECK_EQUAL(res.startrects[0].bottom, 200);
+	BOOST_CHECK_EQUAL(res.restrictions["armcom"], 2);
+
+	loaded.Remove(_T("mine"));
+	BOOST_CHECK(!loaded.Get(_T("mine"), res));
+	std::remove("optionspreset_test.json");
+}
+
+BOOST_AUTO_TEST_CASE(damaged)
+{
+	const wxString path = _T("optionspreset_damaged.json");
+	const char* content = "{\"version\": 1, \"presets\": {";
+	FILE* file = std::fopen("optionspreset_damaged.json", "wb");
+	BOOST_REQUIRE(file != NULL);
+	std::fputs(content, file);
+	std::fclose(file);
+
+	PresetStore store;
+	BOOST_CHECK(!store.Load(path));
+	store.Set(_T("mine"), OptionsPreset());
+	BOOST_CHECK(!store.Save());
+
+	char buf[64] = {0};
+	file = std::fopen("optionspreset_damaged.json", "rb");
+	BOOST_REQUIRE(file != NULL);
+	BOOST_CHECK(std::fread(buf, 1, sizeof(buf) - 1, file) > 0);
+	std::fclose(file);
+	BOOST_CHECK_EQUAL(std::string(buf), content);
+	std::remove("optionspreset_damaged.json");
+}
+
+BOOST_AUTO_TEST_CASE(import)
+{
+	wxStringInputStream stream(wxString::Format(_T("[Hosting/Preset/old/0]\n"
+						       "startmetal=1000\n"
+						       "[Hosting/Preset/old/%d]\n"
+						       "mapname=Delta Siege\n"
+						       "numrects=2\n"
+						       "rect_0_ally=1\n"
+						       "rect_0_left=5\n"
+						       "rect_0_top=6\n"
+						       "rect_0_right=7\n"
+						       "rect_0_bottom=8\n"
+						       "rect_1_ally=0\n"
+						       "restrictions=armcom=0\\tcorcom=3\n" // written escaped by wxFileConfig
+						       "[Hosting/Preset/kept/0]\n"
+						       "startmetal=5\n"),
+						    (int)LSL::Enum::PrivateOptions));
+	wxFileConfig config(stream);
+
+	PresetStore store;
+	OptionsPreset kept;
+	kept.mapname = "newer";
+	store.Set(_T("kept"), kept);
+	BOOST_REQUIRE(store.Import(config, _T("/Hosting/Preset"), LSL::Enum::PrivateOptions));
+	BOOST_CHECK_EQUAL(store.GetNames().GetCount(), 2u);
+
+	OptionsPreset res;
+	BOOST_REQUIRE(store.Get(_T("old"), res));
+	BOOST_CHECK_EQUAL(res.options[0]["startmetal"].type, OptionsPreset::Option::TYPE_STRING);
+	BOOST_CHECK_EQUAL(res.options[0]["startmetal"].value, "1000");
+	BOOST_CHECK(res.options.find(LSL::Enum::PrivateOptions) == res.options.end());
+	BOOST_CHECK_EQUAL(res.mapname, "Delta Siege");
+	BOOST_REQUIRE_EQUAL(res.startrects.size(), 1u); // the rect without ally is skipped
+	BOOST_CHECK_EQUAL(res.startrects[0].ally, 0);
+	BOOST_CHECK_EQUAL(res.startrects[0].left, 5);
+	BOOST_CHECK_EQUAL(res.startrects[0].bottom, 8);
+	BOOST_CHECK_EQUAL(res.restrictions.size(), 2u);
+	BOOST_CHECK_EQUAL(res.restrictions["corcom"], 3);
+
+	// presets already in the store win
+	BOOST_REQUIRE(store.Get(_T("kept"), res));
+	BOOST_CHECK_EQUAL(res.mapname, "newer");
+
+	BOOST_CHECK(!store.Import(config, _T("/Hosting/Nothing"), LSL::Enum::PrivateOptions));
+}
@@ -0,0 +1,59 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#define BOOST_TEST_MODULE ringbuffer
+#include <boost/test/unit_test.hpp>
+
+#include "utils/ringbuffer.h"
+
+#include <string>
+
+BOOST_AUTO_TEST_CASE(overwrite_oldest)
+{
+	RingBuffer<int> buf(3);
+	BOOST_CHECK(buf.empty());
+	BOOST_CHECK(buf.push_back(1));
+	BOOST_CHECK(buf.push_back(2));
+	BOOST_CHECK(buf.push_back(3));
+	BOOST_CHECK(buf.full());
+	BOOST_CHECK(!buf.push_back(4));
+	BOOST_CHECK(!buf.push_back(5));
+	BOOST_CHECK_EQUAL(buf.size(), 3u);
+	BOOST_CHECK_EQUAL(buf[0], 3);
+	BOOST_CHECK_EQUAL(buf[1], 4);
+	BOOST_CHECK_EQUAL(buf[2], 5);
+	BOOST_CHECK_EQUAL(buf.back(), 5);
+}
+
+BOOST_AUTO_TEST_CASE(set_capacity)
+{
+	RingBuffer<std::string> buf(4);
+	for (int i = 0; i < 6; i++) {
+		buf.push_back(std::string(1, 'a' + i));
+	}
+	buf.SetCapacity(2);
+	BOOST_CHECK_EQUAL(buf.size(), 2u);
+	BOOST_CHECK_EQUAL(buf[0], "e");
+	BOOST_CHECK_EQUAL(buf[1], "f");
+	buf.SetCapacity(3);
+	BOOST_CHECK(buf.push_back("g"));
+	BOOST_CHECK(!buf.push_back("h"));
+	BOOST_CHECK_EQUAL(buf[0], "f");
+	BOOST_CHECK_EQUAL(buf[2], "h");
+}
+
+BOOST_AUTO_TEST_CASE(clear)
+{
+	RingBuffer<int> buf(2);
+	buf.push_back(1);
+	buf.push_back(2);
+	buf.push_back(3);
+	buf.clear();
+	BOOST_CHECK(buf.empty());
+	buf.push_back(4);
+	BOOST_CHECK_EQUAL(buf[0], 4);
+	BOOST_CHECK_EQUAL(buf.size(), 1u);
+
+	RingBuffer<int> none;
+	BOOST_CHECK(!none.push_back(1));
+	BOOST_CHECK(none.empty());
+}
@@ -0,0 +1,104 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#define BOOST_TEST_MODULE savegamereader
+#include <boost/test/unit_test.hpp>
+
+#include "utils/savegamereader.h"
+
+#include <cstdio>
+#include <fstream>
+
+static const std::string script = "[GAME]\n{\n\tGameType=Balanced Annihilation;\n\tMapName=DeltaSiegeDry;\n}\n";
+
+//! writes a fixture file and removes it again when going out of scope
+struct Fixture
+{
+	std::string path;
+
+	explicit Fixture(const std::string& content)
+	    : path("savegamereader_fixture.ssf")
+	{
+		std::ofstream file(path.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+		file.write(content.data(), content.size());
+	}
+	~Fixture()
+	{
+		remove(path.c_str());
+	}
+};
+
+//! binary game state following the script, including more null bytes
+static std::string GameState(size_t size)
+{
+	std::string state(size, '\0');
+	for (size_t i = 0; i < size; i++) {
+		state[i] = static_cast<char>(i * 31);
+	}
+	return state;
+}
+
+BOOST_AUTO_TEST_CASE(valid)
+{
+	Fixture fixture(script + std::string(1, '\0') + GameState(200000));
+	std::string result;
+	BOOST_CHECK(SavegameReader::ReadScript(fixture.path, result));
+	BOOST_CHECK_EQUAL(result, script);
+}
+
+BOOST_AUTO_TEST_CASE(terminator_at_block_boundary)
+{
+	std::string big = "[GAME]\n{\n";
+	big.append(SavegameReader::BlockSize - big.size() - 1, 'x');
+	big.append("}");
+	Fixture fixture(big + std::string(1, '\0') + GameState(100));
+	std::string result;
+	BOOST_CHECK(SavegameReader::ReadScript(fixture.path, result));
+	BOOST_CHECK_EQUAL(result.size(), SavegameReader::BlockSize);
+	BOOST_CHECK(result == big);
+}
+
+BOOST_AUTO_TEST_CASE(truncated)
+{
+	Fixture fixture(script.substr(0, 20));
+	std::string result = "stale";
+	BOOST_CHECK(!SavegameReader::ReadScript(fixture.path, result));
+	BOOST_CHECK(result.empty());
+}
+
+BOOST_AUTO_TEST_CASE(corrupt)
+{
+	// binary data without null bytes where the script should be
+	std::string garbage(5000, '\0');
+	for (size_t i = 0; i < garbage.size(); i++) {
+		garbage[i] = static_cast<char>(1 + (i * 31) % 255);
+	}
+	Fixture fixture(garbage + std::string(1, '\0') + GameState(100));
+	std::string result;
+	BOOST_CHECK(!SavegameReader::ReadScript(fixture.path, result));
+	BOOST_CHECK(result.empty());
+}
+
+BOOST_AUTO_TEST_CASE(empty)
+{
+	Fixture empty("");
+	std::string result;
+	BOOST_CHECK(!SavegameReader::ReadScript(empty.path, result));
+	Fixture onlyTerminator(std::string(1, '\0'));
+	BOOST_CHECK(!SavegameReader::ReadScript(onlyTerminator.path, result));
+}
+
+BOOST_AUTO_TEST_CASE(missing)
+{
+	std::string result;
+	BOOST_CHECK(!SavegameReader::ReadScript("savegamereader_does_not_exist.ssf", result));
+}
+
+BOOST_AUTO_TEST_CASE(unterminated_is_bounded)
+{
+	Fixture fixture("[GAME]\n" + std::string(300000, 'x') + std::string(1, '\0'));
+	std::string result;
+	BOOST_CHECK(!SavegameReader::ReadScript(fixture.path, result, 100000));
+	BOOST_CHECK(result.empty());
+	BOOST_CHECK(SavegameReader::ReadScript(fixture.path, result));
+	BOOST_CHECK_EQUAL(result.size(), 300007u);
+}
@@ -0,0 +1,427 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#define BOOST_TEST_MODULE scriptsections
+#include <boost/test/unit_test.hpp>
+
+#include "battlescript.h"
+
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+typedef ScriptSectionCache Cache;
+
+//! the parts of LSL::OptionsWrapper read by WriteBattleScript
+class FakeOptions
+{
+public:
+	typedef std::map<std::string, std::pair<std::string, std::string> > OptionMap;
+
+	std::string getSingleValue(const std::string& key, LSL::Enum::GameOption type) const
+	{
+		const OptionMap& values = Get(type);
+		OptionMap::const_iterator it = values.find(key);
+		return it == values.end() ? std::string() : it->second.second;
+	}
+	OptionMap getOptions(LSL::Enum::GameOption type) const
+	{
+		return Get(type);
+	}
+	int GetAIOptionIndex(const std::string& /*nick*/) const
+	{
+		return -1;
+	}
+	void Set(LSL::Enum::GameOption type, const std::string& key, const std::string& value)
+	{
+		m_options[type][key] = std::make_pair(key, value);
+	}
+
+private:
+	const OptionMap& Get(LSL::Enum::GameOption type) const
+	{
+		static const OptionMap empty;
+		std::map<int, OptionMap>::const_iterator it = m_options.find(type);
+		return it == m_options.end() ? empty : it->second;
+	}
+
+	std::map<int, OptionMap> m_options;
+};
+
+struct FakeUser
+{
+	std::string nick;
+	std::string country;
+	int rank;
+	UserBattleStatus status;
+
+	const std::string& GetNick() const
+	{
+		return nick;
+	}
+	const std::string& GetCountry() const
+	{
+		return country;
+	}
+	int GetRank() const
+	{
+		return rank;
+	}
+	UserBattleStatus& BattleStatus()
+	{
+		return status;
+	}
+};
+
+//! the parts of IBattle read by WriteBattleScript, without a server or unitsync
+struct FakeBattle
+{
+	std::vector<FakeUser> users;
+	size_t me;
+	std::map<std::string, int> restrictions;
+	std::vector<BattleStartRect> rects;
+	FakeOptions options;
+	LSL::UnitsyncMod mod;
+	LSL::UnitsyncMap map;
+	Cache cache;
+
+	bool IsFounderMe() const
+	{
+		return me == 0;
+	}
+	bool IsProxy() const
+	{
+		return false;
+	}
+	NatType GetNatType() const
+	{
+		return NAT_None;
+	}
+	unsigned int GetMyInternalUdpSourcePort() const
+	{
+		return 0;
+	}
+	int GetHostPort() const
+	{
+		return 8452;
+	}
+	std::string GetHostIp() const
+	{
+		return "192.0.2.1";
+	}
+	FakeUser& GetMe()
+	{
+		return users[me];
+	}
+	FakeUser& GetFounder()
+	{
+		return users[0];
+	}
+	const LSL::UnitsyncMod& LoadMod()
+	{
+		return mod;
+	}
+	const LSL::UnitsyncMap& LoadMap()
+	{
+		return map;
+	}
+	std::string GetHostMapName() const
+	{
+		return map.name;
+	}
+	std::string GetHostModName() const
+	{
+		return mod.name;
+	}
+	BattleType GetBattleType() const
+	{
+		return BT_Played;
+	}
+	std::string GetPlayBackFilePath() const
+	{
+		return std::string();
+	}
+	const FakeOptions& GetCustomBattleOptions() const
+	{
+		return options;
+	}
+	std::map<std::string, int> RestrictedUnits() const
+	{
+		return restrictions;
+	}
+	unsigned int GetNumUsers() const
+	{
+		return users.size();
+	}
+	unsigned int GetNumPlayers() const
+	{
+		unsigned int players = 0;
+		for (size_t i = 0; i < users.size(); i++) {
+			if (!users[i].status.IsBot())
+				players++;
+		}
+		return players;
+	}
+	FakeUser& GetUser(unsigned int index)
+	{
+		return users.at(index);
+	}
+	FakeUser& GetUser(const std::string& nick)
+	{
+		for (size_t i = 0; i < users.size(); i++) {
+			if (users[i].nick == nick)
+				return users[i];
+		}
+		throw std::runtime_error("no such user: " + nick);
+	}
+	unsigned int GetLastRectIdx() const
+	{
+		return rects.size() - 1;
+	}
+	BattleStartRect GetStartRect(unsigned int allyno) const
+	{
+		return allyno < rects.size() ? rects[allyno] : BattleStartRect();
+	}
+	Cache& GetScriptCache()
+	{
+		return cache;
+	}
+};
+
+static std::vector<std::string> GetSides(const std::string& /*modname*/)
+{
+	std::vector<std::string> sides;
+	sides.push_back("ARM");
+	sides.push_back("CORE");
+	return sides;
+}
+
+static ScriptEnvironment Environment()
+{
+	ScriptEnvironment env;
+	env.clientport = 8300;
+	env.getsides = &GetSides;
+	return env;
+}
+
+static FakeUser Player(const std::string& nick, const std::string& country, int rank, int team, int red, int green, int blue)
+{
+	FakeUser user;
+	user.nick = nick;
+	user.country = country;
+	user.rank = rank;
+	user.status.team = team;
+	user.status.ally = team;
+	user.status.colour = LSL::lslColor(red, green, blue);
+	return user;
+}
+
+static BattleStartRect Rect(int left, int top, int right, int bottom)
+{
+	BattleStartRect rect;
+	rect.exist = true;
+	rect.left = left;
+	rect.top = top;
+	rect.right = right;
+	rect.bottom = bottom;
+	return rect;
+}
+
+//! a hosted 1v1 with a bot on the second ally team
+static void SetupBattle(FakeBattle& battle)
+{
+	battle.me = 0;
+	battle.mod.name = "Balanced Annihilation V9.79";
+	battle.mod.hash = "1234";
+	battle.map.name = "Comet Catcher Redux";
+	battle.map.hash = "5678";
+
+	battle.users.push_back(Player("host", "DE", 3, 0, 255, 0, 0));
+	battle.users.back().status.SetScriptPassword("secret");
+	battle.users.push_back(Player("guest", "FI", 0, 1, 0, 0, 255));
+	battle.users.back().status.side = 1;
+	battle.users.back().status.handicap = 5;
+	battle.users.push_back(Player("Bot", "", 0, 2, 0, 255, 0));
+	battle.users.back().status.ally = 1;
+	battle.users.back().status.SetOwner("guest");
+	battle.users.back().status.SetAIShortName("KAIK");
+	battle.users.back().status.SetAIVersion("0.13");
+
+	battle.restrictions["armcom"] = 0;
+	battle.rects.push_back(Rect(0, 0, 200, 40));
+	battle.rects.push_back(Rect(0, 160, 200, 200));
+
+	battle.options.Set(LSL::Enum::EngineOption, "startpostype", "2");
+	battle.options.Set(LSL::Enum::MapOption, "maxspeed", "3");
+	battle.options.Set(LSL::Enum::ModOption, "deathmode", "com");
+}
+
+static const char* golden =
+    "[GAME]\n"
+    "{\n"
+    "\tHostIP=;\n"
+    "\tHostPort=8452;\n"
+    "\tIsHost=1;\n"
+    "\tMyPlayerName=host;\n"
+    "\tMyPasswd=secret;\n"
+    "\n"
+    "\tModHash=1234;\n"
+    "\tMapHash=5678;\n"
+    "\tMapname=Comet Catcher Redux;\n"
+    "\tGameType=Balanced Annihilation V9.79;\n"
+    "\n"
+    "\tstartpostype=2;\n"
+    "\t[mapoptions]\n"
+    "\t{\n"
+    "\t\tmaxspeed=3;\n"
+    "\t}\n"
+    "\t[modoptions]\n"
+    "\t{\n"
+    "\t\trelayhoststartpostype=2;\n"
+    "\t\tdeathmode=com;\n"
+    "\t}\n"
+    "\tNumRestrictions=1;\n"
+    "\t[RESTRICT]\n"
+    "\t{\n"
+    "\t\tUnit0=armcom;\n"
+    "\t\tLimit0=0;\n"
+    "\t}\n"
+    "\n"
+    "\tNumPlayers=2;\n"
+    "\tNumUsers=3;\n"
+    "\n"
+    "\t[PLAYER0]\n"
+    "\t{\n"
+    "\t\tName=host;\n"
+    "\t\tCountryCode=de;\n"
+    "\t\tSpectator=0;\n"
+    "\t\tRank=3;\n"
+    "\t\tIsFromDemo=0;\n"
+    "\t\tPassword=secret;\n"
+    "\t\tTeam=0;\n"
+    "\t}\n"
+    "\t[PLAYER1]\n"
+    "\t{\n"
+    "\t\tName=guest;\n"
+    "\t\tCountryCode=fi;\n"
+    "\t\tSpectator=0;\n"
+    "\t\tRank=0;\n"
+    "\t\tIsFromDemo=0;\n"
+    "\t\tTeam=1;\n"
+    "\t}\n"
+    "\t[AI2]\n"
+    "\t{\n"
+    "\t\tName=Bot;\n"
+    "\t\tShortName=KAIK;\n"
+    "\t\tVersion=0.13;\n"
+    "\t\tTeam=2;\n"
+    "\t\tIsFromDemo=0;\n"
+    "\t\tHost=1;\n"
+    "\t\t[Options]\n"
+    "\t\t{\n"
+    "\t\t}\n"
+    "\t}\n"
+    "\n"
+    "\t[TEAM0]\n"
+    "\t{\n"
+    "\t\tTeamLeader=0;\n"
+    "\t\tAllyTeam=0;\n"
+    "\t\tRGBColor=1 0 0;\n"
+    "\t\tSide=ARM;\n"
+    "\t\tHandicap=0;\n"
+    "\t}\n"
+    "\t[TEAM1]\n"
+    "\t{\n"
+    "\t\tTeamLeader=1;\n"
+    "\t\tAllyTeam=1;\n"
+    "\t\tRGBColor=0 0 1;\n"
+    "\t\tSide=CORE;\n"
+    "\t\tHandicap=5;\n"
+    "\t}\n"
+    "\t[TEAM2]\n"
+    "\t{\n"
+    "\t\tTeamLeader=1;\n"
+    "\t\tAllyTeam=1;\n"
+    "\t\tRGBColor=0 1 0;\n"
+    "\t\tSide=ARM;\n"
+    "\t\tHandicap=0;\n"
+    "\t}\n"
+    "\n"
+    "\t[ALLYTEAM0]\n"
+    "\t{\n"
+    "\t\tNumAllies=0;\n"
+    "\t\tStartRectLeft=0.000;\n"
+    "\t\tStartRectTop=0.000;\n"
+    "\t\tStartRectRight=1.000;\n"
+    "\t\tStartRectBottom=0.200;\n"
+    "\t}\n"
+    "\t[ALLYTEAM1]\n"
+    "\t{\n"
+    "\t\tNumAllies=0;\n"
+    "\t\tStartRectLeft=0.000;\n"
+    "\t\tStartRectTop=0.800;\n"
+    "\t\tStartRectRight=1.000;\n"
+    "\t\tStartRectBottom=1.000;\n"
+    "\t}\n"
+    "}\n";
+
+BOOST_AUTO_TEST_CASE(golden_uncached)
+{
+	FakeBattle battle;
+	SetupBattle(battle);
+	for (int i = 0; i < 2; i++) {
+		battle.cache.Invalidate(Cache::AllMask());
+		BOOST_CHECK_EQUAL(WriteBattleScript(battle, Environment()), golden);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(golden_cached)
+{
+	FakeBattle battle;
+	SetupBattle(battle);
+	BOOST_CHECK_EQUAL(WriteBattleScript(battle, Environment()), golden);
+	for (int section = 0; section < Cache::SECTION_COUNT; section++) {
+		BOOST_CHECK(battle.cache.IsValid(static_cast<Cache::Section>(section)));
+	}
+	// every section is copied from the cache now
+	BOOST_CHECK_EQUAL(WriteBattleScript(battle, Environment()), golden);
+}
+
+BOOST_AUTO_TEST_CASE(invalidation)
+{
+	FakeBattle battle;
+	SetupBattle(battle);
+	WriteBattleScript(battle, Environment());
+
+	battle.users[1].status.SetScriptPassword("guestpass");
+	// not invalidated: the cached players are used even though the status changed
+	BOOST_CHECK_EQUAL(WriteBattleScript(battle, Environment()), golden);
+
+	battle.cache.Invalidate(Cache::Mask(Cache::SECTION_PLAYERS));
+	BOOST_CHECK(battle.cache.IsValid(Cache::SECTION_TEAMS));
+	const std::string cached = WriteBattleScript(battle, Environment());
+	BOOST_CHECK(cached.find("\t\tPassword=guestpass;\n") != std::string::npos);
+
+	battle.cache.Invalidate(Cache::AllMask());
+	BOOST_CHECK_EQUAL(WriteBattleScript(battle, Environment()), cached);
+}
+
+BOOST_AUTO_TEST_CASE(joined)
+{
+	FakeBattle battle;
+	SetupBattle(battle);
+	battle.me = 1;
+	BOOST_CHECK_EQUAL(WriteBattleScript(battle, Environment()),
+			  "[GAME]\n"
+			  "{\n"
+			  "\tHostIP=192.0.2.1;\n"
+			  "\tHostPort=8452;\n"
+			  "\tSourcePort=8300;\n"
+			  "\tIsHost=0;\n"
+			  "\tMyPlayerName=guest;\n"
+			  "}\n");
+	for (int section = 0; section < Cache::SECTION_COUNT; section++) {
+		BOOST_CHECK(!battle.cache.IsValid(static_cast<Cache::Section>(section)));
+	}
+}
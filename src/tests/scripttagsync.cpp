@@ -0,0 +1,50 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#define BOOST_TEST_MODULE scripttagsync
+#include <boost/test/unit_test.hpp>
+
+#include "utils/scripttagsync.h"
+
+BOOST_AUTO_TEST_CASE(only_changes)
+{
+	ScriptTagSync tags;
+	tags.Set("game/modoptions/a", "1");
+	tags.Set("game/modoptions/b", "2");
+	std::vector<std::string> cmds = tags.TakePending(900);
+	BOOST_REQUIRE_EQUAL(cmds.size(), 1u);
+	BOOST_CHECK_EQUAL(cmds[0], "game/modoptions/a=1\tgame/modoptions/b=2\t");
+	BOOST_CHECK(!tags.HasPending());
+
+	tags.Set("game/modoptions/a", "1");
+	BOOST_CHECK(!tags.HasPending());
+	tags.Set("game/modoptions/b", "3");
+	tags.Set("game/modoptions/b", "4");
+	cmds = tags.TakePending(900);
+	BOOST_REQUIRE_EQUAL(cmds.size(), 1u);
+	BOOST_CHECK_EQUAL(cmds[0], "game/modoptions/b=4\t");
+}
+
+BOOST_AUTO_TEST_CASE(changed_back)
+{
+	ScriptTagSync tags;
+	tags.Set("game/startpostype", "0");
+	tags.TakePending(900);
+	tags.Set("game/startpostype", "2");
+	tags.Set("game/startpostype", "0");
+	BOOST_CHECK(!tags.HasPending());
+	tags.Reset();
+	tags.Set("game/startpostype", "0");
+	BOOST_CHECK(tags.HasPending());
+}
+
+BOOST_AUTO_TEST_CASE(split)
+{
+	ScriptTagSync tags;
+	tags.Set("a", "12345");
+	tags.Set("b", "12345");
+	tags.Set("c", "12345");
+	const std::vector<std::string> cmds = tags.TakePending(16);
+	BOOST_REQUIRE_EQUAL(cmds.size(), 2u);
+	BOOST_CHECK_EQUAL(cmds[0], "a=12345\tb=12345\t");
+	BOOST_CHECK_EQUAL(cmds[1], "c=12345\t");
+}
@@ -0,0 +1,67 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#define BOOST_TEST_MODULE sendqueue
+#include <boost/test/unit_test.hpp>
+
+#include "utils/sendqueue.h"
+
+BOOST_AUTO_TEST_CASE(unlimited)
+{
+	SendQueue queue;
+	queue.Push("SAY main a\n", SendQueue::PRIORITY_BULK);
+	queue.Push("SAY main b\n", SendQueue::PRIORITY_BULK);
+	std::string out;
+	BOOST_CHECK_EQUAL(queue.Take(out), 22u);
+	BOOST_CHECK_EQUAL(out, "SAY main a\nSAY main b\n");
+	BOOST_CHECK(queue.IsEmpty());
+}
+
+BOOST_AUTO_TEST_CASE(rate_limit)
+{
+	SendQueue queue;
+	queue.SetRate(10, 20);
+	for (int i = 0; i < 5; i++) {
+		queue.Push("123456789\n", SendQueue::PRIORITY_BULK);
+	}
+	std::string out;
+	// the full bucket allows a burst of two commands
+	BOOST_CHECK_EQUAL(queue.Take(out), 20u);
+	BOOST_CHECK_EQUAL(queue.Take(out), 0u);
+	queue.Refill(500);
+	BOOST_CHECK_EQUAL(queue.Take(out), 0u);
+	queue.Refill(500);
+	BOOST_CHECK_EQUAL(queue.Take(out), 10u);
+	// the bucket doesn't grow beyond the burst size
+	queue.Refill(10000);
+	BOOST_CHECK_EQUAL(queue.Take(out), 20u);
+	BOOST_CHECK(queue.IsEmpty());
+	BOOST_CHECK_EQUAL(out.size(), 50u);
+}
+
+BOOST_AUTO_TEST_CASE(priority)
+{
+	SendQueue queue;
+	queue.SetRate(10, 10);
+	queue.Push("MYBATTLESTATUS 1 2\n", SendQueue::PRIORITY_BULK);
+	queue.Push("PING\n", SendQueue::PRIORITY_INTERACTIVE);
+	std::string out;
+	BOOST_CHECK_EQUAL(queue.Take(out), 5u);
+	BOOST_CHECK_EQUAL(out, "PING\n");
+	// bigger than the bucket, it's sent once the bucket is full
+	queue.Refill(300);
+	BOOST_CHECK_EQUAL(queue.Take(out), 0u);
+	queue.Refill(200);
+	BOOST_CHECK_EQUAL(queue.Take(out), 19u);
+	BOOST_CHECK_EQUAL(out, "PING\nMYBATTLESTATUS 1 2\n");
+
+	queue.Push("SETSCRIPTTAGS a=1\n", SendQueue::PRIORITY_BULK);
+	queue.Push("SAY main hi\n", SendQueue::PRIORITY_INTERACTIVE);
+	out.clear();
+	queue.Refill(1000);
+	BOOST_CHECK_EQUAL(queue.Take(out), 0u);
+	queue.Refill(1100);
+	// chat goes first, the bulk command waits for a full bucket again
+	BOOST_CHECK_EQUAL(queue.Take(out), 12u);
+	BOOST_CHECK_EQUAL(out, "SAY main hi\n");
+	BOOST_CHECK_EQUAL(queue.GetQueuedBytes(), 18u);
+}
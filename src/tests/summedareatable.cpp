@@ -0,0 +1,57 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#define BOOST_TEST_MODULE summedareatable
+#include <boost/test/unit_test.hpp>
+
+#include "utils/summedareatable.h"
+
+#include <cstdlib>
+#include <vector>
+
+static uint64_t NaiveSum(const std::vector<unsigned char>& data, int w, int x1, int y1, int x2, int y2)
+{
+	uint64_t sum = 0;
+	for (int y = y1; y < y2; y++) {
+		for (int x = x1; x < x2; x++) {
+			sum += data[3 * (y * w + x)] + data[3 * (y * w + x) + 1] + data[3 * (y * w + x) + 2];
+		}
+	}
+	return sum;
+}
+
+BOOST_AUTO_TEST_CASE(rectangles)
+{
+	const int w = 37, h = 23;
+	std::vector<unsigned char> data(3 * w * h);
+	srand(1);
+	for (size_t i = 0; i < data.size(); i++) {
+		data[i] = rand() & 0xFF;
+	}
+	SummedAreaTable table;
+	BOOST_CHECK(!table.IsOk());
+	table.Build(&data[0], w, h);
+	BOOST_CHECK(table.IsOk());
+	BOOST_CHECK_EQUAL(table.Total(), NaiveSum(data, w, 0, 0, w, h));
+	for (int i = 0; i < 500; i++) {
+		const int x1 = rand() % w, x2 = x1 + rand() % (w - x1 + 1);
+		const int y1 = rand() % h, y2 = y1 + rand() % (h - y1 + 1);
+		BOOST_CHECK_EQUAL(table.Sum(x1, y1, x2, y2), NaiveSum(data, w, x1, y1, x2, y2));
+	}
+	// clamped and empty rectangles
+	BOOST_CHECK_EQUAL(table.Sum(-10, -10, w + 10, h + 10), table.Total());
+	BOOST_CHECK_EQUAL(table.Sum(5, 5, 5, 10), 0u);
+	BOOST_CHECK_EQUAL(table.Sum(10, 10, 5, 5), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(no_overflow)
+{
+	// a 1024x1024 map full of metal sums to ~800M, far beyond the old 24bit sums
+	const int w = 1024, h = 1024;
+	std::vector<unsigned char> data(3 * w * h, 255);
+	SummedAreaTable table;
+	table.Build(&data[0], w, h);
+	const uint64_t expected = 3ull * 255 * w * h;
+	BOOST_CHECK_EQUAL(table.Total(), expected);
+	BOOST_CHECK_EQUAL(table.Sum(0, 0, w / 2, h), expected / 2);
+	BOOST_CHECK_EQUAL(table.Sum(w / 4, h / 4, 3 * w / 4, 3 * h / 4), expected / 4);
+}
@@ -0,0 +1,122 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#define BOOST_TEST_MODULE teambalance
+#include <boost/test/unit_test.hpp>
+
+#include "utils/teambalance.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
+//! exhaustive reference: best (size spread, rank spread) over all assignments
+static void BruteForce(const std::vector<double>& ranks, const std::vector<int>& sizes, size_t k, int& bestSize, double& bestRank)
+{
+	const size_t n = ranks.size();
+	bestSize = 1 << 30;
+	bestRank = 1e30;
+	std::vector<size_t> a(n, 0);
+	while (true) {
+		std::vector<double> r(k, 0.0);
+		std::vector<int> s(k, 0);
+		for (size_t i = 0; i < n; i++) {
+			r[a[i]] += ranks[i];
+			s[a[i]] += sizes[i];
+		}
+		const int sizeSpread = *std::max_element(s.begin(), s.end()) - *std::min_element(s.begin(), s.end());
+		const double rankSpread = *std::max_element(r.begin(), r.end()) - *std::min_element(r.begin(), r.end());
+		if (sizeSpread < bestSize || (sizeSpread == bestSize && rankSpread < bestRank)) {
+			bestSize = sizeSpread;
+			bestRank = rankSpread;
+		}
+		size_t i = 0;
+		while (i < n && ++a[i] == k) {
+			a[i] = 0;
+			i++;
+		}
+		if (i == n)
+			break;
+	}
+}
+
+BOOST_AUTO_TEST_CASE(optimal_small)
+{
+	srand(42);
+	for (int round = 0; round < 50; round++) {
+		const size_t k = 2 + round % 3;
+		const size_t n = 3 + round % 7;
+		std::vector<double> ranks;
+		std::vector<int> sizes;
+		TeamBalancer balancer(k, round);
+		for (size_t i = 0; i < n; i++) {
+			const int size = (rand() % 4 == 0) ? 2 + rand() % 2 : 1;
+			const double rank = size * (1.0 + 0.1 * (rand() % 8) / 7.0);
+			ranks.push_back(rank);
+			sizes.push_back(size);
+			balancer.AddUnit(rank, size);
+		}
+		const std::vector<size_t> groups = balancer.Balance();
+		BOOST_CHECK_EQUAL(groups.size(), n);
+
+		int bestSize;
+		double bestRank;
+		BruteForce(ranks, sizes, k, bestSize, bestRank);
+		BOOST_CHECK(balancer.IsOptimal());
+		BOOST_CHECK_EQUAL(balancer.GetSizeSpread(), bestSize);
+		BOOST_CHECK_SMALL(balancer.GetRankSpread() - bestRank, 1e-6);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(deterministic)
+{
+	std::vector<size_t> first;
+	for (int run = 0; run < 3; run++) {
+		TeamBalancer balancer(2, 1234);
+		for (int i = 0; i < 16; i++) {
+			balancer.AddUnit(1.0 + 0.1 * (i % 8) / 7.0);
+		}
+		const std::vector<size_t> groups = balancer.Balance();
+		if (run == 0)
+			first = groups;
+		BOOST_CHECK(groups == first);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(clans_stay_together)
+{
+	// 8v8 with a clan of four and one of three
+	TeamBalancer balancer(2, 7);
+	const size_t clan4 = balancer.AddUnit(4.2, 4);
+	const size_t clan3 = balancer.AddUnit(3.3, 3);
+	for (int i = 0; i < 9; i++) {
+		balancer.AddUnit(1.0 + 0.1 * (i % 8) / 7.0);
+	}
+	const std::vector<size_t> groups = balancer.Balance();
+	// each clan is a single unit, so it's placed into exactly one team
+	BOOST_CHECK(groups[clan4] < 2);
+	BOOST_CHECK(groups[clan3] < 2);
+	BOOST_CHECK_EQUAL(balancer.GetSizeSpread(), 0);
+	BOOST_CHECK(balancer.GetRankSpread() < 0.05);
+}
+
+BOOST_AUTO_TEST_CASE(large_bounded)
+{
+	for (size_t k = 2; k <= 4; k++) {
+		TeamBalancer balancer(k, 99);
+		for (int i = 0; i < 32; i++) {
+			balancer.AddUnit(1.0 + 0.1 * ((i * 7) % 8) / 7.0 + 0.0001 * i);
+		}
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		const std::vector<size_t> groups = balancer.Balance();
+		const long ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+		BOOST_TEST_MESSAGE("32 players, " << k << " teams: " << ms << "ms, rank spread " << balancer.GetRankSpread());
+		BOOST_CHECK_EQUAL(groups.size(), 32u);
+		if (32 % k == 0) {
+			BOOST_CHECK_EQUAL(balancer.GetSizeSpread(), 0);
+			BOOST_CHECK(balancer.GetRankSpread() < 0.02);
+		} else {
+			BOOST_CHECK_EQUAL(balancer.GetSizeSpread(), 1);
+		}
+		BOOST_CHECK(ms < 1000);
+	}
+}
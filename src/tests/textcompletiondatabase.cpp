@@ -0,0 +1,52 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#define BOOST_TEST_MODULE textcompletiondatabase
+#include <boost/test/unit_test.hpp>
+
+#include "utils/TextCompletionDatabase.h"
+
+static wxString Abbreviations(const TextCompletionMatches& matches)
+{
+	wxString res;
+	for (size_t i = 0; i < matches.size(); i++) {
+		if (i > 0)
+			res += _T(" ");
+		res += matches[i].first;
+	}
+	return res;
+}
+
+BOOST_AUTO_TEST_CASE(prefix_only)
+{
+	TextCompletionDatabase db;
+	db.Insert_Mapping(_T("Bob"), _T("Bob"));
+	db.Insert_Mapping(_T("alice"), _T("alice"));
+	db.Insert_Mapping(_T("bobby"), _T("bobby"));
+	db.Insert_Mapping(_T("[clan]bob"), _T("[clan]bob"));
+	db.Insert_Mapping(_T("BOB"), _T("BOB"));
+	BOOST_CHECK_EQUAL(db.Size(), 5u);
+
+	// case-insensitive, ordered by abbreviation, names which only contain the text don't match
+	BOOST_CHECK(Abbreviations(db.GetMapping(_T("bo"))) == _T("BOB Bob bobby"));
+	BOOST_CHECK(Abbreviations(db.GetMapping(_T("BOBB"))) == _T("bobby"));
+	BOOST_CHECK(Abbreviations(db.GetMapping(_T("[c"))) == _T("[clan]bob"));
+	BOOST_CHECK(db.GetMapping(_T("lan")).empty());
+	BOOST_CHECK_EQUAL(db.GetMapping(_T("")).size(), 5u);
+}
+
+BOOST_AUTO_TEST_CASE(insert_delete)
+{
+	TextCompletionDatabase db;
+	db.Insert_Mapping(_T("nick"), _T("first"));
+	db.Insert_Mapping(_T("nick"), _T("second")); // an existing abbreviation is kept
+	BOOST_CHECK_EQUAL(db.Size(), 1u);
+	const TextCompletionMatches matches = db.GetMapping(_T("ni"));
+	BOOST_REQUIRE_EQUAL(matches.size(), 1u);
+	BOOST_CHECK(matches[0].second == _T("first"));
+
+	db.Delete_Mapping(_T("NICK")); // deleting is case-sensitive
+	BOOST_CHECK_EQUAL(db.Size(), 1u);
+	db.Delete_Mapping(_T("nick"));
+	BOOST_CHECK_EQUAL(db.Size(), 0u);
+	BOOST_CHECK(db.GetMapping(_T("n")).empty());
+}
@@ -0,0 +1,72 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#define BOOST_TEST_MODULE thumbnailcache
+#include <boost/test/unit_test.hpp>
+
+#include "utils/thumbnailcache.h"
+
+#include <cstdio>
+#include <fstream>
+
+#include <wx/filefn.h>
+#include <wx/image.h>
+
+struct PngHandler
+{
+	PngHandler()
+	{
+		wxInitAllImageHandlers();
+	}
+};
+BOOST_GLOBAL_FIXTURE(PngHandler);
+
+BOOST_AUTO_TEST_CASE(disabled)
+{
+	ThumbnailCache cache;
+	wxImage image(4, 4);
+	BOOST_CHECK_EQUAL(cache.GetPath("1234"), "");
+	BOOST_CHECK(!cache.Save("1234", image));
+	BOOST_CHECK(!cache.Load("1234", image));
+
+	cache.SetDirectory("./", 98);
+	BOOST_CHECK_EQUAL(cache.GetPath(""), "");
+	BOOST_CHECK_EQUAL(cache.GetPath("1234"), "./1234-98.png");
+}
+
+BOOST_AUTO_TEST_CASE(roundtrip)
+{
+	ThumbnailCache cache;
+	cache.SetDirectory("./", 8);
+	wxImage image(8, 6);
+	image.SetRGB(wxRect(0, 0, 8, 6), 10, 20, 30);
+	image.SetRGB(3, 2, 200, 100, 50);
+	image.InitAlpha();
+	image.SetAlpha(3, 2, 128);
+
+	BOOST_CHECK(!cache.Load("abcd", image));
+	BOOST_REQUIRE(cache.Save("abcd", image));
+	BOOST_CHECK(!wxFileExists(_T("./abcd-8.png.tmp")));
+
+	wxImage loaded;
+	BOOST_REQUIRE(cache.Load("abcd", loaded));
+	BOOST_CHECK_EQUAL(loaded.GetWidth(), 8);
+	BOOST_CHECK_EQUAL(loaded.GetHeight(), 6);
+	BOOST_CHECK_EQUAL(loaded.GetRed(0, 0), 10);
+	BOOST_CHECK_EQUAL(loaded.GetGreen(3, 2), 100);
+	BOOST_REQUIRE(loaded.HasAlpha());
+	BOOST_CHECK_EQUAL(loaded.GetAlpha(3, 2), 128);
+	BOOST_CHECK(std::remove("abcd-8.png") == 0);
+}
+
+BOOST_AUTO_TEST_CASE(damaged)
+{
+	ThumbnailCache cache;
+	cache.SetDirectory("./", 8);
+	{
+		std::ofstream out("dead-8.png", std::ios::binary);
+		out << "\x89PNG truncated";
+	}
+	wxImage image;
+	BOOST_CHECK(!cache.Load("dead", image));
+	BOOST_CHECK(std::remove("dead-8.png") == 0);
+}
@@ -0,0 +1,38 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#define BOOST_TEST_MODULE usergroupindex
+#include <boost/test/unit_test.hpp>
+
+#include "utils/usergroupindex.h"
+
+static wxArrayString Members(const wxString& first, const wxString& second = wxEmptyString)
+{
+	wxArrayString res;
+	res.Add(first);
+	if (!second.empty())
+		res.Add(second);
+	return res;
+}
+
+BOOST_AUTO_TEST_CASE(combined_actions)
+{
+	UserGroupIndex index;
+	index.AddGroup(_T("Friends"), Members(_T("alice"), _T("bob")), 2 | 4, wxColour(0, 0, 255));
+	index.AddGroup(_T("Ignore PM"), Members(_T("bob")), 16, wxColour(255, 0, 0));
+
+	const UserGroupIndex::Entry* alice = index.Find(_T("alice"));
+	BOOST_REQUIRE(alice != NULL);
+	BOOST_CHECK_EQUAL(alice->actions, 2 | 4);
+	BOOST_CHECK(alice->group == _T("Friends"));
+
+	// bob keeps the actions of both groups, not only those of the last one
+	const UserGroupIndex::Entry* bob = index.Find(_T("bob"));
+	BOOST_REQUIRE(bob != NULL);
+	BOOST_CHECK_EQUAL(bob->actions, 2 | 4 | 16);
+	BOOST_CHECK(bob->group == _T("Ignore PM"));
+	BOOST_CHECK(bob->color == wxColour(255, 0, 0));
+
+	BOOST_CHECK(index.Find(_T("carol")) == NULL);
+	index.Clear();
+	BOOST_CHECK(index.Find(_T("alice")) == NULL);
+}
@@ -0,0 +1,112 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#define BOOST_TEST_MODULE workerpool
+#include <boost/test/unit_test.hpp>
+
+#include "utils/workerpool.h"
+
+#include <vector>
+#include <boost/bind.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+
+//! a task which blocks until Release() is called
+struct Gate
+{
+	boost::mutex mutex;
+	boost::condition_variable cond;
+	bool open;
+	int waiting;
+
+	Gate()
+	    : open(false)
+	    , waiting(0)
+	{
+	}
+	void Wait()
+	{
+		boost::mutex::scoped_lock lock(mutex);
+		waiting++;
+		cond.notify_all();
+		while (!open)
+			cond.wait(lock);
+	}
+	void WaitForWaiting(int count)
+	{
+		boost::mutex::scoped_lock lock(mutex);
+		while (waiting < count)
+			cond.wait(lock);
+	}
+	void Release()
+	{
+		boost::mutex::scoped_lock lock(mutex);
+		open = true;
+		cond.notify_all();
+	}
+};
+
+static void Append(boost::mutex* mutex, std::vector<int>* order, int value)
+{
+	boost::mutex::scoped_lock lock(*mutex);
+	order->push_back(value);
+}
+
+BOOST_AUTO_TEST_CASE(fifo_order)
+{
+	boost::mutex mutex;
+	std::vector<int> order;
+	{
+		Gate gate; // outlives the pool
+		WorkerPool pool(1);
+		BOOST_CHECK_EQUAL(pool.GetThreadCount(), 1u);
+		pool.Push(boost::bind(&Gate::Wait, &gate));
+		gate.WaitForWaiting(1);
+		for (int i = 0; i < 10; i++) {
+			pool.Push(boost::bind(&Append, &mutex, &order, i));
+		}
+		BOOST_CHECK_EQUAL(pool.GetPending(), 10u);
+		gate.Release();
+		while (pool.GetPending() > 0)
+			boost::this_thread::yield();
+		pool.Stop(); // waits for the running task
+	}
+	BOOST_REQUIRE_EQUAL(order.size(), 10u);
+	for (int i = 0; i < 10; i++) {
+		BOOST_CHECK_EQUAL(order[i], i);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(parallel)
+{
+	Gate gate;
+	WorkerPool pool(3);
+	for (int i = 0; i < 3; i++) {
+		pool.Push(boost::bind(&Gate::Wait, &gate));
+	}
+	// all threads run a task at the same time
+	gate.WaitForWaiting(3);
+	gate.Release();
+}
+
+BOOST_AUTO_TEST_CASE(clear_and_stop)
+{
+	boost::mutex mutex;
+	std::vector<int> order;
+	Gate gate;
+	WorkerPool pool(1);
+	pool.Push(boost::bind(&Gate::Wait, &gate));
+	gate.WaitForWaiting(1);
+	pool.Push(boost::bind(&Append, &mutex, &order, 1));
+	pool.ClearPending();
+	BOOST_CHECK_EQUAL(pool.GetPending(), 0u);
+	pool.Push(boost::bind(&Append, &mutex, &order, 2));
+	gate.Release();
+	while (pool.GetPending() > 0)
+		boost::this_thread::yield();
+	pool.Stop();
+	// tasks pushed after Stop() are dropped
+	pool.Push(boost::bind(&Append, &mutex, &order, 3));
+	BOOST_CHECK_EQUAL(pool.GetPending(), 0u);
+	BOOST_REQUIRE_EQUAL(order.size(), 1u);
+	BOOST_CHECK_EQUAL(order[0], 2);
+}
@@ -29,7 +29,6 @@ User::User(IServer& serv)
     : CommonUser("", "", 0)
     , m_serv(&serv)
     , m_battle(0)
-    , m_flagicon_idx(icons().GetFlagIcon(""))
     , m_rankicon_idx(icons().GetRankIcon(0))
     , m_statusicon_idx(icons().GetUserListStateIcon(GetStatus(), false, false))
     , m_sideicon_idx(icons().ICON_NONE)
@@ -40,7 +39,6 @@ User::User(const std::string& nick, IServer& serv)
     : CommonUser(nick, "", 0)
     , m_serv(&serv)
     , m_battle(0)
-    , m_flagicon_idx(icons().GetFlagIcon(""))
     , m_rankicon_idx(icons().GetRankIcon(0))
     , m_statusicon_idx(icons().GetUserListStateIcon(GetStatus(), false, false))
     , m_sideicon_idx(icons().ICON_NONE)
@@ -51,7 +49,6 @@ User::User(const std::string& nick, const std::string& country, const int& cpu,
     : CommonUser(nick, country, cpu)
     , m_serv(&serv)
     , m_battle(0)
-    , m_flagicon_idx(icons().GetFlagIcon(country))
     , m_rankicon_idx(icons().GetRankIcon(0))
     , m_statusicon_idx(icons().GetUserListStateIcon(GetStatus(), false, false))
     , m_sideicon_idx(icons().ICON_NONE)
@@ -62,7 +59,6 @@ User::User(const std::string& nick)
     : CommonUser(nick, "", 0)
     , m_serv(0)
     , m_battle(0)
-    , m_flagicon_idx(icons().GetFlagIcon(""))
     , m_rankicon_idx(icons().GetRankIcon(0))
     , m_statusicon_idx(icons().GetUserListStateIcon(GetStatus(), false, false))
     , m_sideicon_idx(icons().ICON_NONE)
@@ -73,7 +69,6 @@ User::User(const std::string& nick, const std::string& country, const int& cpu)
     : CommonUser(nick, country, cpu)
     , m_serv(0)
     , m_battle(0)
-    , m_flagicon_idx(icons().GetFlagIcon(country))
     , m_rankicon_idx(icons().GetRankIcon(0))
     , m_statusicon_idx(icons().GetUserListStateIcon(GetStatus(), false, false))
     , m_sideicon_idx(icons().ICON_NONE)
@@ -84,7 +79,6 @@ User::User()
     : CommonUser("", "", 0)
     , m_serv(0)
     , m_battle(0)
-    , m_flagicon_idx(icons().GetFlagIcon(""))
     , m_rankicon_idx(icons().GetRankIcon(0))
     , m_statusicon_idx(icons().GetUserListStateIcon(GetStatus(), false, false))
     , m_sideicon_idx(icons().ICON_NONE)
@@ -153,11 +147,6 @@ void User::SetStatus(const UserStatus& status)
 	m_rankicon_idx = icons().GetRankIcon(GetStatus().rank);
 }
 
-void User::SetCountry(const std::string& country)
-{
-	CommonUser::SetCountry(country);
-	m_flagicon_idx = icons().GetFlagIcon(country);
-}
 
 void CommonUser::UpdateBattleStatus(const UserBattleStatus& status)
 {
@@ -173,24 +162,24 @@ void CommonUser::UpdateBattleStatus(const UserBattleStatus& status)
 	m_bstatus.sync = status.sync;
 	m_bstatus.spectator = status.spectator;
 	m_bstatus.ready = status.ready;
-	if (!status.aishortname.empty())
-		m_bstatus.aishortname = status.aishortname;
-	if (!status.airawname.empty())
-		m_bstatus.airawname = status.airawname;
-	if (!status.aiversion.empty())
-		m_bstatus.aiversion = status.aiversion;
+	if (!status.GetAIShortName().empty())
+		m_bstatus.SetAIShortName(status.GetAIShortName());
+	if (!status.GetAIRawName().empty())
+		m_bstatus.SetAIRawName(status.GetAIRawName());
+	if (!status.GetAIVersion().empty())
+		m_bstatus.SetAIVersion(status.GetAIVersion());
 	if (!(status.aitype > 0))
 		m_bstatus.aitype = status.aitype;
-	if (!status.owner.empty())
-		m_bstatus.owner = status.owner;
+	if (!status.GetOwner().empty())
+		m_bstatus.SetOwner(status.GetOwner());
 	if (status.pos.x > 0)
 		m_bstatus.pos.x = status.pos.x;
 	if (status.pos.y > 0)
 		m_bstatus.pos.y = status.pos.y;
 
 	// update ip and port if those were set.
-	if (!status.ip.empty())
-		m_bstatus.ip = status.ip;
+	if (!status.GetIP().empty())
+		m_bstatus.SetIP(status.GetIP());
 	if (status.udpport != 0)
 		m_bstatus.udpport = status.udpport; // 15
 }
@@ -19,6 +19,7 @@ lsl/user/user.h
 
 #include "utils/mixins.h"
 #include <lslutils/misc.h>
+#include <memory>
 #include <string>
 
 class IServer;
@@ -102,6 +103,10 @@ struct UserBattleStatus
 {
 	//!!! when adding something to this struct, also modify User::UpdateBattleStatus() !!
 	// total 17 members here
+	// the numeric fields are updated and compared on every status change, the
+	// strings below are set for bots, relay hosts and hole punching only, so
+	// they're kept in a block which is shared between copies and not allocated at all
+	// for ordinary players. Passing a status by value copies no strings.
 	int team;
 	int ally;
 	LSL::lslColor colour;
@@ -109,23 +114,68 @@ struct UserBattleStatus
 	int handicap;
 	int side;
 	unsigned int sync;
+	int aitype;
+	// for nat holepunching
+	unsigned int udpport;
+	UserPosition pos; // for startpos = 4
 	bool spectator;
 	bool ready;
 	bool isfromdemo;
-	UserPosition pos; // for startpos = 4
+
 	// bot-only stuff
-	std::string owner;
-	std::string aishortname;
-	std::string airawname;
-	std::string aiversion;
-	int aitype;
+	const std::string& GetOwner() const
+	{
+		return m_extra ? m_extra->owner : EmptyString();
+	}
+	void SetOwner(const std::string& owner)
+	{
+		SetExtra(&Extra::owner, owner);
+	}
+	const std::string& GetAIShortName() const
+	{
+		return m_extra ? m_extra->aishortname : EmptyString();
+	}
+	void SetAIShortName(const std::string& name)
+	{
+		SetExtra(&Extra::aishortname, name);
+	}
+	const std::string& GetAIRawName() const
+	{
+		return m_extra ? m_extra->airawname : EmptyString();
+	}
+	void SetAIRawName(const std::string& name)
+	{
+		SetExtra(&Extra::airawname, name);
+	}
+	const std::string& GetAIVersion() const
+	{
+		return m_extra ? m_extra->aiversion : EmptyString();
+	}
+	void SetAIVersion(const std::string& version)
+	{
+		SetExtra(&Extra::aiversion, version);
+	}
 	// for nat holepunching
-	std::string ip;
-	unsigned int udpport;
-	std::string scriptPassword;
+	const std::string& GetIP() const
+	{
+		return m_extra ? m_extra->ip : EmptyString();
+	}
+	void SetIP(const std::string& ip)
+	{
+		SetExtra(&Extra::ip, ip);
+	}
+	const std::string& GetScriptPassword() const
+	{
+		return m_extra ? m_extra->scriptPassword : EmptyString();
+	}
+	void SetScriptPassword(const std::string& password)
+	{
+		SetExtra(&Extra::scriptPassword, password);
+	}
+
 	bool IsBot() const
 	{
-		return !aishortname.empty();
+		return !GetAIShortName().empty();
 	}
 	UserBattleStatus()
 	    : team(0)
@@ -135,20 +185,20 @@ struct UserBattleStatus
 	    , handicap(0)
 	    , side(0)
 	    , sync(SYNC_UNKNOWN)
+	    , aitype(-1)
+	    , udpport(0)
 	    , spectator(false)
 	    , ready(false)
 	    , isfromdemo(false)
-	    , aitype(-1)
-	    , udpport(0)
 	{
 	}
 	bool operator==(const UserBattleStatus& s) const
 	{
-		return ((team == s.team) && (colour == s.colour) && (handicap == s.handicap) && (side == s.side) && (sync == s.sync) && (spectator == s.spectator) && (ready == s.ready) && (owner == s.owner) && (aishortname == s.aishortname) && (isfromdemo == s.isfromdemo) && (aitype == s.aitype));
+		return ((team == s.team) && (colour == s.colour) && (handicap == s.handicap) && (side == s.side) && (sync == s.sync) && (spectator == s.spectator) && (ready == s.ready) && (GetOwner() == s.GetOwner()) && (GetAIShortName() == s.GetAIShortName()) && (isfromdemo == s.isfromdemo) && (aitype == s.aitype));
 	}
 	bool operator!=(const UserBattleStatus& s) const
 	{
-		return ((team != s.team) || (colour != s.colour) || (handicap != s.handicap) || (side != s.side) || (sync != s.sync) || (spectator != s.spectator) || (ready != s.ready) || (owner != s.owner) || (aishortname != s.aishortname) || (isfromdemo != s.isfromdemo) || (aitype != s.aitype));
+		return !(*this == s);
 	}
 
 	static UserBattleStatus FromInt(const int tas)
@@ -179,6 +229,36 @@ struct UserBattleStatus
 		//b28..31 is unused
 		return ret;
 	}
+
+private:
+	struct Extra
+	{
+		std::string owner;
+		std::string aishortname;
+		std::string airawname;
+		std::string aiversion;
+		std::string ip;
+		std::string scriptPassword;
+	};
+
+	static const std::string& EmptyString()
+	{
+		static const std::string empty;
+		return empty;
+	}
+	//! copy on write, the block is only allocated when a string is set
+	void SetExtra(std::string Extra::*member, const std::string& value)
+	{
+		if (m_extra ? (*m_extra).*member == value : value.empty())
+			return;
+		if (!m_extra)
+			m_extra = std::make_shared<Extra>();
+		else if (m_extra.use_count() > 1)
+			m_extra = std::make_shared<Extra>(*m_extra);
+		(*m_extra).*member = value;
+	}
+
+	std::shared_ptr<Extra> m_extra;
 };
 
 class ChatPanel;
@@ -327,7 +407,6 @@ public:
 
 	void SendMyUserStatus() const;
 	void SetStatus(const UserStatus& status);
-	void SetCountry(const std::string& country);
 
 	bool ExecuteSayCommand(const std::string& cmd) const;
 
@@ -337,10 +416,6 @@ public:
 	UserStatus::RankContainer GetRank();
 	std::string GetClan();
 
-	int GetFlagIconIndex() const
-	{
-		return m_flagicon_idx;
-	}
 	int GetRankIconIndex() const
 	{
 		return m_rankicon_idx;
@@ -366,7 +441,6 @@ private:
 
 	IServer* m_serv;
 	IBattle* m_battle;
-	int m_flagicon_idx;
 	int m_rankicon_idx;
 	int m_statusicon_idx;
 	int m_sideicon_idx;
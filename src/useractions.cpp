@@ -43,10 +43,10 @@ bool UserActions::DoActionOnUser(const UserActions::ActionType action, const wxS
 	// preventing action on oneself wasn't the best idea, login gets disabled
 	//if ( m_knownUsers.Index( name ) == -1 || ui().IsThisMe(name) || action == ActNone )
 
-	if (m_knownUsers.Index(name) == -1 || action == ActNone)
+	if (action == ActNone)
 		return false;
-	else
-		return (m_actionsGroups.find(action) != m_actionsGroups.end() && m_actionsPeople[action].Index(name) != -1);
+	const UserGroupIndex::Entry* entry = m_people.Find(name);
+	return entry != NULL && (entry->actions & action) != 0;
 }
 
 void UserActions::Init()
@@ -104,17 +104,12 @@ void UserActions::Init()
 	m_groupMap.clear();
 	m_groupActions.clear();
 	m_actionsGroups.clear();
-	m_actionsPeople.clear();
-	m_knownUsers.Clear();
+	m_people.Clear();
 	for (unsigned int i = 0; i < m_groupNames.GetCount(); ++i) {
-		wxString name = m_groupNames[i];
-		m_groupMap[name] = GetPeopleList(name);
-		for (unsigned int k = 0; k < m_groupMap[name].GetCount(); ++k) {
-			wxString user = m_groupMap[name][k];
-			m_knownUsers.Add(user);
-			m_peopleGroup[user] = name;
-		}
+		const wxString name = m_groupNames[i];
+		const wxArrayString& members = m_groupMap[name] = GetPeopleList(name);
 		m_groupActions[name] = GetGroupActions(name);
+		m_people.AddGroup(name, members, m_groupActions[name], GetGroupHLColor(name));
 	}
 	for (size_t i = 0; i < m_actionNames.size(); ++i) {
 		UserActions::ActionType cur = (UserActions::ActionType)(1 << i);
@@ -123,9 +118,6 @@ void UserActions::Init()
 			wxString name = m_groupNames[j];
 			if ((m_groupActions[name] & cur) != 0) {
 				tmp.Add(name);
-				for (unsigned int k = 0; k < m_groupMap[name].GetCount(); ++k) {
-					m_actionsPeople[cur].Add((m_groupMap[name])[k]);
-				}
 			}
 		}
 		tmp.Sort();
@@ -133,7 +125,6 @@ void UserActions::Init()
 	}
 	m_actionsGroups[ActNone] = m_groupNames;
 	m_groupNames.Sort();
-	m_knownUsers.Sort();
 }
 
 void UserActions::UpdateUI()
@@ -265,8 +256,18 @@ UserActions::ActionType UserActions::GetGroupAction(const wxString& group) const
 
 wxString UserActions::GetGroupOfUser(const wxString& user) const
 {
-	const PeopleGroupMap::const_iterator res = m_peopleGroup.find(user);
-	return res->second;
+	const UserGroupIndex::Entry* entry = m_people.Find(user);
+	if (entry == NULL)
+		return wxEmptyString;
+	return entry->group;
+}
+
+wxColour UserActions::GetUserColor(const wxString& user) const
+{
+	const UserGroupIndex::Entry* entry = m_people.Find(user);
+	if (entry == NULL)
+		return GetGroupHLColor();
+	return entry->color;
 }
 
 void UserActions::SetGroupColor(const wxString& group, const wxColour& color)
@@ -299,7 +300,7 @@ wxColour UserActions::GetGroupColor(const wxString& group) const
 
 bool UserActions::IsKnown(const wxString& name, bool outputWarning) const
 {
-	bool ret = m_knownUsers.Index(name) != -1;
+	bool ret = m_people.Find(name) != NULL;
 	if (outputWarning) {
 		customMessageBoxNoModal(SL_MAIN_ICON, _("To prevent logical inconsistencies, adding a user to more than one group is not allowed"),
 					_("Cannot add user to group"));
@@ -310,9 +311,15 @@ bool UserActions::IsKnown(const wxString& name, bool outputWarning) const
 
 void UserActions::RemoveUser(const wxString& name)
 {
-	wxString group = m_peopleGroup[name];
-	m_groupMap[group].Remove(name);
-	SetPeopleList(m_groupMap[group], group);
+	if (m_people.Find(name) == NULL)
+		return;
+	// old configs may have the user in more than one group
+	for (GroupMap::iterator it = m_groupMap.begin(); it != m_groupMap.end(); ++it) {
+		if (it->second.Index(name) == wxNOT_FOUND)
+			continue;
+		it->second.Remove(name);
+		SetPeopleList(it->second, it->first);
+	}
 	Init();
 	UpdateUI();
 }
@@ -4,17 +4,18 @@
 #define USERACTIONS_HH_INCLUDED
 
 #include <wx/arrstr.h>
+#include <wx/colour.h>
 #include <map>
 #include <list>
 
-class wxColour;
+#include "utils/usergroupindex.h"
 
 
 //! data handling for group / action management
 /** one single static instance is exposed as a global \n
     by forcing a write to settings handler on every change data consistency is ensured \n
-    to keep runtime overhead as small as possible for the often called query funcs, all data is structured in multiple
-    maps and wherever possible sortedArrays (binary search instead of linear!) are used \n
+    to keep runtime overhead as small as possible for the often called query funcs (every list row paint asks
+    DoActionOnUser), each known nick is hashed to its group, the action mask of that group and its highlight colour \n
     the price is that on every change operation (very rare compared to queries) maps need to be cleared/reloaded \n
     currently Gui updates are handled old fashoined way by hangling around classes, this should be improved to dynamic events
 
@@ -47,6 +48,8 @@ public:
 	void ChangeAction(const wxString& group, const ActionType action, bool add = true);
 	ActionType GetGroupAction(const wxString& group) const;
 	wxString GetGroupOfUser(const wxString& user) const;
+	//! highlight colour of the group @p user is in, without touching the settings file
+	wxColour GetUserColor(const wxString& user) const;
 	void SetGroupColor(const wxString& group, const wxColour& color);
 	wxColour GetGroupColor(const wxString& group) const;
 	bool IsKnown(const wxString& name, bool outputWarning = false) const;
@@ -80,14 +83,8 @@ private:
 	typedef std::map<ActionType, wxArrayString> ActionGroupsMap;
 	/// ActionType --> array of groups with that actiontype
 	ActionGroupsMap m_actionsGroups;
-	typedef std::map<ActionType, wxArrayString> ActionPeopleMap;
-	/// ActionType --> array of people with that actiontype
-	ActionPeopleMap m_actionsPeople;
-	///nickname --> group map (we don't allow users to be in more than one group
-	typedef std::map<wxString, wxString> PeopleGroupMap;
-	PeopleGroupMap m_peopleGroup;
-	///list all known users in groups
-	wxArrayString m_knownUsers;
+	///nickname --> group, actions and colour (we don't allow users to be in more than one group, old configs may still have them)
+	UserGroupIndex m_people;
 
 	//reload all maps and stuff
 	void Init();
@@ -2,7 +2,7 @@
 
 #include "TextCompletionDatabase.h"
 #include <wx/string.h>
-#include <wx/regex.h>
+#include <algorithm>
 
 //--------------------------------------------------------------------------------
 ///
@@ -34,7 +34,33 @@ unsigned int
 TextCompletionDatabase::Size()
 {
 
-	return hm.size();
+	return m_entries.size();
+}
+
+//--------------------------------------------------------------------------------
+///
+/// Orders Entries case-insensitively, Abbreviations which only differ in case
+/// are ordered case-sensitively so the Order is stable.
+///
+//--------------------------------------------------------------------------------
+bool
+TextCompletionDatabase::EntryOrder(const Entry& a, const Entry& b)
+{
+	const int cmp = a.key.compare(b.key);
+	if (cmp != 0)
+		return cmp < 0;
+	return a.abbreviation < b.abbreviation;
+}
+
+//--------------------------------------------------------------------------------
+///
+/// Returns the Position of the Entry with the same Abbreviation, or where it would be inserted.
+///
+//--------------------------------------------------------------------------------
+std::vector<TextCompletionDatabase::Entry>::iterator
+TextCompletionDatabase::Find(const Entry& entry)
+{
+	return std::lower_bound(m_entries.begin(), m_entries.end(), entry, EntryOrder);
 }
 
 //--------------------------------------------------------------------------------
@@ -52,10 +78,15 @@ void
 TextCompletionDatabase::Insert_Mapping(const wxString& abbreviation, const wxString& mapping)
 {
 
-	HashMap_String_String::const_iterator iter = hm.find(abbreviation);
+	Entry entry;
+	entry.key = abbreviation.Lower();
+	entry.abbreviation = abbreviation;
+	entry.mapping = mapping;
+
+	std::vector<Entry>::iterator iter = Find(entry);
 
-	if (iter == hm.end()) {
-		hm[abbreviation] = mapping;
+	if (iter == m_entries.end() || iter->abbreviation != abbreviation) {
+		m_entries.insert(iter, entry);
 	}
 }
 
@@ -71,64 +102,43 @@ void
 TextCompletionDatabase::Delete_Mapping(const wxString& abbreviation)
 {
 
-	HashMap_String_String::iterator iter = hm.find(abbreviation);
+	Entry entry;
+	entry.key = abbreviation.Lower();
+	entry.abbreviation = abbreviation;
 
-	if (iter != hm.end()) {
-		hm.erase(iter);
+	std::vector<Entry>::iterator iter = Find(entry);
+
+	if (iter != m_entries.end() && iter->abbreviation == abbreviation) {
+		m_entries.erase(iter);
 	}
 }
 
 //--------------------------------------------------------------------------------
 ///
-/// Get all Abbreviations, that match the provided Abbreviation. All matching Abbreviations and their corresponding Mapping are returned.
+/// Get all Abbreviations, that start with the provided Abbreviation (case-insensitive). All matching Abbreviations and their corresponding Mapping are returned.
 ///
 /// \parem abbreviaton
 ///		The Abbreviation to search for matching Abbreviations already contained in the TextCompletionDatabase.
 ///
 /// \return
-///		A HashMap containing all Matches.
+///		All Matches, ordered by Abbreviation.
 ///
 //--------------------------------------------------------------------------------
-HashMap_String_String
-TextCompletionDatabase::GetMapping(wxString abbreviation)
+TextCompletionMatches
+TextCompletionDatabase::GetMapping(const wxString& abbreviation) const
 {
 
-	HashMap_String_String hashmap;
-
-	// Search for all Abbreviations, containing the provided one.
-
-	// The Regex Container
-	wxRegEx regex_Abbreviations;
-
-	// We build the regular Expression:
-
-	// We need to escape all regular Expression Characters, that have a special Meaning
-	abbreviation.Replace(_T("["), _T("\\["));
-	abbreviation.Replace(_T("]"), _T("\\]"));
-
-	wxString regex_Text;
-	regex_Text.append(abbreviation);
-	regex_Text.append(wxT(".*"));
-
-// We compile the regular Expression and if it's correct, we store it in the Regex Container
-#ifdef wxHAS_REGEX_ADVANCED
-	regex_Abbreviations.Compile(regex_Text, wxRE_ADVANCED | wxRE_ICASE);
-#else
-	regex_Abbreviations.Compile(regex_Text, wxRE_EXTENDED | wxRE_ICASE);
-#endif
-
-
-	// Now we iterate over all stored Abbreviations and search for Abbreviations containing the provided Abbreviation
+	TextCompletionMatches matches;
 
-	// std::cout << "Abbr: (" << abbreviation.char_str() << ")" << std::endl;
+	// All Abbreviations starting with the Prefix follow each other in the sorted Entries,
+	// the first one is found by binary Search.
+	Entry prefix;
+	prefix.key = abbreviation.Lower();
 
-	for (HashMap_String_String::const_iterator iter = hm.begin(); iter != hm.end(); ++iter) {
-		// std::cout << "iter->first: (" << iter->first.char_str() << ")" << std::endl;
-		if (regex_Abbreviations.Matches(iter->first)) {
-			// std::cout << "Match found!" << std::endl;
-			hashmap[iter->first] = iter->second;
-		}
+	std::vector<Entry>::const_iterator iter = std::lower_bound(m_entries.begin(), m_entries.end(), prefix, EntryOrder);
+	for (; iter != m_entries.end() && iter->key.StartsWith(prefix.key); ++iter) {
+		matches.push_back(std::make_pair(iter->abbreviation, iter->mapping));
 	}
 
-	return hashmap;
+	return matches;
 }
@@ -4,11 +4,14 @@
 #define TEXTCOMPLETIONDATABASE_HPP
 
 // wxWidgets
-#include <wx/hashmap.h>
 #include <wx/string.h>
 
+#include <utility>
+#include <vector>
 
-WX_DECLARE_STRING_HASH_MAP(wxString, HashMap_String_String);
+
+//! abbreviation and mapping pairs, ordered case-insensitively by abbreviation
+typedef std::vector<std::pair<wxString, wxString> > TextCompletionMatches;
 
 
 class TextCompletionDatabase
@@ -21,10 +24,21 @@ public:
 
 	void Insert_Mapping(const wxString& abbreviation, const wxString& mapping);
 	void Delete_Mapping(const wxString& abbreviation);
-	HashMap_String_String GetMapping(wxString text);
+	TextCompletionMatches GetMapping(const wxString& text) const;
 
 private:
-	HashMap_String_String hm;
+	struct Entry
+	{
+		//! lower case abbreviation, the sort key
+		wxString key;
+		wxString abbreviation;
+		wxString mapping;
+	};
+	static bool EntryOrder(const Entry& a, const Entry& b);
+	std::vector<Entry>::iterator Find(const Entry& entry);
+
+	//! sorted by EntryOrder, so all abbreviations with a common prefix are adjacent
+	std::vector<Entry> m_entries;
 };
 
 #endif // TEXTCOMPLETIONDATABASE_HPP
@@ -0,0 +1,96 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#include "availabilitycache.h"
+
+#include <boost/bind.hpp>
+#ifndef TESTS
+#include <lslunitsync/unitsync.h>
+
+#include "slpaths.h"
+#endif
+
+static std::string MakeKey(const std::string& name, const std::string& hash)
+{
+	// '\n' can't be part of an archive name
+	return name + '\n' + hash;
+}
+
+AvailabilityCache::AvailabilityCache(const ArchiveLookup& maplookup, const ArchiveLookup& modlookup, const EngineLookup& enginelookup)
+    : m_maplookup(maplookup)
+    , m_modlookup(modlookup)
+    , m_enginelookup(enginelookup)
+    , m_content_generation(0)
+    , m_engine_generation(0)
+{
+}
+
+bool AvailabilityCache::Lookup(ResultMap& results, const unsigned int& generation, const std::string& key, const boost::function<bool()>& query)
+{
+	unsigned int started;
+	{
+		wxMutexLocker lock(m_mutex);
+		ResultMap::const_iterator it = results.find(key);
+		if (it != results.end())
+			return it->second;
+		started = generation;
+	}
+	// query without holding the lock, it might take a while
+	const bool exists = query();
+	wxMutexLocker lock(m_mutex);
+	if (generation == started)
+		results[key] = exists;
+	return exists;
+}
+
+bool AvailabilityCache::MapExists(const std::string& name, const std::string& hash)
+{
+	return Lookup(m_maps, m_content_generation, MakeKey(name, hash), boost::bind(m_maplookup, name, hash));
+}
+
+bool AvailabilityCache::ModExists(const std::string& name, const std::string& hash)
+{
+	return Lookup(m_mods, m_content_generation, MakeKey(name, hash), boost::bind(m_modlookup, name, hash));
+}
+
+bool AvailabilityCache::EngineExists(const std::string& version)
+{
+	return Lookup(m_engines, m_engine_generation, version, boost::bind(m_enginelookup, version));
+}
+
+void AvailabilityCache::ClearContent()
+{
+	wxMutexLocker lock(m_mutex);
+	m_maps.clear();
+	m_mods.clear();
+	m_content_generation++;
+}
+
+void AvailabilityCache::ClearEngines()
+{
+	wxMutexLocker lock(m_mutex);
+	m_engines.clear();
+	m_engine_generation++;
+}
+
+#ifndef TESTS
+static bool UnitsyncMapExists(const std::string& name, const std::string& hash)
+{
+	return LSL::usync().MapExists(name, hash);
+}
+
+static bool UnitsyncModExists(const std::string& name, const std::string& hash)
+{
+	return LSL::usync().ModExists(name, hash);
+}
+
+static bool EngineInstalled(const std::string& version)
+{
+	return !SlPaths::GetCompatibleVersion(version).empty();
+}
+
+AvailabilityCache& availabilityCache()
+{
+	static AvailabilityCache s_availabilityCache(&UnitsyncMapExists, &UnitsyncModExists, &EngineInstalled);
+	return s_availabilityCache;
+}
+#endif
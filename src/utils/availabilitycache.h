@@ -0,0 +1,62 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#ifndef SPRINGLOBBY_AVAILABILITYCACHE_H_INCLUDED
+#define SPRINGLOBBY_AVAILABILITYCACHE_H_INCLUDED
+
+#include <string>
+#include <unordered_map>
+#include <boost/function.hpp>
+#include <wx/thread.h>
+
+/** @brief Remembers whether maps, games and engines are installed.
+ *
+ * Asking unitsync or scanning the engine list is too slow to do for every
+ * row of the battle list on every repaint. Results are kept until Clear()
+ * is called, which has to happen whenever unitsync is reloaded or the list
+ * of engines changes. A result which was looked up while the cache was
+ * cleared is returned, but not kept, as it might be outdated already.
+ * This class is thread-safe
+ */
+class AvailabilityCache
+{
+public:
+	typedef boost::function<bool(const std::string& name, const std::string& hash)> ArchiveLookup;
+	typedef boost::function<bool(const std::string& version)> EngineLookup;
+
+	//! the lookups are called without holding a lock
+	AvailabilityCache(const ArchiveLookup& maplookup, const ArchiveLookup& modlookup, const EngineLookup& enginelookup);
+
+	//! @param hash only a map with this checksum counts if not empty
+	bool MapExists(const std::string& name, const std::string& hash = "");
+	//! @param hash only a game with this checksum counts if not empty
+	bool ModExists(const std::string& name, const std::string& hash = "");
+	//! true if an engine compatible to @p version is installed
+	bool EngineExists(const std::string& version);
+
+	//! forgets all content, call after unitsync was reloaded
+	void ClearContent();
+	//! forgets all engines, call after the engine list was refreshed
+	void ClearEngines();
+
+private:
+	typedef std::unordered_map<std::string, bool> ResultMap;
+
+	//! @param generation counter of @p results, increased when they're cleared
+	bool Lookup(ResultMap& results, const unsigned int& generation, const std::string& key, const boost::function<bool()>& query);
+
+	const ArchiveLookup m_maplookup;
+	const ArchiveLookup m_modlookup;
+	const EngineLookup m_enginelookup;
+
+	wxMutex m_mutex;
+	ResultMap m_maps;
+	ResultMap m_mods;
+	ResultMap m_engines;
+	unsigned int m_content_generation;
+	unsigned int m_engine_generation;
+};
+
+//! uses unitsync and the engine list of SlPaths
+AvailabilityCache& availabilityCache();
+
+#endif // SPRINGLOBBY_AVAILABILITYCACHE_H_INCLUDED
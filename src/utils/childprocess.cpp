@@ -0,0 +1,193 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#include "childprocess.h"
+
+#ifndef _WIN32
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+
+ChildProcess::ChildProcess()
+    : m_pid(0)
+    , m_running(false)
+{
+	m_fds[STREAM_STDOUT] = -1;
+	m_fds[STREAM_STDERR] = -1;
+}
+
+ChildProcess::~ChildProcess()
+{
+	if (m_running) {
+		Terminate(SIGKILL);
+		waitpid(m_pid, NULL, 0);
+	}
+	CloseFds();
+}
+
+void ChildProcess::CloseFds()
+{
+	for (int i = 0; i < 2; i++) {
+		if (m_fds[i] >= 0) {
+			close(m_fds[i]);
+			m_fds[i] = -1;
+		}
+	}
+}
+//! both ends are closed on exec, so they don't leak into other children started meanwhile
+static int CreatePipe(int fds[2])
+{
+#ifdef __APPLE__
+	// no pipe2() there
+	if (pipe(fds) != 0)
+		return -1;
+	fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+	fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+	return 0;
+#else
+	return pipe2(fds, O_CLOEXEC);
+#endif
+}
+
+bool ChildProcess::Start(const std::string& executable, const std::vector<std::string>& args, std::string& error)
+{
+	if (m_running) {
+		error = "process is already running";
+		return false;
+	}
+	CloseFds();
+
+	int pipes[2][2];
+	if (CreatePipe(pipes[STREAM_STDOUT]) != 0) {
+		error = strerror(errno);
+		return false;
+	}
+	if (CreatePipe(pipes[STREAM_STDERR]) != 0) {
+		error = strerror(errno);
+		close(pipes[STREAM_STDOUT][0]);
+		close(pipes[STREAM_STDOUT][1]);
+		return false;
+	}
+
+	// dup2 clears FD_CLOEXEC on the copies, the original ends are closed on exec
+	posix_spawn_file_actions_t actions;
+	posix_spawn_file_actions_init(&actions);
+	posix_spawn_file_actions_adddup2(&actions, pipes[STREAM_STDOUT][1], STDOUT_FILENO);
+	posix_spawn_file_actions_adddup2(&actions, pipes[STREAM_STDERR][1], STDERR_FILENO);
+
+	std::vector<char*> argv;
+	argv.push_back(const_cast<char*>(executable.c_str()));
+	for (size_t i = 0; i < args.size(); i++) {
+		argv.push_back(const_cast<char*>(args[i].c_str()));
+	}
+	argv.push_back(NULL);
+
+	pid_t pid = 0;
+	const int res = posix_spawnp(&pid, executable.c_str(), &actions, NULL, &argv[0], environ);
+	posix_spawn_file_actions_destroy(&actions);
+	close(pipes[STREAM_STDOUT][1]);
+	close(pipes[STREAM_STDERR][1]);
+	if (res != 0) {
+		error = strerror(res);
+		close(pipes[STREAM_STDOUT][0]);
+		close(pipes[STREAM_STDERR][0]);
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_pid = pid;
+	m_running = true;
+	m_fds[STREAM_STDOUT] = pipes[STREAM_STDOUT][0];
+	m_fds[STREAM_STDERR] = pipes[STREAM_STDERR][0];
+	return true;
+}
+
+ChildProcess::ExitStatus ChildProcess::Wait(const LineHandler& handler)
+{
+	ExitStatus status;
+	if (!m_running)
+		return status;
+
+	std::string pending[2];
+	char buf[4096];
+	while (m_fds[STREAM_STDOUT] >= 0 || m_fds[STREAM_STDERR] >= 0) {
+		pollfd fds[2];
+		nfds_t count = 0;
+		Stream streams[2];
+		for (int i = 0; i < 2; i++) {
+			if (m_fds[i] < 0)
+				continue;
+			fds[count].fd = m_fds[i];
+			fds[count].events = POLLIN;
+			fds[count].revents = 0;
+			streams[count] = static_cast<Stream>(i);
+			count++;
+		}
+		if (poll(fds, count, -1) < 0) {
+			if (errno == EINTR)
+				continue;
+			break;
+		}
+		for (nfds_t i = 0; i < count; i++) {
+			if (fds[i].revents == 0)
+				continue;
+			const Stream stream = streams[i];
+			const ssize_t len = read(m_fds[stream], buf, sizeof(buf));
+			if (len < 0 && errno == EINTR)
+				continue;
+			if (len <= 0) {
+				if (!pending[stream].empty())
+					handler(stream, pending[stream]);
+				pending[stream].clear();
+				close(m_fds[stream]);
+				m_fds[stream] = -1;
+				continue;
+			}
+			pending[stream].append(buf, len);
+			size_t start = 0;
+			size_t end;
+			while ((end = pending[stream].find('\n', start)) != std::string::npos) {
+				handler(stream, pending[stream].substr(start, end - start));
+				start = end + 1;
+			}
+			pending[stream].erase(0, start);
+		}
+	}
+	CloseFds();
+
+	// wait without reaping first, so Terminate() can't signal a pid which was reused meanwhile
+	siginfo_t info;
+	while (waitid(P_PID, m_pid, &info, WEXITED | WNOWAIT) != 0 && errno == EINTR) {
+	}
+	std::lock_guard<std::mutex> lock(m_mutex);
+	int wstatus = 0;
+	if (waitpid(m_pid, &wstatus, 0) == m_pid) {
+		if (WIFEXITED(wstatus)) {
+			status.exited = true;
+			status.code = WEXITSTATUS(wstatus);
+		} else if (WIFSIGNALED(wstatus)) {
+			status.signaled = true;
+			status.signal = WTERMSIG(wstatus);
+		}
+	}
+	m_running = false;
+	return status;
+}
+
+bool ChildProcess::Terminate(int signal)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (!m_running)
+		return false;
+	return kill(m_pid, signal) == 0;
+}
+
+#endif // _WIN32
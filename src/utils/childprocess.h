@@ -0,0 +1,86 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#ifndef SPRINGLOBBY_CHILDPROCESS_H_INCLUDED
+#define SPRINGLOBBY_CHILDPROCESS_H_INCLUDED
+
+#ifndef _WIN32
+
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <sys/types.h>
+
+/** @brief Runs an executable directly (without a shell) and captures its output.
+ *
+ * The child is started with posix_spawnp, so the executable is searched in
+ * PATH if it doesn't contain a '/'. Its stdout and stderr are connected to
+ * pipes which are read line by line in Wait(). Terminate() may be called
+ * from another thread while Wait() is running.
+ */
+class ChildProcess
+{
+public:
+	enum Stream {
+		STREAM_STDOUT,
+		STREAM_STDERR
+	};
+	typedef std::function<void(Stream stream, const std::string& line)> LineHandler;
+
+	struct ExitStatus
+	{
+		ExitStatus()
+		    : exited(false)
+		    , code(-1)
+		    , signaled(false)
+		    , signal(0)
+		{
+		}
+		//! true if the child called exit, code is valid then
+		bool exited;
+		int code;
+		//! true if the child was killed by a signal
+		bool signaled;
+		int signal;
+	};
+
+	ChildProcess();
+	//! kills and reaps the child if it is still running
+	~ChildProcess();
+
+	/** @brief Starts @p executable with the arguments @p args (without argv[0]).
+	 * @return false and sets @p error if the process couldn't be started
+	 */
+	bool Start(const std::string& executable, const std::vector<std::string>& args, std::string& error);
+	pid_t GetPid() const
+	{
+		return m_pid;
+	}
+
+	/** @brief Reads the output until the child closes it, then waits for the exit.
+	 *
+	 * Complete lines are passed to @p handler without the line break, a
+	 * last line without line break is passed when the stream ends.
+	 */
+	ExitStatus Wait(const LineHandler& handler);
+
+	//! sends @p signal to the child, @return false if it isn't running
+	bool Terminate(int signal);
+
+private:
+	ChildProcess(const ChildProcess&);
+	ChildProcess& operator=(const ChildProcess&);
+
+	void CloseFds();
+
+	pid_t m_pid;
+	//! set until the child was reaped, so a signal never hits a reused pid
+	bool m_running;
+	std::mutex m_mutex;
+	int m_fds[2];
+};
+
+#endif // _WIN32
+
+#endif // SPRINGLOBBY_CHILDPROCESS_H_INCLUDED
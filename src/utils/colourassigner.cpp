@@ -0,0 +1,210 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#include "colourassigner.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+const double ColourAssigner::MinDistance = 25.0;
+
+static double LinearRGB(unsigned char c)
+{
+	const double v = c / 255.0;
+	return (v <= 0.04045) ? v / 12.92 : std::pow((v + 0.055) / 1.055, 2.4);
+}
+
+static double LabF(double t)
+{
+	return (t > 216.0 / 24389.0) ? std::cbrt(t) : (24389.0 / 27.0 * t + 16.0) / 116.0;
+}
+
+LabColour RGBToLab(const RGBColour& col)
+{
+	const double r = LinearRGB(col.r);
+	const double g = LinearRGB(col.g);
+	const double b = LinearRGB(col.b);
+	// sRGB -> XYZ (D65), normalized by the reference white
+	const double x = (0.4124 * r + 0.3576 * g + 0.1805 * b) / 0.95047;
+	const double y = (0.2126 * r + 0.7152 * g + 0.0722 * b);
+	const double z = (0.0193 * r + 0.1192 * g + 0.9505 * b) / 1.08883;
+	const double fx = LabF(x);
+	const double fy = LabF(y);
+	const double fz = LabF(z);
+	LabColour lab;
+	lab.L = 116.0 * fy - 16.0;
+	lab.a = 500.0 * (fx - fy);
+	lab.b = 200.0 * (fy - fz);
+	return lab;
+}
+
+double ColourDistance(const LabColour& a, const LabColour& b)
+{
+	const double dL = a.L - b.L;
+	const double da = a.a - b.a;
+	const double db = a.b - b.b;
+	return std::sqrt(dL * dL + da * da + db * db);
+}
+
+double ColourDistance(const RGBColour& a, const RGBColour& b)
+{
+	return ColourDistance(RGBToLab(a), RGBToLab(b));
+}
+
+static RGBColour HSVToRGB(double h, double s, double v)
+{
+	const double hh = std::fmod(h, 1.0) * 6.0;
+	const int sector = static_cast<int>(hh);
+	const double f = hh - sector;
+	const double p = v * (1.0 - s);
+	const double q = v * (1.0 - s * f);
+	const double t = v * (1.0 - s * (1.0 - f));
+	double r, g, b;
+	switch (sector) {
+		case 0:
+			r = v;
+			g = t;
+			b = p;
+			break;
+		case 1:
+			r = q;
+			g = v;
+			b = p;
+			break;
+		case 2:
+			r = p;
+			g = v;
+			b = t;
+			break;
+		case 3:
+			r = p;
+			g = q;
+			b = v;
+			break;
+		case 4:
+			r = t;
+			g = p;
+			b = v;
+			break;
+		default:
+			r = v;
+			g = p;
+			b = q;
+			break;
+	}
+	return RGBColour(static_cast<unsigned char>(r * 255 + 0.5), static_cast<unsigned char>(g * 255 + 0.5), static_cast<unsigned char>(b * 255 + 0.5));
+}
+
+namespace
+{
+
+struct Candidate
+{
+	RGBColour rgb;
+	LabColour lab;
+};
+
+//! colours players can get, too dark colours are left out as they are hard to see ingame
+const std::vector<Candidate>& GetCandidates()
+{
+	static std::vector<Candidate> candidates;
+	if (candidates.empty()) {
+		static const double satval[][2] = {{1.0, 1.0}, {1.0, 0.65}, {0.5, 1.0}, {0.6, 0.8}, {1.0, 0.4}};
+		for (size_t sv = 0; sv < sizeof(satval) / sizeof(satval[0]); sv++) {
+			for (int h = 0; h < 24; h++) {
+				Candidate c;
+				c.rgb = HSVToRGB(h / 24.0, satval[sv][0], satval[sv][1]);
+				c.lab = RGBToLab(c.rgb);
+				candidates.push_back(c);
+			}
+		}
+		static const unsigned char greys[] = {255, 160};
+		for (size_t i = 0; i < sizeof(greys); i++) {
+			Candidate c;
+			c.rgb = RGBColour(greys[i], greys[i], greys[i]);
+			c.lab = RGBToLab(c.rgb);
+			candidates.push_back(c);
+		}
+	}
+	return candidates;
+}
+
+} // namespace
+
+void ColourAssigner::AddFixed(const RGBColour& col)
+{
+	m_fixed.push_back(col);
+}
+
+size_t ColourAssigner::AddPlayer(const RGBColour& preferred)
+{
+	Player player;
+	player.preferred = preferred;
+	player.hasPreference = true;
+	m_players.push_back(player);
+	return m_players.size() - 1;
+}
+
+size_t ColourAssigner::AddPlayer()
+{
+	Player player;
+	player.hasPreference = false;
+	m_players.push_back(player);
+	return m_players.size() - 1;
+}
+
+std::vector<RGBColour> ColourAssigner::Assign() const
+{
+	std::vector<RGBColour> result(m_players.size());
+	std::vector<bool> done(m_players.size(), false);
+	std::vector<LabColour> assigned;
+	assigned.reserve(m_fixed.size() + m_players.size());
+	for (size_t i = 0; i < m_fixed.size(); i++) {
+		assigned.push_back(RGBToLab(m_fixed[i]));
+	}
+
+	// keep preferred colours which are distinct enough
+	std::vector<LabColour> preferred(m_players.size());
+	for (size_t i = 0; i < m_players.size(); i++) {
+		if (!m_players[i].hasPreference)
+			continue;
+		preferred[i] = RGBToLab(m_players[i].preferred);
+		bool distinct = true;
+		for (size_t j = 0; j < assigned.size() && distinct; j++) {
+			distinct = ColourDistance(preferred[i], assigned[j]) >= MinDistance;
+		}
+		if (distinct) {
+			result[i] = m_players[i].preferred;
+			done[i] = true;
+			assigned.push_back(preferred[i]);
+		}
+	}
+
+	// the distance of every candidate to the nearest assigned colour
+	const std::vector<Candidate>& candidates = GetCandidates();
+	std::vector<double> nearest(candidates.size(), std::numeric_limits<double>::max());
+	for (size_t c = 0; c < candidates.size(); c++) {
+		for (size_t j = 0; j < assigned.size(); j++) {
+			nearest[c] = std::min(nearest[c], ColourDistance(candidates[c].lab, assigned[j]));
+		}
+	}
+
+	for (size_t i = 0; i < m_players.size(); i++) {
+		if (done[i])
+			continue;
+		size_t best = 0;
+		double bestPreference = std::numeric_limits<double>::max();
+		for (size_t c = 0; c < candidates.size(); c++) {
+			const double preference = m_players[i].hasPreference ? ColourDistance(candidates[c].lab, preferred[i]) : 0.0;
+			if (nearest[c] > nearest[best] + 1e-9 || (std::fabs(nearest[c] - nearest[best]) <= 1e-9 && preference < bestPreference)) {
+				best = c;
+				bestPreference = preference;
+			}
+		}
+		result[i] = candidates[best].rgb;
+		for (size_t c = 0; c < candidates.size(); c++) {
+			nearest[c] = std::min(nearest[c], ColourDistance(candidates[c].lab, candidates[best].lab));
+		}
+	}
+	return result;
+}
@@ -0,0 +1,76 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#ifndef SPRINGLOBBY_COLOURASSIGNER_H_INCLUDED
+#define SPRINGLOBBY_COLOURASSIGNER_H_INCLUDED
+
+#include <cstddef>
+#include <vector>
+
+struct RGBColour
+{
+	unsigned char r, g, b;
+
+	RGBColour()
+	    : r(0)
+	    , g(0)
+	    , b(0)
+	{
+	}
+	RGBColour(unsigned char r_, unsigned char g_, unsigned char b_)
+	    : r(r_)
+	    , g(g_)
+	    , b(b_)
+	{
+	}
+	bool operator==(const RGBColour& other) const
+	{
+		return r == other.r && g == other.g && b == other.b;
+	}
+};
+
+//! a colour in CIELAB space
+struct LabColour
+{
+	double L, a, b;
+};
+
+LabColour RGBToLab(const RGBColour& col);
+//! perceptual colour difference (CIE76 delta E)
+double ColourDistance(const LabColour& a, const LabColour& b);
+double ColourDistance(const RGBColour& a, const RGBColour& b);
+
+/** @brief Picks player colours which are easy to tell apart.
+ *
+ * Fixed colours are never changed. A player keeps the preferred colour if it
+ * is at least MinDistance away from all fixed and already kept colours,
+ * otherwise it gets the candidate colour that is farthest from every colour
+ * assigned so far. The candidates are precomputed in CIELAB once, so assigning
+ * n colours costs O(n * candidates).
+ */
+class ColourAssigner
+{
+public:
+	//! colours closer than this (delta E) are considered hard to distinguish
+	static const double MinDistance;
+
+	void AddFixed(const RGBColour& col);
+	//! adds a player who would like to keep @p preferred, returns its index
+	size_t AddPlayer(const RGBColour& preferred);
+	//! adds a player without a preference, returns its index
+	size_t AddPlayer();
+
+	//! @return the colour of every player added with AddPlayer(), in order
+	std::vector<RGBColour> Assign() const;
+
+private:
+	struct Player
+	{
+		RGBColour preferred;
+		bool hasPreference;
+	};
+
+	std::vector<RGBColour> m_fixed;
+	std::vector<Player> m_players;
+};
+
+#endif // SPRINGLOBBY_COLOURASSIGNER_H_INCLUDED
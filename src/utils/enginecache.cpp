@@ -0,0 +1,78 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#include "enginecache.h"
+
+#include <wx/string.h>
+#include <wx/ffile.h>
+#include <wx/filefn.h>
+#include <wx/tokenzr.h>
+
+#include "conversion.h"
+
+static const wxString EngineCacheHeader = _T("springlobby engine cache 1\n");
+
+static wxString ModificationTime(const std::string& path)
+{
+	if (path.empty())
+		return _T("-");
+	const wxString wxpath = TowxString(path);
+	if (!wxFileExists(wxpath) && !wxDirExists(wxpath))
+		return _T("-");
+	return wxString::Format(_T("%ld"), (long)wxFileModificationTime(wxpath));
+}
+
+std::string EngineCache::Signature(const EngineList& candidates)
+{
+	wxString res;
+	for (const Engine& engine : candidates) {
+		res += _T("candidate\t") + TowxString(engine.path) + _T("\t") + TowxString(engine.unitsync) + _T("\t") + TowxString(engine.spring) + _T("\t") + TowxString(engine.version);
+		res += _T("\t") + ModificationTime(engine.path) + _T("\t") + ModificationTime(engine.unitsync) + _T("\t") + ModificationTime(engine.spring) + _T("\n");
+	}
+	return STD_STRING(res);
+}
+
+bool EngineCache::Load(const std::string& cachefile, const std::string& signature, EngineList& engines)
+{
+	if (cachefile.empty() || !wxFileExists(TowxString(cachefile)))
+		return false;
+	wxFFile file(TowxString(cachefile), _T("rb"));
+	wxString content;
+	if (!file.IsOpened() || !file.ReadAll(&content, wxConvUTF8))
+		return false;
+	const wxString prefix = EngineCacheHeader + TowxString(signature);
+	if (!content.StartsWith(prefix))
+		return false;
+	EngineList res;
+	const wxArrayString lines = wxStringTokenize(content.Mid(prefix.length()), _T("\n"));
+	for (size_t i = 0; i < lines.GetCount(); i++) {
+		const wxArrayString fields = wxStringTokenize(lines[i], _T("\t"), wxTOKEN_RET_EMPTY_ALL);
+		if (fields.GetCount() != 5 || fields[0] != _T("engine"))
+			return false;
+		Engine engine;
+		engine.version = STD_STRING(fields[1]);
+		engine.path = STD_STRING(fields[2]);
+		engine.unitsync = STD_STRING(fields[3]);
+		engine.spring = STD_STRING(fields[4]);
+		res.push_back(engine);
+	}
+	engines.swap(res);
+	return true;
+}
+
+void EngineCache::Save(const std::string& cachefile, const std::string& signature, const EngineList& engines)
+{
+	if (cachefile.empty())
+		return;
+	wxString content = EngineCacheHeader + TowxString(signature);
+	for (const Engine& engine : engines) {
+		content += _T("engine\t") + TowxString(engine.version) + _T("\t") + TowxString(engine.path) + _T("\t") + TowxString(engine.unitsync) + _T("\t") + TowxString(engine.spring) + _T("\n");
+	}
+	// write to a temporary file first, so an interrupted write never leaves a truncated cache
+	const wxString tmpfile = TowxString(cachefile) + _T(".tmp");
+	{
+		wxFFile file(tmpfile, _T("wb"));
+		if (!file.IsOpened() || !file.Write(content, wxConvUTF8))
+			return;
+	}
+	wxRenameFile(tmpfile, TowxString(cachefile), true);
+}
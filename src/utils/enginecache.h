@@ -0,0 +1,36 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#ifndef SPRINGLOBBY_ENGINECACHE_H_INCLUDED
+#define SPRINGLOBBY_ENGINECACHE_H_INCLUDED
+
+#include <string>
+#include <vector>
+
+/** @brief Caches the engines found among the candidate directories.
+ *
+ * Probing every unitsync for its version is slow, so the result is stored
+ * together with a signature of the candidates. The signature contains the
+ * modification times of every candidate directory, unitsync and spring
+ * binary, so the cache is only used while none of them changed.
+ * Doesn't touch the config and may be used on any thread.
+ */
+class EngineCache
+{
+public:
+	struct Engine
+	{
+		std::string version;
+		std::string path;
+		std::string unitsync;
+		std::string spring;
+	};
+	typedef std::vector<Engine> EngineList;
+
+	//! everything which makes the engines found among @p candidates change
+	static std::string Signature(const EngineList& candidates);
+	//! @return false if @p cachefile doesn't exist, is damaged or was written for another signature
+	static bool Load(const std::string& cachefile, const std::string& signature, EngineList& engines);
+	static void Save(const std::string& cachefile, const std::string& signature, const EngineList& engines);
+};
+
+#endif // SPRINGLOBBY_ENGINECACHE_H_INCLUDED
@@ -0,0 +1,257 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#include "fuzzymatcher.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cwctype>
+#include <stdint.h>
+#include <unordered_map>
+
+typedef uint64_t Word;
+static const size_t WordBits = 64;
+static const size_t AsciiSize = 128;
+
+//! the match masks of a query, one bit per query character
+class FuzzyMatcher::Pattern
+{
+public:
+	explicit Pattern(const std::wstring& str)
+	    : m_length(str.size())
+	    , m_blocks(std::max<size_t>(1, (str.size() + WordBits - 1) / WordBits))
+	    , m_ascii(AsciiSize * m_blocks, 0)
+	    , m_none(m_blocks, 0)
+	{
+		for (size_t i = 0; i < str.size(); i++) {
+			const Word bit = Word(1) << (i % WordBits);
+			const wchar_t c = str[i];
+			if ((size_t)c < AsciiSize) {
+				m_ascii[c * m_blocks + i / WordBits] |= bit;
+			} else {
+				std::vector<Word>& eq = m_other[c];
+				eq.resize(m_blocks, 0);
+				eq[i / WordBits] |= bit;
+			}
+		}
+	}
+
+	//! @return one mask per block, the bits are set where the query contains @p c
+	const Word* Eq(wchar_t c) const
+	{
+		if ((size_t)c < AsciiSize)
+			return &m_ascii[c * m_blocks];
+		std::unordered_map<wchar_t, std::vector<Word> >::const_iterator it = m_other.find(c);
+		return it == m_other.end() ? &m_none[0] : &it->second[0];
+	}
+	size_t GetLength() const
+	{
+		return m_length;
+	}
+	size_t GetBlocks() const
+	{
+		return m_blocks;
+	}
+
+private:
+	size_t m_length;
+	size_t m_blocks;
+	std::vector<Word> m_ascii;
+	std::unordered_map<wchar_t, std::vector<Word> > m_other;
+	std::vector<Word> m_none;
+};
+
+FuzzyMatcher::FuzzyMatcher()
+{
+}
+
+FuzzyMatcher::FuzzyMatcher(const std::vector<std::wstring>& candidates)
+{
+	m_candidates.reserve(candidates.size());
+	for (size_t i = 0; i < candidates.size(); i++) {
+		Add(candidates[i]);
+	}
+}
+
+size_t FuzzyMatcher::Add(const std::wstring& candidate)
+{
+	const size_t index = m_candidates.size();
+	m_candidates.push_back(Fold(candidate));
+	m_lengths[candidate.size()].push_back(index);
+	return index;
+}
+
+void FuzzyMatcher::Clear()
+{
+	m_candidates.clear();
+	m_lengths.clear();
+}
+
+std::wstring FuzzyMatcher::Fold(const std::wstring& str)
+{
+	std::wstring res(str);
+	for (size_t i = 0; i < res.size(); i++) {
+		res[i] = std::towlower(res[i]);
+	}
+	return res;
+}
+
+/** Edit distance between the pattern and @p text, or anything above
+ * @p maxDistance if it is larger than that.
+ *
+ * Keeps the vertical deltas of one column of the dynamic programming matrix
+ * as bit vectors (Pv: +1, Mv: -1) and advances them one text character at a
+ * time, block by block, passing the horizontal delta of the bottom row of
+ * each block on to the next one.
+ */
+size_t FuzzyMatcher::Distance(const Pattern& pattern, const std::wstring& text, size_t maxDistance)
+{
+	const size_t m = pattern.GetLength();
+	const size_t n = text.size();
+	if (m == 0)
+		return n;
+
+	const size_t blocks = pattern.GetBlocks();
+	const size_t lastBit = (m - 1) % WordBits;
+	if (blocks == 1)
+		return DistanceSingleWord(pattern, text, maxDistance);
+
+	std::vector<Word> pv(blocks, ~Word(0));
+	std::vector<Word> mv(blocks, 0);
+	size_t score = m;
+
+	for (size_t j = 0; j < n; j++) {
+		const Word* eqs = pattern.Eq(text[j]);
+		// the top row of the matrix is 0, 1, 2, ...
+		int hin = 1;
+		for (size_t b = 0; b < blocks; b++) {
+			const size_t highBit = (b + 1 == blocks) ? lastBit : WordBits - 1;
+			Word eq = eqs[b];
+			const Word Pv = pv[b];
+			const Word Mv = mv[b];
+			const Word hinNeg = (hin < 0) ? 1 : 0;
+
+			const Word xv = eq | Mv;
+			eq |= hinNeg;
+			const Word xh = (((eq & Pv) + Pv) ^ Pv) | eq;
+			Word ph = Mv | ~(xh | Pv);
+			Word mh = Pv & xh;
+
+			const int hout = (int)((ph >> highBit) & 1) - (int)((mh >> highBit) & 1);
+			ph <<= 1;
+			mh <<= 1;
+			mh |= hinNeg;
+			ph |= (hin > 0) ? 1 : 0;
+			pv[b] = mh | ~(xv | ph);
+			mv[b] = ph & xv;
+			hin = hout;
+		}
+		score += hin;
+		// the score can drop by at most one per remaining character
+		if (score > maxDistance + (n - j - 1))
+			return maxDistance + 1;
+	}
+	return score;
+}
+
+//! Distance() for queries of up to 64 characters, without the block bookkeeping
+size_t FuzzyMatcher::DistanceSingleWord(const Pattern& pattern, const std::wstring& text, size_t maxDistance)
+{
+	const size_t m = pattern.GetLength();
+	const size_t n = text.size();
+	const Word highBit = Word(1) << (m - 1);
+	Word pv = ~Word(0);
+	Word mv = 0;
+	size_t score = m;
+
+	for (size_t j = 0; j < n; j++) {
+		const Word eq = *pattern.Eq(text[j]);
+		const Word xv = eq | mv;
+		const Word xh = (((eq & pv) + pv) ^ pv) | eq;
+		Word ph = mv | ~(xh | pv);
+		Word mh = pv & xh;
+		score += ((ph & highBit) != 0);
+		score -= ((mh & highBit) != 0);
+		ph = (ph << 1) | 1;
+		mh <<= 1;
+		pv = mh | ~(xv | ph);
+		mv = ph & xv;
+		if (score > maxDistance + (n - j - 1))
+			return maxDistance + 1;
+	}
+	return score;
+}
+
+size_t FuzzyMatcher::EditDistance(const std::wstring& a, const std::wstring& b)
+{
+	const std::wstring fa = Fold(a);
+	const std::wstring fb = Fold(b);
+	// the shorter string as pattern needs fewer blocks
+	if (fa.size() > fb.size())
+		return Distance(Pattern(fb), fa, fa.size());
+	return Distance(Pattern(fa), fb, fb.size());
+}
+
+double FuzzyMatcher::NormalizedDistance(const std::wstring& a, const std::wstring& b)
+{
+	const size_t longest = std::max(a.size(), b.size());
+	if (longest == 0)
+		return 0.0;
+	return (double)EditDistance(a, b) / longest;
+}
+
+static bool MatchOrder(const FuzzyMatcher::Match& a, const FuzzyMatcher::Match& b)
+{
+	if (a.distance != b.distance)
+		return a.distance < b.distance;
+	return a.index < b.index;
+}
+
+std::vector<FuzzyMatcher::Match> FuzzyMatcher::Find(const std::wstring& query, size_t count, double maxDistance) const
+{
+	std::vector<Match> result;
+	if (count == 0 || m_candidates.empty())
+		return result;
+
+	const std::wstring folded = Fold(query);
+	const Pattern pattern(folded);
+	const size_t m = folded.size();
+
+	// the length difference is a lower bound for the distance, visit the lengths by that bound
+	std::vector<std::pair<double, size_t> > lengths;
+	lengths.reserve(m_lengths.size());
+	for (std::map<size_t, std::vector<size_t> >::const_iterator it = m_lengths.begin(); it != m_lengths.end(); ++it) {
+		const size_t n = it->first;
+		const size_t longest = std::max(m, n);
+		const double bound = (longest == 0) ? 0.0 : (double)(std::max(m, n) - std::min(m, n)) / longest;
+		lengths.push_back(std::make_pair(bound, n));
+	}
+	std::sort(lengths.begin(), lengths.end());
+
+	for (size_t l = 0; l < lengths.size(); l++) {
+		const double worst = (result.size() < count) ? maxDistance : result.back().distance;
+		if (lengths[l].first > worst)
+			break;
+		const size_t n = lengths[l].second;
+		const size_t longest = std::max(m, n);
+		const std::vector<size_t>& indices = m_lengths.find(n)->second;
+		for (size_t i = 0; i < indices.size(); i++) {
+			const double limit = (result.size() < count) ? maxDistance : result.back().distance;
+			const size_t maxEdits = (size_t)std::floor(limit * longest + 1e-9);
+			const size_t edits = Distance(pattern, m_candidates[indices[i]], maxEdits);
+			if (edits > maxEdits)
+				continue;
+			Match match;
+			match.index = indices[i];
+			match.distance = (longest == 0) ? 0.0 : (double)edits / longest;
+			if (match.distance > maxDistance)
+				continue;
+			if (result.size() == count) {
+				if (!MatchOrder(match, result.back()))
+					continue;
+				result.pop_back();
+			}
+			result.insert(std::upper_bound(result.begin(), result.end(), match, MatchOrder), match);
+		}
+	}
+	return result;
+}
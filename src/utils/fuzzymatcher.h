@@ -0,0 +1,62 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#ifndef SPRINGLOBBY_FUZZYMATCHER_H_INCLUDED
+#define SPRINGLOBBY_FUZZYMATCHER_H_INCLUDED
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+/** @brief Finds the candidates closest to a query by case insensitive edit distance.
+ *
+ * Distances are computed with Myers' bit-parallel algorithm (in the block
+ * based form by Hyyrö), which handles strings of any length in
+ * O(ceil(m / 64) * n). The candidates are indexed by length, so a query only
+ * looks at candidates whose length allows them to make it into the result.
+ */
+class FuzzyMatcher
+{
+public:
+	struct Match
+	{
+		//! index of the candidate, in the order they were added
+		size_t index;
+		//! edit distance normalized by the length of the longer string, 0.0 - 1.0
+		double distance;
+	};
+
+	FuzzyMatcher();
+	explicit FuzzyMatcher(const std::vector<std::wstring>& candidates);
+
+	//! adds a candidate and returns its index
+	size_t Add(const std::wstring& candidate);
+	void Clear();
+	size_t GetCount() const
+	{
+		return m_candidates.size();
+	}
+
+	/** @return up to @p count candidates with a normalized distance of at most
+	 * @p maxDistance, best first. Equally good candidates are ordered by index.
+	 */
+	std::vector<Match> Find(const std::wstring& query, size_t count = 1, double maxDistance = 1.0) const;
+
+	//! case insensitive Levenshtein distance
+	static size_t EditDistance(const std::wstring& a, const std::wstring& b);
+	//! EditDistance() normalized by the length of the longer string
+	static double NormalizedDistance(const std::wstring& a, const std::wstring& b);
+
+private:
+	class Pattern;
+	static std::wstring Fold(const std::wstring& str);
+	static size_t Distance(const Pattern& pattern, const std::wstring& text, size_t maxDistance);
+	static size_t DistanceSingleWord(const Pattern& pattern, const std::wstring& text, size_t maxDistance);
+
+	//! lower cased candidates
+	std::vector<std::wstring> m_candidates;
+	//! candidate indices by length
+	std::map<size_t, std::vector<size_t> > m_lengths;
+};
+
+#endif // SPRINGLOBBY_FUZZYMATCHER_H_INCLUDED
@@ -14,6 +14,7 @@ public:
 	static const wxEventType OnDownloadComplete;
 	static const wxEventType OnUnitsyncFirstTimeLoad;
 	static const wxEventType OnUnitsyncReloaded;
+	static const wxEventType OnSpringVersionsChanged;
 	static const wxEventType OnSpringTerminated;
 	static const wxEventType OnSpringStarted;
 	static const wxEventType UpdateFinished;
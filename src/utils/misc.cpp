@@ -2,67 +2,61 @@
 
 #include "misc.h"
 
-#include <lslutils/misc.h>
 #include "settings.h"
 #include "conversion.h"
 
 #include <wx/string.h>
 #include <wx/arrstr.h>
-#include <wx/log.h>
 #include <vector>
 
-double LevenshteinDistance(const wxString& _s, const wxString& _t)
-{
-	const wxString s = _s.Lower(); // case insensitive edit distance
-	const wxString t = _t.Lower();
+#include "fuzzymatcher.h"
 
-	const int m = s.length(), n = t.length(), _w = m + 1;
-	std::vector<unsigned char> _d((m + 1) * (n + 1));
-#define D(x, y) _d[(y)*_w + (x)]
-
-	for (int i = 0; i <= m; ++i)
-		D(i, 0) = i;
-	for (int j = 0; j <= n; ++j)
-		D(0, j) = j;
+static std::wstring ToWString(const wxString& str)
+{
+	return str.ToStdWstring();
+}
 
-	for (int i = 1; i <= m; ++i) {
-		for (int j = 1; j <= n; ++j) {
-			const int cost = (s[i - 1] != t[j - 1]);
-			D(i, j) = LSL::Util::Min(D(i - 1, j) + 1,	 // deletion
-						 D(i, j - 1) + 1,	 // insertion
-						 D(i - 1, j - 1) + cost); // substitution
-		}
-	}
-	double d = (double)D(m, n) / std::max(m, n);
-	wxLogMessage(_T("LevenshteinDistance('%s', '%s') = %g"), s.c_str(), t.c_str(), d);
-	return d;
-#undef D
+double LevenshteinDistance(const wxString& _s, const wxString& _t)
+{
+	return FuzzyMatcher::NormalizedDistance(ToWString(_s), ToWString(_t));
 }
 
 #ifndef TEST
-#include "lslconversion.h"
 std::string GetBestMatch(const std::vector<std::string>& a, const std::string& s, double* distance)
 {
-	auto arr = lslTowxArrayString(a);
-	return STD_STRING(GetBestMatch(arr, TowxString(s), distance));
+	FuzzyMatcher matcher;
+	for (size_t i = 0; i < a.size(); ++i) {
+		matcher.Add(ToWString(TowxString(a[i])));
+	}
+	const int index = GetBestMatch(matcher, ToWString(TowxString(s)), distance);
+	if (index < 0)
+		return "";
+	return a[index];
 }
 #endif
 
 wxString GetBestMatch(const wxArrayString& a, const wxString& s, double* distance)
 {
-	const unsigned int count = a.GetCount();
-	double minDistance = 1.0;
-	int minDistanceIndex = -1;
-	for (unsigned int i = 0; i < count; ++i) {
-		const double distance_ = LevenshteinDistance(a[i], s);
-		if (distance_ < minDistance) {
-			minDistance = distance_;
-			minDistanceIndex = i;
-		}
+	FuzzyMatcher matcher;
+	for (size_t i = 0; i < a.GetCount(); ++i) {
+		matcher.Add(ToWString(a[i]));
 	}
-	if (distance != NULL)
-		*distance = minDistance;
-	if (minDistanceIndex == -1)
+	const int index = GetBestMatch(matcher, ToWString(s), distance);
+	if (index < 0)
 		return wxEmptyString;
-	return a[minDistanceIndex];
+	return a[index];
+}
+
+int GetBestMatch(const FuzzyMatcher& matcher, const std::wstring& s, double* distance)
+{
+	const std::vector<FuzzyMatcher::Match> matches = matcher.Find(s, 1);
+	// a distance of 1.0 means nothing in common
+	if (matches.empty() || matches[0].distance >= 1.0) {
+		if (distance != NULL)
+			*distance = 1.0;
+		return -1;
+	}
+	if (distance != NULL)
+		*distance = matches[0].distance;
+	return matches[0].index;
 }
@@ -8,11 +8,13 @@
 
 class wxArrayString;
 class wxString;
+class FuzzyMatcher;
 
 /**
  * @brief Computes Levenshtein distance (edit distance) between two strings.
  * @return the Levenshtein distance normalized by the longest string's length.
  * @note Source: http://en.wikipedia.org/wiki/Levenshtein_distance
+ * @see FuzzyMatcher
  */
 double LevenshteinDistance(const wxString& _s, const wxString& _t);
 
@@ -22,5 +24,7 @@ double LevenshteinDistance(const wxString& _s, const wxString& _t);
  */
 wxString GetBestMatch(const wxArrayString& a, const wxString& s, double* distance = 0);
 std::string GetBestMatch(const std::vector<std::string>& a, const std::string& s, double* distance = 0);
+//! same as above for a prebuilt candidate index, @return the index of the match or -1
+int GetBestMatch(const FuzzyMatcher& matcher, const std::wstring& s, double* distance = 0);
 
 #endif // SPRINGLOBBY_HEADERGUARD_MISC_H
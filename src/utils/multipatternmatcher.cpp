@@ -0,0 +1,146 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#include "multipatternmatcher.h"
+
+#include <algorithm>
+#include <queue>
+
+static bool IsAscii(wchar_t c)
+{
+	return static_cast<unsigned long>(c) < 128;
+}
+
+static bool EdgeOrder(const std::pair<wchar_t, int>& a, const std::pair<wchar_t, int>& b)
+{
+	return a.first < b.first;
+}
+
+MultiPatternMatcher::MultiPatternMatcher()
+{
+	Clear();
+}
+
+MultiPatternMatcher::MultiPatternMatcher(const std::vector<std::wstring>& patterns)
+{
+	Build(patterns);
+}
+
+void MultiPatternMatcher::Clear()
+{
+	m_nodes.assign(1, Node());
+	m_nodes[0].fail = 0;
+	m_nodes[0].output = -1;
+	m_ascii.assign(AsciiSize, 0);
+	m_patternCount = 0;
+}
+
+int MultiPatternMatcher::Child(int node, wchar_t c) const
+{
+	const std::vector<std::pair<wchar_t, int> >& edges = m_nodes[node].edges;
+	const std::vector<std::pair<wchar_t, int> >::const_iterator it = std::lower_bound(edges.begin(), edges.end(), std::make_pair(c, 0), EdgeOrder);
+	if (it == edges.end() || it->first != c)
+		return -1;
+	return it->second;
+}
+
+int MultiPatternMatcher::Step(int node, wchar_t c) const
+{
+	if (IsAscii(c))
+		return m_ascii[node * AsciiSize + c];
+	while (true) {
+		const int next = Child(node, c);
+		if (next >= 0)
+			return next;
+		if (node == 0)
+			return 0;
+		node = m_nodes[node].fail;
+	}
+}
+
+void MultiPatternMatcher::Build(const std::vector<std::wstring>& patterns)
+{
+	m_nodes.assign(1, Node());
+	m_nodes[0].fail = 0;
+	m_nodes[0].output = -1;
+	// -1 marks a missing edge while the trie is built
+	m_ascii.assign(AsciiSize, -1);
+	m_patternCount = 0;
+
+	for (size_t p = 0; p < patterns.size(); p++) {
+		const std::wstring& pattern = patterns[p];
+		if (pattern.empty())
+			continue;
+		m_patternCount++;
+		int node = 0;
+		for (size_t i = 0; i < pattern.size(); i++) {
+			const wchar_t c = pattern[i];
+			int next = IsAscii(c) ? m_ascii[node * AsciiSize + c] : Child(node, c);
+			if (next < 0) {
+				next = m_nodes.size();
+				Node child;
+				child.fail = 0;
+				child.output = -1;
+				m_nodes.push_back(child);
+				m_ascii.resize(m_nodes.size() * AsciiSize, -1);
+				if (IsAscii(c)) {
+					m_ascii[node * AsciiSize + c] = next;
+				} else {
+					std::vector<std::pair<wchar_t, int> >& edges = m_nodes[node].edges;
+					edges.insert(std::lower_bound(edges.begin(), edges.end(), std::make_pair(c, 0), EdgeOrder), std::make_pair(c, next));
+				}
+			}
+			node = next;
+		}
+		if (m_nodes[node].output < 0)
+			m_nodes[node].output = p;
+	}
+
+	// breadth first, so the failure target of every node is complete before the node itself
+	std::queue<int> queue;
+	queue.push(0);
+	while (!queue.empty()) {
+		const int node = queue.front();
+		queue.pop();
+		const int fail = m_nodes[node].fail;
+		for (size_t c = 0; c < AsciiSize; c++) {
+			int& next = m_ascii[node * AsciiSize + c];
+			const int fallback = (node == 0) ? 0 : m_ascii[fail * AsciiSize + c];
+			if (next < 0) {
+				next = fallback;
+				continue;
+			}
+			Node& child = m_nodes[next];
+			child.fail = fallback;
+			if (child.output < 0)
+				child.output = m_nodes[fallback].output;
+			queue.push(next);
+		}
+		for (size_t e = 0; e < m_nodes[node].edges.size(); e++) {
+			const std::pair<wchar_t, int> edge = m_nodes[node].edges[e];
+			const int fallback = (node == 0) ? 0 : Step(fail, edge.first);
+			Node& child = m_nodes[edge.second];
+			child.fail = fallback;
+			if (child.output < 0)
+				child.output = m_nodes[fallback].output;
+			queue.push(edge.second);
+		}
+	}
+}
+
+int MultiPatternMatcher::FindFirst(const std::wstring& text) const
+{
+	if (m_patternCount == 0)
+		return -1;
+	int node = 0;
+	for (size_t i = 0; i < text.size(); i++) {
+		node = Step(node, text[i]);
+		if (m_nodes[node].output >= 0)
+			return m_nodes[node].output;
+	}
+	return -1;
+}
+
+bool MultiPatternMatcher::ContainsAny(const std::wstring& text) const
+{
+	return FindFirst(text) >= 0;
+}
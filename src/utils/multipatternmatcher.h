@@ -0,0 +1,64 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#ifndef SPRINGLOBBY_MULTIPATTERNMATCHER_H_INCLUDED
+#define SPRINGLOBBY_MULTIPATTERNMATCHER_H_INCLUDED
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+/** @brief Tests a text for any of a fixed set of substrings in one pass.
+ *
+ * The patterns are compiled into an Aho-Corasick automaton. Transitions on
+ * ASCII characters are resolved into a dense table when building, so matching
+ * plain text costs one table lookup per character regardless of the number
+ * of patterns. Other characters follow sparse edges and failure links.
+ * Matching is case sensitive, empty patterns are ignored.
+ */
+class MultiPatternMatcher
+{
+public:
+	MultiPatternMatcher();
+	explicit MultiPatternMatcher(const std::vector<std::wstring>& patterns);
+
+	//! replaces the patterns and rebuilds the automaton
+	void Build(const std::vector<std::wstring>& patterns);
+	void Clear();
+	bool IsEmpty() const
+	{
+		return m_patternCount == 0;
+	}
+	size_t GetPatternCount() const
+	{
+		return m_patternCount;
+	}
+
+	//! true if @p text contains at least one of the patterns
+	bool ContainsAny(const std::wstring& text) const;
+	//! index of the longest pattern ending where the first match in @p text ends, or -1
+	int FindFirst(const std::wstring& text) const;
+
+private:
+	static const size_t AsciiSize = 128;
+
+	struct Node
+	{
+		//! non ASCII edges, sorted by character
+		std::vector<std::pair<wchar_t, int> > edges;
+		int fail;
+		/** index of the first pattern spelling this node, if there is none the
+		 * output of the failure target (the longest proper suffix), or -1 */
+		int output;
+	};
+
+	int Child(int node, wchar_t c) const;
+	int Step(int node, wchar_t c) const;
+
+	std::vector<Node> m_nodes;
+	//! m_ascii[node * AsciiSize + c] is the complete transition on ASCII character c
+	std::vector<int> m_ascii;
+	size_t m_patternCount;
+};
+
+#endif // SPRINGLOBBY_MULTIPATTERNMATCHER_H_INCLUDED
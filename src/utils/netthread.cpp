@@ -0,0 +1,585 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#include "netthread.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <boost/bind.hpp>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+
+typedef SOCKET NativeSocket;
+typedef int socklen_t;
+
+static int LastError()
+{
+	return WSAGetLastError();
+}
+static bool WouldBlock(int err)
+{
+	return err == WSAEWOULDBLOCK;
+}
+static bool Interrupted(int err)
+{
+	return err == WSAEINTR;
+}
+static bool SetNonBlocking(NativeSocket fd)
+{
+	u_long mode = 1;
+	return ioctlsocket(fd, FIONBIO, &mode) == 0;
+}
+static void CloseNative(NativeSocket fd)
+{
+	closesocket(fd);
+}
+static std::string ErrorString(int err)
+{
+	char buf[32];
+	snprintf(buf, sizeof(buf), "socket error %d", err);
+	return buf;
+}
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+typedef int NativeSocket;
+static const NativeSocket INVALID_SOCKET = -1;
+
+static int LastError()
+{
+	return errno;
+}
+static bool WouldBlock(int err)
+{
+	return err == EWOULDBLOCK || err == EAGAIN || err == EINPROGRESS;
+}
+static bool Interrupted(int err)
+{
+	return err == EINTR;
+}
+static bool SetNonBlocking(NativeSocket fd)
+{
+	const int flags = fcntl(fd, F_GETFL, 0);
+	return (flags != -1) && (fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0);
+}
+static void CloseNative(NativeSocket fd)
+{
+	close(fd);
+}
+static std::string ErrorString(int err)
+{
+	return strerror(err);
+}
+#endif
+
+#ifdef MSG_NOSIGNAL
+static const int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+static const int SEND_FLAGS = 0;
+#endif
+
+static const size_t READS_PER_ROUND = 16; // then the other sessions get their turn
+
+static NativeSocket Native(intptr_t handle)
+{
+	return static_cast<NativeSocket>(handle);
+}
+
+struct NetworkThread::Session
+{
+	enum State {
+		STATE_NEW,
+		STATE_CONNECTING,
+		STATE_OPEN,
+		STATE_CLOSED
+	};
+	Session(SessionId id_, const std::string& host_, int port_, int connect_timeout_)
+	    : id(id_)
+	    , host(host_)
+	    , port(port_)
+	    , connect_timeout(connect_timeout_)
+	    , fd(static_cast<SocketHandle>(INVALID_SOCKET))
+	    , state(STATE_NEW)
+	    , closing(false)
+	{
+	}
+	SessionId id;
+	std::string host;
+	int port;
+	int connect_timeout; //!< ms
+	// the members above and these are only used by the network thread
+	SocketHandle fd;
+	State state;
+	std::chrono::steady_clock::time_point connect_deadline;
+	std::string in; //!< received data without a line break yet
+	// guarded by m_mutex
+	std::string out;
+	bool closing;
+};
+
+NetworkThread::NetworkThread(const NotifyCallback& notify)
+    : m_next_id(1)
+    , m_connect_timeout(DefaultConnectTimeout)
+    , m_stop(false)
+    , m_notify(notify)
+    , m_wake_fd(static_cast<SocketHandle>(INVALID_SOCKET))
+    , m_wake_port(0)
+{
+#ifdef _WIN32
+	WSADATA data;
+	WSAStartup(MAKEWORD(2, 2), &data);
+#endif
+	// a udp socket connected to itself, so Wake() works the same on all platforms
+	NativeSocket fd = socket(AF_INET, SOCK_DGRAM, 0);
+	sockaddr_in addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	socklen_t len = sizeof(addr);
+	if ((fd == INVALID_SOCKET) || (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) ||
+	    (getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len) != 0) ||
+	    (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) || !SetNonBlocking(fd)) {
+		const std::string error = ErrorString(LastError());
+		if (fd != INVALID_SOCKET)
+			CloseNative(fd);
+		throw std::runtime_error("NetworkThread: couldn't create the wakeup socket: " + error);
+	}
+	m_wake_fd = static_cast<SocketHandle>(fd);
+	m_wake_port = ntohs(addr.sin_port);
+
+	boost::thread thread(boost::bind(&NetworkThread::Run, this));
+	m_thread.swap(thread);
+}
+
+NetworkThread::~NetworkThread()
+{
+	{
+		boost::mutex::scoped_lock lock(m_mutex);
+		m_stop = true;
+	}
+	Wake();
+	m_thread.join();
+	for (std::map<SessionId, SessionPtr>::iterator it = m_sessions.begin(); it != m_sessions.end(); ++it) {
+		if (Native(it->second->fd) != INVALID_SOCKET)
+			CloseNative(Native(it->second->fd));
+	}
+	CloseNative(Native(m_wake_fd));
+#ifdef _WIN32
+	WSACleanup();
+#endif
+}
+
+NetworkThread::SessionId NetworkThread::Open(const std::string& host, int port)
+{
+	SessionId id;
+	{
+		boost::mutex::scoped_lock lock(m_mutex);
+		id = m_next_id++;
+		m_sessions[id] = SessionPtr(new Session(id, host, port, m_connect_timeout));
+	}
+	Wake();
+	return id;
+}
+
+void NetworkThread::SetConnectTimeout(int ms)
+{
+	boost::mutex::scoped_lock lock(m_mutex);
+	m_connect_timeout = ms;
+}
+
+void NetworkThread::Close(SessionId session)
+{
+	{
+		boost::mutex::scoped_lock lock(m_mutex);
+		std::map<SessionId, SessionPtr>::iterator it = m_sessions.find(session);
+		if (it == m_sessions.end())
+			return;
+		it->second->closing = true;
+	}
+	Wake();
+}
+
+bool NetworkThread::Send(SessionId session, const std::string& data)
+{
+	{
+		boost::mutex::scoped_lock lock(m_mutex);
+		std::map<SessionId, SessionPtr>::iterator it = m_sessions.find(session);
+		if ((it == m_sessions.end()) || it->second->closing)
+			return false;
+		const bool wake = it->second->out.empty();
+		it->second->out += data;
+		if (!wake) // the network thread is already waiting until it can write
+			return true;
+	}
+	Wake();
+	return true;
+}
+
+void NetworkThread::TakeEvents(std::vector<Event>& events)
+{
+	events.clear();
+	boost::mutex::scoped_lock lock(m_mutex);
+	events.swap(m_events);
+}
+
+void NetworkThread::Wake()
+{
+	const char c = 0;
+	send(Native(m_wake_fd), &c, 1, 0);
+}
+
+void NetworkThread::PushEvents(std::vector<Event>& events)
+{
+	if (events.empty())
+		return;
+	bool was_empty;
+	{
+		boost::mutex::scoped_lock lock(m_mutex);
+		was_empty = m_events.empty();
+		m_events.insert(m_events.end(), events.begin(), events.end());
+	}
+	events.clear();
+	// the owner fetches all events queued until then, so one notification per batch is enough
+	if (was_empty && m_notify)
+		m_notify();
+}
+
+void NetworkThread::Run()
+{
+	std::vector<Event> events;
+	std::vector<SessionPtr> sessions;
+	while (true) {
+		sessions.clear();
+		{
+			boost::mutex::scoped_lock lock(m_mutex);
+			if (m_stop)
+				break;
+			for (std::map<SessionId, SessionPtr>::iterator it = m_sessions.begin(); it != m_sessions.end(); ++it) {
+				sessions.push_back(it->second);
+			}
+		}
+
+		fd_set readfds, writefds, exceptfds;
+		FD_ZERO(&readfds);
+		FD_ZERO(&writefds);
+		FD_ZERO(&exceptfds);
+		FD_SET(Native(m_wake_fd), &readfds);
+		NativeSocket maxfd = Native(m_wake_fd);
+		bool has_deadline = false;
+		std::chrono::steady_clock::time_point deadline;
+		for (size_t i = 0; i < sessions.size(); i++) {
+			Session& session = *sessions[i];
+			bool closing;
+			bool has_out;
+			{
+				boost::mutex::scoped_lock lock(m_mutex);
+				closing = session.closing;
+				has_out = !session.out.empty();
+			}
+			if (closing) {
+				std::string error;
+				if (session.state == Session::STATE_OPEN)
+					Write(session, error); // best effort, so a last EXIT reaches the server
+				if (Native(session.fd) != INVALID_SOCKET)
+					CloseNative(Native(session.fd));
+				session.fd = static_cast<SocketHandle>(INVALID_SOCKET);
+				session.state = Session::STATE_CLOSED;
+				boost::mutex::scoped_lock lock(m_mutex);
+				m_sessions.erase(session.id);
+				continue;
+			}
+			if (session.state == Session::STATE_NEW)
+				StartConnect(session, events);
+			const NativeSocket fd = Native(session.fd);
+			if (session.state == Session::STATE_CONNECTING) {
+				FD_SET(fd, &writefds);
+				FD_SET(fd, &exceptfds);
+				if (!has_deadline || (session.connect_deadline < deadline))
+					deadline = session.connect_deadline;
+				has_deadline = true;
+			} else if (session.state == Session::STATE_OPEN) {
+				FD_SET(fd, &readfds);
+				if (has_out)
+					FD_SET(fd, &writefds);
+			} else {
+				continue;
+			}
+			if (fd > maxfd)
+				maxfd = fd;
+		}
+		PushEvents(events);
+
+		timeval timeout;
+		if (has_deadline) {
+			const long long wait = std::max<long long>(0, std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count());
+			timeout.tv_sec = static_cast<long>(wait / 1000);
+			timeout.tv_usec = static_cast<long>((wait % 1000) * 1000);
+		}
+		if (select(static_cast<int>(maxfd) + 1, &readfds, &writefds, &exceptfds, has_deadline ? &timeout : NULL) < 0) {
+			continue; // interrupted, the sets are rebuilt in the next round
+		}
+		const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		if (FD_ISSET(Native(m_wake_fd), &readfds)) {
+			char buf[64];
+			while (recv(Native(m_wake_fd), buf, sizeof(buf), 0) > 0) {
+			}
+		}
+
+		for (size_t i = 0; i < sessions.size(); i++) {
+			Session& session = *sessions[i];
+			const NativeSocket fd = Native(session.fd);
+			if (fd == INVALID_SOCKET)
+				continue;
+			if (session.state == Session::STATE_CONNECTING) {
+				if (FD_ISSET(fd, &writefds) || FD_ISSET(fd, &exceptfds))
+					FinishConnect(session, events);
+				else if (now >= session.connect_deadline)
+					Disconnected(session, "Connection timed out", events);
+				continue;
+			}
+			if (session.state != Session::STATE_OPEN)
+				continue;
+			if (FD_ISSET(fd, &readfds) && !Receive(session, events))
+				continue;
+			std::string error;
+			if (FD_ISSET(fd, &writefds) && !Write(session, error))
+				Disconnected(session, error, events);
+		}
+		PushEvents(events);
+	}
+}
+
+void NetworkThread::StartConnect(Session& session, std::vector<Event>& events)
+{
+	addrinfo hints;
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_INET; // the server wants the local ipv4 address at login
+	hints.ai_socktype = SOCK_STREAM;
+	char port[16];
+	snprintf(port, sizeof(port), "%d", session.port);
+	addrinfo* res = NULL;
+	// blocks the other sessions while resolving, which is rare and usually fast
+	if ((getaddrinfo(session.host.c_str(), port, &hints, &res) != 0) || (res == NULL)) {
+		Disconnected(session, "Couldn't resolve " + session.host, events);
+		return;
+	}
+	const NativeSocket fd = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+	if ((fd == INVALID_SOCKET) || !SetNonBlocking(fd)) {
+		const std::string error = ErrorString(LastError());
+		if (fd != INVALID_SOCKET)
+			CloseNative(fd);
+		freeaddrinfo(res);
+		Disconnected(session, error, events);
+		return;
+	}
+#ifdef SO_NOSIGPIPE
+	int on = 1;
+	setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+	session.fd = static_cast<SocketHandle>(fd);
+	const int res_connect = connect(fd, res->ai_addr, static_cast<socklen_t>(res->ai_addrlen));
+	const int err = LastError();
+	freeaddrinfo(res);
+	if (res_connect == 0) {
+		FinishConnect(session, events);
+	} else if (WouldBlock(err)) {
+		session.state = Session::STATE_CONNECTING;
+		session.connect_deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(session.connect_timeout);
+	} else {
+		Disconnected(session, ErrorString(err), events);
+	}
+}
+
+void NetworkThread::FinishConnect(Session& session, std::vector<Event>& events)
+{
+	const NativeSocket fd = Native(session.fd);
+	int err = 0;
+	socklen_t len = sizeof(err);
+	if (getsockopt(fd, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&err), &len) != 0)
+		err = LastError();
+	if (err != 0) {
+		Disconnected(session, ErrorString(err), events);
+		return;
+	}
+	session.state = Session::STATE_OPEN;
+
+	Event event;
+	event.session = session.id;
+	event.type = Event::EVENT_CONNECTED;
+	sockaddr_in local;
+	len = sizeof(local);
+	if (getsockname(fd, reinterpret_cast<sockaddr*>(&local), &len) == 0)
+		event.params = inet_ntoa(local.sin_addr); // only called on this thread
+	events.push_back(event);
+}
+
+bool NetworkThread::Receive(Session& session, std::vector<Event>& events)
+{
+	char buf[4096];
+	for (size_t reads = 0; reads < READS_PER_ROUND; reads++) {
+		const int len = recv(Native(session.fd), buf, sizeof(buf), 0);
+		if (len == 0) {
+			Disconnected(session, "", events);
+			return false;
+		}
+		if (len < 0) {
+			const int err = LastError();
+			if (Interrupted(err))
+				continue;
+			if (WouldBlock(err))
+				return true;
+			Disconnected(session, ErrorString(err), events);
+			return false;
+		}
+		session.in.append(buf, len);
+		size_t start = 0;
+		size_t end;
+		while ((end = session.in.find('\n', start)) != std::string::npos) {
+			size_t lineend = end;
+			if ((lineend > start) && (session.in[lineend - 1] == '\r'))
+				lineend--;
+			Event event;
+			if (ParseLine(ToUtf8(session.in.substr(start, lineend - start)), event)) {
+				event.session = session.id;
+				events.push_back(event);
+			}
+			start = end + 1;
+		}
+		session.in.erase(0, start);
+	}
+	return true;
+}
+
+bool NetworkThread::Write(Session& session, std::string& error)
+{
+	std::string data;
+	{
+		boost::mutex::scoped_lock lock(m_mutex);
+		data.swap(session.out);
+	}
+	size_t sent = 0;
+	while (sent < data.size()) {
+		const int len = send(Native(session.fd), data.data() + sent, static_cast<int>(data.size() - sent), SEND_FLAGS);
+		if (len > 0) {
+			sent += len;
+			continue;
+		}
+		const int err = LastError();
+		if (Interrupted(err))
+			continue;
+		if (WouldBlock(err))
+			break;
+		error = ErrorString(err);
+		return false;
+	}
+	if (sent < data.size()) { // keep the rest in front of what was queued meanwhile
+		boost::mutex::scoped_lock lock(m_mutex);
+		session.out.insert(0, data, sent, std::string::npos);
+	}
+	return true;
+}
+
+void NetworkThread::Disconnected(Session& session, const std::string& error, std::vector<Event>& events)
+{
+	if (Native(session.fd) != INVALID_SOCKET)
+		CloseNative(Native(session.fd));
+	session.fd = static_cast<SocketHandle>(INVALID_SOCKET);
+	session.state = Session::STATE_CLOSED;
+	{
+		boost::mutex::scoped_lock lock(m_mutex);
+		m_sessions.erase(session.id);
+	}
+	Event event;
+	event.session = session.id;
+	event.type = Event::EVENT_DISCONNECTED;
+	event.params = error;
+	events.push_back(event);
+}
+
+bool NetworkThread::ParseLine(const std::string& line, Event& event)
+{
+	size_t start = 0;
+	event.replyid = 0;
+	if (!line.empty() && (line[0] == '#')) { // "#id COMMAND params"
+		start = line.find(' ');
+		event.replyid = atoi(line.substr(1, start == std::string::npos ? std::string::npos : start - 1).c_str());
+		if (start == std::string::npos)
+			return false;
+		start++;
+	}
+	const size_t end = line.find(' ', start);
+	if (end == std::string::npos) {
+		event.command = line.substr(start);
+		event.params.clear();
+	} else {
+		event.command = line.substr(start, end - start);
+		event.params = line.substr(end + 1);
+	}
+	for (size_t i = 0; i < event.command.size(); i++) {
+		event.command[i] = static_cast<char>(toupper(static_cast<unsigned char>(event.command[i])));
+	}
+	event.type = Event::EVENT_COMMAND;
+	return !event.command.empty();
+}
+
+static bool IsValidUtf8(const std::string& text)
+{
+	const size_t len = text.size();
+	size_t i = 0;
+	while (i < len) {
+		const unsigned char c = text[i];
+		size_t follow;
+		if (c < 0x80)
+			follow = 0;
+		else if ((c >= 0xC2) && (c <= 0xDF))
+			follow = 1;
+		else if ((c >= 0xE0) && (c <= 0xEF))
+			follow = 2;
+		else if ((c >= 0xF0) && (c <= 0xF4))
+			follow = 3;
+		else
+			return false;
+		if (i + follow >= len)
+			return false;
+		for (size_t j = 1; j <= follow; j++) {
+			if ((static_cast<unsigned char>(text[i + j]) & 0xC0) != 0x80)
+				return false;
+		}
+		i += follow + 1;
+	}
+	return true;
+}
+
+std::string NetworkThread::ToUtf8(const std::string& text)
+{
+	if (IsValidUtf8(text))
+		return text;
+	std::string res;
+	res.reserve(text.size() * 2);
+	for (size_t i = 0; i < text.size(); i++) {
+		const unsigned char c = text[i];
+		if (c < 0x80) {
+			res += static_cast<char>(c);
+		} else {
+			res += static_cast<char>(0xC0 | (c >> 6));
+			res += static_cast<char>(0x80 | (c & 0x3F));
+		}
+	}
+	return res;
+}
@@ -0,0 +1,110 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#ifndef SPRINGLOBBY_NETTHREAD_H_INCLUDED
+#define SPRINGLOBBY_NETTHREAD_H_INCLUDED
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+/** @brief Services any number of lobby protocol connections on one thread.
+ *
+ * Connecting, reading, line splitting and splitting the lines into commands
+ * happen on the network thread. The results are queued as events, the
+ * notify callback is called (on the network thread) when the queue becomes
+ * non-empty, so the owner can fetch a whole batch with TakeEvents() from
+ * its own thread. All other methods may be called from any thread.
+ */
+class NetworkThread
+{
+public:
+	typedef int SessionId;
+	typedef boost::function<void()> NotifyCallback;
+
+	struct Event
+	{
+		enum Type {
+			EVENT_CONNECTED,    //!< params is the local address of the connection
+			EVENT_COMMAND,	    //!< a line received from the server
+			EVENT_DISCONNECTED, //!< params is the error, empty if the server closed the connection
+		};
+		Event()
+		    : session(-1)
+		    , type(EVENT_COMMAND)
+		    , replyid(0)
+		{
+		}
+		SessionId session;
+		Type type;
+		std::string command; //!< upper case
+		std::string params;
+		int replyid; //!< id of a "#id COMMAND params" line, 0 if there was none
+	};
+
+	explicit NetworkThread(const NotifyCallback& notify);
+	//! closes all connections and stops the thread
+	~NetworkThread();
+
+	//! default for SetConnectTimeout()
+	static const int DefaultConnectTimeout = 40000;
+
+	/** @brief Starts connecting to @p host.
+	 * The host name is resolved on the network thread, a failure or a connect
+	 * which doesn't finish within the connect timeout is reported with
+	 * EVENT_DISCONNECTED.
+	 */
+	SessionId Open(const std::string& host, int port);
+	//! timeout in milliseconds for sessions opened afterwards
+	void SetConnectTimeout(int ms);
+	//! writes what was queued before and closes the connection, no event is sent for it
+	void Close(SessionId session);
+	//! @return false if @p session isn't open or connecting
+	bool Send(SessionId session, const std::string& data);
+	//! moves all queued events to @p events
+	void TakeEvents(std::vector<Event>& events);
+
+	/** @brief Parses a received line into @p event.
+	 * @return false if the line contains no command
+	 */
+	static bool ParseLine(const std::string& line, Event& event);
+	//! returns @p text if it's valid UTF-8, otherwise it's taken as ISO-8859-1 and converted
+	static std::string ToUtf8(const std::string& text);
+
+private:
+	struct Session;
+	typedef boost::shared_ptr<Session> SessionPtr;
+	//! an int on posix, a SOCKET on windows
+	typedef intptr_t SocketHandle;
+
+	NetworkThread(const NetworkThread&);
+	NetworkThread& operator=(const NetworkThread&);
+
+	void Run();
+	void Wake();
+	void StartConnect(Session& session, std::vector<Event>& events);
+	void FinishConnect(Session& session, std::vector<Event>& events);
+	bool Receive(Session& session, std::vector<Event>& events);
+	//! writes as much as the socket accepts, @return false and sets @p error on failure
+	bool Write(Session& session, std::string& error);
+	void Disconnected(Session& session, const std::string& error, std::vector<Event>& events);
+	void PushEvents(std::vector<Event>& events);
+
+	boost::mutex m_mutex;
+	std::map<SessionId, SessionPtr> m_sessions;
+	std::vector<Event> m_events;
+	SessionId m_next_id;
+	int m_connect_timeout;
+	bool m_stop;
+	NotifyCallback m_notify;
+	//! loopback udp socket, a datagram to it interrupts select()
+	SocketHandle m_wake_fd;
+	int m_wake_port;
+	boost::thread m_thread;
+};
+
+#endif // SPRINGLOBBY_NETTHREAD_H_INCLUDED
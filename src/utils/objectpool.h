@@ -0,0 +1,104 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#ifndef SPRINGLOBBY_OBJECTPOOL_H_INCLUDED
+#define SPRINGLOBBY_OBJECTPOOL_H_INCLUDED
+
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/** @brief Allocates objects of type T in chunks of ChunkSize slots.
+ *
+ * Destroyed slots are kept in a free list and reused by the next Create(),
+ * so a burst of n objects costs about n / ChunkSize allocations instead of n.
+ * Memory is only returned when the pool is destroyed, all objects must have
+ * been destroyed before.
+ */
+template <class T, size_t ChunkSize = 256>
+class ObjectPool
+{
+public:
+	ObjectPool()
+	    : m_free(NULL)
+	    , m_live(0)
+	{
+	}
+	~ObjectPool()
+	{
+		assert(m_live == 0);
+		for (size_t i = 0; i < m_chunks.size(); i++) {
+			delete[] m_chunks[i];
+		}
+	}
+
+	template <class... Args>
+	T* Create(Args&&... args)
+	{
+		if (m_free == NULL)
+			AddChunk();
+		Slot* slot = m_free;
+		m_free = slot->next; // the object overwrites the link
+		T* obj;
+		try {
+			obj = new (slot->storage) T(std::forward<Args>(args)...);
+		} catch (...) {
+			slot->next = m_free;
+			m_free = slot;
+			throw;
+		}
+		m_live++;
+		return obj;
+	}
+
+	//! destroys @p obj which must have been created by this pool
+	void Destroy(T* obj)
+	{
+		if (obj == NULL)
+			return;
+		obj->~T();
+		Slot* slot = reinterpret_cast<Slot*>(obj);
+		slot->next = m_free;
+		m_free = slot;
+		m_live--;
+	}
+
+	//! number of objects which were created and not destroyed
+	size_t GetLiveCount() const
+	{
+		return m_live;
+	}
+	//! number of chunk allocations made so far
+	size_t GetChunkCount() const
+	{
+		return m_chunks.size();
+	}
+
+private:
+	ObjectPool(const ObjectPool&);
+	ObjectPool& operator=(const ObjectPool&);
+
+	union Slot
+	{
+		Slot* next;
+		typename std::aligned_storage<sizeof(T), alignof(T)>::type storage[1];
+	};
+
+	void AddChunk()
+	{
+		Slot* chunk = new Slot[ChunkSize];
+		m_chunks.push_back(chunk);
+		for (size_t i = ChunkSize; i > 0; i--) { // hand out the slots in address order
+			chunk[i - 1].next = m_free;
+			m_free = &chunk[i - 1];
+		}
+	}
+
+	std::vector<Slot*> m_chunks;
+	Slot* m_free;
+	size_t m_live;
+};
+
+#endif // SPRINGLOBBY_OBJECTPOOL_H_INCLUDED
@@ -12,6 +12,7 @@
 #include <lslutils/misc.h>
 
 #include "conversion.h"
+#include "childprocess.h"
 #include "gui/customdialogs.h"
 
 bool SafeMkdir(const wxString& dir)
@@ -183,11 +184,24 @@ int RunProcess(const wxString& cmd, const wxArrayString& params, const bool asyn
 	GetExitCodeProcess(ShExecInfo.hProcess, &exitCode);
 	return exitCode;
 #else
-	wxString realcmd = escapeStr(cmd);
-	if (!paramstring.empty()) {
-		realcmd += _T(" ") + paramstring;
-	}
-	return system(realcmd.mb_str(wxConvUTF8));
+	std::vector<std::string> args;
+	for (const wxString& param : params) {
+		args.push_back(STD_STRING(param));
+	}
+	ChildProcess proc;
+	std::string error;
+	if (!proc.Start(STD_STRING(cmd), args, error)) {
+		wxLogError(_T("Couldn't run %s: %s"), cmd.c_str(), TowxString(error).c_str());
+		return -1;
+	}
+	const ChildProcess::ExitStatus status = proc.Wait([](ChildProcess::Stream /*stream*/, const std::string& line) {
+		wxLogDebug(_T("%s"), TowxString(line).c_str());
+	});
+	if (status.signaled) {
+		wxLogWarning(_T("%s was killed by signal %d"), cmd.c_str(), status.signal);
+		return -1;
+	}
+	return status.code;
 #endif
 }
 
@@ -0,0 +1,104 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#ifndef SPRINGLOBBY_RINGBUFFER_H_INCLUDED
+#define SPRINGLOBBY_RINGBUFFER_H_INCLUDED
+
+#include <cstddef>
+#include <vector>
+
+/** @brief Keeps the last GetCapacity() elements pushed.
+ *
+ * Pushing to a full buffer replaces the oldest element, index 0 is always
+ * the oldest element. Push and access are O(1).
+ */
+template <class T>
+class RingBuffer
+{
+public:
+	explicit RingBuffer(size_t capacity = 0)
+	    : m_capacity(capacity)
+	    , m_start(0)
+	    , m_size(0)
+	{
+	}
+
+	size_t GetCapacity() const
+	{
+		return m_capacity;
+	}
+	//! keeps the newest elements which fit into @p capacity
+	void SetCapacity(size_t capacity)
+	{
+		std::vector<T> items;
+		const size_t keep = (m_size < capacity) ? m_size : capacity;
+		items.reserve(keep);
+		for (size_t i = m_size - keep; i < m_size; i++) {
+			items.push_back((*this)[i]);
+		}
+		m_items.swap(items);
+		m_capacity = capacity;
+		m_start = 0;
+		m_size = keep;
+	}
+
+	size_t size() const
+	{
+		return m_size;
+	}
+	bool empty() const
+	{
+		return m_size == 0;
+	}
+	bool full() const
+	{
+		return m_size == m_capacity;
+	}
+
+	//! @return false if @p item replaced the oldest element (or the capacity is 0)
+	bool push_back(const T& item)
+	{
+		if (m_capacity == 0)
+			return false;
+		if (m_items.size() < m_capacity) { // storage is allocated on demand
+			m_items.push_back(item);
+			m_size++;
+			return true;
+		}
+		if (m_size < m_capacity) {
+			m_items[(m_start + m_size) % m_capacity] = item;
+			m_size++;
+			return true;
+		}
+		m_items[m_start] = item;
+		m_start = (m_start + 1) % m_capacity;
+		return false;
+	}
+
+	T& operator[](size_t index)
+	{
+		return m_items[(m_start + index) % m_capacity];
+	}
+	const T& operator[](size_t index) const
+	{
+		return m_items[(m_start + index) % m_capacity];
+	}
+	T& back()
+	{
+		return (*this)[m_size - 1];
+	}
+
+	void clear()
+	{
+		m_items.clear();
+		m_start = 0;
+		m_size = 0;
+	}
+
+private:
+	std::vector<T> m_items;
+	size_t m_capacity;
+	size_t m_start; //!< index of the oldest element in m_items
+	size_t m_size;
+};
+
+#endif // SPRINGLOBBY_RINGBUFFER_H_INCLUDED
@@ -0,0 +1,51 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#include "savegamereader.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace SavegameReader
+{
+
+//! scripts are sections of key=value pairs, the first thing in one is a [section] header
+static bool LooksLikeScript(const std::string& script)
+{
+	for (size_t i = 0; i < script.size(); i++) {
+		if (!isspace(static_cast<unsigned char>(script[i])))
+			return script[i] == '[';
+	}
+	return false;
+}
+
+bool ReadScript(const std::string& path, std::string& script, size_t maxSize)
+{
+	script.clear();
+	std::ifstream file(path.c_str(), std::ios::in | std::ios::binary);
+	if (!file.is_open())
+		return false;
+
+	std::vector<char> block(BlockSize);
+	while (script.size() < maxSize) {
+		const size_t want = std::min(BlockSize, maxSize - script.size());
+		file.read(&block[0], want);
+		const size_t got = static_cast<size_t>(file.gcount());
+		const char* end = static_cast<const char*>(memchr(&block[0], 0, got));
+		if (end != NULL) {
+			script.append(&block[0], end - &block[0]);
+			if (LooksLikeScript(script))
+				return true;
+			break;
+		}
+		script.append(&block[0], got);
+		if (got < want) // end of file before the terminator
+			break;
+	}
+	script.clear();
+	return false;
+}
+
+} // namespace SavegameReader
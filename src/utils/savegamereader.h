@@ -0,0 +1,30 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#ifndef SPRINGLOBBY_SAVEGAMEREADER_H_INCLUDED
+#define SPRINGLOBBY_SAVEGAMEREADER_H_INCLUDED
+
+#include <cstddef>
+#include <string>
+
+namespace SavegameReader
+{
+
+//! scripts are a few kilobytes, anything without a terminator within this is treated as corrupt
+static const size_t MaxScriptSize = 4 * 1024 * 1024;
+static const size_t BlockSize = 64 * 1024;
+
+/** @brief Reads the start script stored at the beginning of a spring savegame.
+ *
+ * The script is a null terminated string in front of the binary game state.
+ * It is read in blocks of BlockSize and at most @p maxSize bytes are looked at,
+ * so corrupt files cost at most a few reads.
+ *
+ * @return false if the file can't be read, the script is empty, isn't
+ * terminated within @p maxSize or the file ends before the terminator
+ * (truncated), or it doesn't look like a script.
+ */
+bool ReadScript(const std::string& path, std::string& script, size_t maxSize = MaxScriptSize);
+
+} // namespace SavegameReader
+
+#endif // SPRINGLOBBY_SAVEGAMEREADER_H_INCLUDED
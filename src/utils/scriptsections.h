@@ -0,0 +1,71 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#ifndef SPRINGLOBBY_SCRIPTSECTIONS_H_INCLUDED
+#define SPRINGLOBBY_SCRIPTSECTIONS_H_INCLUDED
+
+#include <string>
+#include <vector>
+
+/** @brief The parts of a start script which are kept between launches.
+ *
+ * Each section holds the text written for it, which is copied into the
+ * script as is. A section is rebuilt only after it was invalidated, the owner
+ * invalidates the sections affected by an event (see IBattle::InvalidateScript).
+ */
+class ScriptSectionCache
+{
+public:
+	enum Section {
+		SECTION_OPTIONS = 0, //!< map and mod options
+		SECTION_RESTRICTIONS,
+		SECTION_PLAYERS, //!< players and AIs
+		SECTION_TEAMS,
+		SECTION_ALLYTEAMS,
+		SECTION_COUNT
+	};
+
+	static unsigned int Mask(Section section)
+	{
+		return 1u << section;
+	}
+	//! sections which depend on the users in the battle and their status
+	static unsigned int RosterMask()
+	{
+		return Mask(SECTION_PLAYERS) | Mask(SECTION_TEAMS) | Mask(SECTION_ALLYTEAMS);
+	}
+	static unsigned int AllMask()
+	{
+		return (1u << SECTION_COUNT) - 1;
+	}
+
+	ScriptSectionCache()
+	    : m_sections(SECTION_COUNT)
+	    , m_valid(0)
+	{
+	}
+
+	void Invalidate(unsigned int mask)
+	{
+		m_valid &= ~mask;
+	}
+	bool IsValid(Section section) const
+	{
+		return (m_valid & Mask(section)) != 0;
+	}
+	//! stores the text of @p section, it counts as valid afterwards
+	void Set(Section section, const std::string& text)
+	{
+		m_sections[section] = text;
+		m_valid |= Mask(section);
+	}
+	const std::string& Get(Section section) const
+	{
+		return m_sections[section];
+	}
+
+private:
+	std::vector<std::string> m_sections;
+	unsigned int m_valid;
+};
+
+#endif // SPRINGLOBBY_SCRIPTSECTIONS_H_INCLUDED
@@ -0,0 +1,39 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#include "scripttagsync.h"
+
+void ScriptTagSync::Set(const std::string& key, const std::string& value)
+{
+	const std::map<std::string, std::string>::const_iterator it = m_sent.find(key);
+	if (it != m_sent.end() && it->second == value) {
+		// changed back before it was sent
+		m_pending.erase(key);
+		return;
+	}
+	m_pending[key] = value;
+}
+
+std::vector<std::string> ScriptTagSync::TakePending(size_t maxlen)
+{
+	std::vector<std::string> res;
+	std::string cmd;
+	for (const auto& tag : m_pending) {
+		const std::string entry = tag.first + "=" + tag.second + "\t";
+		if (!cmd.empty() && cmd.size() + entry.size() > maxlen) {
+			res.push_back(cmd);
+			cmd.clear();
+		}
+		cmd += entry;
+		m_sent[tag.first] = tag.second;
+	}
+	if (!cmd.empty())
+		res.push_back(cmd);
+	m_pending.clear();
+	return res;
+}
+
+void ScriptTagSync::Reset()
+{
+	m_sent.clear();
+	m_pending.clear();
+}
@@ -0,0 +1,42 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#ifndef SPRINGLOBBY_SCRIPTTAGSYNC_H_INCLUDED
+#define SPRINGLOBBY_SCRIPTTAGSYNC_H_INCLUDED
+
+#include <map>
+#include <string>
+#include <vector>
+
+/** @brief Script tags of a hosted battle, as sent to the server.
+ *
+ * Tags are collected with Set() and only those whose value differs from the
+ * value sent last are returned by TakePending(), so a tag which changed
+ * several times in between is sent once with its latest value.
+ */
+class ScriptTagSync
+{
+public:
+	//! marks @p key as changed, unless it was sent with @p value already
+	void Set(const std::string& key, const std::string& value);
+	bool HasPending() const
+	{
+		return !m_pending.empty();
+	}
+
+	/** @brief Returns the changed tags as SETSCRIPTTAGS parameters.
+	 *
+	 * Each entry is "key=value\t", an entry is never split and each string
+	 * is at most @p maxlen long unless a single entry is longer.
+	 * The tags count as sent afterwards.
+	 */
+	std::vector<std::string> TakePending(size_t maxlen);
+
+	//! forgets all values, the next battle starts without any tags
+	void Reset();
+
+private:
+	std::map<std::string, std::string> m_sent;
+	std::map<std::string, std::string> m_pending;
+};
+
+#endif // SPRINGLOBBY_SCRIPTTAGSYNC_H_INCLUDED
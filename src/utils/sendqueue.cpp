@@ -0,0 +1,74 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#include "sendqueue.h"
+
+#include <algorithm>
+
+SendQueue::SendQueue()
+    : m_queued(0)
+    , m_rate(-1)
+    , m_burst(0)
+    , m_tokens(0)
+{
+}
+
+void SendQueue::SetRate(int rate, int burst)
+{
+	m_rate = rate;
+	m_burst = (burst > 0) ? burst : rate;
+	// start with a full bucket, the server didn't get anything from us yet
+	m_tokens = std::max(m_burst, 0);
+}
+
+void SendQueue::Push(const std::string& data, Priority priority)
+{
+	if (data.empty())
+		return;
+	m_queues[priority].push_back(data);
+	m_queued += data.length();
+}
+
+void SendQueue::Refill(int mselapsed)
+{
+	if (m_rate <= 0 || mselapsed <= 0)
+		return;
+	m_tokens = std::min<double>(m_burst, m_tokens + (mselapsed / 1000.0) * m_rate);
+}
+
+bool SendQueue::CanTake(size_t len) const
+{
+	if (m_rate <= 0)
+		return true;
+	// a command bigger than the bucket is sent when the bucket is full,
+	// the debt is paid off by the following refills
+	return (len <= m_tokens) || (m_tokens >= m_burst);
+}
+
+size_t SendQueue::Take(std::string& out)
+{
+	size_t taken = 0;
+	for (int prio = 0; prio < PRIORITY_COUNT; prio++) {
+		std::deque<std::string>& queue = m_queues[prio];
+		while (!queue.empty()) {
+			const std::string& data = queue.front();
+			// don't let bulk commands overtake an interactive one which has to wait
+			if (!CanTake(data.length()))
+				return taken;
+			out += data;
+			taken += data.length();
+			m_queued -= data.length();
+			if (m_rate > 0)
+				m_tokens -= data.length();
+			queue.pop_front();
+		}
+	}
+	return taken;
+}
+
+void SendQueue::Clear()
+{
+	for (int prio = 0; prio < PRIORITY_COUNT; prio++) {
+		m_queues[prio].clear();
+	}
+	m_queued = 0;
+}
@@ -0,0 +1,66 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#ifndef SPRINGLOBBY_SENDQUEUE_H_INCLUDED
+#define SPRINGLOBBY_SENDQUEUE_H_INCLUDED
+
+#include <cstddef>
+#include <deque>
+#include <string>
+
+/** @brief Outgoing commands, released at a limited rate (token bucket).
+ *
+ * The bucket holds up to burst bytes and is refilled with rate bytes per
+ * second. Commands are only released as a whole and interactive ones are
+ * released before bulk ones. Everything released at once is appended to one
+ * buffer, so it can be written with a single call.
+ */
+class SendQueue
+{
+public:
+	enum Priority {
+		PRIORITY_INTERACTIVE = 0, //!< pings and chat, which the user waits for
+		PRIORITY_BULK,
+		PRIORITY_COUNT
+	};
+
+	SendQueue();
+
+	/** @brief Sets the limit to @p rate bytes per second.
+	 * @p burst is the size of the bucket, the rate is used if it's 0 or less.
+	 * A rate of 0 or less disables the limit.
+	 */
+	void SetRate(int rate, int burst = 0);
+	int GetRate() const
+	{
+		return m_rate;
+	}
+
+	void Push(const std::string& data, Priority priority);
+	//! adds the tokens for @p mselapsed milliseconds
+	void Refill(int mselapsed);
+	/** @brief Appends the commands which can be sent now to @p out.
+	 * @return the number of bytes appended
+	 */
+	size_t Take(std::string& out);
+
+	bool IsEmpty() const
+	{
+		return m_queued == 0;
+	}
+	size_t GetQueuedBytes() const
+	{
+		return m_queued;
+	}
+	void Clear();
+
+private:
+	bool CanTake(size_t len) const;
+
+	std::deque<std::string> m_queues[PRIORITY_COUNT];
+	size_t m_queued;
+	int m_rate;
+	int m_burst;
+	double m_tokens;
+};
+
+#endif // SPRINGLOBBY_SENDQUEUE_H_INCLUDED
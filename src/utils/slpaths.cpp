@@ -17,6 +17,8 @@
 
 #include "platform.h"
 #include "conversion.h"
+#include "globalevents.h"
+#include "enginecache.h"
 #include "utils/version.h"
 #include "log.h"
 
@@ -134,6 +136,12 @@ void SlPaths::EngineSubPaths(const LSL::StringVector& basedirs, LSL::StringVecto
 }
 
 void SlPaths::RefreshSpringVersionList(bool autosearch, const LSL::SpringBundle* additionalbundle)
+{
+	slLogDebugFunc("");
+	SetSpringVersionList(DiscoverSpringVersions(GetSpringCandidates(autosearch, additionalbundle), GetEngineCacheFile()));
+}
+
+std::list<LSL::SpringBundle> SlPaths::GetSpringCandidates(bool autosearch, const LSL::SpringBundle* additionalbundle)
 {
 	/*
 	FIXME: move to LSL's GetSpringVersionList() which does:
@@ -146,7 +154,6 @@ void SlPaths::RefreshSpringVersionList(bool autosearch, const LSL::SpringBundle*
 	needs to change to sth like: GetSpringVersionList(std::list<LSL::Bundle>)
 
 	*/
-	slLogDebugFunc("");
 	std::list<LSL::SpringBundle> usync_paths;
 
 	if (additionalbundle != NULL) {
@@ -189,25 +196,79 @@ void SlPaths::RefreshSpringVersionList(bool autosearch, const LSL::SpringBundle*
 		bundle.version = configsection;
 		usync_paths.push_back(bundle);
 	}
+	return usync_paths;
+}
 
-	cfg().DeleteGroup(_T("/Spring/Paths"));
+std::string SlPaths::GetEngineCacheFile()
+{
+	const std::string cachedir = GetCachePath();
+	if (cachedir.empty())
+		return "";
+	return cachedir + "engines.txt";
+}
 
-	m_spring_versions.clear();
+static EngineCache::Engine ToEngine(const LSL::SpringBundle& bundle)
+{
+	EngineCache::Engine engine;
+	engine.version = bundle.version;
+	engine.path = bundle.path;
+	engine.unitsync = bundle.unitsync;
+	engine.spring = bundle.spring;
+	return engine;
+}
+
+SlPaths::SpringVersionMap SlPaths::DiscoverSpringVersions(const std::list<LSL::SpringBundle>& candidates, const std::string& cachefile)
+{
+	SpringVersionMap versions;
+	EngineCache::EngineList engines;
+	for (const LSL::SpringBundle& bundle : candidates) {
+		engines.push_back(ToEngine(bundle));
+	}
+	const std::string signature = EngineCache::Signature(engines);
+	if (EngineCache::Load(cachefile, signature, engines)) {
+		for (const EngineCache::Engine& engine : engines) {
+			LSL::SpringBundle& bundle = versions[engine.version];
+			bundle.version = engine.version;
+			bundle.path = engine.path;
+			bundle.unitsync = engine.unitsync;
+			bundle.spring = engine.spring;
+		}
+		return versions;
+	}
 	try {
-		const auto versions = LSL::SpringBundle::GetSpringVersionList(usync_paths);
-		for (const auto pair : versions) {
-			const LSL::SpringBundle& bundle = pair.second;
-			const std::string version = bundle.version;
-			m_spring_versions[version] = bundle;
-			SetSpringBinary(version, bundle.spring);
-			SetUnitSync(version, bundle.unitsync);
-			SetBundle(version, bundle.path);
+		const auto found = LSL::SpringBundle::GetSpringVersionList(candidates);
+		for (const auto pair : found) {
+			versions[pair.second.version] = pair.second;
 		}
 	} catch (const std::runtime_error& e) {
 		wxLogError(wxString::Format(_T("Couldn't get list of spring versions: %s"), e.what()));
+		return versions;
 	} catch (...) {
-		wxLogError(_T("Unknown Execption caught in SlPaths::RefreshSpringVersionList"));
+		wxLogError(_T("Unknown Execption caught in SlPaths::DiscoverSpringVersions"));
+		return versions;
+	}
+	engines.clear();
+	for (const auto pair : versions) {
+		engines.push_back(ToEngine(pair.second));
+	}
+	EngineCache::Save(cachefile, signature, engines);
+	return versions;
+}
+
+void SlPaths::SetSpringVersionList(const SpringVersionMap& versions)
+{
+	cfg().DeleteGroup(_T("/Spring/Paths"));
+
+	m_spring_versions.clear();
+	for (const auto pair : versions) {
+		const LSL::SpringBundle& bundle = pair.second;
+		const std::string version = bundle.version;
+		m_spring_versions[version] = bundle;
+		SetSpringBinary(version, bundle.spring);
+		SetUnitSync(version, bundle.unitsync);
+		SetBundle(version, bundle.path);
 	}
+	GlobalEvent::Send(GlobalEvent::OnSpringVersionsChanged);
 }
 
 std::string SlPaths::GetCurrentUsedSpringIndex()
@@ -398,12 +459,9 @@ bool VersionSyncCompatible(const std::string& ver1, const std::string& ver2)
 
 std::string SlPaths::GetCompatibleVersion(const std::string& neededversion)
 {
-	const auto versionlist = SlPaths::GetSpringVersionList();
-	for (const auto pair : versionlist) {
-		const std::string ver = pair.first;
-		const LSL::SpringBundle bundle = pair.second;
-		if (VersionSyncCompatible(neededversion, ver)) {
-			return ver;
+	for (const auto& pair : m_spring_versions) {
+		if (VersionSyncCompatible(neededversion, pair.first)) {
+			return pair.first;
 		}
 	}
 	return "";
@@ -3,6 +3,7 @@
 #ifndef SPRINGLOBBY_SLPATHS_H
 #define SPRINGLOBBY_SLPATHS_H
 
+#include <list>
 #include <map>
 #include <vector>
 #include <cstddef>
@@ -35,9 +36,23 @@ public:
 	 * @{
 	 */
 
+	typedef std::map<std::string, LSL::SpringBundle> SpringVersionMap;
+
+	//! same as SetSpringVersionList(DiscoverSpringVersions(GetSpringCandidates(...), GetEngineCacheFile()))
 	static void RefreshSpringVersionList(bool autosearch = true, const LSL::SpringBundle* additionalbundle = NULL);
 	static std::map<std::string, LSL::SpringBundle> GetSpringVersionList(); /// index -> version
 
+	//! places which may contain an engine, reads the config so it has to run on the main thread
+	static std::list<LSL::SpringBundle> GetSpringCandidates(bool autosearch = true, const LSL::SpringBundle* additionalbundle = NULL);
+	/** finds the engines among @p candidates. This doesn't touch the config and may run on any thread.
+	 * The result is cached in @p cachefile and reused as long as the candidates and the modification
+	 * times of their directories and files don't change, so warm starts don't have to probe every engine.
+	 */
+	static SpringVersionMap DiscoverSpringVersions(const std::list<LSL::SpringBundle>& candidates, const std::string& cachefile);
+	//! makes @p versions the known engines and stores their paths in the config
+	static void SetSpringVersionList(const SpringVersionMap& versions);
+	static std::string GetEngineCacheFile();
+
 	static std::string GetCurrentUsedSpringIndex();
 	static void SetUsedSpringIndex(const std::string& index);
 
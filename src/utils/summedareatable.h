@@ -0,0 +1,53 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#ifndef SPRINGLOBBY_SUMMEDAREATABLE_H_INCLUDED
+#define SPRINGLOBBY_SUMMEDAREATABLE_H_INCLUDED
+
+#include <cstddef>
+#include <stdint.h>
+#include <vector>
+
+/** @brief 2d prefix sums over an image, giving the sum of any rectangle in O(1).
+ *
+ * The table has a zero row and column in front, so entry (x, y) holds the sum
+ * of all pixels left of x and above y and queries need no bounds special cases.
+ * 64bit entries can't overflow for any realistic image size.
+ */
+class SummedAreaTable
+{
+public:
+	SummedAreaTable();
+
+	//! builds the table from interleaved 8bit pixels, summing all @p channels of a pixel
+	void Build(const unsigned char* data, int width, int height, int channels = 3);
+	void Clear();
+
+	bool IsOk() const
+	{
+		return !m_table.empty();
+	}
+	int GetWidth() const
+	{
+		return m_width;
+	}
+	int GetHeight() const
+	{
+		return m_height;
+	}
+
+	//! sum of the pixels in [x1, x2) x [y1, y2), coordinates are clamped to the image
+	uint64_t Sum(int x1, int y1, int x2, int y2) const;
+	uint64_t Total() const;
+
+private:
+	uint64_t At(int x, int y) const
+	{
+		return m_table[(size_t)y * (m_width + 1) + x];
+	}
+
+	int m_width;
+	int m_height;
+	std::vector<uint64_t> m_table;
+};
+
+#endif // SPRINGLOBBY_SUMMEDAREATABLE_H_INCLUDED
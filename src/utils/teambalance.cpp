@@ -0,0 +1,354 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#include "teambalance.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+static const double RankEpsilon = 1e-9;
+
+namespace
+{
+
+//! one partial solution of the differencing method: a set of groups
+struct Partition
+{
+	std::vector<double> rank;
+	std::vector<int> size;
+	std::vector<std::vector<size_t> > members;
+
+	explicit Partition(size_t numgroups)
+	    : rank(numgroups, 0.0)
+	    , size(numgroups, 0)
+	    , members(numgroups)
+	{
+	}
+
+	int SizeSpread() const
+	{
+		return *std::max_element(size.begin(), size.end()) - *std::min_element(size.begin(), size.end());
+	}
+	double RankSpread() const
+	{
+		return *std::max_element(rank.begin(), rank.end()) - *std::min_element(rank.begin(), rank.end());
+	}
+	bool operator<(const Partition& other) const
+	{
+		if (SizeSpread() != other.SizeSpread())
+			return SizeSpread() < other.SizeSpread();
+		return RankSpread() < other.RankSpread();
+	}
+};
+
+struct GroupOrder
+{
+	const Partition& p;
+	bool ascending;
+	GroupOrder(const Partition& p_, bool ascending_)
+	    : p(p_)
+	    , ascending(ascending_)
+	{
+	}
+	bool operator()(size_t a, size_t b) const
+	{
+		if (p.size[a] != p.size[b])
+			return ascending ? p.size[a] < p.size[b] : p.size[a] > p.size[b];
+		if (p.rank[a] != p.rank[b])
+			return ascending ? p.rank[a] < p.rank[b] : p.rank[a] > p.rank[b];
+		return a < b;
+	}
+};
+
+//! combines two partitions, pairing the largest groups of one with the smallest of the other
+Partition Combine(const Partition& a, const Partition& b)
+{
+	const size_t k = a.rank.size();
+	std::vector<size_t> orderA(k), orderB(k);
+	for (size_t i = 0; i < k; i++) {
+		orderA[i] = i;
+		orderB[i] = i;
+	}
+	std::sort(orderA.begin(), orderA.end(), GroupOrder(a, true));
+	std::sort(orderB.begin(), orderB.end(), GroupOrder(b, false));
+
+	Partition res(k);
+	for (size_t i = 0; i < k; i++) {
+		const size_t ga = orderA[i];
+		const size_t gb = orderB[i];
+		res.rank[i] = a.rank[ga] + b.rank[gb];
+		res.size[i] = a.size[ga] + b.size[gb];
+		res.members[i] = a.members[ga];
+		res.members[i].insert(res.members[i].end(), b.members[gb].begin(), b.members[gb].end());
+	}
+	return res;
+}
+
+} // namespace
+
+TeamBalancer::TeamBalancer(size_t numgroups, unsigned int seed)
+    : m_numgroups(std::max<size_t>(numgroups, 1))
+    , m_seed(seed)
+    , m_totalRank(0)
+    , m_totalSize(0)
+    , m_nodes(0)
+    , m_bestRankSpread(0)
+    , m_bestSizeSpread(0)
+    , m_optimal(false)
+{
+}
+
+size_t TeamBalancer::AddUnit(double rank, int size)
+{
+	Unit unit;
+	unit.rank = rank;
+	unit.size = size;
+	unit.index = m_units.size();
+	unit.tiebreak = 0;
+	m_units.push_back(unit);
+	return unit.index;
+}
+
+bool TeamBalancer::UnitOrder(const Unit& a, const Unit& b)
+{
+	if (a.size != b.size)
+		return a.size > b.size;
+	if (a.rank != b.rank)
+		return a.rank > b.rank;
+	return a.tiebreak < b.tiebreak;
+}
+
+std::vector<size_t> TeamBalancer::Balance()
+{
+	std::vector<size_t> result(m_units.size(), 0);
+	m_best.clear();
+	m_bestRankSpread = 0;
+	m_bestSizeSpread = 0;
+	m_optimal = true;
+	if (m_units.empty())
+		return result;
+
+	// std::mt19937 produces the same sequence everywhere, unlike rand()
+	std::mt19937 rng(m_seed);
+	for (size_t i = 0; i < m_units.size(); i++) {
+		m_units[i].tiebreak = rng();
+	}
+	std::sort(m_units.begin(), m_units.end(), UnitOrder);
+
+	const size_t n = m_units.size();
+	m_totalRank = 0;
+	m_totalSize = 0;
+	m_remainingRank.assign(n + 1, 0.0);
+	m_remainingSize.assign(n + 1, 0);
+	for (size_t i = n; i-- > 0;) {
+		m_remainingRank[i] = m_remainingRank[i + 1] + m_units[i].rank;
+		m_remainingSize[i] = m_remainingSize[i + 1] + m_units[i].size;
+	}
+	m_totalRank = m_remainingRank[0];
+	m_totalSize = m_remainingSize[0];
+
+	Heuristic();
+
+	if (n <= MaxExactUnits) {
+		m_current.assign(n, 0);
+		m_groupRank.assign(m_numgroups, 0.0);
+		m_groupSize.assign(m_numgroups, 0);
+		m_nodes = 0;
+		Search(0);
+		m_optimal = IsPerfect() || m_nodes < MaxSearchNodes;
+	} else {
+		m_optimal = IsPerfect();
+	}
+
+	for (size_t i = 0; i < n; i++) {
+		result[m_units[i].index] = m_best[i];
+	}
+	// restore the order of AddUnit
+	std::vector<Unit> units(n);
+	for (size_t i = 0; i < n; i++) {
+		units[m_units[i].index] = m_units[i];
+	}
+	m_units.swap(units);
+	return result;
+}
+
+//! balanced largest differencing method, followed by a local search
+void TeamBalancer::Heuristic()
+{
+	const size_t k = m_numgroups;
+	std::vector<Partition> parts;
+
+	// single players are taken in chunks of k, so every group gets one from each chunk
+	size_t i = 0;
+	for (; i < m_units.size() && m_units[i].size > 1; i++) {
+		Partition p(k);
+		p.rank[0] = m_units[i].rank;
+		p.size[0] = m_units[i].size;
+		p.members[0].push_back(i);
+		parts.push_back(p);
+	}
+	while (i < m_units.size()) {
+		Partition p(k);
+		for (size_t g = 0; g < k && i < m_units.size(); g++, i++) {
+			p.rank[g] = m_units[i].rank;
+			p.size[g] = m_units[i].size;
+			p.members[g].push_back(i);
+		}
+		parts.push_back(p);
+	}
+
+	// repeatedly combine the two partitions with the largest differences
+	while (parts.size() > 1) {
+		std::sort(parts.begin(), parts.end());
+		Partition combined = Combine(parts[parts.size() - 1], parts[parts.size() - 2]);
+		parts.pop_back();
+		parts.back() = combined;
+	}
+
+	std::vector<size_t> assignment(m_units.size(), 0);
+	for (size_t g = 0; g < k; g++) {
+		for (size_t j = 0; j < parts[0].members[g].size(); j++) {
+			assignment[parts[0].members[g][j]] = g;
+		}
+	}
+	LocalSearch(assignment);
+	Store(assignment);
+}
+
+//! moves and swaps single units while that improves the result
+void TeamBalancer::LocalSearch(std::vector<size_t>& assignment)
+{
+	int sizeSpread;
+	double rankSpread;
+	Evaluate(assignment, sizeSpread, rankSpread);
+
+	const size_t n = assignment.size();
+	for (int pass = 0; pass < 100; pass++) {
+		bool improved = false;
+		for (size_t a = 0; a < n; a++) {
+			for (size_t g = 0; g < m_numgroups; g++) {
+				if (g == assignment[a])
+					continue;
+				const size_t old = assignment[a];
+				assignment[a] = g;
+				int s;
+				double r;
+				Evaluate(assignment, s, r);
+				if (s < sizeSpread || (s == sizeSpread && r < rankSpread - RankEpsilon)) {
+					sizeSpread = s;
+					rankSpread = r;
+					improved = true;
+				} else {
+					assignment[a] = old;
+				}
+			}
+			for (size_t b = a + 1; b < n; b++) {
+				if (assignment[a] == assignment[b])
+					continue;
+				std::swap(assignment[a], assignment[b]);
+				int s;
+				double r;
+				Evaluate(assignment, s, r);
+				if (s < sizeSpread || (s == sizeSpread && r < rankSpread - RankEpsilon)) {
+					sizeSpread = s;
+					rankSpread = r;
+					improved = true;
+				} else {
+					std::swap(assignment[a], assignment[b]);
+				}
+			}
+		}
+		if (!improved)
+			break;
+	}
+}
+
+//! branch and bound over all assignments, groups in equal state are only tried once
+void TeamBalancer::Search(size_t pos)
+{
+	if (m_nodes >= MaxSearchNodes || IsPerfect())
+		return;
+	m_nodes++;
+
+	const int minSize = *std::min_element(m_groupSize.begin(), m_groupSize.end());
+	const int maxSize = *std::max_element(m_groupSize.begin(), m_groupSize.end());
+	const double minRank = *std::min_element(m_groupRank.begin(), m_groupRank.end());
+	const double maxRank = *std::max_element(m_groupRank.begin(), m_groupRank.end());
+
+	if (pos == m_units.size()) {
+		if (IsBetter(maxSize - minSize, maxRank - minRank)) {
+			Store(m_current);
+		}
+		return;
+	}
+
+	// the final minimum can't be above the average and the final maximum can't be below it
+	const int k = m_numgroups;
+	const int sizeBound = std::max(std::max(0, maxSize - m_totalSize / k), (m_totalSize + k - 1) / k - (minSize + m_remainingSize[pos]));
+	const double avgRank = m_totalRank / k;
+	const double rankBound = std::max(std::max(0.0, maxRank - avgRank), avgRank - (minRank + m_remainingRank[pos]));
+	if (sizeBound > m_bestSizeSpread || (sizeBound == m_bestSizeSpread && rankBound >= m_bestRankSpread - RankEpsilon))
+		return;
+
+	// try the weakest groups first, that finds good solutions early
+	std::vector<size_t> order(m_numgroups);
+	for (size_t g = 0; g < m_numgroups; g++) {
+		order[g] = g;
+	}
+	for (size_t a = 1; a < order.size(); a++) {
+		for (size_t b = a; b > 0; b--) {
+			const size_t x = order[b - 1], y = order[b];
+			if (m_groupSize[x] < m_groupSize[y] || (m_groupSize[x] == m_groupSize[y] && m_groupRank[x] <= m_groupRank[y]))
+				break;
+			std::swap(order[b - 1], order[b]);
+		}
+	}
+
+	const Unit& unit = m_units[pos];
+	for (size_t i = 0; i < order.size(); i++) {
+		const size_t g = order[i];
+		if (i > 0) {
+			const size_t prev = order[i - 1];
+			if (m_groupSize[prev] == m_groupSize[g] && std::fabs(m_groupRank[prev] - m_groupRank[g]) < RankEpsilon)
+				continue;
+		}
+		m_current[pos] = g;
+		m_groupSize[g] += unit.size;
+		m_groupRank[g] += unit.rank;
+		Search(pos + 1);
+		m_groupSize[g] -= unit.size;
+		m_groupRank[g] -= unit.rank;
+	}
+}
+
+void TeamBalancer::Evaluate(const std::vector<size_t>& assignment, int& sizeSpread, double& rankSpread) const
+{
+	std::vector<int> size(m_numgroups, 0);
+	std::vector<double> rank(m_numgroups, 0.0);
+	for (size_t i = 0; i < assignment.size(); i++) {
+		size[assignment[i]] += m_units[i].size;
+		rank[assignment[i]] += m_units[i].rank;
+	}
+	sizeSpread = *std::max_element(size.begin(), size.end()) - *std::min_element(size.begin(), size.end());
+	rankSpread = *std::max_element(rank.begin(), rank.end()) - *std::min_element(rank.begin(), rank.end());
+}
+
+bool TeamBalancer::IsBetter(int sizeSpread, double rankSpread) const
+{
+	if (m_best.empty())
+		return true;
+	return sizeSpread < m_bestSizeSpread || (sizeSpread == m_bestSizeSpread && rankSpread < m_bestRankSpread - RankEpsilon);
+}
+
+//! no split can be better than the current best one
+bool TeamBalancer::IsPerfect() const
+{
+	const int minSizeSpread = (m_totalSize % m_numgroups == 0) ? 0 : 1;
+	return !m_best.empty() && m_bestSizeSpread <= minSizeSpread && m_bestRankSpread < RankEpsilon;
+}
+
+void TeamBalancer::Store(const std::vector<size_t>& assignment)
+{
+	m_best = assignment;
+	Evaluate(m_best, m_bestSizeSpread, m_bestRankSpread);
+}
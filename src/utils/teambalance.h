@@ -0,0 +1,90 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#ifndef SPRINGLOBBY_TEAMBALANCE_H_INCLUDED
+#define SPRINGLOBBY_TEAMBALANCE_H_INCLUDED
+
+#include <cstddef>
+#include <vector>
+
+/** @brief Splits units (single players or clans/shared teams which have to stay
+ * together) into a fixed number of groups.
+ *
+ * The result first minimises the difference in the number of players per group,
+ * then the difference between the highest and lowest rank sum.
+ * Up to MaxExactUnits units are placed by an exhaustive branch and bound search,
+ * larger inputs use the balanced largest differencing method (Karmarkar-Karp)
+ * followed by a local search. Both are bounded, so Balance() returns quickly even
+ * for 32 players and more.
+ *
+ * The result only depends on the input and the seed, which is used to order
+ * units of equal rank.
+ */
+class TeamBalancer
+{
+public:
+	static const size_t MaxExactUnits = 20;
+	static const unsigned long MaxSearchNodes = 2000000;
+
+	TeamBalancer(size_t numgroups, unsigned int seed);
+
+	//! adds a unit of @p size players with summed rank @p rank, returns its index
+	size_t AddUnit(double rank, int size = 1);
+
+	//! @return the group of every unit, in the order they were added
+	std::vector<size_t> Balance();
+
+	//! true if the last Balance() call found a provably optimal split
+	bool IsOptimal() const
+	{
+		return m_optimal;
+	}
+	//! difference between the highest and lowest rank sum of the last result
+	double GetRankSpread() const
+	{
+		return m_bestRankSpread;
+	}
+	//! difference between the largest and smallest group of the last result
+	int GetSizeSpread() const
+	{
+		return m_bestSizeSpread;
+	}
+
+private:
+	struct Unit
+	{
+		double rank;
+		int size;
+		size_t index;
+		unsigned int tiebreak;
+	};
+
+	static bool UnitOrder(const Unit& a, const Unit& b);
+	void Heuristic();
+	void LocalSearch(std::vector<size_t>& assignment);
+	void Search(size_t pos);
+	void Evaluate(const std::vector<size_t>& assignment, int& sizeSpread, double& rankSpread) const;
+	bool IsBetter(int sizeSpread, double rankSpread) const;
+	bool IsPerfect() const;
+	void Store(const std::vector<size_t>& assignment);
+
+	const size_t m_numgroups;
+	unsigned int m_seed;
+	std::vector<Unit> m_units;
+
+	// search state, indexed like the sorted m_units
+	std::vector<size_t> m_current;
+	std::vector<double> m_groupRank;
+	std::vector<int> m_groupSize;
+	std::vector<double> m_remainingRank;
+	std::vector<int> m_remainingSize;
+	double m_totalRank;
+	int m_totalSize;
+	unsigned long m_nodes;
+
+	std::vector<size_t> m_best;
+	double m_bestRankSpread;
+	int m_bestSizeSpread;
+	bool m_optimal;
+};
+
+#endif // SPRINGLOBBY_TEAMBALANCE_H_INCLUDED
@@ -0,0 +1,47 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#include "thumbnailcache.h"
+
+#include <sstream>
+#include <wx/filefn.h>
+#include <wx/image.h>
+#include <wx/log.h>
+
+#include "conversion.h"
+
+void ThumbnailCache::SetDirectory(const std::string& dir, int size)
+{
+	m_dir = dir;
+	m_size = size;
+}
+
+std::string ThumbnailCache::GetPath(const std::string& hash) const
+{
+	if (m_dir.empty() || hash.empty())
+		return "";
+	std::ostringstream path;
+	path << m_dir << hash << "-" << m_size << ".png";
+	return path.str();
+}
+
+bool ThumbnailCache::Load(const std::string& hash, wxImage& image) const
+{
+	const std::string path = GetPath(hash);
+	if (path.empty() || !wxFileExists(TowxString(path)))
+		return false;
+	wxLogNull nolog; // a damaged file is simply written again
+	return image.LoadFile(TowxString(path), wxBITMAP_TYPE_PNG) && image.IsOk();
+}
+
+bool ThumbnailCache::Save(const std::string& hash, const wxImage& image) const
+{
+	const std::string path = GetPath(hash);
+	if (path.empty() || !image.IsOk())
+		return false;
+	const wxString tmp = TowxString(path + ".tmp");
+	if (!image.SaveFile(tmp, wxBITMAP_TYPE_PNG)) {
+		wxRemoveFile(tmp);
+		return false;
+	}
+	return wxRenameFile(tmp, TowxString(path), true);
+}
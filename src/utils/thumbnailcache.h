@@ -0,0 +1,36 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#ifndef SPRINGLOBBY_THUMBNAILCACHE_H_INCLUDED
+#define SPRINGLOBBY_THUMBNAILCACHE_H_INCLUDED
+
+#include <string>
+
+class wxImage;
+
+/** @brief Keeps finished map thumbnails on disk, named by map hash and size.
+ *
+ * Only does file I/O and png coding, so it may be used from worker threads
+ * once SetDirectory() was called.
+ */
+class ThumbnailCache
+{
+public:
+	ThumbnailCache()
+	    : m_size(0)
+	{
+	}
+	//! @param dir has to end with a path delimiter, empty disables the cache
+	void SetDirectory(const std::string& dir, int size);
+
+	//! empty if the cache is disabled or @p hash is empty
+	std::string GetPath(const std::string& hash) const;
+	bool Load(const std::string& hash, wxImage& image) const;
+	//! writes a temporary file first, so a concurrent Load never sees half a png
+	bool Save(const std::string& hash, const wxImage& image) const;
+
+private:
+	std::string m_dir;
+	int m_size;
+};
+
+#endif // SPRINGLOBBY_THUMBNAILCACHE_H_INCLUDED
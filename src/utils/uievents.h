@@ -31,8 +31,23 @@ enum EventType {
 	UserAction
 };
 
-typedef std::pair<EventType, wxString>
-    NotficationData;
+struct NotficationData
+{
+	NotficationData()
+	    : type(PrivateMessage)
+	{
+	}
+	NotficationData(EventType type_, const wxString& message_, const wxString& source_ = wxEmptyString)
+	    : type(type_)
+	    , message(message_)
+	    , source(source_)
+	{
+	}
+	EventType type;
+	wxString message;
+	//! channel or nick the event belongs to, queued events of the same source are shown as one
+	wxString source;
+};
 
 EventSender<NotficationData>& GetNotificationEventSender();
 
@@ -0,0 +1,21 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#include "usergroupindex.h"
+
+void UserGroupIndex::AddGroup(const wxString& group, const wxArrayString& members, int actions, const wxColour& color)
+{
+	for (size_t i = 0; i < members.GetCount(); ++i) {
+		Entry& entry = m_people[members[i]];
+		entry.group = group;
+		entry.actions |= actions;
+		entry.color = color;
+	}
+}
+
+const UserGroupIndex::Entry* UserGroupIndex::Find(const wxString& user) const
+{
+	const PeopleMap::const_iterator it = m_people.find(user);
+	if (it == m_people.end())
+		return NULL;
+	return &it->second;
+}
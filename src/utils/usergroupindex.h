@@ -0,0 +1,43 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#ifndef SPRINGLOBBY_USERGROUPINDEX_H_INCLUDED
+#define SPRINGLOBBY_USERGROUPINDEX_H_INCLUDED
+
+#include <wx/arrstr.h>
+#include <wx/colour.h>
+#include <wx/hashmap.h>
+#include <unordered_map>
+
+//! nick --> group, action mask and highlight colour, see UserActions
+class UserGroupIndex
+{
+public:
+	struct Entry
+	{
+		Entry()
+		    : actions(0)
+		{
+		}
+		wxString group;
+		int actions; //!< UserActions::ActionType flags
+		wxColour color;
+	};
+
+	void Clear()
+	{
+		m_people.clear();
+	}
+	/** @brief Adds the members of @p group.
+	 * A user in more than one group gets the actions of all of them, the
+	 * group and colour of the group added last.
+	 */
+	void AddGroup(const wxString& group, const wxArrayString& members, int actions, const wxColour& color);
+	//! @return NULL if @p user isn't in any group
+	const Entry* Find(const wxString& user) const;
+
+private:
+	typedef std::unordered_map<wxString, Entry, wxStringHash, wxStringEqual> PeopleMap;
+	PeopleMap m_people;
+};
+
+#endif // SPRINGLOBBY_USERGROUPINDEX_H_INCLUDED
@@ -0,0 +1,76 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#include "workerpool.h"
+
+#include <algorithm>
+#include <boost/bind.hpp>
+
+WorkerPool::WorkerPool(size_t threads)
+    : m_count(threads)
+    , m_stop(false)
+{
+	if (m_count == 0)
+		m_count = std::max(2u, boost::thread::hardware_concurrency());
+	for (size_t i = 0; i < m_count; i++) {
+		m_threads.create_thread(boost::bind(&WorkerPool::Run, this));
+	}
+}
+
+WorkerPool::~WorkerPool()
+{
+	Stop();
+}
+
+void WorkerPool::Push(const Task& task)
+{
+	{
+		boost::mutex::scoped_lock lock(m_mutex);
+		if (m_stop)
+			return;
+		m_tasks.push_back(task);
+	}
+	m_cond.notify_one();
+}
+
+void WorkerPool::ClearPending()
+{
+	boost::mutex::scoped_lock lock(m_mutex);
+	m_tasks.clear();
+}
+
+void WorkerPool::Stop()
+{
+	{
+		boost::mutex::scoped_lock lock(m_mutex);
+		if (m_stop)
+			return;
+		m_stop = true;
+		m_tasks.clear();
+	}
+	m_cond.notify_all();
+	m_threads.join_all();
+}
+
+size_t WorkerPool::GetPending() const
+{
+	boost::mutex::scoped_lock lock(m_mutex);
+	return m_tasks.size();
+}
+
+void WorkerPool::Run()
+{
+	while (true) {
+		Task task;
+		{
+			boost::mutex::scoped_lock lock(m_mutex);
+			while (!m_stop && m_tasks.empty()) {
+				m_cond.wait(lock);
+			}
+			if (m_stop)
+				return;
+			task = m_tasks.front();
+			m_tasks.pop_front();
+		}
+		task();
+	}
+}
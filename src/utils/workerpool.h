@@ -0,0 +1,51 @@
+/* This file is part of the Springlobby (GPL v2 or later), see COPYING */
+
+#ifndef SPRINGLOBBY_WORKERPOOL_H_INCLUDED
+#define SPRINGLOBBY_WORKERPOOL_H_INCLUDED
+
+#include <cstddef>
+#include <deque>
+#include <boost/function.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+/** @brief A fixed number of threads running queued tasks in FIFO order.
+ *
+ * Tasks must not touch gui objects, hand results back to the main thread
+ * with wxPostEvent or similar instead.
+ */
+class WorkerPool
+{
+public:
+	typedef boost::function<void()> Task;
+
+	//! @param threads number of threads, 0 uses the number of cores
+	explicit WorkerPool(size_t threads = 0);
+	//! drops all pending tasks and waits for the running ones
+	~WorkerPool();
+
+	void Push(const Task& task);
+	//! drops all tasks which didn't start yet
+	void ClearPending();
+	//! drops pending tasks, waits for the running ones and stops the threads
+	void Stop();
+
+	size_t GetPending() const;
+	size_t GetThreadCount() const
+	{
+		return m_count;
+	}
+
+private:
+	void Run();
+
+	mutable boost::mutex m_mutex;
+	boost::condition_variable m_cond;
+	std::deque<Task> m_tasks;
+	boost::thread_group m_threads;
+	size_t m_count;
+	bool m_stop;
+};
+
+#endif // SPRINGLOBBY_WORKERPOOL_H_INCLUDED